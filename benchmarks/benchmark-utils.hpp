@@ -0,0 +1,169 @@
+#ifndef VIENNAGRID_BENCHMARKS_BENCHMARK_UTILS_HPP
+#define VIENNAGRID_BENCHMARKS_BENCHMARK_UTILS_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+
+#ifdef _WIN32
+
+#define WINDOWS_LEAN_AND_MEAN
+#include <windows.h>
+#undef min
+#undef max
+
+/** @brief Simple wall clock timer for the benchmarks */
+class Timer
+{
+public:
+
+  Timer()
+  {
+    QueryPerformanceFrequency(&freq);
+  }
+
+  void start()
+  {
+    QueryPerformanceCounter((LARGE_INTEGER*) &start_time);
+  }
+
+  double get() const
+  {
+    LARGE_INTEGER  end_time;
+    QueryPerformanceCounter((LARGE_INTEGER*) &end_time);
+    return (static_cast<double>(end_time.QuadPart) - static_cast<double>(start_time.QuadPart)) / static_cast<double>(freq.QuadPart);
+  }
+
+
+private:
+  LARGE_INTEGER freq;
+  LARGE_INTEGER start_time;
+};
+
+#else
+
+#include <sys/time.h>
+
+/** @brief Simple wall clock timer for the benchmarks */
+class Timer
+{
+public:
+
+  Timer() : ts(0)
+  {}
+
+  void start()
+  {
+    struct timeval tval;
+    gettimeofday(&tval, NULL);
+    ts = static_cast<double>(tval.tv_sec * 1000000 + tval.tv_usec);
+  }
+
+  double get() const
+  {
+    struct timeval tval;
+    gettimeofday(&tval, NULL);
+    double end_time = static_cast<double>(tval.tv_sec * 1000000 + tval.tv_usec);
+
+    return static_cast<double>(end_time-ts) / 1000000.0;
+  }
+
+private:
+  double ts;
+};
+
+
+#endif
+
+
+/** @brief Collects named timings of a benchmark run.
+  *
+  * The results are written as plain text with one line 'name seconds' per timing, which is also the format of a baseline.
+  * Comparing against a baseline reports all timings slower than the baseline by more than a relative tolerance.
+  */
+class BenchmarkResults
+{
+public:
+
+  void add(std::string const & name, double seconds)
+  {
+    std::cout << name << ": " << seconds << " sec" << std::endl;
+    names.push_back(name);
+    timings[name] = seconds;
+  }
+
+  /** @brief Writes the results to a file, returns false if the file cannot be opened */
+  bool write(std::string const & filename) const
+  {
+    std::ofstream writer(filename.c_str());
+    if (!writer)
+      return false;
+
+    writer.precision(9);
+    for (std::size_t i = 0; i < names.size(); ++i)
+      writer << names[i] << " " << timings.find(names[i])->second << std::endl;
+    return true;
+  }
+
+  /** @brief Compares the results against a baseline file written by write(). Returns the number of regressions or -1 if the baseline cannot be read. */
+  int compare(std::string const & baseline_filename, double tolerance) const
+  {
+    std::ifstream reader(baseline_filename.c_str());
+    if (!reader)
+      return -1;
+
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(reader, line))
+    {
+      std::istringstream iss(line);
+      std::string name;
+      double seconds;
+      if (iss >> name >> seconds)
+        baseline[name] = seconds;
+    }
+
+    int regressions = 0;
+    std::cout << std::endl << "Comparison with baseline " << baseline_filename << " (tolerance " << tolerance * 100.0 << "%):" << std::endl;
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+      std::map<std::string, double>::const_iterator it = baseline.find(names[i]);
+      if (it == baseline.end())
+      {
+        std::cout << "  " << names[i] << ": not in baseline" << std::endl;
+        continue;
+      }
+
+      double seconds = timings.find(names[i])->second;
+      double ratio = (it->second > 0) ? seconds / it->second : 1.0;
+      bool regression = ratio > 1.0 + tolerance;
+      if (regression)
+        ++regressions;
+
+      std::cout << "  " << names[i] << ": " << ratio << "x baseline" << (regression ? "  <-- REGRESSION" : "") << std::endl;
+    }
+
+    return regressions;
+  }
+
+private:
+  std::vector<std::string> names;
+  std::map<std::string, double> timings;
+};
+
+#endif
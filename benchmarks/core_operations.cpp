@@ -0,0 +1,227 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+/*
+*   Benchmark: Core mesh operations on synthetic structured meshes
+*
+*   Structured triangular (4n cells per direction), tetrahedral and hexahedral meshes (n cells per direction) are created,
+*   and the construction (make_element), the coboundary and neighbor caches, the boundary detection, the filling of a segmentation,
+*   the uniform refinement, the Voronoi information and writing and reading VTK files are timed. The best time of all runs is reported.
+*
+*   Usage: core_operations [n] [number-of-runs] [--output results.txt] [--baseline baseline.txt] [--tolerance 0.2]
+*
+*   The results written with --output can be used as baseline for later runs. With --baseline, all timings slower than the baseline
+*   by more than the relative tolerance are reported as regressions and the exit code is the number of regressions.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/mesh/coboundary_iteration.hpp"
+#include "viennagrid/mesh/neighbor_iteration.hpp"
+#include "viennagrid/algorithm/boundary.hpp"
+#include "viennagrid/algorithm/centroid.hpp"
+#include "viennagrid/algorithm/refine.hpp"
+#include "viennagrid/algorithm/voronoi.hpp"
+#include "viennagrid/io/vtk_writer.hpp"
+#include "viennagrid/io/vtk_reader.hpp"
+
+#include "benchmark-utils.hpp"
+#include "structured_mesh.hpp"
+
+
+template<typename MeshT>
+void benchmark_uniform_refinement(MeshT const & mesh, std::string const & prefix, int runs, BenchmarkResults & results)
+{
+  Timer timer;
+  double best = 1e30;
+  for (int r = 0; r < runs; ++r)
+  {
+    MeshT refined_mesh;
+    timer.start();
+    viennagrid::cell_refine_uniformly(mesh, refined_mesh);
+    best = std::min(best, timer.get());
+  }
+  results.add(prefix + "/cell_refine_uniformly", best);
+}
+
+/** @brief Runs all benchmarks for one mesh type */
+template<typename MeshT>
+void benchmark(std::string const & prefix, std::size_t n, int runs, BenchmarkResults & results)
+{
+  typedef typename viennagrid::result_of::segmentation<MeshT>::type            SegmentationType;
+  typedef typename viennagrid::result_of::cell_tag<MeshT>::type                CellTag;
+  typedef typename viennagrid::result_of::facet_tag<MeshT>::type               FacetTag;
+  typedef typename viennagrid::result_of::cell<MeshT>::type                    CellType;
+  typedef typename viennagrid::result_of::line<MeshT>::type                    EdgeType;
+  typedef typename viennagrid::result_of::vertex<MeshT>::type                  VertexType;
+  typedef typename viennagrid::result_of::cell_range<MeshT>::type              CellRangeType;
+  typedef typename viennagrid::result_of::iterator<CellRangeType>::type        CellIteratorType;
+  typedef typename viennagrid::result_of::const_cell_handle<MeshT>::type       ConstCellHandleType;
+  typedef typename viennagrid::result_of::voronoi_cell_contribution<ConstCellHandleType>::type  ContributionType;
+
+  Timer timer;
+  double best_construction = 1e30;
+  double best_coboundary = 1e30;
+  double best_neighbors = 1e30;
+  double best_boundary = 1e30;
+  double best_segmentation = 1e30;
+
+  for (int r = 0; r < runs; ++r)
+  {
+    MeshT mesh;
+
+    timer.start();
+    make_structured_mesh(mesh, n, CellTag());
+    best_construction = std::min(best_construction, timer.get());
+
+    timer.start();
+    viennagrid::prepare_coboundary<viennagrid::vertex_tag, CellTag>(mesh);
+    best_coboundary = std::min(best_coboundary, timer.get());
+
+    timer.start();
+    viennagrid::prepare_neighbors<CellTag, FacetTag>(mesh);
+    best_neighbors = std::min(best_neighbors, timer.get());
+
+    timer.start();
+    viennagrid::prepare_boundary(mesh);
+    best_boundary = std::min(best_boundary, timer.get());
+
+    // two segments, split at x = 0.5
+    SegmentationType segmentation(mesh);
+    CellRangeType cells(mesh);
+    timer.start();
+    for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+      viennagrid::add( segmentation[viennagrid::centroid(*cit)[0] < 0.5 ? 0 : 1], *cit );
+    best_segmentation = std::min(best_segmentation, timer.get());
+  }
+
+  std::cout << prefix << ": " << n << " cells per direction" << std::endl;
+  results.add(prefix + "/make_element", best_construction);
+  results.add(prefix + "/prepare_coboundary", best_coboundary);
+  results.add(prefix + "/prepare_neighbors", best_neighbors);
+  results.add(prefix + "/prepare_boundary", best_boundary);
+  results.add(prefix + "/segmentation_fill", best_segmentation);
+
+  MeshT mesh;
+  make_structured_mesh(mesh, n, CellTag());
+
+  benchmark_uniform_refinement(mesh, prefix, runs, results);
+
+  {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r)
+    {
+      std::deque<double> interface_areas;
+      std::deque<ContributionType> interface_contributions;
+      std::deque<double> vertex_box_volumes;
+      std::deque<ContributionType> vertex_box_volume_contributions;
+      std::deque<double> edge_box_volumes;
+      std::deque<ContributionType> edge_box_volume_contributions;
+
+      timer.start();
+      viennagrid::apply_voronoi<CellType>(mesh,
+                                          viennagrid::make_field<EdgeType>(interface_areas),
+                                          viennagrid::make_field<EdgeType>(interface_contributions),
+                                          viennagrid::make_field<VertexType>(vertex_box_volumes),
+                                          viennagrid::make_field<VertexType>(vertex_box_volume_contributions),
+                                          viennagrid::make_field<EdgeType>(edge_box_volumes),
+                                          viennagrid::make_field<EdgeType>(edge_box_volume_contributions));
+      best = std::min(best, timer.get());
+    }
+    results.add(prefix + "/apply_voronoi", best);
+  }
+
+  {
+    std::string filename = "core_operations_" + prefix;
+    double best_write = 1e30;
+    double best_read = 1e30;
+    for (int r = 0; r < runs; ++r)
+    {
+      viennagrid::io::vtk_writer<MeshT> writer;
+      timer.start();
+      writer(mesh, filename);
+      best_write = std::min(best_write, timer.get());
+
+      MeshT read_mesh;
+      SegmentationType read_segmentation(read_mesh);
+      viennagrid::io::vtk_reader<MeshT> reader;
+      timer.start();
+      reader(read_mesh, read_segmentation, filename + ".vtu");
+      best_read = std::min(best_read, timer.get());
+    }
+    results.add(prefix + "/vtk_write", best_write);
+    results.add(prefix + "/vtk_read", best_read);
+    std::remove( (filename + ".vtu").c_str() );
+  }
+}
+
+
+int main(int argc, char ** argv)
+{
+  std::vector<std::string> positional;
+  std::string output_filename;
+  std::string baseline_filename;
+  double tolerance = 0.2;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--output" && i+1 < argc)
+      output_filename = argv[++i];
+    else if (arg == "--baseline" && i+1 < argc)
+      baseline_filename = argv[++i];
+    else if (arg == "--tolerance" && i+1 < argc)
+      tolerance = std::atof(argv[++i]);
+    else
+      positional.push_back(arg);
+  }
+
+  std::size_t n = (positional.size() > 0) ? static_cast<std::size_t>(std::atoi(positional[0].c_str())) : 20;
+  int runs = (positional.size() > 1) ? std::atoi(positional[1].c_str()) : 3;
+
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Benchmark :: Core mesh operations" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+
+  BenchmarkResults results;
+  benchmark<viennagrid::triangular_2d_mesh>("triangle", 4 * n, runs, results);
+  benchmark<viennagrid::tetrahedral_3d_mesh>("tetrahedron", n, runs, results);
+  benchmark<viennagrid::hexahedral_3d_mesh>("hexahedron", n, runs, results);
+
+  if (!output_filename.empty() && !results.write(output_filename))
+  {
+    std::cerr << "Cannot write results to " << output_filename << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!baseline_filename.empty())
+  {
+    int regressions = results.compare(baseline_filename, tolerance);
+    if (regressions < 0)
+    {
+      std::cerr << "Cannot read baseline " << baseline_filename << std::endl;
+      return EXIT_FAILURE;
+    }
+    return regressions;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+/*
+*   Benchmark: Throughput of the plain text readers
+*
+*   The bundled Netgen and Tetgen files from examples/data/ are replicated (shifted copies) into larger files,
+*   which are then read several times. The throughput is reported in MB/s.
+*
+*   Usage: io_readers [path-to-examples/data/] [number-of-copies]
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/io/tetgen_poly_reader.hpp"
+
+#include "benchmark-utils.hpp"
+
+
+/** @brief Writes 'copies' shifted copies of a Netgen mesh into a single file */
+void scale_netgen_file(std::string const & infile, std::string const & outfile, int copies)
+{
+  std::ifstream reader(infile.c_str());
+  if (!reader)
+  {
+    std::cerr << "Cannot open " << infile << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::size_t node_num, cell_num;
+  reader >> node_num;
+  std::vector<double> coords(3*node_num);
+  for (std::size_t i = 0; i < coords.size(); ++i)
+    reader >> coords[i];
+
+  reader >> cell_num;
+  std::vector<long> cells(5*cell_num);
+  for (std::size_t i = 0; i < cells.size(); ++i)
+    reader >> cells[i];
+
+  std::ofstream writer(outfile.c_str());
+  writer.precision(17);
+
+  writer << copies * node_num << "\n";
+  for (int c = 0; c < copies; ++c)
+    for (std::size_t i = 0; i < node_num; ++i)
+      writer << "  " << coords[3*i] + 1.5*c << "  " << coords[3*i+1] << "  " << coords[3*i+2] << "\n";
+
+  writer << copies * cell_num << "\n";
+  for (int c = 0; c < copies; ++c)
+    for (std::size_t i = 0; i < cell_num; ++i)
+    {
+      writer << "   " << cells[5*i];
+      for (std::size_t j = 1; j < 5; ++j)
+        writer << "   " << cells[5*i+j] + static_cast<long>(c*node_num);
+      writer << "\n";
+    }
+}
+
+/** @brief Writes a Tetgen .poly file consisting of 'copies' shifted cubes, each face being a facet */
+void make_poly_file(std::string const & outfile, int copies)
+{
+  std::ofstream writer(outfile.c_str());
+  writer.precision(17);
+
+  writer << "# " << copies << " shifted unit cubes\n";
+  writer << 8*copies << " 3 0 0\n";
+  for (int c = 0; c < copies; ++c)
+    for (int i = 0; i < 8; ++i)
+      writer << 8*c+i << "  " << (i & 1) + 1.5*c << "  " << ((i >> 1) & 1) << "  " << ((i >> 2) & 1) << "\n";
+
+  static const int faces[6][4] = { {0, 1, 3, 2}, {4, 5, 7, 6}, {0, 1, 5, 4}, {2, 3, 7, 6}, {0, 2, 6, 4}, {1, 3, 7, 5} };
+
+  writer << 6*copies << " 0\n";
+  for (int c = 0; c < copies; ++c)
+    for (int f = 0; f < 6; ++f)
+    {
+      writer << "1 0\n";
+      writer << "4";
+      for (int j = 0; j < 4; ++j)
+        writer << " " << 8*c + faces[f][j];
+      writer << "\n";
+    }
+
+  writer << "0\n0\n";
+}
+
+std::size_t file_size(std::string const & filename)
+{
+  std::ifstream reader(filename.c_str(), std::ios::binary | std::ios::ate);
+  return static_cast<std::size_t>(reader.tellg());
+}
+
+void print_result(std::string const & name, std::size_t bytes, double seconds, std::size_t cells)
+{
+  std::cout << name << ": " << bytes / (1024.0 * 1024.0) / seconds << " MB/s (" << cells << " elements, " << seconds << " sec)" << std::endl;
+}
+
+template<typename MeshT>
+void bench_netgen(std::string const & name, std::string const & filename, int runs)
+{
+  Timer timer;
+  std::size_t bytes = file_size(filename);
+
+  double best = 1e30;
+  std::size_t cells = 0;
+  for (int r = 0; r < runs; ++r)
+  {
+    MeshT mesh;
+    typename viennagrid::result_of::segmentation<MeshT>::type segmentation(mesh);
+    viennagrid::io::netgen_reader reader;
+
+    timer.start();
+    reader(mesh, segmentation, filename);
+    best = std::min(best, timer.get());
+    cells = viennagrid::cells(mesh).size();
+  }
+  print_result(name, bytes, best, cells);
+}
+
+
+int main(int argc, char ** argv)
+{
+  std::string path = (argc > 1) ? argv[1] : "../examples/data/";
+  int copies = (argc > 2) ? std::atoi(argv[2]) : 50;
+  int runs = 3;
+
+  Timer timer;
+
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Benchmark :: Plain text reader throughput" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+
+  //
+  // Netgen, the thin mesh shows the parsing throughput, the full mesh includes the construction of all boundary elements
+  //
+  {
+    std::string filename = "io_readers_scaled.mesh";
+    scale_netgen_file(path + "cube3072.mesh", filename, copies);
+
+    bench_netgen<viennagrid::thin_tetrahedral_3d_mesh>("netgen_reader (thin tetrahedral mesh)", filename, runs);
+    bench_netgen<viennagrid::tetrahedral_3d_mesh>("netgen_reader (tetrahedral mesh)", filename, runs);
+
+    std::remove(filename.c_str());
+  }
+
+  //
+  // Tetgen .poly
+  //
+  {
+    std::string filename = "io_readers_scaled.poly";
+    make_poly_file(filename, 20*copies);
+    std::size_t bytes = file_size(filename);
+
+    double best = 1e30;
+    std::size_t plcs = 0;
+    for (int r = 0; r < runs; ++r)
+    {
+      viennagrid::plc_3d_mesh mesh;
+      viennagrid::io::tetgen_poly_reader reader;
+
+      timer.start();
+      reader(mesh, filename);
+      best = std::min(best, timer.get());
+      plcs = viennagrid::elements<viennagrid::plc_tag>(mesh).size();
+    }
+    print_result("tetgen_poly_reader", bytes, best, plcs);
+    std::remove(filename.c_str());
+  }
+
+  return EXIT_SUCCESS;
+}
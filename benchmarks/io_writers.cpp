@@ -0,0 +1,120 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+/*
+*   Benchmark: Throughput of the plain text writers
+*
+*   The bundled Netgen mesh from examples/data/ is read and written to OpenDX and Comsol .mphtxt files several times.
+*   The throughput is reported in MB/s.
+*
+*   Usage: io_writers [path-to-examples/data/] [number-of-runs]
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/io/opendx_writer.hpp"
+#include "viennagrid/io/mphtxt_writer.hpp"
+
+#include "benchmark-utils.hpp"
+
+
+std::size_t file_size(std::string const & filename)
+{
+  std::ifstream reader(filename.c_str(), std::ios::binary | std::ios::ate);
+  return static_cast<std::size_t>(reader.tellg());
+}
+
+void print_result(std::string const & name, std::size_t bytes, double seconds)
+{
+  std::cout << name << ": " << bytes / (1024.0 * 1024.0) / seconds << " MB/s (" << bytes << " bytes, " << seconds << " sec)" << std::endl;
+}
+
+
+int main(int argc, char ** argv)
+{
+  typedef viennagrid::tetrahedral_3d_mesh                               MeshType;
+  typedef viennagrid::result_of::segmentation<MeshType>::type           SegmentationType;
+  typedef viennagrid::result_of::vertex<MeshType>::type                 VertexType;
+
+  std::string path = (argc > 1) ? argv[1] : "../examples/data/";
+  int runs = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+  std::cout << "----------------------------------------------" << std::endl;
+  std::cout << "## Benchmark :: Plain text writer throughput" << std::endl;
+  std::cout << "----------------------------------------------" << std::endl;
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, path + "cube3072.mesh");
+
+  std::vector<double> potential;
+  viennagrid::result_of::field<std::vector<double>, VertexType>::type potential_field(potential);
+
+  typedef viennagrid::result_of::const_vertex_range<MeshType>::type     ConstVertexRangeType;
+  typedef viennagrid::result_of::iterator<ConstVertexRangeType>::type   ConstVertexIteratorType;
+
+  ConstVertexRangeType vertices(mesh);
+  for (ConstVertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+    potential_field(*vit) = viennagrid::point(*vit)[0] * viennagrid::point(*vit)[1] + 0.25;
+
+  Timer timer;
+
+  //
+  // OpenDX with vertex data
+  //
+  {
+    std::string filename = "io_writers.dx";
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r)
+    {
+      viennagrid::io::opendx_writer<MeshType> writer;
+      viennagrid::io::add_scalar_data_on_vertices(writer, potential_field, "potential");
+
+      timer.start();
+      writer(mesh, filename);
+      best = std::min(best, timer.get());
+    }
+    print_result("opendx_writer", file_size(filename), best);
+    std::remove(filename.c_str());
+  }
+
+  //
+  // Comsol .mphtxt, includes the detection of boundary triangles and contacts
+  //
+  {
+    std::string filename = "io_writers.mphtxt";
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r)
+    {
+      viennagrid::io::mphtxt_writer writer;
+
+      timer.start();
+      writer(mesh, segmentation, filename);
+      best = std::min(best, timer.get());
+    }
+    print_result("mphtxt_writer", file_size(filename), best);
+    std::remove(filename.c_str());
+  }
+
+  return EXIT_SUCCESS;
+}
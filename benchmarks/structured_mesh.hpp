@@ -0,0 +1,115 @@
+#ifndef VIENNAGRID_BENCHMARKS_STRUCTURED_MESH_HPP
+#define VIENNAGRID_BENCHMARKS_STRUCTURED_MESH_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+
+/*
+*   Synthetic structured meshes of scalable size for the benchmarks:
+*   The unit square (cube) is divided into n x n squares (n x n x n cubes), each square is split into two triangles, each cube into six tetrahedra or kept as a hexahedron.
+*/
+
+
+/** @brief Creates the vertices of a structured grid with n+1 vertices per direction in 'dimension' dimensions */
+template<typename MeshT>
+std::vector<typename viennagrid::result_of::vertex_handle<MeshT>::type> make_grid_vertices(MeshT & mesh, std::size_t n, std::size_t dimension)
+{
+  typedef typename viennagrid::result_of::point<MeshT>::type           PointType;
+
+  std::vector<typename viennagrid::result_of::vertex_handle<MeshT>::type> vertices;
+  double h = 1.0 / static_cast<double>(n);
+
+  std::size_t nz = (dimension == 3) ? n : 0;
+  for (std::size_t k = 0; k <= nz; ++k)
+    for (std::size_t j = 0; j <= n; ++j)
+      for (std::size_t i = 0; i <= n; ++i)
+      {
+        PointType p;
+        p[0] = static_cast<double>(i) * h;
+        p[1] = static_cast<double>(j) * h;
+        if (dimension == 3)
+          p[2] = static_cast<double>(k) * h;
+        vertices.push_back( viennagrid::make_vertex(mesh, p) );
+      }
+
+  return vertices;
+}
+
+
+/** @brief Creates a structured triangle mesh of the unit square with 2 n^2 triangles */
+template<typename MeshT>
+void make_structured_mesh(MeshT & mesh, std::size_t n, viennagrid::triangle_tag)
+{
+  typedef typename viennagrid::result_of::vertex_handle<MeshT>::type   VertexHandleType;
+
+  std::vector<VertexHandleType> vertices = make_grid_vertices(mesh, n, 2);
+
+  for (std::size_t j = 0; j < n; ++j)
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      std::size_t v0 = j * (n+1) + i;
+      viennagrid::make_triangle(mesh, vertices[v0], vertices[v0+1], vertices[v0+n+2]);
+      viennagrid::make_triangle(mesh, vertices[v0], vertices[v0+n+2], vertices[v0+n+1]);
+    }
+}
+
+/** @brief Creates a structured tetrahedral mesh of the unit cube with 6 n^3 tetrahedra (Kuhn triangulation of each cube) */
+template<typename MeshT>
+void make_structured_mesh(MeshT & mesh, std::size_t n, viennagrid::tetrahedron_tag)
+{
+  typedef typename viennagrid::result_of::vertex_handle<MeshT>::type   VertexHandleType;
+
+  std::vector<VertexHandleType> vertices = make_grid_vertices(mesh, n, 3);
+
+  // the six tetrahedra of a cube with corners numbered 0..7 (bit 0: x, bit 1: y, bit 2: z) share the diagonal 0-7
+  static const std::size_t kuhn[6][4] = { {0,1,3,7}, {0,1,5,7}, {0,2,3,7}, {0,2,6,7}, {0,4,5,7}, {0,4,6,7} };
+
+  for (std::size_t k = 0; k < n; ++k)
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        VertexHandleType corners[8];
+        for (std::size_t c = 0; c < 8; ++c)
+          corners[c] = vertices[ ((k + (c >> 2)) * (n+1) + j + ((c >> 1) & 1)) * (n+1) + i + (c & 1) ];
+
+        for (std::size_t t = 0; t < 6; ++t)
+          viennagrid::make_tetrahedron(mesh, corners[kuhn[t][0]], corners[kuhn[t][1]], corners[kuhn[t][2]], corners[kuhn[t][3]]);
+      }
+}
+
+/** @brief Creates a structured hexahedral mesh of the unit cube with n^3 hexahedra */
+template<typename MeshT>
+void make_structured_mesh(MeshT & mesh, std::size_t n, viennagrid::hexahedron_tag)
+{
+  typedef typename viennagrid::result_of::vertex_handle<MeshT>::type   VertexHandleType;
+  typedef typename viennagrid::result_of::cell<MeshT>::type            CellType;
+
+  std::vector<VertexHandleType> vertices = make_grid_vertices(mesh, n, 3);
+
+  VertexHandleType corners[8];
+  for (std::size_t k = 0; k < n; ++k)
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        for (std::size_t c = 0; c < 8; ++c)
+          corners[c] = vertices[ ((k + (c >> 2)) * (n+1) + j + ((c >> 1) & 1)) * (n+1) + i + (c & 1) ];
+
+        viennagrid::make_element<CellType>(mesh, corners, corners + 8);
+      }
+}
+
+#endif
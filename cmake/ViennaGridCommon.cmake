@@ -34,8 +34,16 @@ option(BUILD_MANUAL "Build the PDF manual" OFF)
 
 option(BUILD_EXAMPLES "Build example programs" ON)
 
+option(BUILD_BENCHMARKS "Build benchmark programs" OFF)
+
 option(ENABLE_VIENNADATA "Enable ViennaData for advanced accessors" OFF)
 
+option(ENABLE_OPENMP "Enable OpenMP parallelization of selected algorithms" OFF)
+
+option(ENABLE_INSTRUMENTATION "Enable counters and timers of cache builds, key map operations, handle dereferences and IO phases" OFF)
+
+option(ENABLE_PRECOMPILED_INSTANCES "Build the library viennagrid_instances with precompiled instantiations of the default configurations and link against it" OFF)
+
 mark_as_advanced(ENABLE_PEDANTIC_FLAGS)
 
 include_directories(${PROJECT_SOURCE_DIR})
@@ -50,6 +58,19 @@ if(ENABLE_VIENNADATA)
   set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DVIENNAGRID_WITH_VIENNADATA")
 endif()
 
+if(ENABLE_OPENMP)
+  find_package(OpenMP REQUIRED)
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS} -DVIENNAGRID_WITH_OPENMP")
+endif()
+
+if(ENABLE_INSTRUMENTATION)
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DVIENNAGRID_WITH_INSTRUMENTATION")
+endif()
+
+if(ENABLE_PRECOMPILED_INSTANCES)
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DVIENNAGRID_WITH_PRECOMPILED_INSTANCES")
+endif()
+
 
 # Export
 ########
@@ -0,0 +1,190 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Per element type change counters: caches are only invalidated by changes of the element types they depend on, coboundary information is extended after insertions.
+//
+
+#include <vector>
+#include <algorithm>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/mesh/element_deletion.hpp"
+#include "viennagrid/mesh/coboundary_iteration.hpp"
+#include "viennagrid/mesh/neighbor_iteration.hpp"
+#include "viennagrid/algorithm/boundary.hpp"
+
+#include "check_common.hpp"
+
+typedef viennagrid::tetrahedral_3d_mesh                                             MeshType;
+typedef viennagrid::result_of::segmentation<MeshType>::type                        SegmentationType;
+typedef viennagrid::result_of::point<MeshType>::type                               PointType;
+typedef viennagrid::result_of::vertex_handle<MeshType>::type                       VertexHandleType;
+typedef viennagrid::result_of::cell_handle<MeshType>::type                         CellHandleType;
+typedef viennagrid::result_of::const_vertex_range<MeshType>::type                  VertexRangeType;
+typedef viennagrid::result_of::iterator<VertexRangeType>::type                     VertexIteratorType;
+typedef viennagrid::result_of::const_line_range<MeshType>::type                    LineRangeType;
+typedef viennagrid::result_of::iterator<LineRangeType>::type                       LineIteratorType;
+typedef viennagrid::result_of::const_cell_range<MeshType>::type                    CellRangeType;
+typedef viennagrid::result_of::iterator<CellRangeType>::type                       CellIteratorType;
+typedef viennagrid::result_of::vertex_range<MeshType>::type                        MutableVertexRangeType;
+typedef viennagrid::result_of::iterator<MutableVertexRangeType>::type              MutableVertexIteratorType;
+typedef viennagrid::result_of::vertex_range<viennagrid::result_of::cell<MeshType>::type>::type  VertexOnCellRangeType;
+
+typedef viennagrid::make_typelist<viennagrid::vertex_tag, viennagrid::tetrahedron_tag>::type    VertexCellDependencies;
+typedef viennagrid::make_typelist<viennagrid::tetrahedron_tag, viennagrid::triangle_tag>::type  CellFacetDependencies;
+
+
+/** @brief Returns the sorted IDs of the given range of elements */
+template<typename RangeT>
+std::vector<long> sorted_ids(RangeT const & range)
+{
+  std::vector<long> result;
+  for (typename viennagrid::result_of::iterator<RangeT>::type it = range.begin(); it != range.end(); ++it)
+    result.push_back( static_cast<long>((*it).id().get()) );
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+/** @brief Collects the coboundary cells of all vertices, the neighbor cells of all cells and the boundary flags of all lines, ordered by IDs */
+std::vector< std::vector<long> > query_caches(MeshType const & mesh)
+{
+  std::vector< std::vector<long> > result;
+
+  std::vector<long> vertex_ids = sorted_ids( VertexRangeType(mesh) );
+  VertexRangeType vertices(mesh);
+  for (std::size_t i = 0; i < vertex_ids.size(); ++i)
+    for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+      if ( static_cast<long>((*vit).id().get()) == vertex_ids[i] )
+        result.push_back( sorted_ids( viennagrid::coboundary_elements<viennagrid::vertex_tag, viennagrid::tetrahedron_tag>(mesh, vit.handle()) ) );
+
+  std::vector<long> cell_ids = sorted_ids( CellRangeType(mesh) );
+  CellRangeType cells(mesh);
+  for (std::size_t i = 0; i < cell_ids.size(); ++i)
+    for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+      if ( static_cast<long>((*cit).id().get()) == cell_ids[i] )
+        result.push_back( sorted_ids( viennagrid::neighbor_elements<viennagrid::tetrahedron_tag, viennagrid::triangle_tag>(mesh, cit.handle()) ) );
+
+  std::vector<long> boundary_lines;
+  LineRangeType lines(mesh);
+  for (LineIteratorType lit = lines.begin(); lit != lines.end(); ++lit)
+    if ( viennagrid::is_boundary(mesh, *lit) )
+      boundary_lines.push_back( static_cast<long>((*lit).id().get()) );
+  std::sort(boundary_lines.begin(), boundary_lines.end());
+  result.push_back(boundary_lines);
+
+  return result;
+}
+
+/** @brief Checks that the caches of a mesh match the caches of a copy, which are created from scratch */
+void check_against_copy(MeshType const & mesh, std::string const & message)
+{
+  MeshType copy(mesh);
+  check( query_caches(mesh) == query_caches(copy), message );
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, "../examples/data/twocubes.mesh");
+
+  query_caches(mesh);
+
+  long const & coboundary_counter = viennagrid::detail::coboundary_collection<viennagrid::vertex_tag, viennagrid::tetrahedron_tag>(mesh).change_counter;
+  long const & neighbor_counter   = viennagrid::detail::neighbor_collection<viennagrid::tetrahedron_tag, viennagrid::triangle_tag>(mesh).change_counter;
+  long const & boundary_counter   = viennagrid::detail::boundary_information_collection<viennagrid::triangle_tag>(mesh).change_counter;
+
+  check( !viennagrid::detail::is_dependency_obsolete<VertexCellDependencies>(mesh, coboundary_counter), "coboundary information up to date" );
+
+
+  //
+  // A line between two existing vertices does not affect caches which do not depend on lines
+  //
+  MutableVertexRangeType vertices(mesh);
+  MutableVertexIteratorType vit = vertices.begin();
+  VertexHandleType first_vertex = vit.handle();
+  VertexHandleType far_vertex = first_vertex;
+  double max_distance = 0;
+  for (; vit != vertices.end(); ++vit)
+  {
+    double distance = viennagrid::norm_2( viennagrid::point(*vit) - viennagrid::point(mesh, first_vertex) );
+    if (distance > max_distance)
+    {
+      max_distance = distance;
+      far_vertex = vit.handle();
+    }
+  }
+
+  std::size_t line_count = viennagrid::lines(mesh).size();
+  viennagrid::make_line(mesh, first_vertex, far_vertex);
+  check( viennagrid::lines(mesh).size() == line_count + 1, "new line inserted" );
+
+  check( viennagrid::detail::is_obsolete(mesh, coboundary_counter), "the total counter changes on every insertion" );
+  check( !viennagrid::detail::is_dependency_obsolete<VertexCellDependencies>(mesh, coboundary_counter), "line does not invalidate the vertex-to-cell coboundary information" );
+  check( !viennagrid::detail::is_dependency_obsolete<CellFacetDependencies>(mesh, neighbor_counter), "line does not invalidate the neighbor information" );
+  check( !viennagrid::detail::is_dependency_obsolete<CellFacetDependencies>(mesh, boundary_counter), "line does not invalidate the boundary facets" );
+
+  check_against_copy(mesh, "caches after inserting a line");
+
+
+  //
+  // New cells are added to the coboundary information without re-creating it
+  //
+  std::size_t cell_count = viennagrid::cells(mesh).size();
+  VertexHandleType new_vertex = viennagrid::make_vertex( mesh, viennagrid::point(mesh, far_vertex) + PointType(1.0, 1.0, 1.0) );
+
+  VertexOnCellRangeType vertices_on_cell( viennagrid::cells(mesh)[0] );
+  viennagrid::make_tetrahedron( mesh, vertices_on_cell.handle_at(0), vertices_on_cell.handle_at(1), vertices_on_cell.handle_at(2), new_vertex );
+  viennagrid::make_tetrahedron( mesh, vertices_on_cell.handle_at(1), vertices_on_cell.handle_at(2), vertices_on_cell.handle_at(3), new_vertex );
+  check( viennagrid::cells(mesh).size() == cell_count + 2, "new cells inserted" );
+
+  check( viennagrid::detail::is_dependency_obsolete<VertexCellDependencies>(mesh, coboundary_counter), "new cells invalidate the coboundary information" );
+  check( viennagrid::detail::extend_coboundary_information<viennagrid::vertex_tag, viennagrid::tetrahedron_tag>(mesh), "coboundary information extended" );
+  check( !viennagrid::detail::is_dependency_obsolete<VertexCellDependencies>(mesh, coboundary_counter), "extended coboundary information up to date" );
+  check( viennagrid::coboundary_elements<viennagrid::vertex_tag, viennagrid::tetrahedron_tag>(mesh, new_vertex).size() == 2, "coboundary cells of the new vertex" );
+
+  check_against_copy(mesh, "caches after inserting cells");
+
+
+  //
+  // Deleting elements re-creates the caches
+  //
+  CellHandleType cell_to_erase = viennagrid::cells(mesh).handle_at(0);
+  viennagrid::erase_element(mesh, cell_to_erase);
+  check( viennagrid::cells(mesh).size() == cell_count + 1, "cell erased" );
+
+  check( viennagrid::detail::is_dependency_obsolete<VertexCellDependencies>(mesh, coboundary_counter), "deletion invalidates the coboundary information" );
+  check( !viennagrid::detail::extend_coboundary_information<viennagrid::vertex_tag, viennagrid::tetrahedron_tag>(mesh), "coboundary information is not extended after deletion" );
+
+  check_against_copy(mesh, "caches after deleting a cell");
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,26 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+
+/** @brief Aborts the test with the given message if the condition does not hold */
+inline void check(bool condition, std::string const & message)
+{
+  if (!condition)
+  {
+    std::cerr << "Failed: " << message << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
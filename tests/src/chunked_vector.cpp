@@ -0,0 +1,162 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/storage/chunked_vector.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/mesh/element_deletion.hpp"
+#include "viennagrid/algorithm/volume.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+
+#include "check_common.hpp"
+
+
+struct chunked_tetrahedral_3d
+{
+  typedef viennagrid::config::result_of::full_mesh_config< viennagrid::tetrahedron_tag,
+                                                           viennagrid::config::point_type_3d,
+                                                           viennagrid::pointer_handle_tag,
+                                                           viennagrid::chunked_vector_tag<>,
+                                                           viennagrid::chunked_vector_tag<> >::type type;
+};
+
+typedef viennagrid::mesh<chunked_tetrahedral_3d>                                      ChunkedMeshType;
+typedef viennagrid::result_of::segmentation<ChunkedMeshType>::type                   ChunkedSegmentationType;
+
+
+void test_container()
+{
+  typedef viennagrid::chunked_vector<int, 4> ContainerType;
+
+  check( ContainerType::chunk_size == 4 && viennagrid::chunked_vector<int, 6>::chunk_size == 4, "Wrong chunk size" );
+
+  ContainerType numbers;
+  check( numbers.begin() == numbers.end() && numbers.empty(), "Empty container is not empty" );
+
+  numbers.push_back(0);
+  int * first = &numbers[0];
+  for (int i = 1; i < 30; ++i)
+    numbers.push_back(i);
+
+  check( first == &numbers[0] && *first == 0, "Element moved while the container grew" );
+  check( numbers.size() == 30 && numbers.end() - numbers.begin() == 30 && numbers.back() == 29, "Wrong size" );
+
+  int expected = 0;
+  for (ContainerType::const_iterator it = numbers.begin(); it != numbers.end(); ++it, ++expected)
+    check( *it == expected, "Wrong iteration order" );
+
+  expected = 29;
+  for (ContainerType::reverse_iterator it = numbers.rbegin(); it != numbers.rend(); ++it, --expected)
+    check( *it == expected, "Wrong reverse iteration order" );
+
+  for (int i = 0; i < 30; ++i)
+    for (int j = 0; j < 30; ++j)
+      check( *(numbers.begin() + i + (j - i)) == j && (numbers.begin() + j) - (numbers.begin() + i) == j - i, "Wrong random access" );
+
+  numbers.erase( numbers.begin() + 5 );
+  numbers.erase( numbers.begin() + 10, numbers.begin() + 20 );
+  check( numbers.size() == 19 && numbers[4] == 4 && numbers[5] == 6 && numbers[9] == 10 && numbers[10] == 21 && numbers.back() == 29, "Wrong erase" );
+
+  ContainerType copy = numbers;
+  numbers.clear();
+  check( copy.size() == 19 && copy[10] == 21 && numbers.empty() && numbers.capacity() >= 30, "Wrong copy or clear" );
+
+  numbers.shrink_to_fit();
+  check( numbers.capacity() == 0, "Wrong shrink_to_fit" );
+
+  numbers.reserve(9);
+  check( numbers.capacity() == 12 && numbers.begin() == numbers.end(), "Wrong reserve" );
+  for (int i = 0; i < 8; ++i)
+    numbers.push_back(i);
+  check( numbers.end() - numbers.begin() == 8 && *(--numbers.end()) == 7, "Wrong end after filling a reserved chunk" );
+}
+
+
+template<typename MeshT>
+void check(MeshT const & mesh, std::size_t vertices, std::size_t edges, std::size_t triangles, std::size_t tetrahedra)
+{
+  if ( viennagrid::vertices(mesh).size() != vertices ||
+       viennagrid::lines(mesh).size() != edges ||
+       viennagrid::triangles(mesh).size() != triangles ||
+       viennagrid::tetrahedra(mesh).size() != tetrahedra )
+  {
+    std::cerr << "Element count mismatch: " << viennagrid::vertices(mesh).size() << " " << viennagrid::lines(mesh).size() << " "
+              << viennagrid::triangles(mesh).size() << " " << viennagrid::tetrahedra(mesh).size() << " instead of "
+              << vertices << " " << edges << " " << triangles << " " << tetrahedra << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+template<typename MeshT>
+double total_volume(MeshT const & mesh)
+{
+  typedef typename viennagrid::result_of::const_cell_range<MeshT>::type     CellRangeType;
+  typedef typename viennagrid::result_of::iterator<CellRangeType>::type     CellIteratorType;
+
+  double result = 0;
+  CellRangeType cells(mesh);
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+    result += viennagrid::volume(*cit);
+  return result;
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  std::cout << "* Chunked vector" << std::endl;
+  test_container();
+
+  std::cout << "* Reading a tetrahedral mesh into a mesh with chunked element storage" << std::endl;
+  viennagrid::tetrahedral_3d_mesh reference_mesh;
+  viennagrid::tetrahedral_3d_segmentation reference_segmentation(reference_mesh);
+  viennagrid::io::netgen_reader reader;
+  reader(reference_mesh, reference_segmentation, "../examples/data/cube48.mesh");
+
+  ChunkedMeshType mesh;
+  ChunkedSegmentationType segmentation(mesh);
+  reader(mesh, segmentation, "../examples/data/cube48.mesh");
+
+  check(mesh, viennagrid::vertices(reference_mesh).size(), viennagrid::lines(reference_mesh).size(),
+              viennagrid::triangles(reference_mesh).size(), viennagrid::tetrahedra(reference_mesh).size());
+
+  check( std::fabs(total_volume(mesh) - total_volume(reference_mesh)) <= 1e-10, "Wrong volume" );
+
+  std::cout << "* Copying the mesh" << std::endl;
+  ChunkedMeshType mesh_copy;
+  mesh_copy = mesh;
+  check( std::fabs(total_volume(mesh_copy) - total_volume(reference_mesh)) <= 1e-10 &&
+         &viennagrid::vertices(viennagrid::cells(mesh_copy)[0])[0] != &viennagrid::vertices(viennagrid::cells(mesh)[0])[0],
+         "Wrong mesh copy" );
+
+  std::cout << "* Erasing a cell" << std::endl;
+  viennagrid::erase_element( mesh, viennagrid::cells(mesh).handle_at(0) );
+  viennagrid::erase_element( reference_mesh, viennagrid::cells(reference_mesh).handle_at(0) );
+  check(mesh, viennagrid::vertices(reference_mesh).size(), viennagrid::lines(reference_mesh).size(),
+              viennagrid::triangles(reference_mesh).size(), viennagrid::tetrahedra(reference_mesh).size());
+
+  check( std::fabs(total_volume(mesh) - total_volume(reference_mesh)) <= 1e-10, "Wrong volume after erase" );
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,218 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Queries of lazily built caches (coboundary, neighbor, boundary and interface information) on a shared const mesh.
+// If compiled with VIENNAGRID_WITH_OPENMP the queries are issued concurrently, otherwise sequentially.
+//
+
+#include <vector>
+#include <algorithm>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/coboundary_iteration.hpp"
+#include "viennagrid/mesh/neighbor_iteration.hpp"
+#include "viennagrid/algorithm/boundary.hpp"
+#include "viennagrid/algorithm/interface.hpp"
+
+typedef viennagrid::tetrahedral_3d_mesh                                             MeshType;
+typedef viennagrid::result_of::segmentation<MeshType>::type                        SegmentationType;
+typedef viennagrid::result_of::segment_handle<SegmentationType>::type              SegmentHandleType;
+typedef viennagrid::result_of::cell<MeshType>::type                                CellType;
+typedef viennagrid::result_of::facet<MeshType>::type                               FacetType;
+typedef viennagrid::result_of::vertex<MeshType>::type                              VertexType;
+
+
+/** @brief Collects per-element results of all cached queries */
+struct query_results
+{
+  std::vector<long> cells_on_vertex;
+  std::vector<long> cell_neighbors;
+  std::vector<long> facet_flags;
+
+  bool operator==(query_results const & other) const
+  {
+    return cells_on_vertex == other.cells_on_vertex && cell_neighbors == other.cell_neighbors && facet_flags == other.facet_flags;
+  }
+};
+
+template<typename ElementT, typename MeshT>
+std::vector<ElementT const *> element_pointers(MeshT const & mesh)
+{
+  typedef typename viennagrid::result_of::const_element_range<MeshT, ElementT>::type   RangeType;
+  typedef typename viennagrid::result_of::iterator<RangeType>::type                   IteratorType;
+
+  std::vector<ElementT const *> result;
+  RangeType elements(mesh);
+  for (IteratorType it = elements.begin(); it != elements.end(); ++it)
+    result.push_back( &*it );
+  return result;
+}
+
+void run_queries(MeshType const & mesh, SegmentHandleType const & seg0, SegmentHandleType const & seg1, query_results & results)
+{
+  std::vector<VertexType const *> vertices = element_pointers<VertexType>(mesh);
+  std::vector<CellType const *> cells = element_pointers<CellType>(mesh);
+  std::vector<FacetType const *> facets = element_pointers<FacetType>(mesh);
+
+  results.cells_on_vertex.resize( vertices.size() );
+  results.cell_neighbors.resize( cells.size() );
+  results.facet_flags.resize( facets.size() );
+
+  long vertex_count = static_cast<long>(vertices.size());
+  long cell_count = static_cast<long>(cells.size());
+  long facet_count = static_cast<long>(facets.size());
+
+#ifdef VIENNAGRID_WITH_OPENMP
+  #pragma omp parallel
+#endif
+  {
+#ifdef VIENNAGRID_WITH_OPENMP
+    #pragma omp for schedule(dynamic, 8)
+#endif
+    for (long i = 0; i < vertex_count; ++i)
+    {
+      typedef viennagrid::result_of::const_coboundary_range<MeshType, viennagrid::vertex_tag, viennagrid::tetrahedron_tag>::type CoboundaryRangeType;
+      CoboundaryRangeType coboundary_cells(mesh, *vertices[static_cast<std::size_t>(i)]);
+      results.cells_on_vertex[static_cast<std::size_t>(i)] = static_cast<long>(coboundary_cells.size());
+    }
+
+#ifdef VIENNAGRID_WITH_OPENMP
+    #pragma omp for schedule(dynamic, 8)
+#endif
+    for (long i = 0; i < cell_count; ++i)
+    {
+      typedef viennagrid::result_of::const_neighbor_range<MeshType, viennagrid::tetrahedron_tag, viennagrid::triangle_tag>::type NeighborRangeType;
+      NeighborRangeType neighbors(mesh, *cells[static_cast<std::size_t>(i)]);
+      results.cell_neighbors[static_cast<std::size_t>(i)] = static_cast<long>(neighbors.size());
+    }
+
+#ifdef VIENNAGRID_WITH_OPENMP
+    #pragma omp for schedule(dynamic, 8)
+#endif
+    for (long i = 0; i < facet_count; ++i)
+    {
+      FacetType const & facet = *facets[static_cast<std::size_t>(i)];
+      results.facet_flags[static_cast<std::size_t>(i)] = (viennagrid::is_boundary(mesh, facet) ? 1 : 0)
+                                                        + (viennagrid::is_boundary(seg0, facet) ? 2 : 0)
+                                                        + (viennagrid::is_interface(seg0, seg1, facet) ? 4 : 0);
+    }
+  }
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  std::string filename = "../examples/data/twocubes.mesh";
+  viennagrid::io::netgen_reader reader;
+
+  // reference: caches are built by sequential queries
+  MeshType reference_mesh;
+  SegmentationType reference_segmentation(reference_mesh);
+  reader(reference_mesh, reference_segmentation, filename);
+  if (reference_segmentation.size() < 2)
+  {
+    std::cerr << "Not enough segments in " << filename << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  query_results reference;
+  {
+    SegmentationType::iterator sit = reference_segmentation.begin();
+    SegmentHandleType const & seg0 = *sit; ++sit;
+    SegmentHandleType const & seg1 = *sit;
+
+    MeshType const & mesh = reference_mesh;
+    std::vector<VertexType const *> vertices = element_pointers<VertexType>(mesh);
+    std::vector<CellType const *> cells = element_pointers<CellType>(mesh);
+    std::vector<FacetType const *> facets = element_pointers<FacetType>(mesh);
+
+    typedef viennagrid::result_of::const_coboundary_range<MeshType, viennagrid::vertex_tag, viennagrid::tetrahedron_tag>::type CoboundaryRangeType;
+    typedef viennagrid::result_of::const_neighbor_range<MeshType, viennagrid::tetrahedron_tag, viennagrid::triangle_tag>::type NeighborRangeType;
+
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+      reference.cells_on_vertex.push_back( static_cast<long>(CoboundaryRangeType(mesh, *vertices[i]).size()) );
+    for (std::size_t i = 0; i < cells.size(); ++i)
+      reference.cell_neighbors.push_back( static_cast<long>(NeighborRangeType(mesh, *cells[i]).size()) );
+    for (std::size_t i = 0; i < facets.size(); ++i)
+      reference.facet_flags.push_back( (viennagrid::is_boundary(mesh, *facets[i]) ? 1 : 0)
+                                     + (viennagrid::is_boundary(seg0, *facets[i]) ? 2 : 0)
+                                     + (viennagrid::is_interface(seg0, seg1, *facets[i]) ? 4 : 0) );
+  }
+
+  if ( std::count(reference.facet_flags.begin(), reference.facet_flags.end(), 1) == 0 ||
+       std::count(reference.facet_flags.begin(), reference.facet_flags.end(), 6) == 0 )
+  {
+    std::cerr << "No boundary or interface facets found in " << filename << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "* Queries building the caches on demand" << std::endl;
+  {
+    MeshType mesh;
+    SegmentationType segmentation(mesh);
+    reader(mesh, segmentation, filename);
+
+    SegmentationType::iterator sit = segmentation.begin();
+    SegmentHandleType const & seg0 = *sit; ++sit;
+    SegmentHandleType const & seg1 = *sit;
+
+    query_results results;
+    run_queries(mesh, seg0, seg1, results);
+    if ( !(results == reference) )
+    {
+      std::cerr << "Results of queries differ from reference" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "* Queries on prepared caches" << std::endl;
+  {
+    MeshType mesh;
+    SegmentationType segmentation(mesh);
+    reader(mesh, segmentation, filename);
+
+    SegmentationType::iterator sit = segmentation.begin();
+    SegmentHandleType const & seg0 = *sit; ++sit;
+    SegmentHandleType const & seg1 = *sit;
+
+    viennagrid::prepare_coboundary<viennagrid::vertex_tag, viennagrid::tetrahedron_tag>(mesh);
+    viennagrid::prepare_neighbors<viennagrid::tetrahedron_tag, viennagrid::triangle_tag>(mesh);
+    viennagrid::prepare_boundary(mesh);
+    viennagrid::prepare_boundary(seg0);
+    viennagrid::prepare_interface(seg0, seg1);
+
+    query_results results;
+    run_queries(mesh, seg0, seg1, results);
+    if ( !(results == reference) )
+    {
+      std::cerr << "Results of queries differ from reference" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
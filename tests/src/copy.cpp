@@ -0,0 +1,143 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/mesh/mesh_operations.hpp"
+
+
+struct left_half_functor
+{
+  template<typename CellT>
+  bool operator()(CellT const & cell) const
+  {
+    typedef typename viennagrid::result_of::const_vertex_range<CellT>::type VertexRangeType;
+    typedef typename viennagrid::result_of::iterator<VertexRangeType>::type VertexIteratorType;
+
+    VertexRangeType vertices(cell);
+    for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+      if ( viennagrid::point(*vit)[0] > 1.0 )
+        return false;
+    return true;
+  }
+};
+
+template<typename MeshT>
+void check(MeshT const & mesh, std::size_t vertex_count, std::size_t cell_count)
+{
+  if ( viennagrid::vertices(mesh).size() != vertex_count || viennagrid::cells(mesh).size() != cell_count )
+  {
+    std::cerr << "Copied mesh has " << viennagrid::vertices(mesh).size() << " vertices and " << viennagrid::cells(mesh).size() << " cells, should be "
+              << vertex_count << " and " << cell_count << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  typedef viennagrid::triangular_2d_mesh                            MeshType;
+  typedef viennagrid::result_of::segmentation<MeshType>::type       SegmentationType;
+  typedef viennagrid::result_of::segment_handle<SegmentationType>::type SegmentHandleType;
+  typedef viennagrid::result_of::point<MeshType>::type              PointType;
+  typedef viennagrid::result_of::vertex_handle<MeshType>::type      VertexHandleType;
+  typedef viennagrid::result_of::cell_handle<MeshType>::type        CellHandleType;
+
+  // a strip of four triangles along the x-axis: [0,2] x [0,1]
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+  SegmentHandleType seg0 = segmentation.make_segment();
+  SegmentHandleType seg1 = segmentation.make_segment();
+
+  VertexHandleType v[6];
+  for (int i = 0; i < 3; ++i)
+  {
+    v[2*i]   = viennagrid::make_vertex( mesh, PointType(i, 0) );
+    v[2*i+1] = viennagrid::make_vertex( mesh, PointType(i, 1) );
+  }
+
+  for (int i = 0; i < 2; ++i)
+  {
+    SegmentHandleType & seg = (i == 0) ? seg0 : seg1;
+    CellHandleType c0 = viennagrid::make_triangle( mesh, v[2*i], v[2*i+2], v[2*i+1] );
+    CellHandleType c1 = viennagrid::make_triangle( mesh, v[2*i+2], v[2*i+3], v[2*i+1] );
+    viennagrid::add( seg, c0 );
+    viennagrid::add( seg, c1 );
+  }
+
+  std::cout << "* Copy of the full mesh" << std::endl;
+  MeshType full_copy;
+  viennagrid::copy( mesh, full_copy, viennagrid::true_functor() );
+  check(full_copy, 6, 4);
+
+  std::cout << "* Filtered copy including segmentation" << std::endl;
+  MeshType left_copy;
+  SegmentationType left_segmentation(left_copy);
+  viennagrid::copy( mesh, segmentation, left_copy, left_segmentation, left_half_functor() );
+  check(left_copy, 4, 2);
+  if ( left_segmentation.size() != 1 || viennagrid::cells(left_segmentation(seg0.id())).size() != 2 )
+  {
+    std::cerr << "Segmentation of the filtered copy is wrong" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "* Merging coinciding vertices of two meshes with a tolerance" << std::endl;
+  MeshType second;
+  VertexHandleType w0 = viennagrid::make_vertex( second, PointType(2, 0) );
+  VertexHandleType w1 = viennagrid::make_vertex( second, PointType(3, 0) );
+  VertexHandleType w2 = viennagrid::make_vertex( second, PointType(2, 1 + 1e-9) );
+  viennagrid::make_triangle( second, w0, w1, w2 );
+
+  MeshType merged;
+  viennagrid::vertex_copy_map<MeshType, MeshType> map_first(merged);
+  viennagrid::vertex_copy_map<MeshType, MeshType> map_second(merged);
+
+  typedef viennagrid::result_of::const_cell_range<MeshType>::type   ConstCellRangeType;
+  typedef viennagrid::result_of::iterator<ConstCellRangeType>::type ConstCellIteratorType;
+
+  ConstCellRangeType first_cells(mesh);
+  for (ConstCellIteratorType cit = first_cells.begin(); cit != first_cells.end(); ++cit)
+    map_first.copy_element(*cit, 1e-6);
+
+  ConstCellRangeType second_cells(second);
+  for (ConstCellIteratorType cit = second_cells.begin(); cit != second_cells.end(); ++cit)
+    map_second.copy_element(*cit, 1e-6);
+
+  check(merged, 7, 5);
+
+  std::cout << "* Merging with vertices created by another copy map after the first search" << std::endl;
+  MeshType interleaved;
+  viennagrid::vertex_copy_map<MeshType, MeshType> map_interleaved_first(interleaved);
+  viennagrid::vertex_copy_map<MeshType, MeshType> map_interleaved_second(interleaved);
+
+  map_interleaved_second( viennagrid::dereference_handle(second, w2), 1e-6 );
+  for (ConstCellIteratorType cit = first_cells.begin(); cit != first_cells.end(); ++cit)
+    map_interleaved_first.copy_element(*cit, 1e-6);
+  for (ConstCellIteratorType cit = second_cells.begin(); cit != second_cells.end(); ++cit)
+    map_interleaved_second.copy_element(*cit, 1e-6);
+
+  check(interleaved, 7, 5);
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
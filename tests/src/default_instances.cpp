@@ -0,0 +1,150 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Precompiled instances of the default configurations: the instantiated algorithms are called for each configuration.
+// Without ENABLE_PRECOMPILED_INSTANCES the instantiations are compiled here, otherwise they are taken from the library viennagrid_instances.
+//
+
+#include <cmath>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_instances.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+
+#include "check_common.hpp"
+
+#ifndef VIENNAGRID_WITH_PRECOMPILED_INSTANCES
+VIENNAGRID_ALL_DEFAULT_INSTANCES(template)
+#endif
+
+
+/** @brief Calls the precompiled algorithms for a mesh with two segments */
+template<typename MeshT, typename SegmentationT, typename HullMeshT>
+void check_instances(MeshT const & mesh, SegmentationT const & segmentation,
+                     double expected_volume, double expected_surface, std::size_t expected_facets)
+{
+  typedef typename viennagrid::result_of::const_vertex_range<MeshT>::type   VertexRangeType;
+  typedef typename viennagrid::result_of::iterator<VertexRangeType>::type   VertexIteratorType;
+  typedef typename viennagrid::result_of::const_facet_range<MeshT>::type    FacetRangeType;
+  typedef typename viennagrid::result_of::iterator<FacetRangeType>::type    FacetIteratorType;
+
+  check( std::fabs(viennagrid::volume(mesh) - expected_volume) < 1e-8 * expected_volume, "volume of the mesh" );
+  check( std::fabs(viennagrid::volume(segmentation(1)) + viennagrid::volume(segmentation(2)) - expected_volume) < 1e-8 * expected_volume, "volume of the segments" );
+  check( std::fabs(viennagrid::surface(mesh) - expected_surface) < 1e-8 * expected_surface, "surface of the mesh" );
+  check( viennagrid::surface(segmentation(1)) + viennagrid::surface(segmentation(2)) > expected_surface, "surface of the segments" );
+
+  HullMeshT hull;
+  viennagrid::extract_boundary(mesh, hull);
+  check( viennagrid::cells(hull).size() == expected_facets, "extracted boundary" );
+
+  viennagrid::prepare_boundary(mesh);
+
+  std::size_t boundary_facets = 0;
+  FacetRangeType facets(mesh);
+  for (FacetIteratorType fit = facets.begin(); fit != facets.end(); ++fit)
+    if (viennagrid::is_boundary(mesh, *fit))
+      ++boundary_facets;
+  check( boundary_facets == expected_facets, "boundary facets" );
+
+  std::size_t boundary_vertices = 0;
+  VertexRangeType vertices(mesh);
+  for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+    if (viennagrid::is_boundary(mesh, *vit))
+      ++boundary_vertices;
+  check( boundary_vertices == viennagrid::vertices(hull).size(), "boundary vertices" );
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  //
+  // triangular_2d: unit square consisting of two triangles
+  //
+  {
+    typedef viennagrid::triangular_2d_mesh                                    MeshType;
+    typedef viennagrid::result_of::point<MeshType>::type                     PointType;
+    typedef viennagrid::result_of::vertex_handle<MeshType>::type             VertexHandleType;
+
+    MeshType mesh;
+    viennagrid::triangular_2d_segmentation segmentation(mesh);
+
+    VertexHandleType v0 = viennagrid::make_vertex( mesh, PointType(0.0, 0.0) );
+    VertexHandleType v1 = viennagrid::make_vertex( mesh, PointType(1.0, 0.0) );
+    VertexHandleType v2 = viennagrid::make_vertex( mesh, PointType(0.0, 1.0) );
+    VertexHandleType v3 = viennagrid::make_vertex( mesh, PointType(1.0, 1.0) );
+
+    viennagrid::make_triangle( segmentation.get_make_segment(1), v0, v1, v2 );
+    viennagrid::make_triangle( segmentation.get_make_segment(2), v1, v3, v2 );
+
+    check_instances<MeshType, viennagrid::triangular_2d_segmentation, viennagrid::line_2d_mesh>(mesh, segmentation, 1.0, 4.0, 4);
+  }
+
+  //
+  // tetrahedral_3d: two cubes read from file
+  //
+  {
+    typedef viennagrid::tetrahedral_3d_mesh                                   MeshType;
+
+    MeshType mesh;
+    viennagrid::tetrahedral_3d_segmentation segmentation(mesh);
+
+    viennagrid::io::netgen_reader reader;
+    reader(mesh, segmentation, "../examples/data/twocubes.mesh");
+
+    viennagrid::triangular_3d_mesh hull;
+    viennagrid::extract_boundary(mesh, hull);
+
+    double hull_surface = 0;
+    for (std::size_t i = 0; i < viennagrid::cells(hull).size(); ++i)
+      hull_surface += viennagrid::volume( viennagrid::cells(hull)[i] );
+
+    check_instances<MeshType, viennagrid::tetrahedral_3d_segmentation, viennagrid::triangular_3d_mesh>(
+          mesh, segmentation, viennagrid::volume(segmentation(1)) + viennagrid::volume(segmentation(2)), hull_surface, viennagrid::cells(hull).size());
+  }
+
+  //
+  // hexahedral_3d: two unit cubes
+  //
+  {
+    typedef viennagrid::hexahedral_3d_mesh                                    MeshType;
+    typedef viennagrid::result_of::point<MeshType>::type                     PointType;
+    typedef viennagrid::result_of::vertex_handle<MeshType>::type             VertexHandleType;
+
+    MeshType mesh;
+    viennagrid::hexahedral_3d_segmentation segmentation(mesh);
+
+    VertexHandleType vh[12];
+    for (std::size_t i = 0; i < 12; ++i)
+      vh[i] = viennagrid::make_vertex( mesh, PointType( static_cast<double>(i % 3), static_cast<double>((i / 3) % 2), static_cast<double>(i / 6) ) );
+
+    viennagrid::make_hexahedron( segmentation.get_make_segment(1), vh[0], vh[1], vh[3], vh[4], vh[6], vh[7], vh[9],  vh[10] );
+    viennagrid::make_hexahedron( segmentation.get_make_segment(2), vh[1], vh[2], vh[4], vh[5], vh[7], vh[8], vh[10], vh[11] );
+
+    check_instances<MeshType, viennagrid::hexahedral_3d_segmentation, viennagrid::quadrilateral_3d_mesh>(mesh, segmentation, 2.0, 10.0, 10);
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Exchange of ghost values between the parts of a partitioned mesh using the in-process transport
+//
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/algorithm/halo_exchange.hpp"
+
+#include "check_common.hpp"
+
+typedef viennagrid::tetrahedral_3d_mesh                                   MeshType;
+typedef viennagrid::result_of::segmentation<MeshType>::type              SegmentationType;
+typedef viennagrid::submesh<MeshType>                                    SubmeshType;
+
+
+/** @brief Sets the values of owned elements to a function of the global ID and ghost values to -1, exchanges the ghost values and checks all values */
+template<bool for_vertices>
+void check_exchange(std::vector<SubmeshType> const & submeshes, std::vector<viennagrid::halo_descriptor> const & halos, std::size_t global_count)
+{
+  std::vector< std::vector<double> > values( submeshes.size() );
+  std::vector<std::size_t> owners(global_count, 0);
+
+  for (std::size_t part = 0; part < submeshes.size(); ++part)
+  {
+    SubmeshType const & sub = submeshes[part];
+    std::size_t count = for_vertices ? viennagrid::vertices(sub.mesh()).size() : viennagrid::cells(sub.mesh()).size();
+
+    values[part].resize(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      bool owned = for_vertices ? halos[part].is_owned_vertex(i) : halos[part].is_owned_cell(i);
+      std::size_t global_id = for_vertices ? sub.global_vertex_id(i) : sub.global_cell_id(i);
+
+      if (owned)
+      {
+        ++owners[global_id];
+        values[part][i] = 0.5 * static_cast<double>(global_id) + 1.0;
+      }
+      else
+        values[part][i] = -1.0;
+    }
+  }
+
+  for (std::size_t i = 0; i < global_count; ++i)
+    check( owners[i] == 1, "Element is not owned by exactly one part" );
+
+  viennagrid::local_transport transport;
+  if (for_vertices)
+    viennagrid::update_vertex_halos(halos, values, transport);
+  else
+    viennagrid::update_cell_halos(halos, values, transport);
+
+  check( transport.pending() == 0, "Messages have not been received" );
+
+  for (std::size_t part = 0; part < submeshes.size(); ++part)
+  {
+    SubmeshType const & sub = submeshes[part];
+    for (std::size_t i = 0; i < values[part].size(); ++i)
+    {
+      std::size_t global_id = for_vertices ? sub.global_vertex_id(i) : sub.global_cell_id(i);
+      check( values[part][i] == 0.5 * static_cast<double>(global_id) + 1.0, "Wrong value after the exchange" );
+    }
+  }
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, "../examples/data/cube3072.mesh");
+
+  std::size_t part_count = 4;
+  std::vector<std::size_t> cell_part = viennagrid::partition(mesh, part_count, viennagrid::graph_bisection_partitioning_tag());
+
+  for (std::size_t ghost_layers = 1; ghost_layers <= 2; ++ghost_layers)
+  {
+    std::cout << "* " << ghost_layers << " ghost layer(s)" << std::endl;
+
+    std::vector<SubmeshType> submeshes;
+    viennagrid::extract_submeshes(mesh, cell_part, part_count, ghost_layers, submeshes);
+
+    std::vector<viennagrid::halo_descriptor> halos;
+    viennagrid::make_halo_descriptors(submeshes, halos);
+
+    for (std::size_t part = 0; part < part_count; ++part)
+    {
+      std::vector<std::size_t> neighbors = halos[part].neighbors();
+      check( !neighbors.empty() && std::find(neighbors.begin(), neighbors.end(), part) == neighbors.end(), "Wrong neighbor parts" );
+    }
+
+    check_exchange<true>(submeshes, halos, viennagrid::vertices(mesh).size());
+    check_exchange<false>(submeshes, halos, viennagrid::cells(mesh).size());
+  }
+
+  {
+    // receiving without a message sent
+    viennagrid::local_transport transport;
+    std::vector<double> data;
+
+    bool thrown = false;
+    try
+    {
+      transport.receive(0, 1, data);
+    }
+    catch (std::runtime_error const &)
+    {
+      thrown = true;
+    }
+    check( thrown, "Receive without a message accepted" );
+
+    // a message with one value for a receive list of two ghost elements
+    viennagrid::halo_lists lists;
+    lists.part = 0;
+    lists.receive[1].push_back(0);
+    lists.receive[1].push_back(1);
+
+    std::vector<double> values(2, -1.0);
+    transport.send(1, 0, std::vector<double>(1, 1.0));
+
+    thrown = false;
+    try
+    {
+      viennagrid::halo_receive(lists, values, transport);
+    }
+    catch (std::runtime_error const &)
+    {
+      thrown = true;
+    }
+    check( thrown, "Message not matching the receive list accepted" );
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
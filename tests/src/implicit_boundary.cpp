@@ -0,0 +1,282 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Compares implicit boundary elements of thin meshes with the boundary elements stored in full meshes
+//
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <algorithm>
+
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/mesh/implicit_boundary.hpp"
+#include "viennagrid/algorithm/boundary.hpp"
+#include "viennagrid/algorithm/interface.hpp"
+#include "viennagrid/algorithm/quantity_transfer.hpp"
+
+#include "check_common.hpp"
+
+
+/** @brief Returns the sorted vertex IDs of an element */
+template <typename ElementT>
+std::vector<int> vertex_ids(ElementT const & element)
+{
+  std::vector<int> ids;
+  for (std::size_t i = 0; i < viennagrid::vertices(element).size(); ++i)
+    ids.push_back( viennagrid::vertices(element)[i].id().get() );
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+/** @brief Maps the sorted vertex IDs of all implicit boundary elements to their compact IDs */
+template <typename ImplicitElementsT>
+std::map<std::vector<int>, std::size_t> implicit_ids(ImplicitElementsT const & elements)
+{
+  std::map<std::vector<int>, std::size_t> result;
+  for (std::size_t id = 0; id < elements.size(); ++id)
+  {
+    std::vector<int> ids;
+    for (int j = 0; j < ImplicitElementsT::num_vertices; ++j)
+      ids.push_back( elements.vertex(id, j).id().get() );
+    std::sort(ids.begin(), ids.end());
+    result[ids] = id;
+  }
+  check( result.size() == elements.size(), "Implicit boundary elements are not distinct" );
+  return result;
+}
+
+
+/** @brief Compares the implicit boundary elements of a thin mesh or segment with the elements of a full mesh or segment */
+template <typename BoundaryTagT, typename ThinMeshOrSegmentT, typename FullMeshOrSegmentT>
+void check_boundary(ThinMeshOrSegmentT const & thin, FullMeshOrSegmentT const & full, std::string const & name)
+{
+  typedef typename viennagrid::result_of::const_element_range<FullMeshOrSegmentT, BoundaryTagT>::type   RangeType;
+  typedef typename viennagrid::result_of::iterator<RangeType>::type                                     IteratorType;
+  typedef typename viennagrid::result_of::const_cell_range<ThinMeshOrSegmentT>::type                    CellRangeType;
+  typedef typename viennagrid::result_of::iterator<CellRangeType>::type                                 CellIteratorType;
+  typedef viennagrid::implicit_boundary_elements<ThinMeshOrSegmentT, BoundaryTagT>                      ImplicitType;
+
+  std::cout << "* " << name << std::endl;
+
+  ImplicitType implicit(thin);
+  RangeType elements(full);
+  if (implicit.size() != elements.size())
+    std::cerr << implicit.size() << " implicit elements vs. " << elements.size() << " elements" << std::endl;
+  check( implicit.size() == elements.size(), name + ": wrong number of elements" );
+
+  std::map<std::vector<int>, std::size_t> ids = implicit_ids(implicit);
+  std::size_t boundary_count = 0;
+  for (IteratorType it = elements.begin(); it != elements.end(); ++it)
+  {
+    std::map<std::vector<int>, std::size_t>::const_iterator id_it = ids.find( vertex_ids(*it) );
+    check( id_it != ids.end(), name + ": element not found" );
+    check( implicit.is_boundary(id_it->second) == viennagrid::is_boundary(full, *it), name + ": wrong boundary flag" );
+    if (implicit.is_boundary(id_it->second))
+      ++boundary_count;
+  }
+  check( boundary_count > 0, name + ": no boundary elements" );
+
+  // the local numbering of the boundary elements of the cells is the same as in full meshes
+  CellRangeType cells(thin);
+  std::size_t cell_index = 0;
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit, ++cell_index)
+  {
+    typename viennagrid::result_of::const_element_range<typename viennagrid::result_of::cell<FullMeshOrSegmentT>::type, BoundaryTagT>::type
+        full_boundary = viennagrid::elements<BoundaryTagT>( viennagrid::cells(full)[cell_index] );
+
+    for (int i = 0; i < ImplicitType::num_per_cell; ++i)
+      check( ids[ vertex_ids(full_boundary[static_cast<std::size_t>(i)]) ] == implicit.id(*cit, i), name + ": wrong local numbering" );
+  }
+}
+
+
+/** @brief Creates a structured grid of n^dim quadrilaterals or hexahedra */
+template <typename MeshT>
+void make_grid(MeshT & mesh, int n)
+{
+  typedef typename viennagrid::result_of::cell<MeshT>::type            CellType;
+  typedef typename viennagrid::result_of::point<MeshT>::type           PointType;
+  typedef typename viennagrid::result_of::vertex_handle<MeshT>::type   VertexHandleType;
+
+  static const int dim = viennagrid::result_of::cell_tag<MeshT>::type::dim;
+  int nz = (dim == 3) ? n : 0;
+
+  std::vector<VertexHandleType> vertices;
+  for (int k = 0; k <= nz; ++k)
+    for (int j = 0; j <= n; ++j)
+      for (int i = 0; i <= n; ++i)
+      {
+        PointType p;
+        p[0] = i; p[1] = j;
+        if (dim == 3) p[2] = k;
+        vertices.push_back( viennagrid::make_vertex(mesh, p) );
+      }
+
+  for (int k = 0; k < std::max(nz, 1); ++k)
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+      {
+        std::vector<VertexHandleType> cell_vertices;
+        for (int c = 0; c < (1 << dim); ++c)
+        {
+          int ci = i + (c & 1), cj = j + ((c >> 1) & 1), ck = k + ((c >> 2) & 1);
+          cell_vertices.push_back( vertices[static_cast<std::size_t>( (ck * (n+1) + cj) * (n+1) + ci )] );
+        }
+        viennagrid::make_element<CellType>(mesh, cell_vertices.begin(), cell_vertices.end());
+      }
+}
+
+
+struct cell_id_accessor
+{
+  typedef double value_type;
+
+  template <typename CellT>
+  double operator()(CellT const & cell) const { return 1.0 + cell.id().get(); }
+};
+
+struct accept_all_filter
+{
+  template <typename ElementT>
+  bool operator()(ElementT const &) const { return true; }
+};
+
+template <typename ElementT>
+struct value_setter
+{
+  value_setter(std::vector<double> & values) : values_(values) {}
+
+  void operator()(ElementT const & element, double value) { viennagrid::make_field<ElementT>(values_)(element) = value; }
+
+  std::vector<double> & values_;
+};
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  viennagrid::io::netgen_reader reader;
+
+  {
+    viennagrid::thin_tetrahedral_3d_mesh thin_mesh;
+    viennagrid::thin_tetrahedral_3d_segmentation thin_segmentation(thin_mesh);
+    reader(thin_mesh, thin_segmentation, "../examples/data/twocubes.mesh");
+
+    viennagrid::tetrahedral_3d_mesh full_mesh;
+    viennagrid::tetrahedral_3d_segmentation full_segmentation(full_mesh);
+    reader(full_mesh, full_segmentation, "../examples/data/twocubes.mesh");
+
+    check_boundary<viennagrid::triangle_tag>(thin_mesh, full_mesh, "Facets of a tetrahedral mesh");
+    check_boundary<viennagrid::line_tag>(thin_mesh, full_mesh, "Edges of a tetrahedral mesh");
+
+    viennagrid::thin_tetrahedral_3d_segmentation::iterator thin_sit = thin_segmentation.begin();
+    viennagrid::thin_tetrahedral_3d_segment_handle const & thin_seg0 = *thin_sit; ++thin_sit;
+    viennagrid::thin_tetrahedral_3d_segment_handle const & thin_seg1 = *thin_sit;
+
+    viennagrid::tetrahedral_3d_segmentation::iterator full_sit = full_segmentation.begin();
+    viennagrid::tetrahedral_3d_segment_handle const & full_seg0 = *full_sit; ++full_sit;
+    viennagrid::tetrahedral_3d_segment_handle const & full_seg1 = *full_sit;
+
+    check_boundary<viennagrid::triangle_tag>(thin_seg0, full_seg0, "Facets of a segment");
+
+    std::cout << "* Interface facets" << std::endl;
+    {
+      typedef viennagrid::implicit_boundary_elements<viennagrid::thin_tetrahedral_3d_mesh, viennagrid::triangle_tag>  ImplicitType;
+      typedef viennagrid::result_of::const_triangle_range<viennagrid::tetrahedral_3d_mesh>::type                     TriangleRangeType;
+
+      ImplicitType facets(thin_mesh);
+      std::map<std::vector<int>, std::size_t> ids = implicit_ids(facets);
+
+      std::size_t interface_count = 0;
+      TriangleRangeType triangles(full_mesh);
+      for (viennagrid::result_of::iterator<TriangleRangeType>::type tit = triangles.begin(); tit != triangles.end(); ++tit)
+      {
+        bool implicit_interface = viennagrid::is_interface(facets, thin_seg0, thin_seg1, ids[vertex_ids(*tit)]);
+        check( implicit_interface == viennagrid::is_interface(full_seg0, full_seg1, *tit), "Wrong interface flag" );
+        if (implicit_interface)
+          ++interface_count;
+      }
+      check( interface_count > 0, "No interface facets" );
+    }
+
+    std::cout << "* Quantity transfer from cells to facets" << std::endl;
+    {
+      typedef viennagrid::implicit_boundary_elements<viennagrid::thin_tetrahedral_3d_mesh, viennagrid::triangle_tag>  ImplicitType;
+      typedef viennagrid::result_of::triangle<viennagrid::tetrahedral_3d_mesh>::type                                 TriangleType;
+      typedef viennagrid::result_of::const_triangle_range<viennagrid::tetrahedral_3d_mesh>::type                     TriangleRangeType;
+
+      ImplicitType facets(thin_mesh);
+      std::map<std::vector<int>, std::size_t> ids = implicit_ids(facets);
+
+      std::vector<double> implicit_values;
+      viennagrid::quantity_transfer(thin_mesh, facets, cell_id_accessor(), implicit_values, viennagrid::arithmetic_averager(), accept_all_filter());
+
+      std::vector<double> values;
+      value_setter<TriangleType> setter(values);
+      viennagrid::quantity_transfer<viennagrid::tetrahedron_tag, viennagrid::triangle_tag>(full_mesh, cell_id_accessor(), setter,
+                                                                                          viennagrid::arithmetic_averager(), accept_all_filter(), accept_all_filter());
+
+      TriangleRangeType triangles(full_mesh);
+      for (viennagrid::result_of::iterator<TriangleRangeType>::type tit = triangles.begin(); tit != triangles.end(); ++tit)
+        check( std::fabs(implicit_values[ ids[vertex_ids(*tit)] ] - viennagrid::make_field<TriangleType>(values)(*tit)) <= 1e-12, "Wrong transferred value" );
+    }
+  }
+
+  {
+    viennagrid::thin_triangular_2d_mesh thin_mesh;
+    viennagrid::thin_triangular_2d_segmentation thin_segmentation(thin_mesh);
+    reader(thin_mesh, thin_segmentation, "../examples/data/square32.mesh");
+
+    viennagrid::triangular_2d_mesh full_mesh;
+    viennagrid::triangular_2d_segmentation full_segmentation(full_mesh);
+    reader(full_mesh, full_segmentation, "../examples/data/square32.mesh");
+
+    check_boundary<viennagrid::line_tag>(thin_mesh, full_mesh, "Edges of a triangular mesh");
+  }
+
+  {
+    viennagrid::mesh<viennagrid::config::thin_quadrilateral_2d> thin_mesh;
+    make_grid(thin_mesh, 3);
+    viennagrid::quadrilateral_2d_mesh full_mesh;
+    make_grid(full_mesh, 3);
+
+    check_boundary<viennagrid::line_tag>(thin_mesh, full_mesh, "Edges of a quadrilateral mesh");
+  }
+
+  {
+    viennagrid::mesh<viennagrid::config::thin_hexahedral_3d> thin_mesh;
+    make_grid(thin_mesh, 3);
+    viennagrid::hexahedral_3d_mesh full_mesh;
+    make_grid(full_mesh, 3);
+
+    check_boundary<viennagrid::quadrilateral_tag>(thin_mesh, full_mesh, "Facets of a hexahedral mesh");
+    check_boundary<viennagrid::line_tag>(thin_mesh, full_mesh, "Edges of a hexahedral mesh");
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
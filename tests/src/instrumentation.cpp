@@ -0,0 +1,120 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Instrumentation counters and scoped timers: probes are hit by cache builds, key map operations and IO, reset and reported on demand.
+//
+
+#ifndef VIENNAGRID_WITH_INSTRUMENTATION
+  #define VIENNAGRID_WITH_INSTRUMENTATION
+#endif
+
+#include <sstream>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/coboundary_iteration.hpp"
+#include "viennagrid/mesh/neighbor_iteration.hpp"
+#include "viennagrid/algorithm/boundary.hpp"
+
+#include "check_common.hpp"
+
+typedef viennagrid::tetrahedral_3d_mesh                                             MeshType;
+typedef viennagrid::result_of::segmentation<MeshType>::type                        SegmentationType;
+typedef viennagrid::result_of::const_vertex_range<MeshType>::type                  VertexRangeType;
+typedef viennagrid::result_of::iterator<VertexRangeType>::type                     VertexIteratorType;
+typedef viennagrid::result_of::const_cell_range<MeshType>::type                    CellRangeType;
+typedef viennagrid::result_of::iterator<CellRangeType>::type                       CellIteratorType;
+
+
+/** @brief Returns the count of a probe */
+unsigned long count(std::string const & name)
+{
+  return viennagrid::instrumentation::get_probe(name).count;
+}
+
+/** @brief Runs coboundary, neighbor and boundary queries on all vertices and cells of a mesh */
+void query_caches(MeshType const & mesh)
+{
+  VertexRangeType vertices(mesh);
+  for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+  {
+    viennagrid::coboundary_elements<viennagrid::vertex_tag, viennagrid::tetrahedron_tag>(mesh, vit.handle());
+    viennagrid::is_boundary(mesh, *vit);
+  }
+
+  CellRangeType cells(mesh);
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+    viennagrid::neighbor_elements<viennagrid::tetrahedron_tag, viennagrid::triangle_tag>(mesh, cit.handle());
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  viennagrid::instrumentation::report_at_exit(false);
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, "../examples/data/twocubes.mesh");
+
+  check( count("netgen_reader: read") == 1, "reader phase timed" );
+  check( viennagrid::instrumentation::get_probe("netgen_reader: read").seconds >= 0.0, "reader time" );
+  check( count("hidden_key_map: insert") > 0, "key map insertions counted" );
+  check( count("view: unique insert into set") > 0, "segment view inserts counted" );
+
+
+  //
+  // caches are built once, later queries only hit the caches
+  //
+  viennagrid::instrumentation::reset();
+  check( count("hidden_key_map: insert") == 0, "counts reset" );
+
+  query_caches(mesh);
+  unsigned long coboundary_builds = count("coboundary: create") + count("coboundary: extend");
+  check( coboundary_builds > 0, "coboundary information built" );
+  check( count("neighbor: create") == 1, "neighbor information built once" );
+  check( count("boundary: detect") > 0, "boundary detected" );
+  unsigned long boundary_detections = count("boundary: detect");
+
+  query_caches(mesh);
+  check( count("coboundary: create") + count("coboundary: extend") == coboundary_builds, "coboundary information reused" );
+  check( count("neighbor: create") == 1, "neighbor information reused" );
+  check( count("boundary: detect") == boundary_detections, "boundary information reused" );
+
+
+  //
+  // the report lists all probes
+  //
+  std::stringstream ss;
+  viennagrid::instrumentation::report(ss);
+  check( ss.str().find("neighbor: create") != std::string::npos, "report contains timers" );
+  check( ss.str().find("hidden_key_map: find") != std::string::npos, "report contains counters" );
+
+  std::cout << ss.str();
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
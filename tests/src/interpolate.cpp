@@ -0,0 +1,294 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Interpolation of fields between non-matching meshes. Linear fields are reproduced exactly by barycentric and multilinear interpolation.
+//
+
+#include <vector>
+#include <cmath>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/algorithm/interpolate.hpp"
+
+
+/** @brief A linear function, reproduced exactly by all interpolations */
+template<typename PointT>
+double linear(PointT const & p)
+{
+  double value = 1.0;
+  for (std::size_t i = 0; i < p.size(); ++i)
+    value += static_cast<double>(i + 1) * p[i];
+  return value;
+}
+
+/** @brief The product of the coordinates, reproduced exactly by multilinear interpolation on axis aligned cells */
+template<typename PointT>
+double product(PointT const & p)
+{
+  double value = 1.0;
+  for (std::size_t i = 0; i < p.size(); ++i)
+    value *= p[i];
+  return value;
+}
+
+/** @brief Creates a structured simplex mesh of [-0.25, 1.25]^d with n intervals per direction as destination */
+void make_destination(viennagrid::triangular_2d_mesh & mesh, std::size_t n)
+{
+  typedef viennagrid::result_of::vertex_handle<viennagrid::triangular_2d_mesh>::type VertexHandleType;
+  std::vector<VertexHandleType> vertices;
+  for (std::size_t j = 0; j <= n; ++j)
+    for (std::size_t i = 0; i <= n; ++i)
+      vertices.push_back( viennagrid::make_vertex(mesh, viennagrid::result_of::point<viennagrid::triangular_2d_mesh>::type(-0.25 + 1.5*i/n, -0.25 + 1.5*j/n)) );
+  for (std::size_t j = 0; j < n; ++j)
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      std::size_t v = j*(n+1) + i;
+      viennagrid::make_triangle(mesh, vertices[v], vertices[v+1], vertices[v+n+2]);
+      viennagrid::make_triangle(mesh, vertices[v], vertices[v+n+2], vertices[v+n+1]);
+    }
+}
+
+void make_destination(viennagrid::tetrahedral_3d_mesh & mesh, std::size_t n)
+{
+  typedef viennagrid::result_of::vertex_handle<viennagrid::tetrahedral_3d_mesh>::type VertexHandleType;
+  static const std::size_t kuhn[6][4] = { {0,1,3,7}, {0,1,5,7}, {0,2,3,7}, {0,2,6,7}, {0,4,5,7}, {0,4,6,7} };
+
+  std::vector<VertexHandleType> vertices;
+  for (std::size_t k = 0; k <= n; ++k)
+    for (std::size_t j = 0; j <= n; ++j)
+      for (std::size_t i = 0; i <= n; ++i)
+        vertices.push_back( viennagrid::make_vertex(mesh, viennagrid::result_of::point<viennagrid::tetrahedral_3d_mesh>::type(-0.25 + 1.5*i/n, -0.25 + 1.5*j/n, -0.25 + 1.5*k/n)) );
+  for (std::size_t k = 0; k < n; ++k)
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        VertexHandleType corners[8];
+        for (std::size_t c = 0; c < 8; ++c)
+          corners[c] = vertices[ ((k + (c >> 2)) * (n+1) + j + ((c >> 1) & 1)) * (n+1) + i + (c & 1) ];
+        for (std::size_t t = 0; t < 6; ++t)
+          viennagrid::make_tetrahedron(mesh, corners[kuhn[t][0]], corners[kuhn[t][1]], corners[kuhn[t][2]], corners[kuhn[t][3]]);
+      }
+}
+
+/** @brief Creates a structured quadrilateral or hexahedral mesh of [0,1]^d with graded coordinates (i/n)^2. With 'perturb', the interior vertices are moved, resulting in non-affine cells. */
+template<typename MeshT>
+void make_source(MeshT & mesh, std::size_t n, bool perturb)
+{
+  typedef typename viennagrid::result_of::vertex_handle<MeshT>::type  VertexHandleType;
+  typedef typename viennagrid::result_of::cell<MeshT>::type           CellType;
+  typedef typename viennagrid::result_of::point<MeshT>::type          PointType;
+
+  std::size_t dim = PointType::dim;
+  std::size_t nz = (dim == 3) ? n : 0;
+
+  std::vector<VertexHandleType> vertices;
+  for (std::size_t k = 0; k <= nz; ++k)
+    for (std::size_t j = 0; j <= n; ++j)
+      for (std::size_t i = 0; i <= n; ++i)
+      {
+        std::size_t index[3] = {i, j, k};
+        PointType p;
+        bool interior = true;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+          p[d] = double(index[d] * index[d]) / double(n * n);
+          interior = interior && index[d] > 0 && index[d] < n;
+        }
+        if (perturb && interior)
+          for (std::size_t d = 0; d < dim; ++d)
+            p[d] += 0.02 * std::sin( double(3*i + 5*j + 7*k + d) );
+        vertices.push_back( viennagrid::make_vertex(mesh, p) );
+      }
+
+  std::size_t corner_count = std::size_t(1) << dim;
+  for (std::size_t k = 0; k < std::max<std::size_t>(nz, 1); ++k)
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        VertexHandleType corners[8];
+        for (std::size_t c = 0; c < corner_count; ++c)
+          corners[c] = vertices[ ((k + (c >> 2)) * (n+1) + j + ((c >> 1) & 1)) * (n+1) + i + (c & 1) ];
+        viennagrid::make_element<CellType>(mesh, corners, corners + corner_count);
+      }
+}
+
+/** @brief Interpolates the function f from the source to the destination and checks the values inside and outside of the unit box */
+template<typename SourceMeshT, typename DestinationMeshT, typename FunctionT>
+void check_interpolation(SourceMeshT const & source, DestinationMeshT const & destination, FunctionT f)
+{
+  typedef typename viennagrid::result_of::vertex<SourceMeshT>::type                        SourceVertexType;
+  typedef typename viennagrid::result_of::const_vertex_range<SourceMeshT>::type            SourceVertexRangeType;
+  typedef typename viennagrid::result_of::iterator<SourceVertexRangeType>::type            SourceVertexIteratorType;
+  typedef typename viennagrid::result_of::vertex<DestinationMeshT>::type                   DestinationVertexType;
+  typedef typename viennagrid::result_of::const_vertex_range<DestinationMeshT>::type       DestinationVertexRangeType;
+  typedef typename viennagrid::result_of::iterator<DestinationVertexRangeType>::type       DestinationVertexIteratorType;
+
+  std::vector<double> source_values;
+  typename viennagrid::result_of::field<std::vector<double>, SourceVertexType>::type source_field(source_values);
+  SourceVertexRangeType source_vertices(source);
+  for (SourceVertexIteratorType vit = source_vertices.begin(); vit != source_vertices.end(); ++vit)
+    source_field(*vit) = f( viennagrid::point(*vit) );
+
+  std::vector<double> values;
+  typename viennagrid::result_of::field<std::vector<double>, DestinationVertexType>::type field(values);
+  DestinationVertexRangeType vertices(destination);
+  for (DestinationVertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+    field(*vit) = -42.0;
+
+  std::size_t outside = viennagrid::interpolate_field(source, source_field, destination, field);
+
+  double max_error = 0.0;
+  std::size_t expected_outside = 0;
+  for (DestinationVertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+  {
+    bool inside = true;
+    for (std::size_t i = 0; i < viennagrid::point(*vit).size(); ++i)
+      inside = inside && viennagrid::point(*vit)[i] > -1e-12 && viennagrid::point(*vit)[i] < 1.0 + 1e-12;
+
+    if (inside)
+      max_error = std::max(max_error, std::fabs(field(*vit) - f(viennagrid::point(*vit))));
+    else
+    {
+      ++expected_outside;
+      if (field(*vit) != -42.0)
+      {
+        std::cerr << "Value outside of the source modified at " << viennagrid::point(*vit) << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+  }
+
+  std::cout << "  " << vertices.size() - outside << " of " << vertices.size() << " vertices interpolated, max error " << max_error << std::endl;
+  if (outside != expected_outside)
+  {
+    std::cerr << "Wrong number of vertices outside: " << outside << " instead of " << expected_outside << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (max_error > 1e-10)
+  {
+    std::cerr << "Interpolated values differ from the exact values" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/** @brief Locates the centroid of each cell without hint and with the neighbor cell as hint */
+template<typename MeshT>
+void check_locator(MeshT const & mesh)
+{
+  typedef typename viennagrid::result_of::const_cell_range<MeshT>::type  CellRangeType;
+  typedef typename viennagrid::result_of::iterator<CellRangeType>::type  CellIteratorType;
+  typedef typename viennagrid::result_of::point<MeshT>::type             PointType;
+
+  viennagrid::point_locator locator(mesh);
+  std::size_t indices[8];
+  double weights[8];
+
+  CellRangeType cells(mesh);
+  std::size_t index = 0;
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit, ++index)
+  {
+    PointType c = viennagrid::point(viennagrid::vertices(*cit)[0]);
+    for (std::size_t i = 1; i < viennagrid::vertices(*cit).size(); ++i)
+      c += viennagrid::point(viennagrid::vertices(*cit)[i]);
+    c /= double(viennagrid::vertices(*cit).size());
+
+    std::size_t hint = (index + 1) % cells.size();
+    if ( locator.locate(c, viennagrid::point_locator::invalid_index(), indices, weights) != index || locator.locate(c, hint, indices, weights) != index )
+    {
+      std::cerr << "Centroid of cell " << index << " not located in the cell" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  std::cout << "  " << cells.size() << " cell centroids located" << std::endl;
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  std::string path = "../examples/data/";
+
+  {
+    std::cout << "Triangles" << std::endl;
+    viennagrid::triangular_2d_mesh source;
+    viennagrid::result_of::segmentation<viennagrid::triangular_2d_mesh>::type segmentation(source);
+    viennagrid::io::netgen_reader reader;
+    reader(source, segmentation, path + "square32.mesh");
+
+    viennagrid::triangular_2d_mesh destination;
+    make_destination(destination, 12);
+
+    check_locator(source);
+    check_interpolation(source, destination, linear<viennagrid::result_of::point<viennagrid::triangular_2d_mesh>::type>);
+  }
+
+  {
+    std::cout << "Tetrahedra" << std::endl;
+    viennagrid::tetrahedral_3d_mesh source;
+    viennagrid::result_of::segmentation<viennagrid::tetrahedral_3d_mesh>::type segmentation(source);
+    viennagrid::io::netgen_reader reader;
+    reader(source, segmentation, path + "cube384.mesh");
+
+    viennagrid::tetrahedral_3d_mesh destination;
+    make_destination(destination, 6);
+
+    check_locator(source);
+    check_interpolation(source, destination, linear<viennagrid::result_of::point<viennagrid::tetrahedral_3d_mesh>::type>);
+  }
+
+  {
+    std::cout << "Quadrilaterals" << std::endl;
+    typedef viennagrid::result_of::point<viennagrid::quadrilateral_2d_mesh>::type PointType;
+    viennagrid::quadrilateral_2d_mesh source, perturbed;
+    make_source(source, 5, false);
+    make_source(perturbed, 5, true);
+
+    viennagrid::triangular_2d_mesh destination;
+    make_destination(destination, 12);
+
+    check_locator(perturbed);
+    check_interpolation(source, destination, product<PointType>);
+    check_interpolation(perturbed, destination, linear<PointType>);
+  }
+
+  {
+    std::cout << "Hexahedra" << std::endl;
+    typedef viennagrid::result_of::point<viennagrid::hexahedral_3d_mesh>::type PointType;
+    viennagrid::hexahedral_3d_mesh source, perturbed;
+    make_source(source, 4, false);
+    make_source(perturbed, 4, true);
+
+    viennagrid::tetrahedral_3d_mesh destination;
+    make_destination(destination, 6);
+
+    check_locator(perturbed);
+    check_interpolation(source, destination, product<PointType>);
+    check_interpolation(perturbed, destination, linear<PointType>);
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Memory usage reports: consistency of the breakdown, growth of the caches on queries and release of the caches with shrink_caches().
+//
+
+#include <vector>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/memory_usage.hpp"
+#include "viennagrid/mesh/coboundary_iteration.hpp"
+#include "viennagrid/mesh/neighbor_iteration.hpp"
+#include "viennagrid/algorithm/boundary.hpp"
+#include "viennagrid/algorithm/interface.hpp"
+
+#include "check_common.hpp"
+
+typedef viennagrid::tetrahedral_3d_mesh                                             MeshType;
+typedef viennagrid::result_of::segmentation<MeshType>::type                        SegmentationType;
+typedef viennagrid::result_of::segment_handle<SegmentationType>::type              SegmentHandleType;
+typedef viennagrid::result_of::const_vertex_range<MeshType>::type                  VertexRangeType;
+typedef viennagrid::result_of::iterator<VertexRangeType>::type                     VertexIteratorType;
+typedef viennagrid::result_of::const_facet_range<MeshType>::type                   FacetRangeType;
+typedef viennagrid::result_of::iterator<FacetRangeType>::type                      FacetIteratorType;
+typedef viennagrid::result_of::const_cell_range<MeshType>::type                    CellRangeType;
+typedef viennagrid::result_of::iterator<CellRangeType>::type                       CellIteratorType;
+
+
+/** @brief Checks that the categories of a report add up to its total */
+void check_breakdown(viennagrid::memory_usage_report const & report)
+{
+  std::size_t sum = 0;
+  for (int category = 0; category < viennagrid::memory_category_count; ++category)
+    sum += report.bytes( static_cast<viennagrid::memory_usage_category>(category) );
+  check( sum == report.bytes(), "categories add up to the total" );
+}
+
+/** @brief Returns the number of coboundary cells of all vertices, number of neighbor cells of all cells and boundary facets */
+std::vector<std::size_t> query_caches(MeshType const & mesh)
+{
+  std::vector<std::size_t> result(3, 0);
+
+  VertexRangeType vertices(mesh);
+  for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+    result[0] += viennagrid::coboundary_elements<viennagrid::vertex_tag, viennagrid::tetrahedron_tag>(mesh, vit.handle()).size();
+
+  CellRangeType cells(mesh);
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+    result[1] += viennagrid::neighbor_elements<viennagrid::tetrahedron_tag, viennagrid::triangle_tag>(mesh, cit.handle()).size();
+
+  FacetRangeType facets(mesh);
+  for (FacetIteratorType fit = facets.begin(); fit != facets.end(); ++fit)
+    result[2] += viennagrid::is_boundary(mesh, *fit) ? 1 : 0;
+
+  return result;
+}
+
+/** @brief Returns the number of interface facets between two segments */
+std::size_t interface_facets(SegmentHandleType const & seg0, SegmentHandleType const & seg1, MeshType const & mesh)
+{
+  std::size_t result = 0;
+  FacetRangeType facets(mesh);
+  for (FacetIteratorType fit = facets.begin(); fit != facets.end(); ++fit)
+    result += viennagrid::is_interface(seg0, seg1, *fit) ? 1 : 0;
+  return result;
+}
+
+
+void test_mesh(MeshType & mesh)
+{
+  viennagrid::memory_usage_report report = viennagrid::memory_usage(mesh);
+  check_breakdown(report);
+
+  check( report.bytes(viennagrid::memory_elements, viennagrid::vertex_tag::name()) >= viennagrid::vertices(mesh).size() * sizeof(viennagrid::result_of::vertex<MeshType>::type), "vertex memory" );
+  check( report.bytes(viennagrid::memory_elements, viennagrid::tetrahedron_tag::name()) > 0, "tetrahedron memory" );
+  check( report.bytes(viennagrid::memory_boundary_handles, viennagrid::tetrahedron_tag::name()) > 0, "boundary handles of tetrahedra" );
+  check( report.bytes(viennagrid::memory_boundary_handles, viennagrid::vertex_tag::name()) == 0, "vertices have no boundary handles" );
+  check( report.bytes(viennagrid::memory_dedup_keys, viennagrid::triangle_tag::name()) > 0, "triangles are deduplicated" );
+  check( report.bytes(viennagrid::memory_dedup_keys, viennagrid::tetrahedron_tag::name()) == 0, "cells are not deduplicated" );
+  check( report.bytes(viennagrid::memory_segment_views) == 0, "a mesh has no views" );
+
+  std::size_t const coboundary_empty = report.bytes(viennagrid::memory_coboundary);
+  std::size_t const neighbor_empty = report.bytes(viennagrid::memory_neighbor);
+  std::size_t const boundary_empty = report.bytes(viennagrid::memory_boundary_flags);
+
+  std::vector<std::size_t> reference = query_caches(mesh);
+
+  viennagrid::memory_usage_report built = viennagrid::memory_usage(mesh);
+  check_breakdown(built);
+  check( built.bytes(viennagrid::memory_coboundary) > coboundary_empty + viennagrid::vertices(mesh).size(), "coboundary cache grows" );
+  check( built.bytes(viennagrid::memory_neighbor) > neighbor_empty + viennagrid::cells(mesh).size(), "neighbor cache grows" );
+  check( built.bytes(viennagrid::memory_boundary_flags) > boundary_empty, "boundary cache grows" );
+  check( built.bytes(viennagrid::memory_elements) == report.bytes(viennagrid::memory_elements), "queries do not change the elements" );
+
+  std::size_t const released = viennagrid::shrink_caches(mesh);
+  check( released > 0, "shrink_caches releases memory" );
+
+  viennagrid::memory_usage_report shrunk = viennagrid::memory_usage(mesh);
+  check( shrunk.bytes(viennagrid::memory_coboundary) == coboundary_empty, "coboundary cache released" );
+  check( shrunk.bytes(viennagrid::memory_neighbor) == neighbor_empty, "neighbor cache released" );
+  check( shrunk.bytes(viennagrid::memory_boundary_flags) == boundary_empty, "boundary cache released" );
+  check( built.bytes() - shrunk.bytes() == released, "released bytes match the report" );
+
+  check( query_caches(mesh) == reference, "caches are rebuilt after shrink_caches" );
+  check( viennagrid::memory_usage(mesh).bytes() == built.bytes(), "rebuilt caches have the same size" );
+
+  std::cout << built << std::endl;
+}
+
+
+void test_segmentation(MeshType & mesh, SegmentationType & segmentation)
+{
+  check( segmentation.size() == 2, "two segments" );
+  SegmentationType::iterator sit = segmentation.begin();
+  SegmentHandleType const & seg0 = *sit;
+  ++sit;
+  SegmentHandleType const & seg1 = *sit;
+
+  viennagrid::memory_usage_report report = viennagrid::memory_usage(segmentation);
+  check_breakdown(report);
+  check( report.bytes(viennagrid::memory_segment_views, viennagrid::tetrahedron_tag::name()) > 0, "segment views" );
+  check( report.bytes(viennagrid::memory_segment_mapping, viennagrid::tetrahedron_tag::name()) > 0, "segment mapping" );
+  check( report.bytes(viennagrid::memory_elements) == 0, "elements belong to the mesh" );
+
+  std::size_t const interface_empty = report.bytes(viennagrid::memory_interface_info);
+  std::size_t const reference = interface_facets(seg0, seg1, mesh);
+  check( reference > 0, "segments share an interface" );
+
+  viennagrid::memory_usage_report built = viennagrid::memory_usage(segmentation);
+  check( built.bytes(viennagrid::memory_interface_info) > interface_empty, "interface information grows" );
+  check( built.bytes(viennagrid::memory_boundary_flags) > report.bytes(viennagrid::memory_boundary_flags), "boundary information of the segments grows" );
+
+  check( viennagrid::shrink_caches(segmentation) > 0, "shrink_caches releases memory" );
+
+  viennagrid::memory_usage_report shrunk = viennagrid::memory_usage(segmentation);
+  check( shrunk.bytes(viennagrid::memory_interface_info) == interface_empty, "interface information released" );
+  check( shrunk.bytes() == report.bytes(), "segmentation back to the initial size" );
+
+  check( interface_facets(seg0, seg1, mesh) == reference, "interface rebuilt after shrink_caches" );
+
+  std::cout << built << std::endl;
+}
+
+
+void test_polygons()
+{
+  typedef viennagrid::polygonal_2d_mesh                                      PolygonMeshType;
+  typedef viennagrid::result_of::point<PolygonMeshType>::type                PointType;
+  typedef viennagrid::result_of::vertex_handle<PolygonMeshType>::type        VertexHandleType;
+  typedef viennagrid::result_of::element<PolygonMeshType, viennagrid::polygon_tag>::type PolygonType;
+
+  PolygonMeshType mesh;
+
+  std::vector<VertexHandleType> handles;
+  handles.push_back( viennagrid::make_vertex(mesh, PointType(0, 0)) );
+  handles.push_back( viennagrid::make_vertex(mesh, PointType(1, 0)) );
+  handles.push_back( viennagrid::make_vertex(mesh, PointType(2, 1)) );
+  handles.push_back( viennagrid::make_vertex(mesh, PointType(1, 2)) );
+  handles.push_back( viennagrid::make_vertex(mesh, PointType(0, 1)) );
+  viennagrid::make_element<PolygonType>( mesh, handles.begin(), handles.end() );
+
+  viennagrid::memory_usage_report report = viennagrid::memory_usage(mesh);
+  check_breakdown(report);
+
+  // the boundary handles of polygons are stored in std::vector
+  check( report.bytes(viennagrid::memory_boundary_handles, viennagrid::polygon_tag::name()) >= 10 * sizeof(VertexHandleType), "boundary handles of polygons" );
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, "../examples/data/twocubes.mesh");
+
+  test_mesh(mesh);
+  test_segmentation(mesh, segmentation);
+  test_polygons();
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Compares the cached neighbor ranges (vertex, edge and facet connectors) against a brute force computation on meshes and segments.
+//
+
+#include <vector>
+#include <set>
+#include <algorithm>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/neighbor_iteration.hpp"
+
+
+/** @brief Returns the IDs of all boundary elements of type BoundaryTagT of a cell */
+template<typename BoundaryTagT, typename CellT>
+std::vector<long> boundary_ids(CellT const & cell)
+{
+  typedef typename viennagrid::result_of::const_element_range<CellT, BoundaryTagT>::type   BoundaryRangeType;
+  typedef typename viennagrid::result_of::iterator<BoundaryRangeType>::type               BoundaryIteratorType;
+
+  std::vector<long> result;
+  BoundaryRangeType boundary_elements(cell);
+  for (BoundaryIteratorType it = boundary_elements.begin(); it != boundary_elements.end(); ++it)
+    result.push_back( it->id().get() );
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+/** @brief Checks the neighbors of all cells of a mesh or segment with the connector BoundaryTagT */
+template<typename BoundaryTagT, typename MeshOrSegmentT>
+void check_neighbors(MeshOrSegmentT & mesh_or_segment)
+{
+  typedef typename viennagrid::result_of::cell_tag<MeshOrSegmentT>::type                                CellTag;
+  typedef typename viennagrid::result_of::cell_range<MeshOrSegmentT>::type                              CellRangeType;
+  typedef typename viennagrid::result_of::iterator<CellRangeType>::type                                 CellIteratorType;
+  typedef typename viennagrid::result_of::neighbor_range<MeshOrSegmentT, CellTag, BoundaryTagT>::type   NeighborRangeType;
+  typedef typename viennagrid::result_of::iterator<NeighborRangeType>::type                             NeighborIteratorType;
+
+  CellRangeType cells(mesh_or_segment);
+
+  std::vector< std::vector<long> > cell_boundary_ids;
+  std::vector<long> cell_ids;
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+  {
+    cell_boundary_ids.push_back( boundary_ids<BoundaryTagT>(*cit) );
+    cell_ids.push_back( cit->id().get() );
+  }
+
+  std::size_t total = 0;
+  std::size_t i = 0;
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit, ++i)
+  {
+    std::set<long> expected;
+    for (std::size_t j = 0; j < cell_ids.size(); ++j)
+    {
+      if (j == i)
+        continue;
+
+      std::vector<long> shared;
+      std::set_intersection(cell_boundary_ids[i].begin(), cell_boundary_ids[i].end(),
+                            cell_boundary_ids[j].begin(), cell_boundary_ids[j].end(),
+                            std::back_inserter(shared));
+      if (!shared.empty())
+        expected.insert( cell_ids[j] );
+    }
+
+    std::vector<long> found;
+    NeighborRangeType neighbors(mesh_or_segment, cit.handle());
+    for (NeighborIteratorType nit = neighbors.begin(); nit != neighbors.end(); ++nit)
+      found.push_back( nit->id().get() );
+
+    // no duplicates and exactly the expected neighbors
+    std::sort(found.begin(), found.end());
+    if ( std::adjacent_find(found.begin(), found.end()) != found.end() ||
+         !std::equal(expected.begin(), expected.end(), found.begin()) || found.size() != expected.size() )
+    {
+      std::cerr << "Neighbors of cell " << cell_ids[i] << " with connector dimension " << BoundaryTagT::dim << " do not match" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    total += found.size();
+  }
+
+  std::cout << "  connector dimension " << BoundaryTagT::dim << ": " << total << " neighbor entries" << std::endl;
+}
+
+
+template<typename MeshT>
+void test(std::string const & infile)
+{
+  typedef typename viennagrid::result_of::segmentation<MeshT>::type          SegmentationType;
+  typedef typename viennagrid::result_of::segment_handle<SegmentationType>::type  SegmentHandleType;
+  typedef typename viennagrid::result_of::cell_tag<MeshT>::type              CellTag;
+
+  MeshT mesh;
+  SegmentationType segmentation(mesh);
+
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, infile);
+
+  std::cout << "Mesh " << infile << std::endl;
+  check_neighbors<viennagrid::vertex_tag>(mesh);
+  check_neighbors<viennagrid::line_tag>(mesh);
+  check_neighbors<typename CellTag::facet_tag>(mesh);
+
+  // neighbor information is rebuilt after the mesh has changed
+  viennagrid::prepare_neighbors<CellTag, viennagrid::vertex_tag>(mesh);
+  viennagrid::make_vertex(mesh);
+  check_neighbors<viennagrid::vertex_tag>(mesh);
+
+  for (typename SegmentationType::iterator sit = segmentation.begin(); sit != segmentation.end(); ++sit)
+  {
+    SegmentHandleType & segment = *sit;
+    std::cout << "Segment " << segment.id() << std::endl;
+    check_neighbors<viennagrid::vertex_tag>(segment);
+    check_neighbors<typename CellTag::facet_tag>(segment);
+  }
+}
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  std::string path = "../examples/data/";
+
+  test<viennagrid::triangular_2d_mesh>(path + "square32.mesh");
+  test<viennagrid::tetrahedral_3d_mesh>(path + "cube384.mesh");
+  test<viennagrid::tetrahedral_3d_mesh>(path + "twocubes.mesh");
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Compares the orientation of boundary elements stored as permutation indices with the orientation stored as full permutations
+//
+
+#include <iostream>
+#include <vector>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+
+#include "check_common.hpp"
+
+
+struct compact_tetrahedral_3d
+{
+  typedef viennagrid::config::result_of::full_mesh_config< viennagrid::tetrahedron_tag,
+                                                           viennagrid::config::point_type_3d,
+                                                           viennagrid::pointer_handle_tag,
+                                                           viennagrid::std_deque_tag,
+                                                           viennagrid::std_deque_tag,
+                                                           viennagrid::compact_orientation_handling_tag >::type type;
+};
+
+struct compact_hexahedral_3d
+{
+  typedef viennagrid::config::result_of::full_mesh_config< viennagrid::hexahedron_tag,
+                                                           viennagrid::config::point_type_3d,
+                                                           viennagrid::pointer_handle_tag,
+                                                           viennagrid::std_deque_tag,
+                                                           viennagrid::std_deque_tag,
+                                                           viennagrid::compact_orientation_handling_tag >::type type;
+};
+
+typedef viennagrid::mesh<compact_tetrahedral_3d>     CompactTetrahedralMeshType;
+typedef viennagrid::mesh<compact_hexahedral_3d>      CompactHexahedralMeshType;
+
+
+/** @brief Compares the local vertices of all boundary elements of all cells of two meshes with the same cells */
+template <typename BoundaryTagT, typename MeshT, typename ReferenceMeshT>
+void compare(MeshT & mesh, ReferenceMeshT & reference_mesh, std::string const & name, bool expect_reoriented = true)
+{
+  typedef typename viennagrid::result_of::cell_range<MeshT>::type                     CellRangeType;
+  typedef typename viennagrid::result_of::cell_range<ReferenceMeshT>::type            ReferenceCellRangeType;
+  typedef typename viennagrid::result_of::cell<MeshT>::type                                 CellType;
+  typedef typename viennagrid::result_of::cell<ReferenceMeshT>::type                        ReferenceCellType;
+  typedef typename viennagrid::result_of::element_range<CellType, BoundaryTagT>::type           BoundaryRangeType;
+  typedef typename viennagrid::result_of::element_range<ReferenceCellType, BoundaryTagT>::type  ReferenceBoundaryRangeType;
+
+  std::cout << "* " << name << std::endl;
+
+  CellRangeType cells(mesh);
+  ReferenceCellRangeType reference_cells(reference_mesh);
+  check( cells.size() == reference_cells.size(), name + ": different number of cells" );
+
+  std::size_t non_default_orientations = 0;
+  for (std::size_t i = 0; i < cells.size(); ++i)
+  {
+    BoundaryRangeType boundary = viennagrid::elements<BoundaryTagT>(cells[i]);
+    ReferenceBoundaryRangeType reference_boundary = viennagrid::elements<BoundaryTagT>(reference_cells[i]);
+
+    for (std::size_t j = 0; j < boundary.size(); ++j)
+    {
+      for (std::size_t k = 0; k < viennagrid::vertices(boundary[j]).size(); ++k)
+      {
+        int id = viennagrid::dereference_handle(mesh, viennagrid::local_vertex(cells[i], boundary.handle_at(j), k)).id().get();
+        int reference_id = viennagrid::dereference_handle(reference_mesh, viennagrid::local_vertex(reference_cells[i], reference_boundary.handle_at(j), k)).id().get();
+
+        check( id == reference_id, name + ": different local vertices" );
+
+        if (cells[i].global_to_local_orientation(boundary.handle_at(j), k) != k)
+          ++non_default_orientations;
+      }
+    }
+  }
+
+  check( !expect_reoriented || non_default_orientations > 0, name + ": only default orientations" );
+}
+
+
+/** @brief Creates a structured grid of n^3 hexahedra */
+template <typename MeshT>
+void make_grid(MeshT & mesh, int n)
+{
+  typedef typename viennagrid::result_of::cell<MeshT>::type            CellType;
+  typedef typename viennagrid::result_of::point<MeshT>::type           PointType;
+  typedef typename viennagrid::result_of::vertex_handle<MeshT>::type   VertexHandleType;
+
+  std::vector<VertexHandleType> vertices;
+  for (int k = 0; k <= n; ++k)
+    for (int j = 0; j <= n; ++j)
+      for (int i = 0; i <= n; ++i)
+        vertices.push_back( viennagrid::make_vertex(mesh, PointType(i, j, k)) );
+
+  for (int k = 0; k < n; ++k)
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+      {
+        std::vector<VertexHandleType> cell_vertices;
+        for (int c = 0; c < 8; ++c)
+          cell_vertices.push_back( vertices[static_cast<std::size_t>( ((k + (c >> 2)) * (n+1) + j + ((c >> 1) & 1)) * (n+1) + i + (c & 1) )] );
+        viennagrid::make_element<CellType>(mesh, cell_vertices.begin(), cell_vertices.end());
+      }
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  check( sizeof(viennagrid::result_of::cell<CompactTetrahedralMeshType>::type) < sizeof(viennagrid::tetrahedral_3d_cell),
+         "Compact orientations do not reduce the size of a tetrahedron" );
+
+  {
+    viennagrid::io::netgen_reader reader;
+
+    viennagrid::tetrahedral_3d_mesh reference_mesh;
+    viennagrid::tetrahedral_3d_segmentation reference_segmentation(reference_mesh);
+    reader(reference_mesh, reference_segmentation, "../examples/data/cube384.mesh");
+
+    CompactTetrahedralMeshType mesh;
+    viennagrid::result_of::segmentation<CompactTetrahedralMeshType>::type segmentation(mesh);
+    reader(mesh, segmentation, "../examples/data/cube384.mesh");
+
+    compare<viennagrid::triangle_tag>(mesh, reference_mesh, "Triangles of tetrahedra");
+    compare<viennagrid::line_tag>(mesh, reference_mesh, "Edges of tetrahedra");
+  }
+
+  {
+    viennagrid::hexahedral_3d_mesh reference_mesh;
+    make_grid(reference_mesh, 3);
+
+    CompactHexahedralMeshType mesh;
+    make_grid(mesh, 3);
+
+    compare<viennagrid::quadrilateral_tag>(mesh, reference_mesh, "Quadrilaterals of hexahedra", false);
+    compare<viennagrid::line_tag>(mesh, reference_mesh, "Edges of hexahedra", false);
+  }
+
+  {
+    // 0-1-3-2 is not a symmetry of the reference quadrilateral (it swaps the vertices of the edge 2-3 only)
+    unsigned int invalid_permutation[4] = {0, 1, 3, 2};
+    viennagrid::compact_element_orientation<viennagrid::quadrilateral_tag> orientation;
+
+    bool thrown = false;
+    try
+    {
+      orientation.setPermutation(invalid_permutation);
+    }
+    catch (std::runtime_error const &)
+    {
+      thrown = true;
+    }
+
+    check( thrown, "Invalid permutation accepted by compact orientation" );
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Partitioning of a mesh and extraction of the submeshes with ghost layers
+//
+
+#include <iostream>
+#include <vector>
+#include <set>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/algorithm/partition.hpp"
+
+#include "check_common.hpp"
+
+typedef viennagrid::tetrahedral_3d_mesh                                   MeshType;
+typedef viennagrid::result_of::segmentation<MeshType>::type              SegmentationType;
+typedef viennagrid::result_of::cell<MeshType>::type                      CellType;
+typedef viennagrid::result_of::vertex<MeshType>::type                    VertexType;
+typedef viennagrid::submesh<MeshType>                                    SubmeshType;
+
+
+/** @brief Returns the number of facets shared by cells of different parts */
+std::size_t cut_size(MeshType const & mesh, std::vector<std::size_t> const & cell_part)
+{
+  viennagrid::cell_graph graph = viennagrid::make_cell_graph(mesh);
+  viennagrid::result_of::const_cell_range<MeshType>::type cells(mesh);
+
+  std::size_t cut = 0;
+  for (std::size_t i = 0; i < graph.size(); ++i)
+    for (std::size_t j = graph.offsets[i]; j < graph.offsets[i+1]; ++j)
+      if (cell_part[ static_cast<std::size_t>(cells[i].id().get()) ] != cell_part[ static_cast<std::size_t>(cells[graph.adjacency[j]].id().get()) ])
+        ++cut;
+  return cut / 2;
+}
+
+void check_submeshes(MeshType const & mesh, std::vector<std::size_t> const & cell_part, std::size_t part_count, std::size_t ghost_layers)
+{
+  std::vector<SubmeshType> submeshes;
+  viennagrid::extract_submeshes(mesh, cell_part, part_count, ghost_layers, submeshes);
+
+  check( submeshes.size() == part_count, "Wrong number of submeshes" );
+
+  viennagrid::result_of::const_cell_range<MeshType>::type cells(mesh);
+  viennagrid::result_of::const_vertex_range<MeshType>::type vertices(mesh);
+
+  std::size_t owned_cells = 0;
+  for (std::size_t p = 0; p < part_count; ++p)
+  {
+    SubmeshType const & sub = submeshes[p];
+    viennagrid::result_of::const_cell_range<MeshType>::type sub_cells(sub.mesh());
+    viennagrid::result_of::const_vertex_range<MeshType>::type sub_vertices(sub.mesh());
+
+    owned_cells += sub.owned_cell_count();
+
+    // the ghost cells of the first layer are exactly the foreign cells sharing a vertex with an owned cell
+    std::set<std::size_t> owned_vertices;
+    std::size_t owned = 0;
+    for (std::size_t i = 0; i < sub_cells.size(); ++i)
+    {
+      std::size_t global_id = sub.global_cell_id(i);
+      check( sub.local_cell_id(global_id) == i && sub.cell_owner(i) == cell_part[global_id], "Inconsistent cell numbering" );
+
+      CellType const & global_cell = cells[global_id];
+      for (std::size_t j = 0; j < viennagrid::vertices(sub_cells[i]).size(); ++j)
+      {
+        std::size_t global_vertex = sub.global_vertex_id( static_cast<std::size_t>(viennagrid::vertices(sub_cells[i])[j].id().get()) );
+        check( global_vertex == static_cast<std::size_t>(viennagrid::vertices(global_cell)[j].id().get()), "Cell vertices do not match" );
+        if (!sub.is_ghost_cell(i))
+          owned_vertices.insert(global_vertex);
+      }
+      if (!sub.is_ghost_cell(i))
+        ++owned;
+    }
+    check( owned == sub.owned_cell_count(), "Wrong number of owned cells" );
+
+    std::size_t first_layer = 0;
+    for (std::size_t i = 0; i < cells.size(); ++i)
+    {
+      if (cell_part[i] == p)
+        continue;
+      bool touches = false;
+      for (std::size_t j = 0; j < viennagrid::vertices(cells[i]).size(); ++j)
+        touches = touches || owned_vertices.count( static_cast<std::size_t>(viennagrid::vertices(cells[i])[j].id().get()) ) > 0;
+      if (touches)
+      {
+        ++first_layer;
+        check( ghost_layers == 0 || sub.local_cell_id(i) != SubmeshType::invalid_id(), "Ghost cell is missing" );
+      }
+    }
+    check( ghost_layers != 0 || sub_cells.size() == owned, "Unexpected ghost cells" );
+    check( ghost_layers != 1 || sub_cells.size() == owned + first_layer, "Unexpected ghost cells" );
+
+    for (std::size_t i = 0; i < sub_vertices.size(); ++i)
+    {
+      VertexType const & global_vertex = vertices[ sub.global_vertex_id(i) ];
+      check( viennagrid::norm_2(viennagrid::point(sub_vertices[i]) - viennagrid::point(global_vertex)) == 0, "Vertex does not match" );
+    }
+
+    // the shared vertex lists of two parts describe the same vertices
+    for (std::map<std::size_t, std::vector<std::size_t> >::const_iterator it = sub.shared_vertices().begin(); it != sub.shared_vertices().end(); ++it)
+    {
+      SubmeshType const & other = submeshes[it->first];
+      std::vector<std::size_t> const & other_list = other.shared_vertices().find(p)->second;
+      check( other_list.size() == it->second.size(), "Shared vertex lists differ in size" );
+      for (std::size_t i = 0; i < it->second.size(); ++i)
+        check( sub.global_vertex_id(it->second[i]) == other.global_vertex_id(other_list[i]) &&
+               sub.vertex_owner(it->second[i]) == other.vertex_owner(other_list[i]),
+               "Shared vertex lists differ" );
+    }
+  }
+
+  check( owned_cells == cells.size(), "Not every cell is owned by exactly one part" );
+}
+
+template<typename StrategyTagT>
+void test(MeshType const & mesh, std::size_t part_count, StrategyTagT strategy, std::string const & name)
+{
+  std::cout << "* " << name << ", " << part_count << " parts" << std::endl;
+
+  std::vector<std::size_t> cell_part = viennagrid::partition(mesh, part_count, strategy);
+
+  std::vector<std::size_t> sizes(part_count, 0);
+  for (std::size_t i = 0; i < cell_part.size(); ++i)
+    ++sizes[cell_part[i]];
+  std::size_t smallest = *std::min_element(sizes.begin(), sizes.end());
+  std::size_t largest = *std::max_element(sizes.begin(), sizes.end());
+  check( largest - smallest <= 1, "Parts are not balanced" );
+
+  std::size_t cut = cut_size(mesh, cell_part);
+  std::size_t total = viennagrid::make_cell_graph(mesh).adjacency.size() / 2;
+  std::cout << "  cut facets: " << cut << " of " << total << std::endl;
+  check( cut * 4 <= total, "Cut too large" );
+
+  check_submeshes(mesh, cell_part, part_count, 0);
+  check_submeshes(mesh, cell_part, part_count, 1);
+  check_submeshes(mesh, cell_part, part_count, 2);
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, "../examples/data/cube3072.mesh");
+
+  test(mesh, 2, viennagrid::graph_bisection_partitioning_tag(), "Graph bisection");
+  test(mesh, 5, viennagrid::graph_bisection_partitioning_tag(), "Graph bisection");
+  test(mesh, 2, viennagrid::coordinate_bisection_partitioning_tag(), "Coordinate bisection");
+  test(mesh, 5, viennagrid::coordinate_bisection_partitioning_tag(), "Coordinate bisection");
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
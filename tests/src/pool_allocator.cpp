@@ -0,0 +1,133 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/storage/pool_allocator.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+
+
+struct pooled_tetrahedral_3d
+{
+  typedef viennagrid::config::result_of::full_mesh_config< viennagrid::tetrahedron_tag,
+                                                           viennagrid::config::point_type_3d,
+                                                           viennagrid::pointer_handle_tag,
+                                                           viennagrid::pool_allocated_tag<viennagrid::std_deque_tag>,
+                                                           viennagrid::pool_allocated_tag<viennagrid::std_deque_tag> >::type type;
+};
+
+typedef viennagrid::mesh<pooled_tetrahedral_3d>                                 PooledMeshType;
+typedef viennagrid::result_of::mesh_view_from_typelist<
+            PooledMeshType,
+            viennagrid::detail::result_of::key_typelist<
+              viennagrid::result_of::element_collection<PooledMeshType>::type::typemap
+            >::type,
+            viennagrid::pool_allocated_view_container_config
+        >::type                                                                   PooledViewType;
+typedef viennagrid::result_of::segmentation<PooledMeshType, PooledViewType>::type PooledSegmentationType;
+
+
+template<typename MeshT>
+void check(MeshT const & mesh, std::size_t vertices, std::size_t edges, std::size_t triangles, std::size_t tetrahedra)
+{
+  if ( viennagrid::vertices(mesh).size() != vertices ||
+       viennagrid::lines(mesh).size() != edges ||
+       viennagrid::triangles(mesh).size() != triangles ||
+       viennagrid::tetrahedra(mesh).size() != tetrahedra )
+  {
+    std::cerr << "Element count mismatch: " << viennagrid::vertices(mesh).size() << " " << viennagrid::lines(mesh).size() << " "
+              << viennagrid::triangles(mesh).size() << " " << viennagrid::tetrahedra(mesh).size() << " instead of "
+              << vertices << " " << edges << " " << triangles << " " << tetrahedra << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  std::cout << "* Pool allocated standard containers" << std::endl;
+  {
+    viennagrid::result_of::container<int, viennagrid::pool_allocated_tag<viennagrid::std_set_tag<> > >::type numbers;
+    viennagrid::result_of::container<double, viennagrid::pool_allocated_tag<viennagrid::std_vector_tag> >::type values;
+    for (int i = 0; i < 1000; ++i)
+    {
+      numbers.insert( (i * 37) % 1000 );
+      values.push_back(i);
+    }
+
+    if (numbers.size() != 1000 || *numbers.begin() != 0 || *numbers.rbegin() != 999 || values[999] != 999)
+    {
+      std::cerr << "Pool allocated containers hold wrong values" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    if (viennagrid::detail::pool_reserved_bytes() == 0)
+    {
+      std::cerr << "Pool allocated containers did not use the pools" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "* Reading a tetrahedral mesh into a pool allocated mesh" << std::endl;
+  viennagrid::tetrahedral_3d_mesh reference_mesh;
+  viennagrid::tetrahedral_3d_segmentation reference_segmentation(reference_mesh);
+  viennagrid::io::netgen_reader reader;
+  reader(reference_mesh, reference_segmentation, "../examples/data/cube48.mesh");
+
+  std::size_t vertex_count = viennagrid::vertices(reference_mesh).size();
+  std::size_t edge_count = viennagrid::lines(reference_mesh).size();
+  std::size_t triangle_count = viennagrid::triangles(reference_mesh).size();
+  std::size_t tetrahedron_count = viennagrid::tetrahedra(reference_mesh).size();
+
+  for (int run = 0; run < 2; ++run)
+  {
+    PooledMeshType mesh;
+    PooledSegmentationType segmentation(mesh);
+    reader(mesh, segmentation, "../examples/data/cube48.mesh");
+    check(mesh, vertex_count, edge_count, triangle_count, tetrahedron_count);
+
+    if (segmentation.size() != reference_segmentation.size())
+    {
+      std::cerr << "Wrong number of segments" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (PooledSegmentationType::iterator sit = segmentation.begin(); sit != segmentation.end(); ++sit)
+    {
+      if ( viennagrid::tetrahedra(*sit).size() != viennagrid::tetrahedra(reference_segmentation(sit->id())).size() ||
+           viennagrid::triangles(*sit).size() != viennagrid::triangles(reference_segmentation(sit->id())).size() )
+      {
+        std::cerr << "Wrong number of elements in segment " << sit->id() << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "* Clearing the mesh" << std::endl;
+    segmentation.clear();
+    mesh.clear();
+    check(mesh, 0, 0, 0, 0);
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
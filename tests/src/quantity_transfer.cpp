@@ -0,0 +1,214 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Compares the quantity transfer using streaming averagers with the transfer using container-based averagers
+//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/coboundary_iteration.hpp"
+#include "viennagrid/algorithm/quantity_transfer.hpp"
+#include "viennagrid/algorithm/volume.hpp"
+
+#include "check_common.hpp"
+
+typedef viennagrid::tetrahedral_3d_mesh                           MeshType;
+typedef viennagrid::result_of::segmentation<MeshType>::type      SegmentationType;
+typedef viennagrid::result_of::cell<MeshType>::type              CellType;
+typedef viennagrid::result_of::vertex<MeshType>::type            VertexType;
+
+
+/** @brief Container-based averager as used with the original interface */
+struct container_mean
+{
+  template <typename ContainerT>
+  double operator()(ContainerT const & values) const
+  {
+    double result = 0;
+    for (typename ContainerT::const_iterator it = values.begin(); it != values.end(); ++it)
+      result += *it;
+    return result / static_cast<double>(values.size());
+  }
+};
+
+/** @brief Container-based averager returning the largest value */
+struct container_max
+{
+  template <typename ContainerT>
+  double operator()(ContainerT const & values) const { return *std::max_element(values.begin(), values.end()); }
+};
+
+/** @brief Stores transferred values and counts the number of calls */
+template <typename ElementT>
+struct value_setter
+{
+  value_setter(std::vector<double> & values, std::vector<int> & calls) : values_(values), calls_(calls) {}
+
+  void operator()(ElementT const & element, double value)
+  {
+    viennagrid::make_field<ElementT>(values_)(element) = value;
+    ++viennagrid::make_field<ElementT>(calls_)(element);
+  }
+
+  std::vector<double> & values_;
+  std::vector<int> & calls_;
+};
+
+/** @brief Accepts elements with even ID */
+struct even_id_filter
+{
+  template <typename ElementT>
+  bool operator()(ElementT const & element) const { return element.id().get() % 2 == 0; }
+};
+
+struct accept_all_filter
+{
+  template <typename ElementT>
+  bool operator()(ElementT const &) const { return true; }
+};
+
+/** @brief Volume of a cell as weight */
+struct volume_accessor
+{
+  typedef double value_type;
+
+  double operator()(CellType const & cell) const { return viennagrid::volume(cell); }
+};
+
+
+void compare(std::vector<double> const & values, std::vector<int> const & calls,
+             std::vector<double> const & reference_values, std::vector<int> const & reference_calls,
+             std::string const & name)
+{
+  check( calls == reference_calls, name + ": different destination elements set" );
+
+  for (std::size_t i = 0; i < calls.size(); ++i)
+  {
+    check( calls[i] <= 1, name + ": destination element set twice" );
+
+    bool matches = !calls[i] || std::fabs(values[i] - reference_values[i]) <= 1e-12 * (1.0 + std::fabs(reference_values[i]));
+    if (!matches)
+      std::cerr << name << " of element " << i << ": " << values[i] << " vs. " << reference_values[i] << " (reference)" << std::endl;
+    check( matches, name + ": values differ" );
+  }
+}
+
+
+template <typename SourceT, typename DestinationT, typename AccessorT, typename AveragerT, typename ReferenceAveragerT, typename SourceFilterT, typename DestinationFilterT>
+void check_transfer(MeshType const & mesh, AccessorT const & accessor, AveragerT const & averager, ReferenceAveragerT const & reference_averager,
+                    SourceFilterT const & filter_src, DestinationFilterT const & filter_dest, std::string const & name)
+{
+  std::cout << "* " << name << std::endl;
+
+  std::vector<double> values;
+  std::vector<int> calls;
+  value_setter<DestinationT> setter(values, calls);
+  viennagrid::quantity_transfer<SourceT, DestinationT>(mesh, accessor, setter, averager, filter_src, filter_dest);
+
+  std::vector<double> reference_values;
+  std::vector<int> reference_calls;
+  value_setter<DestinationT> reference_setter(reference_values, reference_calls);
+  viennagrid::quantity_transfer<SourceT, DestinationT>(mesh, accessor, reference_setter, reference_averager, filter_src, filter_dest);
+
+  check( !calls.empty(), name + ": no values transferred" );
+
+  calls.resize( std::max(calls.size(), reference_calls.size()) );
+  reference_calls.resize( calls.size() );
+  compare(values, calls, reference_values, reference_calls, name);
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, "../examples/data/cube384.mesh");
+
+  // a quantity on cells and vertices
+  std::vector<double> cell_quantity;
+  std::vector<double> vertex_quantity;
+  {
+    viennagrid::result_of::field<std::vector<double>, CellType>::type cell_field(cell_quantity);
+    viennagrid::result_of::cell_range<MeshType>::type cells(mesh);
+    for (viennagrid::result_of::iterator< viennagrid::result_of::cell_range<MeshType>::type >::type cit = cells.begin(); cit != cells.end(); ++cit)
+      cell_field(*cit) = std::sin( 0.7 * static_cast<double>(cit->id().get()) );
+
+    viennagrid::result_of::field<std::vector<double>, VertexType>::type vertex_field(vertex_quantity);
+    viennagrid::result_of::vertex_range<MeshType>::type vertices(mesh);
+    for (viennagrid::result_of::iterator< viennagrid::result_of::vertex_range<MeshType>::type >::type vit = vertices.begin(); vit != vertices.end(); ++vit)
+      vertex_field(*vit) = std::cos( 1.3 * static_cast<double>(vit->id().get()) );
+  }
+
+  viennagrid::result_of::field<std::vector<double> const, CellType>::type cell_field(cell_quantity);
+  viennagrid::result_of::field<std::vector<double> const, VertexType>::type vertex_field(vertex_quantity);
+
+  // boundary direction
+  check_transfer<CellType, VertexType>(mesh, cell_field, viennagrid::arithmetic_averager(), container_mean(), accept_all_filter(), accept_all_filter(), "Cells to vertices, mean");
+  check_transfer<CellType, VertexType>(mesh, cell_field, viennagrid::arithmetic_averager(), container_mean(), even_id_filter(), even_id_filter(), "Cells to vertices, mean, filtered");
+  check_transfer<CellType, VertexType>(mesh, cell_field, viennagrid::max_averager(), container_max(), accept_all_filter(), accept_all_filter(), "Cells to vertices, max");
+  check_transfer<CellType, VertexType>(mesh, cell_field, viennagrid::min_averager(), viennagrid::min_averager(), accept_all_filter(), accept_all_filter(), "Cells to vertices, min");
+
+  // coboundary direction
+  check_transfer<VertexType, CellType>(mesh, vertex_field, viennagrid::arithmetic_averager(), container_mean(), accept_all_filter(), accept_all_filter(), "Vertices to cells, mean");
+  check_transfer<VertexType, CellType>(mesh, vertex_field, viennagrid::max_averager(), container_max(), accept_all_filter(), even_id_filter(), "Vertices to cells, max, filtered");
+
+  // weighted averaging
+  std::cout << "* Cells to vertices, volume weighted" << std::endl;
+  {
+    std::vector<double> values;
+    std::vector<int> calls;
+    value_setter<VertexType> setter(values, calls);
+    viennagrid::quantity_transfer<CellType, VertexType>(mesh, cell_field, setter,
+                                                        viennagrid::make_weighted_averager(volume_accessor()),
+                                                        accept_all_filter(), accept_all_filter());
+
+    typedef viennagrid::result_of::const_coboundary_range<MeshType, viennagrid::vertex_tag, viennagrid::tetrahedron_tag>::type  CellOnVertexRange;
+    typedef viennagrid::result_of::iterator<CellOnVertexRange>::type                                                           CellOnVertexIterator;
+
+    viennagrid::result_of::vertex_range<MeshType>::type vertices(mesh);
+    for (viennagrid::result_of::iterator< viennagrid::result_of::vertex_range<MeshType>::type >::type vit = vertices.begin(); vit != vertices.end(); ++vit)
+    {
+      double weighted_sum = 0;
+      double weight_sum = 0;
+      CellOnVertexRange cells_on_vertex(mesh, vit.handle());
+      for (CellOnVertexIterator cit = cells_on_vertex.begin(); cit != cells_on_vertex.end(); ++cit)
+      {
+        weighted_sum += viennagrid::volume(*cit) * cell_field(*cit);
+        weight_sum += viennagrid::volume(*cit);
+      }
+
+      double value = viennagrid::make_field<VertexType>(values)(*vit);
+      check( viennagrid::make_field<VertexType>(calls)(*vit) == 1 && std::fabs(value - weighted_sum / weight_sum) <= 1e-12, "Cells to vertices, volume weighted: values differ" );
+    }
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
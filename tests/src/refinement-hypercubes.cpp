@@ -0,0 +1,348 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Uniform, anisotropic and adaptive refinement of quadrilateral and hexahedral meshes: element counts, volume, hanging vertices and segmentations.
+//
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/algorithm/refine.hpp"
+#include "viennagrid/algorithm/hanging_vertices.hpp"
+#include "viennagrid/algorithm/volume.hpp"
+#include "viennagrid/algorithm/centroid.hpp"
+
+#include "check_common.hpp"
+
+
+/** @brief Creates a structured mesh of the unit square or cube with n intervals per direction. If a segmentation is given, cells with a centroid x < 0.5 are put into segment 0, all others into segment 1. */
+template<typename MeshT, typename SegmentationT>
+void make_grid(MeshT & mesh, SegmentationT * segmentation, std::size_t n)
+{
+  typedef typename viennagrid::result_of::point<MeshT>::type          PointType;
+  typedef typename viennagrid::result_of::vertex_handle<MeshT>::type  VertexHandleType;
+  typedef typename viennagrid::result_of::cell<MeshT>::type           CellType;
+  typedef typename viennagrid::result_of::cell_handle<MeshT>::type    CellHandleType;
+
+  std::size_t dim = PointType::dim;
+  std::size_t nz = (dim == 3) ? n : 0;
+
+  std::vector<VertexHandleType> vertices;
+  for (std::size_t k = 0; k <= nz; ++k)
+    for (std::size_t j = 0; j <= n; ++j)
+      for (std::size_t i = 0; i <= n; ++i)
+      {
+        PointType p;
+        p[0] = double(i) / double(n);
+        p[1] = double(j) / double(n);
+        if (dim == 3)
+          p[2] = double(k) / double(n);
+        vertices.push_back( viennagrid::make_vertex(mesh, p) );
+      }
+
+  std::size_t corner_count = (dim == 3) ? 8 : 4;
+  for (std::size_t k = 0; k < std::max<std::size_t>(nz, 1); ++k)
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        VertexHandleType corners[8];
+        for (std::size_t c = 0; c < corner_count; ++c)
+          corners[c] = vertices[ ((k + (c >> 2)) * (n+1) + j + ((c >> 1) & 1)) * (n+1) + i + (c & 1) ];
+        CellHandleType cell = viennagrid::make_element<CellType>(mesh, corners, corners + corner_count);
+        if (segmentation)
+          viennagrid::add( (*segmentation)[ (2*i < n) ? 0 : 1 ], cell );
+      }
+}
+
+template<typename MeshT>
+void make_grid(MeshT & mesh, std::size_t n)
+{
+  make_grid(mesh, static_cast<typename viennagrid::result_of::segmentation<MeshT>::type *>(NULL), n);
+}
+
+/** @brief Flags cells for refinement whose centroid is inside the box [lower, upper] in all directions */
+template<typename MeshT>
+struct centroid_in_box
+{
+  typedef typename viennagrid::result_of::cell<MeshT>::type CellType;
+
+  centroid_in_box(double lower, double upper) : lower_(lower), upper_(upper) {}
+
+  bool operator()(CellType const & cell) const
+  {
+    typename viennagrid::result_of::point<MeshT>::type c = viennagrid::centroid(cell);
+    for (std::size_t i = 0; i < c.size(); ++i)
+      if (c[i] < lower_ || c[i] > upper_)
+        return false;
+    return true;
+  }
+
+  double lower_, upper_;
+};
+
+template<typename MeshT, typename PredicateT>
+void flag_cells(MeshT const & mesh, std::vector<bool> & flags, PredicateT predicate)
+{
+  typedef typename viennagrid::result_of::const_cell_range<MeshT>::type   CellRangeType;
+  typedef typename viennagrid::result_of::iterator<CellRangeType>::type   CellIteratorType;
+
+  CellRangeType cells(mesh);
+  flags.assign(cells.size(), false);
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+    flags[ static_cast<std::size_t>(cit->id().get()) ] = predicate(*cit);
+}
+
+/** @brief Returns true if p is in the interior of the convex hull of the given vertices (a line or a planar quadrilateral) */
+template<typename MeshT, typename VertexRangeT>
+bool is_inside(MeshT const & mesh, typename viennagrid::result_of::point<MeshT>::type const & p, VertexRangeT vertices)
+{
+  typedef typename viennagrid::result_of::point<MeshT>::type PointType;
+
+  PointType lower = viennagrid::point(mesh, vertices[0]);
+  PointType upper = lower;
+  for (std::size_t i = 1; i < vertices.size(); ++i)
+    for (std::size_t j = 0; j < p.size(); ++j)
+    {
+      lower[j] = std::min(lower[j], viennagrid::point(mesh, vertices[i])[j]);
+      upper[j] = std::max(upper[j], viennagrid::point(mesh, vertices[i])[j]);
+    }
+
+  // axis aligned elements only: degenerate directions have to match, the others have to be strictly inside
+  for (std::size_t j = 0; j < p.size(); ++j)
+  {
+    if (upper[j] - lower[j] < 1e-12)
+    {
+      if (std::fabs(p[j] - lower[j]) > 1e-12)
+        return false;
+    }
+    else if (p[j] < lower[j] + 1e-12 || p[j] > upper[j] - 1e-12)
+      return false;
+  }
+  return true;
+}
+
+/** @brief Checks volume, duplicate vertices and that every vertex inside a line or facet is reported as hanging vertex at its center. Returns the number of hanging vertices. */
+template<typename MeshT>
+std::size_t check_mesh(MeshT const & mesh, double expected_volume)
+{
+  typedef typename viennagrid::result_of::point<MeshT>::type                   PointType;
+  typedef typename viennagrid::result_of::const_vertex_handle<MeshT>::type     ConstVertexHandleType;
+  typedef typename viennagrid::result_of::hanging_vertex<MeshT>::type          HangingVertexType;
+  typedef typename viennagrid::result_of::const_vertex_range<MeshT>::type      VertexRangeType;
+  typedef typename viennagrid::result_of::iterator<VertexRangeType>::type      VertexIteratorType;
+  typedef typename viennagrid::result_of::const_line_range<MeshT>::type        LineRangeType;
+  typedef typename viennagrid::result_of::iterator<LineRangeType>::type        LineIteratorType;
+  typedef typename viennagrid::result_of::const_facet_range<MeshT>::type       FacetRangeType;
+  typedef typename viennagrid::result_of::iterator<FacetRangeType>::type       FacetIteratorType;
+
+  check( std::fabs(viennagrid::volume(mesh) - expected_volume) < 1e-12, "volume is preserved" );
+
+  // no duplicate vertices
+  std::vector< std::vector<double> > points;
+  VertexRangeType vertices(mesh);
+  for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+  {
+    PointType const & p = viennagrid::point(mesh, *vit);
+    points.push_back( std::vector<double>(p.begin(), p.end()) );
+  }
+  std::sort(points.begin(), points.end());
+  check( std::adjacent_find(points.begin(), points.end()) == points.end(), "no duplicate vertices" );
+
+  std::vector<HangingVertexType> hanging;
+  viennagrid::hanging_vertices(mesh, hanging);
+
+  std::vector<ConstVertexHandleType> hanging_handles;
+  for (std::size_t i = 0; i < hanging.size(); ++i)
+  {
+    PointType mean = viennagrid::point(mesh, hanging[i].parents[0]);
+    for (std::size_t j = 1; j < hanging[i].parents.size(); ++j)
+      mean += viennagrid::point(mesh, hanging[i].parents[j]);
+    mean /= double(hanging[i].parents.size());
+    check( viennagrid::norm_2(mean - viennagrid::point(mesh, hanging[i].vertex)) < 1e-12, "hanging vertex at the mean of its parents" );
+    hanging_handles.push_back( hanging[i].vertex );
+  }
+  std::sort(hanging_handles.begin(), hanging_handles.end());
+  check( std::adjacent_find(hanging_handles.begin(), hanging_handles.end()) == hanging_handles.end(), "hanging vertices are reported once" );
+
+  // every vertex inside a line or facet must be reported (i.e. the mesh is 1-irregular)
+  std::size_t inside_count = 0;
+  LineRangeType lines(mesh);
+  for (LineIteratorType lit = lines.begin(); lit != lines.end(); ++lit)
+    for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+      if ( is_inside(mesh, viennagrid::point(mesh, *vit), viennagrid::vertices(*lit)) )
+      {
+        check( std::binary_search(hanging_handles.begin(), hanging_handles.end(), vit.handle()), "vertex inside a line is a hanging vertex" );
+        ++inside_count;
+      }
+
+  if (PointType::dim == 3)
+  {
+    FacetRangeType facets(mesh);
+    for (FacetIteratorType fit = facets.begin(); fit != facets.end(); ++fit)
+      for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+        if ( is_inside(mesh, viennagrid::point(mesh, *vit), viennagrid::vertices(*fit)) )
+        {
+          check( std::binary_search(hanging_handles.begin(), hanging_handles.end(), vit.handle()), "vertex inside a facet is a hanging vertex" );
+          ++inside_count;
+        }
+  }
+  check( inside_count == hanging.size(), "all hanging vertices are inside a line or facet" );
+
+  return hanging.size();
+}
+
+
+template<typename MeshT>
+void test(std::size_t n)
+{
+  typedef typename viennagrid::result_of::cell<MeshT>::type          CellType;
+  typedef typename viennagrid::result_of::line<MeshT>::type          LineType;
+  typedef typename viennagrid::result_of::segmentation<MeshT>::type  SegmentationType;
+
+  std::size_t dim = viennagrid::result_of::point<MeshT>::type::dim;
+  std::size_t cells_per_cell = (dim == 3) ? 8 : 4;
+
+  MeshT mesh;
+  make_grid(mesh, n);
+  std::size_t cell_count = viennagrid::cells(mesh).size();
+  std::size_t vertex_count = viennagrid::vertices(mesh).size();
+
+  //
+  // Uniform refinement, twice
+  //
+  {
+    MeshT refined, refined2;
+    viennagrid::cell_refine_uniformly(mesh, refined);
+    check( viennagrid::cells(refined).size() == cells_per_cell * cell_count, "uniform refinement: number of cells" );
+    check( viennagrid::vertices(refined).size() == std::size_t(std::pow(double(2*n+1), double(dim))), "uniform refinement: number of vertices" );
+    check( check_mesh(refined, 1.0) == 0, "uniform refinement is conforming" );
+
+    viennagrid::cell_refine_uniformly(refined, refined2);
+    check( viennagrid::vertices(refined2).size() == std::size_t(std::pow(double(4*n+1), double(dim))), "second uniform refinement: number of vertices" );
+    check( check_mesh(refined2, 1.0) == 0, "second uniform refinement is conforming" );
+    std::cout << "  uniform: " << viennagrid::cells(refined2).size() << " cells" << std::endl;
+  }
+
+  //
+  // Anisotropic refinement: all edges in x-direction
+  //
+  {
+    std::vector<bool> edge_flags( static_cast<std::size_t>(viennagrid::id_upper_bound<LineType>(mesh).get()) );
+    typename viennagrid::result_of::field<std::vector<bool>, LineType>::type edge_flag_field(edge_flags);
+    typedef typename viennagrid::result_of::const_line_range<MeshT>::type  LineRangeType;
+    LineRangeType lines(mesh);
+    std::size_t x_edges = 0;
+    for (typename viennagrid::result_of::iterator<LineRangeType>::type lit = lines.begin(); lit != lines.end(); ++lit)
+      if ( std::fabs(viennagrid::point(viennagrid::vertices(*lit)[0])[0] - viennagrid::point(viennagrid::vertices(*lit)[1])[0]) > 0.0 )
+      {
+        edge_flag_field(*lit) = true;
+        ++x_edges;
+      }
+
+    MeshT refined;
+    viennagrid::refine<CellType>(mesh, refined, edge_flag_field);
+    check( viennagrid::cells(refined).size() == 2 * cell_count, "anisotropic refinement: number of cells" );
+    check( viennagrid::vertices(refined).size() == vertex_count + x_edges, "anisotropic refinement: number of vertices" );
+    check( check_mesh(refined, 1.0) == 0, "anisotropic refinement is conforming" );
+    std::cout << "  anisotropic: " << viennagrid::cells(refined).size() << " cells" << std::endl;
+  }
+
+  //
+  // Adaptive refinement of the center cell, then of one of its children next to a coarse cell
+  //
+  {
+    double h = 1.0 / double(n);
+    std::vector<bool> cell_flags;
+    flag_cells(mesh, cell_flags, centroid_in_box<MeshT>(0.5 - 0.5*h, 0.5 + 0.5*h));
+
+    MeshT refined;
+    viennagrid::cell_refine(mesh, refined, viennagrid::make_field<CellType>(cell_flags));
+    check( viennagrid::cells(refined).size() == cell_count - 1 + cells_per_cell, "adaptive refinement: number of cells" );
+    std::size_t hanging_count = check_mesh(refined, 1.0);
+    check( hanging_count == ((dim == 3) ? 12 + 6 : 4), "adaptive refinement: hanging vertices on the edges and facets of the refined cell" );
+    check( viennagrid::vertices(refined).size() == vertex_count + hanging_count + 1, "adaptive refinement: number of vertices" );
+
+    // the lower child touches the unrefined neighbors, refining it again forces the neighbors to be split
+    flag_cells(refined, cell_flags, centroid_in_box<MeshT>(0.5 - 0.5*h, 0.5 - 0.25*h + 1e-10));
+    check( std::count(cell_flags.begin(), cell_flags.end(), true) == 1, "one child is flagged" );
+
+    MeshT refined2;
+    viennagrid::cell_refine(refined, refined2, viennagrid::make_field<CellType>(cell_flags));
+    std::size_t hanging_count2 = check_mesh(refined2, 1.0);
+    check( viennagrid::cells(refined2).size() > viennagrid::cells(refined).size() - 1 + cells_per_cell, "neighbors of the refined child are split" );
+
+    std::cout << "  adaptive: " << viennagrid::cells(refined).size() << " cells, " << hanging_count << " hanging vertices; "
+              << viennagrid::cells(refined2).size() << " cells, " << hanging_count2 << " hanging vertices" << std::endl;
+
+    // uniform refinement of the adaptively refined mesh reuses the hanging vertices
+    MeshT refined3;
+    viennagrid::cell_refine_uniformly(refined2, refined3);
+    check( viennagrid::cells(refined3).size() == cells_per_cell * viennagrid::cells(refined2).size(), "uniform refinement with hanging vertices: number of cells" );
+    std::size_t hanging_count3 = check_mesh(refined3, 1.0);
+    if (dim == 2)
+      check( hanging_count3 == 2 * hanging_count2, "uniform refinement with hanging vertices: each hanging vertex is replaced by two" );
+  }
+
+  //
+  // Segmentation
+  //
+  {
+    MeshT mesh_in, mesh_out;
+    SegmentationType segmentation_in(mesh_in), segmentation_out(mesh_out);
+    make_grid(mesh_in, &segmentation_in, n);
+
+    double h = 1.0 / double(n);
+    std::vector<bool> cell_flags;
+    flag_cells(mesh_in, cell_flags, centroid_in_box<MeshT>(0.5 - 0.5*h, 0.5 + 0.5*h));
+
+    viennagrid::element_refine<CellType>(mesh_in, segmentation_in, mesh_out, segmentation_out, viennagrid::make_field<CellType>(cell_flags));
+    check_mesh(mesh_out, 1.0);
+
+    for (typename SegmentationType::iterator sit = segmentation_in.begin(); sit != segmentation_in.end(); ++sit)
+    {
+      std::size_t cells_in = viennagrid::cells(*sit).size();
+      std::size_t cells_out = viennagrid::cells(segmentation_out(sit->id())).size();
+      check( std::fabs(viennagrid::volume(*sit) - viennagrid::volume(segmentation_out(sit->id()))) < 1e-12, "segment volume is preserved" );
+      check( cells_out == cells_in || cells_out == cells_in - 1 + cells_per_cell, "segment cells" );
+      std::cout << "  segment " << sit->id() << ": " << cells_in << " -> " << cells_out << " cells" << std::endl;
+    }
+  }
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  std::cout << "Quadrilaterals" << std::endl;
+  test<viennagrid::quadrilateral_2d_mesh>(5);
+
+  std::cout << "Hexahedra" << std::endl;
+  test<viennagrid::hexahedral_3d_mesh>(3);
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Reordering of meshes along space-filling curves and by reverse Cuthill-McKee
+//
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/algorithm/reorder.hpp"
+
+#include "check_common.hpp"
+
+
+/** @brief Returns the sorted IDs of the vertices of each cell, indexed by the cell ID */
+template<typename MeshT>
+std::vector< std::vector<std::size_t> > cell_vertex_ids(MeshT const & mesh)
+{
+  typedef typename viennagrid::result_of::cell<MeshT>::type                           CellType;
+  typedef typename viennagrid::result_of::const_cell_range<MeshT>::type               CellRangeType;
+  typedef typename viennagrid::result_of::iterator<CellRangeType>::type               CellIteratorType;
+  typedef typename viennagrid::result_of::const_vertex_range<CellType>::type          VertexOnCellRangeType;
+  typedef typename viennagrid::result_of::iterator<VertexOnCellRangeType>::type       VertexOnCellIteratorType;
+
+  std::vector< std::vector<std::size_t> > result( static_cast<std::size_t>(viennagrid::id_upper_bound<CellType>(mesh).get()) );
+
+  CellRangeType cells(mesh);
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+  {
+    std::vector<std::size_t> & ids = result[ static_cast<std::size_t>((*cit).id().get()) ];
+    VertexOnCellRangeType vertices(*cit);
+    for (VertexOnCellIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+      ids.push_back( static_cast<std::size_t>((*vit).id().get()) );
+    std::sort(ids.begin(), ids.end());
+  }
+
+  return result;
+}
+
+/** @brief Returns the points of all vertices, indexed by the vertex ID */
+template<typename MeshT>
+std::vector<typename viennagrid::result_of::point<MeshT>::type> vertex_points(MeshT const & mesh)
+{
+  typedef typename viennagrid::result_of::const_vertex_range<MeshT>::type             VertexRangeType;
+  typedef typename viennagrid::result_of::iterator<VertexRangeType>::type             VertexIteratorType;
+
+  std::vector<typename viennagrid::result_of::point<MeshT>::type> result( static_cast<std::size_t>(viennagrid::id_upper_bound<viennagrid::vertex_tag>(mesh).get()) );
+
+  VertexRangeType vertices(mesh);
+  for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+    result[ static_cast<std::size_t>((*vit).id().get()) ] = viennagrid::point(*vit);
+
+  return result;
+}
+
+/** @brief Sum of the ID spans of the vertices of all cells, a measure for the locality of cell-vertex accesses */
+long cell_vertex_spread(std::vector< std::vector<std::size_t> > const & cell_vertices)
+{
+  long spread = 0;
+  for (std::size_t i = 0; i < cell_vertices.size(); ++i)
+    spread += static_cast<long>(cell_vertices[i].back() - cell_vertices[i].front());
+  return spread;
+}
+
+
+/** @brief Checks that the reordered mesh is the original mesh permuted by 'permutation' */
+template<typename MeshT>
+void check_permutation(MeshT const & mesh, viennagrid::mesh_permutation const & permutation,
+                       std::vector< std::vector<std::size_t> > const & old_cell_vertices,
+                       std::vector<typename viennagrid::result_of::point<MeshT>::type> old_points)
+{
+  std::vector< std::vector<std::size_t> > new_cell_vertices = cell_vertex_ids(mesh);
+  std::vector<typename viennagrid::result_of::point<MeshT>::type> new_points = vertex_points(mesh);
+
+  check( new_points.size() == viennagrid::vertices(mesh).size() && new_points.size() == permutation.vertices.size(), "Vertex IDs are not contiguous" );
+  check( new_cell_vertices.size() == viennagrid::cells(mesh).size() && new_cell_vertices.size() == permutation.cells.size(), "Cell IDs are not contiguous" );
+
+  viennagrid::permute(old_points, permutation.vertices);
+  for (std::size_t i = 0; i < new_points.size(); ++i)
+    check( viennagrid::norm_2(new_points[i] - old_points[i]) == 0, "Vertex does not match the permuted vertex" );
+
+  for (std::size_t i = 0; i < new_cell_vertices.size(); ++i)
+  {
+    std::vector<std::size_t> old_ids;
+    for (std::size_t j = 0; j < new_cell_vertices[i].size(); ++j)
+      old_ids.push_back( permutation.vertices[ new_cell_vertices[i][j] ] );
+    std::sort(old_ids.begin(), old_ids.end());
+
+    check( old_ids == old_cell_vertices[ permutation.cells[i] ], "Cell does not match the permuted cell" );
+  }
+}
+
+
+/** @brief Creates a triangulated n x n grid with vertices and cells in a scrambled order */
+template<typename MeshT>
+void make_scrambled_grid(MeshT & mesh, std::size_t n)
+{
+  typedef typename viennagrid::result_of::point<MeshT>::type           PointType;
+  typedef typename viennagrid::result_of::vertex_handle<MeshT>::type   VertexHandleType;
+
+  std::size_t vertex_count = (n+1) * (n+1);
+
+  // a fixed permutation, 7919 is prime and does not divide the number of vertices or cells
+  std::vector<VertexHandleType> vertices(vertex_count);
+  for (std::size_t k = 0; k < vertex_count; ++k)
+  {
+    std::size_t index = (k * 7919) % vertex_count;
+    vertices[index] = viennagrid::make_vertex( mesh, PointType(static_cast<double>(index % (n+1)), static_cast<double>(index / (n+1))) );
+  }
+
+  for (std::size_t k = 0; k < n*n; ++k)
+  {
+    std::size_t index = (k * 7919) % (n*n);
+    std::size_t i = index % n;
+    std::size_t j = index / n;
+
+    std::size_t v0 = j*(n+1) + i;
+    viennagrid::make_triangle( mesh, vertices[v0], vertices[v0+1], vertices[v0+n+2] );
+    viennagrid::make_triangle( mesh, vertices[v0], vertices[v0+n+2], vertices[v0+n+1] );
+  }
+}
+
+template<typename StrategyTagT>
+void test_scrambled_grid(StrategyTagT strategy, std::string const & name)
+{
+  std::cout << "* Scrambled grid, " << name << std::endl;
+
+  viennagrid::triangular_2d_mesh mesh;
+  make_scrambled_grid(mesh, 40);
+
+  std::vector< std::vector<std::size_t> > old_cell_vertices = cell_vertex_ids(mesh);
+  std::vector<viennagrid::result_of::point<viennagrid::triangular_2d_mesh>::type> old_points = vertex_points(mesh);
+  long old_spread = cell_vertex_spread(old_cell_vertices);
+
+  viennagrid::mesh_permutation permutation = viennagrid::reorder(mesh, strategy);
+  check_permutation(mesh, permutation, old_cell_vertices, old_points);
+
+  long new_spread = cell_vertex_spread( cell_vertex_ids(mesh) );
+  std::cout << "  spread of vertex IDs within cells: " << old_spread << " -> " << new_spread << std::endl;
+  check( new_spread * 10 <= old_spread, "Reordering did not improve the locality" );
+}
+
+template<typename StrategyTagT>
+void test_segmented_mesh(StrategyTagT strategy, std::string const & name)
+{
+  typedef viennagrid::tetrahedral_3d_mesh                                   MeshType;
+  typedef viennagrid::result_of::segmentation<MeshType>::type              SegmentationType;
+  typedef viennagrid::result_of::cell_range<MeshType>::type                CellRangeType;
+
+  std::cout << "* Segmented mesh, " << name << std::endl;
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, "../examples/data/twocubes.mesh");
+
+  segmentation.begin()->set_name("first");
+  std::size_t segment_count = segmentation.size();
+
+  std::vector< std::vector<std::size_t> > old_cell_vertices = cell_vertex_ids(mesh);
+  std::vector<viennagrid::result_of::point<MeshType>::type> old_points = vertex_points(mesh);
+
+  // segment of each cell by cell ID
+  std::vector<int> cell_segment( old_cell_vertices.size() );
+  CellRangeType cells(mesh);
+  for (std::size_t i = 0; i < cells.size(); ++i)
+    cell_segment[ static_cast<std::size_t>(cells[i].id().get()) ] = *viennagrid::segment_ids(segmentation, cells[i]).begin();
+
+  viennagrid::mesh_permutation permutation = viennagrid::reorder(mesh, segmentation, strategy);
+  check_permutation(mesh, permutation, old_cell_vertices, old_points);
+
+  check( segmentation.size() == segment_count && segmentation.begin()->name() == "first", "Segments are not preserved" );
+
+  viennagrid::permute(cell_segment, permutation.cells);
+  cells = CellRangeType(mesh);
+  std::size_t cells_in_segments = 0;
+  for (SegmentationType::iterator sit = segmentation.begin(); sit != segmentation.end(); ++sit)
+    cells_in_segments += viennagrid::cells(*sit).size();
+  check( cells_in_segments == cells.size(), "Cells are not assigned to segments" );
+
+  for (std::size_t i = 0; i < cells.size(); ++i)
+  {
+    check( cells[i].id().get() == static_cast<long>(i), "Cells are not stored in the order of their IDs" );
+    check( viennagrid::segment_ids(segmentation, cells[i]).size() == 1 && *viennagrid::segment_ids(segmentation, cells[i]).begin() == cell_segment[i], "Cell is not in its segment" );
+  }
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  test_scrambled_grid(viennagrid::hilbert_reordering_tag(), "Hilbert curve");
+  test_scrambled_grid(viennagrid::morton_reordering_tag(), "Morton curve");
+  test_scrambled_grid(viennagrid::reverse_cuthill_mckee_reordering_tag(), "reverse Cuthill-McKee");
+
+  test_segmented_mesh(viennagrid::hilbert_reordering_tag(), "Hilbert curve");
+  test_segmented_mesh(viennagrid::morton_reordering_tag(), "Morton curve");
+  test_segmented_mesh(viennagrid::reverse_cuthill_mckee_reordering_tag(), "reverse Cuthill-McKee");
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Bitset selections: comparison with element views, set operations, iteration order, segments and deleted elements.
+//
+
+#include <vector>
+#include <set>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/element/element_view.hpp"
+#include "viennagrid/mesh/selection.hpp"
+#include "viennagrid/mesh/element_deletion.hpp"
+#include "viennagrid/algorithm/boundary.hpp"
+#include "viennagrid/algorithm/centroid.hpp"
+
+#include "check_common.hpp"
+
+typedef viennagrid::tetrahedral_3d_mesh                                             MeshType;
+typedef viennagrid::result_of::segmentation<MeshType>::type                        SegmentationType;
+typedef viennagrid::result_of::segment_handle<SegmentationType>::type              SegmentHandleType;
+typedef viennagrid::result_of::cell<MeshType>::type                                CellType;
+typedef viennagrid::result_of::facet<MeshType>::type                               FacetType;
+typedef viennagrid::result_of::cell_range<MeshType>::type                          CellRangeType;
+typedef viennagrid::result_of::iterator<CellRangeType>::type                       CellIteratorType;
+typedef viennagrid::result_of::element_selection<MeshType, CellType>::type         CellSelectionType;
+
+
+/** @brief Selects cells by the x-coordinate of their centroid */
+struct centroid_below
+{
+  centroid_below(double x, std::size_t coordinate = 0) : x_(x), coordinate_(coordinate) {}
+
+  bool operator()(CellType const & cell) const { return viennagrid::centroid(cell)[coordinate_] < x_; }
+
+  double x_;
+  std::size_t coordinate_;
+};
+
+/** @brief Selects boundary facets */
+struct is_boundary_facet
+{
+  is_boundary_facet(MeshType const & mesh) : mesh_(&mesh) {}
+
+  bool operator()(FacetType const & facet) const { return viennagrid::is_boundary(*mesh_, facet); }
+
+  MeshType const * mesh_;
+};
+
+/** @brief Returns the IDs of the selected elements in the order of iteration */
+template<typename SelectionT>
+std::vector<long> selected_ids(SelectionT const & selection)
+{
+  std::vector<long> result;
+  for (typename SelectionT::iterator it = selection.begin(); it != selection.end(); ++it)
+  {
+    check( static_cast<std::size_t>(it->id().get()) == it.id(), "iterator ID matches element ID" );
+    check( &viennagrid::dereference_handle(selection.mesh(), it.handle()) == &*it, "iterator handle refers to the element" );
+    result.push_back( it->id().get() );
+  }
+  return result;
+}
+
+/** @brief Returns the IDs of all elements of a range (views, segments) for which a predicate holds, sorted */
+template<typename RangeT, typename PredicateT>
+std::vector<long> reference_ids(RangeT range, PredicateT predicate)
+{
+  std::set<long> ids;
+  for (typename viennagrid::result_of::iterator<RangeT>::type it = range.begin(); it != range.end(); ++it)
+    if (predicate(*it))
+      ids.insert( (*it).id().get() );
+  return std::vector<long>(ids.begin(), ids.end());
+}
+
+struct always_true
+{
+  template<typename ElementT>
+  bool operator()(ElementT const &) const { return true; }
+};
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, "../examples/data/twocubes.mesh");
+
+  CellRangeType cells(mesh);
+
+  //
+  // Selection by functor compared with element_view()
+  //
+  CellSelectionType left = viennagrid::make_selection<CellType>(mesh, centroid_below(0.5));
+  viennagrid::result_of::element_view<MeshType, CellType>::type left_view = viennagrid::element_view<CellType>(mesh, centroid_below(0.5));
+
+  check( left.size() == left_view.size(), "size matches element_view" );
+  check( selected_ids(left) == reference_ids(cells, centroid_below(0.5)), "selected cells match" );
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+    check( left.contains(*cit) == centroid_below(0.5)(*cit), "contains() matches the predicate" );
+  std::cout << "Selected " << left.size() << " of " << cells.size() << " cells" << std::endl;
+
+  //
+  // Set operations
+  //
+  CellSelectionType lower = viennagrid::make_selection<CellType>(mesh, centroid_below(0.5, 1));
+  CellSelectionType all = viennagrid::make_selection<CellType>(mesh);
+  check( all.size() == cells.size(), "selection of all cells" );
+
+  CellSelectionType both = left & lower;
+  CellSelectionType any = left | lower;
+  CellSelectionType left_only = left - lower;
+  for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+  {
+    bool l = centroid_below(0.5)(*cit);
+    bool b = centroid_below(0.5, 1)(*cit);
+    check( both.contains(*cit) == (l && b), "intersection" );
+    check( any.contains(*cit) == (l || b), "union" );
+    check( left_only.contains(*cit) == (l && !b), "difference" );
+  }
+  check( both.size() + left_only.size() == left.size(), "intersection and difference partition the selection" );
+  check( (all - left) == (all - left_only - both), "difference is associative with the partition" );
+  check( (left - all).empty(), "empty difference" );
+
+  //
+  // insert, erase, clear
+  //
+  CellSelectionType manual(mesh);
+  check( manual.empty() && manual.begin() == manual.end(), "empty selection" );
+  manual.insert(cells[3]);
+  manual.insert(cells[1]);
+  manual.insert(cells[3]);
+  check( manual.size() == 2, "insert is idempotent" );
+  check( selected_ids(manual)[0] == cells[1].id().get(), "iteration in ID order" );
+  manual.erase(cells[1]);
+  check( manual.size() == 1 && manual.contains(cells[3]) && !manual.contains(cells[1]), "erase" );
+  manual.insert(1000);
+  check( manual.contains(1000) && !manual.contains(999) && !manual.contains(100000), "IDs beyond the mesh" );
+  manual.clear();
+  check( manual.empty(), "clear" );
+
+  //
+  // Facets and segments
+  //
+  typedef viennagrid::result_of::element_selection<MeshType, FacetType>::type FacetSelectionType;
+  FacetSelectionType boundary_facets = viennagrid::make_selection<FacetType>(mesh, is_boundary_facet(mesh));
+  check( selected_ids(boundary_facets) == reference_ids(viennagrid::result_of::facet_range<MeshType>::type(mesh), is_boundary_facet(mesh)), "boundary facets" );
+  std::cout << "Selected " << boundary_facets.size() << " boundary facets" << std::endl;
+
+  for (SegmentationType::iterator sit = segmentation.begin(); sit != segmentation.end(); ++sit)
+  {
+    SegmentHandleType & segment = *sit;
+    viennagrid::result_of::element_selection<SegmentHandleType, CellType>::type segment_cells = viennagrid::make_selection<CellType>(segment);
+    check( selected_ids(segment_cells) == reference_ids(viennagrid::result_of::cell_range<SegmentHandleType>::type(segment), always_true()), "segment cells" );
+    std::cout << "Segment " << segment.id() << ": " << segment_cells.size() << " cells" << std::endl;
+  }
+
+  //
+  // After deleting elements, IDs no longer match the positions in the mesh
+  //
+  std::size_t all_count = all.size();
+  std::size_t erased_id = static_cast<std::size_t>( cells[0].id().get() );
+  viennagrid::erase_element(mesh, cells.handle_at(0));
+  check( all.contains(erased_id) && all.size() == all_count, "deleted elements stay selected" );
+  check( selected_ids(all) == reference_ids(CellRangeType(mesh), always_true()), "deleted elements are skipped by the iteration" );
+  check( !left.empty(), "non-empty selection" );
+  left.erase(0);
+  std::vector<long> after_deletion = selected_ids(left);
+  check( after_deletion == reference_ids(CellRangeType(mesh), centroid_below(0.5)), "selection after deletion" );
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,267 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Signed distance fields to the boundary of box-shaped meshes and segments, compared with the exact signed distance to the box.
+//
+
+#include <vector>
+#include <cmath>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/algorithm/signed_distance.hpp"
+#include "viennagrid/algorithm/distance.hpp"
+
+
+/** @brief Exact signed distance of a point to the boundary of an axis aligned box, negative inside */
+template<typename PointT>
+double box_signed_distance(PointT const & p, PointT const & lower, PointT const & upper)
+{
+  double outside = 0.0;
+  double inside = -1e300;
+  for (std::size_t i = 0; i < p.size(); ++i)
+  {
+    double d = std::max(lower[i] - p[i], p[i] - upper[i]);
+    outside += std::max(d, 0.0) * std::max(d, 0.0);
+    inside = std::max(inside, d);
+  }
+  return (inside > 0.0) ? std::sqrt(outside) : inside;
+}
+
+template<typename MeshOrSegmentT>
+void bounding_box(MeshOrSegmentT const & mesh_or_segment,
+                  typename viennagrid::result_of::point<MeshOrSegmentT>::type & lower,
+                  typename viennagrid::result_of::point<MeshOrSegmentT>::type & upper)
+{
+  typedef typename viennagrid::result_of::const_vertex_range<MeshOrSegmentT>::type  VertexRangeType;
+  typedef typename viennagrid::result_of::iterator<VertexRangeType>::type          VertexIteratorType;
+
+  VertexRangeType vertices(mesh_or_segment);
+  lower = upper = viennagrid::point(*vertices.begin());
+  for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+    for (std::size_t i = 0; i < lower.size(); ++i)
+    {
+      lower[i] = std::min(lower[i], viennagrid::point(*vit)[i]);
+      upper[i] = std::max(upper[i], viennagrid::point(*vit)[i]);
+    }
+}
+
+/** @brief Creates a structured simplex mesh of [-0.5, 1.5]^d with n intervals per direction as target */
+void make_target(viennagrid::triangular_2d_mesh & mesh, std::size_t n)
+{
+  typedef viennagrid::result_of::vertex_handle<viennagrid::triangular_2d_mesh>::type VertexHandleType;
+  std::vector<VertexHandleType> vertices;
+  for (std::size_t j = 0; j <= n; ++j)
+    for (std::size_t i = 0; i <= n; ++i)
+      vertices.push_back( viennagrid::make_vertex(mesh, viennagrid::result_of::point<viennagrid::triangular_2d_mesh>::type(-0.5 + 2.0*i/n, -0.5 + 2.0*j/n)) );
+  for (std::size_t j = 0; j < n; ++j)
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      std::size_t v = j*(n+1) + i;
+      viennagrid::make_triangle(mesh, vertices[v], vertices[v+1], vertices[v+n+2]);
+      viennagrid::make_triangle(mesh, vertices[v], vertices[v+n+2], vertices[v+n+1]);
+    }
+}
+
+void make_target(viennagrid::tetrahedral_3d_mesh & mesh, std::size_t n)
+{
+  typedef viennagrid::result_of::vertex_handle<viennagrid::tetrahedral_3d_mesh>::type VertexHandleType;
+  static const std::size_t kuhn[6][4] = { {0,1,3,7}, {0,1,5,7}, {0,2,3,7}, {0,2,6,7}, {0,4,5,7}, {0,4,6,7} };
+
+  std::vector<VertexHandleType> vertices;
+  for (std::size_t k = 0; k <= n; ++k)
+    for (std::size_t j = 0; j <= n; ++j)
+      for (std::size_t i = 0; i <= n; ++i)
+        vertices.push_back( viennagrid::make_vertex(mesh, viennagrid::result_of::point<viennagrid::tetrahedral_3d_mesh>::type(-0.5 + 2.0*i/n, -0.5 + 2.0*j/n, -0.5 + 2.0*k/n)) );
+  for (std::size_t k = 0; k < n; ++k)
+    for (std::size_t j = 0; j < n; ++j)
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        VertexHandleType corners[8];
+        for (std::size_t c = 0; c < 8; ++c)
+          corners[c] = vertices[ ((k + (c >> 2)) * (n+1) + j + ((c >> 1) & 1)) * (n+1) + i + (c & 1) ];
+        for (std::size_t t = 0; t < 6; ++t)
+          viennagrid::make_tetrahedron(mesh, corners[kuhn[t][0]], corners[kuhn[t][1]], corners[kuhn[t][2]], corners[kuhn[t][3]]);
+      }
+}
+
+/** @brief Computes the signed distance field of the source boundary on the target and compares it with the distance to the bounding box of the source */
+template<typename TargetMeshT, typename SourceT>
+void check_field(TargetMeshT const & target, SourceT const & source, double band)
+{
+  typedef typename viennagrid::result_of::vertex<TargetMeshT>::type              VertexType;
+  typedef typename viennagrid::result_of::point<TargetMeshT>::type               PointType;
+  typedef typename viennagrid::result_of::const_vertex_range<TargetMeshT>::type  VertexRangeType;
+  typedef typename viennagrid::result_of::iterator<VertexRangeType>::type       VertexIteratorType;
+
+  PointType lower, upper;
+  bounding_box(source, lower, upper);
+
+  std::vector<double> values;
+  viennagrid::signed_distance_field(target, source, viennagrid::make_field<VertexType>(values), band);
+
+  double max_error = 0.0;
+  std::size_t inside = 0;
+  VertexRangeType vertices(target);
+  for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+  {
+    double exact = box_signed_distance(viennagrid::point(*vit), lower, upper);
+    double value = values[static_cast<std::size_t>(vit->id().get())];
+    if (band > 0.0 && std::fabs(exact) > band)
+    {
+      if ( value != (exact < 0.0 ? -band : band) )
+      {
+        std::cerr << "Wrong value " << value << " outside the band at " << viennagrid::point(*vit) << ", exact: " << exact << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+    else
+      max_error = std::max(max_error, std::fabs(value - exact));
+
+    if (value < 0.0)
+      ++inside;
+  }
+
+  std::cout << "  band " << band << ": " << inside << " of " << vertices.size() << " vertices inside, max error " << max_error << std::endl;
+  if (max_error > 1e-10)
+  {
+    std::cerr << "Signed distance differs from the exact value" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+/** @brief Compares single queries with the unsigned distance of viennagrid::boundary_distance() */
+template<typename MeshT>
+void check_queries(MeshT const & source)
+{
+  typedef typename viennagrid::result_of::point<MeshT>::type PointType;
+
+  viennagrid::signed_distance_tree tree(source);
+  PointType lower, upper;
+  bounding_box(source, lower, upper);
+
+  for (std::size_t k = 0; k < 20; ++k)
+  {
+    PointType p = lower;
+    for (std::size_t i = 0; i < p.size(); ++i)
+      p[i] = -0.7 + 2.4 * std::fmod(0.618034 * static_cast<double>(k * (i + 3) + 1), 1.0);
+
+    double value = tree(p);
+    double unsigned_distance = viennagrid::boundary_distance(p, source);
+    if ( std::fabs(std::fabs(value) - unsigned_distance) > 1e-10 || std::fabs(value - box_signed_distance(p, lower, upper)) > 1e-10 )
+    {
+      std::cerr << "Query at " << p << " failed: " << value << " vs. " << unsigned_distance << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  std::cout << "  " << tree.size() << " boundary primitives, queries match boundary_distance()" << std::endl;
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  std::string path = "../examples/data/";
+
+  {
+    std::cout << "Triangles" << std::endl;
+    viennagrid::triangular_2d_mesh source;
+    viennagrid::result_of::segmentation<viennagrid::triangular_2d_mesh>::type segmentation(source);
+    viennagrid::io::netgen_reader reader;
+    reader(source, segmentation, path + "square32.mesh");
+
+    viennagrid::triangular_2d_mesh target;
+    make_target(target, 16);
+
+    check_queries(source);
+    check_field(target, source, 0.0);
+    check_field(target, source, 0.3);
+  }
+
+  {
+    std::cout << "Tetrahedra" << std::endl;
+    viennagrid::tetrahedral_3d_mesh source;
+    viennagrid::result_of::segmentation<viennagrid::tetrahedral_3d_mesh>::type segmentation(source);
+    viennagrid::io::netgen_reader reader;
+    reader(source, segmentation, path + "cube384.mesh");
+
+    viennagrid::tetrahedral_3d_mesh target;
+    make_target(target, 8);
+
+    check_queries(source);
+    check_field(target, source, 0.0);
+    check_field(target, source, 0.3);
+  }
+
+  {
+    std::cout << "Segments" << std::endl;
+    typedef viennagrid::result_of::segmentation<viennagrid::tetrahedral_3d_mesh>::type SegmentationType;
+    viennagrid::tetrahedral_3d_mesh source;
+    SegmentationType segmentation(source);
+    viennagrid::io::netgen_reader reader;
+    reader(source, segmentation, path + "twocubes.mesh");
+
+    viennagrid::tetrahedral_3d_mesh target;
+    make_target(target, 8);
+
+    for (SegmentationType::const_iterator sit = segmentation.begin(); sit != segmentation.end(); ++sit)
+    {
+      check_field(target, *sit, 0.0);
+      check_field(target, *sit, 0.3);
+    }
+  }
+
+  {
+    std::cout << "Hexahedra" << std::endl;
+    typedef viennagrid::hexahedral_3d_mesh MeshType;
+    typedef viennagrid::result_of::vertex_handle<MeshType>::type VertexHandleType;
+    typedef viennagrid::result_of::cell<MeshType>::type CellType;
+
+    MeshType source;
+    std::size_t n = 3;
+    std::vector<VertexHandleType> vertices;
+    for (std::size_t k = 0; k <= n; ++k)
+      for (std::size_t j = 0; j <= n; ++j)
+        for (std::size_t i = 0; i <= n; ++i)
+          vertices.push_back( viennagrid::make_vertex(source, viennagrid::result_of::point<MeshType>::type(double(i)/n, double(j)/n, double(k)/n)) );
+    for (std::size_t k = 0; k < n; ++k)
+      for (std::size_t j = 0; j < n; ++j)
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          VertexHandleType corners[8];
+          for (std::size_t c = 0; c < 8; ++c)
+            corners[c] = vertices[ ((k + (c >> 2)) * (n+1) + j + ((c >> 1) & 1)) * (n+1) + i + (c & 1) ];
+          viennagrid::make_element<CellType>(source, corners, corners + 8);
+        }
+
+    viennagrid::tetrahedral_3d_mesh target;
+    make_target(target, 8);
+
+    check_field(target, source, 0.0);
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
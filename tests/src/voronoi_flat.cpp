@@ -0,0 +1,275 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Compares the flat and CSR computation of Voronoi quantities with the computation using contribution accessors
+//
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <cmath>
+
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/algorithm/voronoi.hpp"
+#include "viennagrid/algorithm/volume.hpp"
+
+#include "check_common.hpp"
+
+
+bool close(double a, double b, double scale)
+{
+  return std::fabs(a - b) <= 1e-10 * scale;
+}
+
+
+template <typename ElementTag, typename MeshT, typename ReferenceT, typename ValuesT, typename CSRT>
+void compare(MeshT const & mesh_obj, ReferenceT const & reference, ValuesT const & flat, ValuesT const & csr_totals, CSRT const & csr, double scale, std::string const & name)
+{
+  typedef typename viennagrid::result_of::const_element_range<MeshT, ElementTag>::type   RangeType;
+  typedef typename viennagrid::result_of::iterator<RangeType>::type                      IteratorType;
+  typedef typename viennagrid::result_of::element<MeshT, ElementTag>::type               ElementType;
+
+  RangeType elements(mesh_obj);
+  for (IteratorType it = elements.begin(); it != elements.end(); ++it)
+  {
+    double reference_value = viennagrid::make_field<ElementType>(reference)(*it);
+    double flat_value = viennagrid::make_field<ElementType>(flat)(*it);
+    double csr_value = viennagrid::make_field<ElementType>(csr_totals)(*it);
+
+    double csr_sum = 0;
+    for (typename CSRT::const_iterator cit = csr.begin(*it); cit != csr.end(*it); ++cit)
+      csr_sum += cit->second;
+
+    bool matches = close(reference_value, flat_value, scale) && close(reference_value, csr_value, scale) && close(csr_value, csr_sum, scale);
+    if (!matches)
+      std::cerr << name << " of element " << (*it).id() << ": " << reference_value << " (reference) vs. "
+                << flat_value << " (flat) vs. " << csr_value << " (CSR) vs. " << csr_sum << " (CSR row)" << std::endl;
+    check( matches, "Mismatch of " + name );
+  }
+}
+
+
+template <typename CellTag, typename MeshT>
+void check_mesh(MeshT const & mesh_obj, std::string const & name)
+{
+  typedef typename viennagrid::result_of::const_handle<MeshT, CellTag>::type    ConstCellHandleType;
+  typedef typename viennagrid::result_of::voronoi_cell_contribution<ConstCellHandleType>::type   ContributionType;
+  typedef typename viennagrid::result_of::vertex<MeshT>::type                   VertexType;
+  typedef typename viennagrid::result_of::line<MeshT>::type                     EdgeType;
+
+  std::cout << "* " << name << std::endl;
+
+  std::deque<double> interface_areas;
+  std::deque<ContributionType> interface_contributions;
+  std::deque<double> vertex_box_volumes;
+  std::deque<ContributionType> vertex_box_volume_contributions;
+  std::deque<double> edge_box_volumes;
+  std::deque<ContributionType> edge_box_volume_contributions;
+
+  viennagrid::apply_voronoi<CellTag>(mesh_obj,
+                                     viennagrid::make_field<EdgeType>(interface_areas),
+                                     viennagrid::make_field<EdgeType>(interface_contributions),
+                                     viennagrid::make_field<VertexType>(vertex_box_volumes),
+                                     viennagrid::make_field<VertexType>(vertex_box_volume_contributions),
+                                     viennagrid::make_field<EdgeType>(edge_box_volumes),
+                                     viennagrid::make_field<EdgeType>(edge_box_volume_contributions));
+
+  std::vector<double> flat_interface_areas;
+  std::vector<double> flat_vertex_box_volumes;
+  std::vector<double> flat_edge_box_volumes;
+
+  viennagrid::apply_voronoi<CellTag>(mesh_obj,
+                                     viennagrid::make_field<EdgeType>(flat_interface_areas),
+                                     viennagrid::make_field<VertexType>(flat_vertex_box_volumes),
+                                     viennagrid::make_field<EdgeType>(flat_edge_box_volumes));
+
+  std::vector<double> csr_interface_areas;
+  std::vector<double> csr_vertex_box_volumes;
+  std::vector<double> csr_edge_box_volumes;
+  viennagrid::voronoi_contributions<ConstCellHandleType> contributions;
+
+  viennagrid::apply_voronoi<CellTag>(mesh_obj,
+                                     viennagrid::make_field<EdgeType>(csr_interface_areas),
+                                     viennagrid::make_field<VertexType>(csr_vertex_box_volumes),
+                                     viennagrid::make_field<EdgeType>(csr_edge_box_volumes),
+                                     contributions);
+
+  double mesh_volume = viennagrid::volume(mesh_obj);
+  compare<viennagrid::vertex_tag>(mesh_obj, vertex_box_volumes, flat_vertex_box_volumes, csr_vertex_box_volumes,
+                                  contributions.vertex_box_volume, mesh_volume, "vertex box volume");
+  compare<viennagrid::line_tag>(mesh_obj, edge_box_volumes, flat_edge_box_volumes, csr_edge_box_volumes,
+                                contributions.edge_box_volume, mesh_volume, "edge box volume");
+  compare<viennagrid::line_tag>(mesh_obj, interface_areas, flat_interface_areas, csr_interface_areas,
+                                contributions.interface_area, std::pow(mesh_volume, 2.0/3.0), "interface area");
+
+  std::size_t cell_count = viennagrid::elements<CellTag>(mesh_obj).size();
+  check( contributions.vertex_box_volume.entry_count() == cell_count * viennagrid::boundary_elements<CellTag, viennagrid::vertex_tag>::num &&
+         contributions.interface_area.entry_count() == cell_count * viennagrid::boundary_elements<CellTag, viennagrid::line_tag>::num,
+         "Wrong number of CSR entries" );
+}
+
+
+//
+// The computation with contribution accessors does not support segments of tetrahedral meshes, thus flat and CSR computation are compared with each other and the segment volume
+//
+template <typename SegmentHandleT>
+void check_segment(SegmentHandleT const & segment, std::string const & name)
+{
+  typedef typename viennagrid::result_of::const_cell_handle<SegmentHandleT>::type   ConstCellHandleType;
+  typedef typename viennagrid::result_of::vertex<SegmentHandleT>::type              VertexType;
+  typedef typename viennagrid::result_of::line<SegmentHandleT>::type                EdgeType;
+  typedef typename viennagrid::result_of::const_vertex_range<SegmentHandleT>::type  VertexRangeType;
+  typedef typename viennagrid::result_of::iterator<VertexRangeType>::type           VertexIteratorType;
+
+  std::cout << "* " << name << std::endl;
+
+  std::vector<double> interface_areas;
+  std::vector<double> vertex_box_volumes;
+  std::vector<double> edge_box_volumes;
+  viennagrid::apply_voronoi<viennagrid::tetrahedron_tag>(segment,
+                                                         viennagrid::make_field<EdgeType>(interface_areas),
+                                                         viennagrid::make_field<VertexType>(vertex_box_volumes),
+                                                         viennagrid::make_field<EdgeType>(edge_box_volumes));
+
+  std::vector<double> csr_interface_areas;
+  std::vector<double> csr_vertex_box_volumes;
+  std::vector<double> csr_edge_box_volumes;
+  viennagrid::voronoi_contributions<ConstCellHandleType> contributions;
+  viennagrid::apply_voronoi<viennagrid::tetrahedron_tag>(segment,
+                                                         viennagrid::make_field<EdgeType>(csr_interface_areas),
+                                                         viennagrid::make_field<VertexType>(csr_vertex_box_volumes),
+                                                         viennagrid::make_field<EdgeType>(csr_edge_box_volumes),
+                                                         contributions);
+
+  double segment_volume = viennagrid::volume(segment);
+  compare<viennagrid::vertex_tag>(segment, vertex_box_volumes, vertex_box_volumes, csr_vertex_box_volumes,
+                                  contributions.vertex_box_volume, segment_volume, "vertex box volume");
+  compare<viennagrid::line_tag>(segment, edge_box_volumes, edge_box_volumes, csr_edge_box_volumes,
+                                contributions.edge_box_volume, segment_volume, "edge box volume");
+  compare<viennagrid::line_tag>(segment, interface_areas, interface_areas, csr_interface_areas,
+                                contributions.interface_area, std::pow(segment_volume, 2.0/3.0), "interface area");
+
+  double box_volume = 0;
+  VertexRangeType vertices(segment);
+  for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+    box_volume += viennagrid::make_field<VertexType>(vertex_box_volumes)(*vit);
+
+  if ( !close(box_volume, segment_volume, segment_volume) )
+    std::cerr << "Box volume " << box_volume << " vs. segment volume " << segment_volume << std::endl;
+  check( close(box_volume, segment_volume, segment_volume), "Mismatch of segment volume" );
+}
+
+
+//
+// Ring of triangles including a triangle with circumcenter outside (see voronoi_triangle.cpp)
+//
+void setup_triangles(viennagrid::triangular_2d_mesh & mesh)
+{
+  typedef viennagrid::result_of::vertex_handle<viennagrid::triangular_2d_mesh>::type   VertexHandleType;
+  typedef viennagrid::result_of::point<viennagrid::triangular_2d_mesh>::type           PointType;
+
+  VertexHandleType vh[10];
+  vh[0] = viennagrid::make_vertex( mesh, PointType(0, 0) );
+  vh[1] = viennagrid::make_vertex( mesh, PointType(2, 1) );
+  vh[2] = viennagrid::make_vertex( mesh, PointType(1, 2) );
+  vh[3] = viennagrid::make_vertex( mesh, PointType(-1, 2) );
+  vh[4] = viennagrid::make_vertex( mesh, PointType(-2, 1) );
+  vh[5] = viennagrid::make_vertex( mesh, PointType(-2, -1) );
+  vh[6] = viennagrid::make_vertex( mesh, PointType(-1, -2) );
+  vh[7] = viennagrid::make_vertex( mesh, PointType(1, -2) );
+  vh[8] = viennagrid::make_vertex( mesh, PointType(2, -1) );
+  vh[9] = viennagrid::make_vertex( mesh, PointType(1.3, 2.7) );
+
+  viennagrid::make_triangle( mesh, vh[8], vh[1], vh[0] );
+  for (std::size_t i=1; i<8; ++i)
+    viennagrid::make_triangle( mesh, vh[i], vh[i+1], vh[0] );
+  viennagrid::make_triangle( mesh, vh[2], vh[1], vh[9] );
+}
+
+//
+// Four rectangles (see voronoi_rect.cpp)
+//
+void setup_quadrilaterals(viennagrid::quadrilateral_2d_mesh & mesh)
+{
+  typedef viennagrid::result_of::vertex_handle<viennagrid::quadrilateral_2d_mesh>::type   VertexHandleType;
+  typedef viennagrid::result_of::point<viennagrid::quadrilateral_2d_mesh>::type           PointType;
+
+  VertexHandleType vh0 = viennagrid::make_vertex( mesh, PointType(0, 0) );
+  VertexHandleType vh1 = viennagrid::make_vertex( mesh, PointType(2, 0) );
+  VertexHandleType vh2 = viennagrid::make_vertex( mesh, PointType(1, 1) );
+  VertexHandleType vh3 = viennagrid::make_vertex( mesh, PointType(0, 2) );
+  VertexHandleType vh4 = viennagrid::make_vertex( mesh, PointType(-1, 1) );
+  VertexHandleType vh5 = viennagrid::make_vertex( mesh, PointType(-2, 0) );
+  VertexHandleType vh6 = viennagrid::make_vertex( mesh, PointType(-1, -1) );
+  VertexHandleType vh7 = viennagrid::make_vertex( mesh, PointType(0, -2) );
+  VertexHandleType vh8 = viennagrid::make_vertex( mesh, PointType(1, -1) );
+
+  viennagrid::make_quadrilateral( mesh, vh0, vh8, vh2, vh1 );
+  viennagrid::make_quadrilateral( mesh, vh0, vh2, vh4, vh3 );
+  viennagrid::make_quadrilateral( mesh, vh0, vh4, vh6, vh5 );
+  viennagrid::make_quadrilateral( mesh, vh0, vh6, vh8, vh7 );
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  viennagrid::io::netgen_reader reader;
+
+  {
+    viennagrid::triangular_2d_mesh mesh;
+    setup_triangles(mesh);
+    check_mesh<viennagrid::triangle_tag>(mesh, "Triangles with circumcenter outside");
+  }
+
+  {
+    viennagrid::triangular_2d_mesh mesh;
+    viennagrid::triangular_2d_segmentation segmentation(mesh);
+    reader(mesh, segmentation, "../examples/data/square32.mesh");
+    check_mesh<viennagrid::triangle_tag>(mesh, "Triangular mesh");
+  }
+
+  {
+    viennagrid::quadrilateral_2d_mesh mesh;
+    setup_quadrilaterals(mesh);
+    check_mesh<viennagrid::quadrilateral_tag>(mesh, "Quadrilateral mesh");
+  }
+
+  {
+    viennagrid::tetrahedral_3d_mesh mesh;
+    viennagrid::tetrahedral_3d_segmentation segmentation(mesh);
+    reader(mesh, segmentation, "../examples/data/cube384.mesh");
+    check_mesh<viennagrid::tetrahedron_tag>(mesh, "Tetrahedral mesh");
+  }
+
+  {
+    viennagrid::tetrahedral_3d_mesh mesh;
+    viennagrid::tetrahedral_3d_segmentation segmentation(mesh);
+    reader(mesh, segmentation, "../examples/data/twocubes.mesh");
+    check_segment(segmentation(0), "Tetrahedral segment");
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
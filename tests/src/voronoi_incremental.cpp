@@ -0,0 +1,238 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Splits a cell at its centroid, updates the Voronoi quantities incrementally and compares them with a full recomputation.
+// Erases and restores triangles next to obtuse triangles without passing the obtuse triangles.
+//
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/mesh/element_deletion.hpp"
+#include "viennagrid/algorithm/centroid.hpp"
+#include "viennagrid/algorithm/voronoi.hpp"
+#include "viennagrid/algorithm/volume.hpp"
+
+#include "check_common.hpp"
+
+
+template <typename ElementTag, typename MeshT>
+void compare(MeshT const & mesh_obj, std::vector<double> const & updated, std::vector<double> const & reference, double scale, std::string const & name)
+{
+  typedef typename viennagrid::result_of::const_element_range<MeshT, ElementTag>::type   RangeType;
+  typedef typename viennagrid::result_of::iterator<RangeType>::type                      IteratorType;
+  typedef typename viennagrid::result_of::element<MeshT, ElementTag>::type               ElementType;
+
+  RangeType elements(mesh_obj);
+  for (IteratorType it = elements.begin(); it != elements.end(); ++it)
+  {
+    double updated_value = viennagrid::make_field<ElementType>(updated)(*it);
+    double reference_value = viennagrid::make_field<ElementType>(reference)(*it);
+
+    bool matches = std::fabs(updated_value - reference_value) <= 1e-10 * scale;
+    if (!matches)
+      std::cerr << name << " of element " << (*it).id() << ": " << updated_value << " (updated) vs. " << reference_value << " (recomputed)" << std::endl;
+    check( matches, "Mismatch of " + name );
+  }
+}
+
+
+template <typename CellTag, typename MeshT>
+void compare_with_recomputation(MeshT const & mesh_obj,
+                                std::vector<double> const & interface_areas,
+                                std::vector<double> const & vertex_box_volumes,
+                                std::vector<double> const & edge_box_volumes)
+{
+  typedef typename viennagrid::result_of::vertex<MeshT>::type                  VertexType;
+  typedef typename viennagrid::result_of::line<MeshT>::type                    EdgeType;
+
+  std::vector<double> reference_interface_areas;
+  std::vector<double> reference_vertex_box_volumes;
+  std::vector<double> reference_edge_box_volumes;
+
+  viennagrid::apply_voronoi<CellTag>(mesh_obj,
+                                     viennagrid::make_field<EdgeType>(reference_interface_areas),
+                                     viennagrid::make_field<VertexType>(reference_vertex_box_volumes),
+                                     viennagrid::make_field<EdgeType>(reference_edge_box_volumes));
+
+  double mesh_volume = viennagrid::volume(mesh_obj);
+  compare<viennagrid::vertex_tag>(mesh_obj, vertex_box_volumes, reference_vertex_box_volumes, mesh_volume, "vertex box volume");
+  compare<viennagrid::line_tag>(mesh_obj, edge_box_volumes, reference_edge_box_volumes, mesh_volume, "edge box volume");
+  compare<viennagrid::line_tag>(mesh_obj, interface_areas, reference_interface_areas, mesh_volume, "interface area");
+}
+
+
+template <typename CellTag, typename MeshT>
+void split_cells(MeshT & mesh_obj, std::size_t step, std::string const & name)
+{
+  typedef typename viennagrid::result_of::cell<MeshT>::type                    CellType;
+  typedef typename viennagrid::result_of::handle<MeshT, CellTag>::type         CellHandleType;
+  typedef typename viennagrid::result_of::vertex<MeshT>::type                  VertexType;
+  typedef typename viennagrid::result_of::vertex_handle<MeshT>::type           VertexHandleType;
+  typedef typename viennagrid::result_of::line<MeshT>::type                    EdgeType;
+  typedef typename viennagrid::result_of::point<MeshT>::type                   PointType;
+  typedef typename viennagrid::result_of::vertex_range<CellType>::type         VertexOnCellRange;
+
+  static const std::size_t num_vertices = viennagrid::boundary_elements<CellTag, viennagrid::vertex_tag>::num;
+
+  std::cout << "* " << name << std::endl;
+
+  std::vector<double> interface_areas;
+  std::vector<double> vertex_box_volumes;
+  std::vector<double> edge_box_volumes;
+
+  viennagrid::apply_voronoi<CellTag>(mesh_obj,
+                                     viennagrid::make_field<EdgeType>(interface_areas),
+                                     viennagrid::make_field<VertexType>(vertex_box_volumes),
+                                     viennagrid::make_field<EdgeType>(edge_box_volumes));
+
+  std::size_t num_cells = viennagrid::cells(mesh_obj).size();
+  for (std::size_t index = step / 2; index < num_cells; index += step)
+  {
+    // remove the cell
+    std::vector<CellHandleType> removed_cells(1, viennagrid::cells(mesh_obj).handle_at(index));
+    CellType & cell = viennagrid::dereference_handle(mesh_obj, removed_cells[0]);
+
+    viennagrid::subtract_voronoi_contributions<CellTag>(mesh_obj, removed_cells.begin(), removed_cells.end(),
+                                                        viennagrid::make_field<EdgeType>(interface_areas),
+                                                        viennagrid::make_field<VertexType>(vertex_box_volumes),
+                                                        viennagrid::make_field<EdgeType>(edge_box_volumes));
+
+    PointType center = viennagrid::centroid(cell);
+    std::vector<VertexHandleType> vertices;
+    VertexOnCellRange vertices_on_cell(cell);
+    for (typename viennagrid::result_of::iterator<VertexOnCellRange>::type vit = vertices_on_cell.begin(); vit != vertices_on_cell.end(); ++vit)
+      vertices.push_back( vit.handle() );
+
+    viennagrid::erase_element(mesh_obj, removed_cells[0]);
+
+    // replace it by cells connecting the centroid with the facets of the removed cell
+    VertexHandleType center_vertex = viennagrid::make_vertex(mesh_obj, center);
+    std::vector<CellHandleType> added_cells;
+    for (std::size_t i = 0; i < num_vertices; ++i)
+    {
+      std::vector<VertexHandleType> cell_vertices(vertices);
+      cell_vertices[i] = center_vertex;
+      added_cells.push_back( viennagrid::make_element<CellType>(mesh_obj, cell_vertices.begin(), cell_vertices.end()) );
+    }
+
+    viennagrid::add_voronoi_contributions<CellTag>(mesh_obj, added_cells.begin(), added_cells.end(),
+                                                   viennagrid::make_field<EdgeType>(interface_areas),
+                                                   viennagrid::make_field<VertexType>(vertex_box_volumes),
+                                                   viennagrid::make_field<EdgeType>(edge_box_volumes));
+  }
+
+  check( viennagrid::cells(mesh_obj).size() > num_cells, "No cells split" );
+
+  compare_with_recomputation<CellTag>(mesh_obj, interface_areas, vertex_box_volumes, edge_box_volumes);
+}
+
+
+/** @brief Erases the cells at the base of obtuse triangles without replacement and adds them again, which changes whether the edges crossed by the circumcenters of the obtuse triangles are shared */
+void erase_and_restore_cells()
+{
+  typedef viennagrid::triangular_2d_mesh                                       MeshType;
+  typedef viennagrid::result_of::cell_handle<MeshType>::type                   CellHandleType;
+  typedef viennagrid::result_of::vertex<MeshType>::type                        VertexType;
+  typedef viennagrid::result_of::vertex_handle<MeshType>::type                 VertexHandleType;
+  typedef viennagrid::result_of::line<MeshType>::type                          EdgeType;
+  typedef viennagrid::result_of::point<MeshType>::type                         PointType;
+
+  std::cout << "* Triangles erased without replacement next to obtuse triangles" << std::endl;
+
+  // a strip of two obtuse triangles on top of two triangles sharing their base edges
+  MeshType mesh;
+  VertexHandleType v0 = viennagrid::make_vertex( mesh, PointType(0.0, 0.0) );
+  VertexHandleType v1 = viennagrid::make_vertex( mesh, PointType(2.0, 0.0) );
+  VertexHandleType v2 = viennagrid::make_vertex( mesh, PointType(4.0, 0.0) );
+  VertexHandleType v3 = viennagrid::make_vertex( mesh, PointType(1.0, 0.3) );
+  VertexHandleType v4 = viennagrid::make_vertex( mesh, PointType(3.0, 0.3) );
+  VertexHandleType v5 = viennagrid::make_vertex( mesh, PointType(1.0, -1.0) );
+  VertexHandleType v6 = viennagrid::make_vertex( mesh, PointType(3.0, -1.0) );
+
+  viennagrid::make_triangle( mesh, v0, v1, v3 );
+  viennagrid::make_triangle( mesh, v1, v2, v4 );
+  viennagrid::make_triangle( mesh, v1, v4, v3 );
+  std::vector<CellHandleType> base_cells;
+  base_cells.push_back( viennagrid::make_triangle( mesh, v0, v5, v1 ) );
+  base_cells.push_back( viennagrid::make_triangle( mesh, v1, v6, v2 ) );
+
+  std::vector<double> interface_areas;
+  std::vector<double> vertex_box_volumes;
+  std::vector<double> edge_box_volumes;
+
+  viennagrid::apply_voronoi<viennagrid::triangle_tag>(mesh,
+                                                      viennagrid::make_field<EdgeType>(interface_areas),
+                                                      viennagrid::make_field<VertexType>(vertex_box_volumes),
+                                                      viennagrid::make_field<EdgeType>(edge_box_volumes));
+
+  viennagrid::subtract_voronoi_contributions<viennagrid::triangle_tag>(mesh, base_cells.begin(), base_cells.end(),
+                                                                       viennagrid::make_field<EdgeType>(interface_areas),
+                                                                       viennagrid::make_field<VertexType>(vertex_box_volumes),
+                                                                       viennagrid::make_field<EdgeType>(edge_box_volumes));
+  viennagrid::erase_element(mesh, base_cells[1]);
+  viennagrid::erase_element(mesh, base_cells[0]);
+
+  compare_with_recomputation<viennagrid::triangle_tag>(mesh, interface_areas, vertex_box_volumes, edge_box_volumes);
+
+  base_cells.clear();
+  base_cells.push_back( viennagrid::make_triangle( mesh, v0, v5, v1 ) );
+  base_cells.push_back( viennagrid::make_triangle( mesh, v1, v6, v2 ) );
+
+  viennagrid::add_voronoi_contributions<viennagrid::triangle_tag>(mesh, base_cells.begin(), base_cells.end(),
+                                                                  viennagrid::make_field<EdgeType>(interface_areas),
+                                                                  viennagrid::make_field<VertexType>(vertex_box_volumes),
+                                                                  viennagrid::make_field<EdgeType>(edge_box_volumes));
+
+  compare_with_recomputation<viennagrid::triangle_tag>(mesh, interface_areas, vertex_box_volumes, edge_box_volumes);
+}
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  viennagrid::io::netgen_reader reader;
+
+  {
+    viennagrid::triangular_2d_mesh mesh;
+    viennagrid::triangular_2d_segmentation segmentation(mesh);
+    reader(mesh, segmentation, "../examples/data/square32.mesh");
+    split_cells<viennagrid::triangle_tag>(mesh, 5, "Triangles");
+  }
+
+  erase_and_restore_cells();
+
+  {
+    viennagrid::tetrahedral_3d_mesh mesh;
+    viennagrid::tetrahedral_3d_segmentation segmentation(mesh);
+    reader(mesh, segmentation, "../examples/data/cube384.mesh");
+    split_cells<viennagrid::tetrahedron_tag>(mesh, 37, "Tetrahedra");
+  }
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
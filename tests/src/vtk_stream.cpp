@@ -0,0 +1,150 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _MSC_VER
+  #pragma warning( disable : 4503 )     //truncated name decoration
+#endif
+
+//
+// Streaming of multi-piece VTK datasets: piece-by-piece reading, boundary extraction and writing compared to the in-memory counterparts.
+//
+
+#include <cmath>
+#include <deque>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/io/netgen_reader.hpp"
+#include "viennagrid/io/vtk_reader.hpp"
+#include "viennagrid/io/vtk_writer.hpp"
+#include "viennagrid/io/vtk_stream.hpp"
+#include "viennagrid/algorithm/extract_boundary.hpp"
+
+#include "check_common.hpp"
+
+typedef viennagrid::tetrahedral_3d_mesh                                             MeshType;
+typedef viennagrid::triangular_3d_mesh                                              HullMeshType;
+typedef viennagrid::result_of::segmentation<MeshType>::type                        SegmentationType;
+typedef viennagrid::result_of::vertex<MeshType>::type                              VertexType;
+typedef viennagrid::result_of::const_vertex_range<MeshType>::type                  VertexRangeType;
+typedef viennagrid::result_of::iterator<VertexRangeType>::type                     VertexIteratorType;
+typedef viennagrid::io::vtk_reader<MeshType>                                       ReaderType;
+
+
+
+/** @brief Checks the data read for a piece, extracts its boundary and writes it again together with its data */
+class piece_pipeline
+{
+public:
+  piece_pipeline(viennagrid::io::vtk_stream_writer<MeshType> & writer) : writer_(writer), pieces_(0), cells_(0) {}
+
+  void operator()(int part, MeshType const & piece_mesh, ReaderType const & piece_reader)
+  {
+    ++pieces_;
+    cells_ += viennagrid::cells(piece_mesh).size();
+
+    viennagrid::result_of::field<const std::deque<double>, VertexType>::type x = piece_reader.vertex_scalar_field("x", 0);
+    check( x.is_valid(), "piece data read" );
+
+    VertexRangeType vertices(piece_mesh);
+    for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+      check( std::fabs( x(*vit) - viennagrid::point(*vit)[0] ) < 1e-4, "piece data matches the coordinates" );
+
+    extractor_(piece_mesh);
+
+    viennagrid::io::add_scalar_data_on_vertices( writer_.piece_writer(), x, "x" );
+    writer_(piece_mesh, part);
+  }
+
+  std::size_t pieces() const { return pieces_; }
+  std::size_t cells() const { return cells_; }
+  viennagrid::boundary_stream_extractor<viennagrid::triangle_tag, HullMeshType> const & extractor() const { return extractor_; }
+
+private:
+  viennagrid::io::vtk_stream_writer<MeshType> & writer_;
+  viennagrid::boundary_stream_extractor<viennagrid::triangle_tag, HullMeshType> extractor_;
+  std::size_t pieces_;
+  std::size_t cells_;
+};
+
+
+int main()
+{
+  std::cout << "*****************" << std::endl;
+  std::cout << "* Test started! *" << std::endl;
+  std::cout << "*****************" << std::endl;
+
+  MeshType mesh;
+  SegmentationType segmentation(mesh);
+
+  viennagrid::io::netgen_reader reader;
+  reader(mesh, segmentation, "../examples/data/twocubes.mesh");
+  check( segmentation.size() == 2, "two segments" );
+
+  // write a dataset with one piece per segment
+  std::deque<double> x_data;
+  viennagrid::result_of::field<std::deque<double>, VertexType>::type x_field(x_data);
+
+  VertexRangeType vertices(mesh);
+  for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+    x_field(*vit) = viennagrid::point(*vit)[0];
+
+  viennagrid::io::vtk_writer<MeshType> writer;
+  viennagrid::io::add_scalar_data_on_vertices(writer, x_field, "x");
+  writer(mesh, segmentation, "vtk_stream_input");
+
+
+  // stream the pieces
+  viennagrid::io::vtk_stream_writer<MeshType> stream_writer("vtk_stream_output");
+  piece_pipeline pipeline(stream_writer);
+
+  std::size_t pieces = viennagrid::io::stream_vtk_pieces<MeshType>("vtk_stream_input_main.pvd", pipeline);
+  stream_writer.finish();
+
+  check( pieces == 2 && pipeline.pieces() == 2, "all pieces streamed" );
+  check( stream_writer.size() == 2, "all pieces written" );
+  check( pipeline.cells() == viennagrid::cells(mesh).size(), "pieces contain all cells" );
+
+
+  // boundary of the streamed pieces vs. boundary of the whole mesh
+  HullMeshType hull;
+  viennagrid::extract_boundary(mesh, hull);
+
+  HullMeshType streamed_hull;
+  pipeline.extractor().finish(streamed_hull);
+
+  check( pipeline.extractor().open_element_count() == viennagrid::cells(hull).size(), "interface between the pieces removed" );
+  check( viennagrid::cells(streamed_hull).size() == viennagrid::cells(hull).size(), "streamed boundary triangles" );
+  check( viennagrid::vertices(streamed_hull).size() == viennagrid::vertices(hull).size(), "streamed boundary vertices" );
+
+
+  // the dataset written piece by piece is read like any other multi-piece dataset
+  MeshType reread_mesh;
+  SegmentationType reread_segmentation(reread_mesh);
+  viennagrid::io::vtk_reader<MeshType> vtk_reader;
+  vtk_reader(reread_mesh, reread_segmentation, "vtk_stream_output_main.pvd");
+
+  check( reread_segmentation.size() == 2, "streamed dataset has two pieces" );
+  check( viennagrid::cells(reread_mesh).size() == viennagrid::cells(mesh).size(), "streamed dataset has all cells" );
+  check( viennagrid::vertices(reread_mesh).size() == viennagrid::vertices(mesh).size(), "streamed dataset has all vertices" );
+
+
+  // a single .vtu file is a single piece
+  piece_pipeline single_pipeline(stream_writer);
+  check( viennagrid::io::stream_vtk_pieces<MeshType>("vtk_stream_input_1.vtu", single_pipeline) == 1 && single_pipeline.cells() > 0, "single .vtu piece" );
+
+  std::cout << "*******************************" << std::endl;
+  std::cout << "* Test finished successfully! *" << std::endl;
+  std::cout << "*******************************" << std::endl;
+
+  return EXIT_SUCCESS;
+}
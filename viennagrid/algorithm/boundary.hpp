@@ -18,6 +18,7 @@
 #include "viennagrid/element/element.hpp"
 #include "viennagrid/accessor.hpp"
 #include "viennagrid/mesh/segmentation.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 
 /** @file viennagrid/algorithm/boundary.hpp
@@ -34,6 +35,7 @@ namespace viennagrid
     template <typename MeshT, typename AccessorT>
     void detect_boundary(MeshT & mesh_obj, AccessorT boundary_info_accessor)
     {
+      VIENNAGRID_INSTRUMENT_SCOPE("boundary: detect");
       typedef typename viennagrid::result_of::cell_tag<MeshT>::type CellTag;
       typedef typename viennagrid::result_of::facet_tag<CellTag>::type FacetTag;
 
@@ -79,6 +81,7 @@ namespace viennagrid
                          DestinationAccessorT destination_boundary_info_accessor
                         )
     {
+      VIENNAGRID_INSTRUMENT_SCOPE("boundary: transfer");
       typedef typename SourceAccessorT::access_type src_element_type;
       typedef typename DestinationAccessorT::access_type dst_element_type;
 
@@ -115,12 +118,65 @@ namespace viennagrid
 
 
 
-    /** @brief For internal use only. */
+    /** @brief For internal use only. The boundary flags of an element type depend on the cells, the facets and the element type itself. */
+    template<typename MeshT, typename ElementTagT>
+    struct boundary_information_dependencies
+    {
+      typedef typename viennagrid::result_of::cell_tag< MeshT >::type cell_tag;
+      typedef typename viennagrid::result_of::facet_tag< cell_tag >::type facet_tag;
+
+      typedef typename viennagrid::make_typelist<cell_tag, facet_tag, ElementTagT>::type type;
+    };
+
+
+    /** @brief For internal use only. The element tags with boundary flags transferred from the facets, i.e. all element tags except the facet tag. */
+    template<typename MeshT>
+    struct transferred_boundary_information_taglist
+    {
+      typedef typename viennagrid::result_of::cell_tag< MeshT >::type cell_tag;
+      typedef typename viennagrid::result_of::facet_tag< cell_tag >::type facet_tag;
+
+      typedef typename viennagrid::detail::result_of::erase<
+          typename viennagrid::detail::result_of::key_typelist<
+              typename viennagrid::detail::result_of::lookup<
+                  typename MeshT::appendix_type,
+                  boundary_information_collection_tag
+              >::type::typemap
+          >::type,
+          facet_tag
+      >::type type;
+    };
+
+
+    /** @brief For internal use only. Checks if the transferred boundary flags of any element type are out of date. */
+    template<typename MeshT>
+    class boundary_information_obsolete_functor
+    {
+    public:
+      boundary_information_obsolete_functor(MeshT const & mesh_obj, bool & obsolete) : mesh_obj_(mesh_obj), obsolete_(obsolete) {}
+
+      template<typename something>
+      void operator()( viennagrid::detail::tag<something> )
+      {
+        typedef typename viennagrid::result_of::element_tag< something >::type element_tag;
+        typedef typename boundary_information_dependencies<MeshT, element_tag>::type dependency_taglist;
+
+        if ( detail::is_dependency_obsolete<dependency_taglist>(mesh_obj_, detail::boundary_information_collection<element_tag>( mesh_obj_ ).change_counter) )
+          obsolete_ = true;
+      }
+    private:
+
+      MeshT const & mesh_obj_;
+      bool & obsolete_;
+    };
+
+
+    /** @brief For internal use only. If obsolete_only is set, only boundary flags which are out of date are transferred. */
     template<typename MeshT>
     class boundary_setter_functor
     {
     public:
-      boundary_setter_functor(MeshT & mesh_obj) : mesh_obj_(mesh_obj) {}
+      boundary_setter_functor(MeshT & mesh_obj, bool obsolete_only = false) : mesh_obj_(mesh_obj), obsolete_only_(obsolete_only) {}
 
       template<typename something>
       void operator()( viennagrid::detail::tag<something> )
@@ -153,39 +209,31 @@ namespace viennagrid
 
         dst_boundary_information_container_wrapper_type & dst_boundary_information_container_wrapper = detail::boundary_information_collection<element_tag>( mesh_obj_ );
 
+        typedef typename boundary_information_dependencies<MeshT, element_tag>::type dependency_taglist;
+        if ( obsolete_only_ && !detail::is_dependency_obsolete<dependency_taglist>(mesh_obj_, dst_boundary_information_container_wrapper.change_counter) )
+          return;
+
         transfer_boundary_information(mesh_obj_,
                                       viennagrid::make_field<facet_type>( src_boundary_information_container_wrapper.container ),
                                       viennagrid::make_field<element_type>( dst_boundary_information_container_wrapper.container ));
 
-        detail::update_change_counter( mesh_obj_, dst_boundary_information_container_wrapper.change_counter );
+        detail::update_dependency_change_counter<dependency_taglist>( mesh_obj_, dst_boundary_information_container_wrapper.change_counter );
       }
     private:
 
       MeshT & mesh_obj_;
+      bool obsolete_only_;
     };
 
 
     /** @brief For internal use only. */
     template<typename WrappedConfigT>
-    void transfer_boundary_information( mesh<WrappedConfigT> & mesh_obj)
+    void transfer_boundary_information( mesh<WrappedConfigT> & mesh_obj, bool obsolete_only = false)
     {
       typedef mesh<WrappedConfigT> mesh_type;
-      typedef typename viennagrid::result_of::cell_tag< mesh_type >::type cell_tag;
-      typedef typename viennagrid::result_of::facet_tag< cell_tag >::type facet_tag;
-
-      typedef typename viennagrid::detail::result_of::erase<
-          typename viennagrid::detail::result_of::key_typelist<
-              typename viennagrid::detail::result_of::lookup<
-                  typename mesh_type::appendix_type,
-                  boundary_information_collection_tag
-              >::type::typemap
-          >::type,
-          facet_tag
-      >::type typelist;
-
-      boundary_setter_functor<mesh_type> functor(mesh_obj);
 
-      viennagrid::detail::for_each< typelist >( functor );
+      boundary_setter_functor<mesh_type> functor(mesh_obj, obsolete_only);
+      viennagrid::detail::for_each< typename transferred_boundary_information_taglist<mesh_type>::type >( functor );
     }
 
     /** @brief For internal use only. */
@@ -215,7 +263,7 @@ namespace viennagrid
       detect_boundary( mesh_obj, viennagrid::make_field<facet_type>( boundary_information_container_wrapper.container ) );
 
       transfer_boundary_information(mesh_obj);
-      detail::update_change_counter( mesh_obj, boundary_information_container_wrapper.change_counter );
+      detail::update_dependency_change_counter< typename viennagrid::make_typelist<cell_tag, facet_tag>::type >( mesh_obj, boundary_information_container_wrapper.change_counter );
     }
 
     /** @brief For internal use only. */
@@ -223,6 +271,49 @@ namespace viennagrid
     void detect_boundary( segment_handle<SegmentationT> & segment )
     { detect_boundary( segment.view() ); }
 
+    /** @brief For internal use only. Re-creates the boundary information if it is out of date.
+      *
+      * The boundary flags of the facets are re-detected if cells or facets changed, the flags of any other element type are only re-transferred if elements of this type changed.
+      * Thread-safe, see viennagrid/mesh/cache_guard.hpp
+      */
+    template<typename WrappedConfigT>
+    void prepare_boundary_information( mesh<WrappedConfigT> const & mesh_obj )
+    {
+      typedef mesh<WrappedConfigT> mesh_type;
+      typedef typename viennagrid::result_of::cell_tag< mesh_type >::type cell_tag;
+      typedef typename viennagrid::result_of::facet_tag< cell_tag >::type facet_tag;
+
+      typedef typename viennagrid::detail::result_of::lookup<
+              typename viennagrid::detail::result_of::lookup<
+                  typename mesh_type::appendix_type,
+                  boundary_information_collection_tag
+                >::type,
+                facet_tag
+              >::type boundary_information_container_wrapper_type;
+      boundary_information_container_wrapper_type const & boundary_information_container_wrapper = detail::boundary_information_collection<facet_tag>(mesh_obj);
+
+      typedef typename viennagrid::make_typelist<cell_tag, facet_tag>::type dependency_taglist;
+
+      if ( detail::is_dependency_obsolete<dependency_taglist>(mesh_obj, boundary_information_container_wrapper.change_counter) )
+      {
+        detail::cache_update_guard guard;
+        if ( detail::is_dependency_obsolete<dependency_taglist>(mesh_obj, boundary_information_container_wrapper.change_counter) )
+          detail::detect_boundary( const_cast<mesh_type&>(mesh_obj) );
+      }
+      else
+      {
+        bool obsolete = false;
+        boundary_information_obsolete_functor<mesh_type> functor(mesh_obj, obsolete);
+        viennagrid::detail::for_each< typename transferred_boundary_information_taglist<mesh_type>::type >( functor );
+
+        if (obsolete)
+        {
+          detail::cache_update_guard guard;
+          detail::transfer_boundary_information( const_cast<mesh_type&>(mesh_obj), true );
+        }
+      }
+    }
+
     /** @brief For internal use only. */
     template <typename ElementT, typename AccessorT>
     bool is_boundary(AccessorT const boundary_info_accessor,
@@ -255,8 +346,7 @@ namespace viennagrid
             >::type boundary_information_container_wrapper_type;
     boundary_information_container_wrapper_type const & boundary_information_container_wrapper = detail::boundary_information_collection<element_tag>(mesh_obj);
 
-    if (mesh_obj.is_obsolete(boundary_information_container_wrapper.change_counter))
-      detail::detect_boundary( const_cast<mesh_type&>(mesh_obj) );
+    detail::prepare_boundary_information(mesh_obj);
 
     return detail::is_boundary( viennagrid::make_field<ElementT>(boundary_information_container_wrapper.container), element );
   }
@@ -271,6 +361,23 @@ namespace viennagrid
   { return is_boundary( segment.view(), element ); }
 
 
+  /** @brief Detects the boundary of a mesh if the boundary information is out of date. Call this function before calling is_boundary() on a shared mesh from multiple threads, afterwards is_boundary() does not modify the mesh.
+   *
+   * @param mesh_obj    The ViennaGrid mesh
+   */
+  template <typename WrappedConfigT>
+  void prepare_boundary(mesh<WrappedConfigT> const & mesh_obj)
+  { detail::prepare_boundary_information(mesh_obj); }
+
+  /** @brief Detects the boundary of a segment if the boundary information is out of date. Call this function before calling is_boundary() on a shared segment from multiple threads, afterwards is_boundary() does not modify the segment.
+   *
+   * @param segment      The ViennaGrid segment
+   */
+  template <typename SegmentationT>
+  void prepare_boundary(segment_handle<SegmentationT> const & segment)
+  { detail::prepare_boundary_information( segment.view() ); }
+
+
   /** @brief Returns true if the element provided as second argument is on the boundary of the element provided as first argument
    *
    * @param host_element    The host element
@@ -16,6 +16,8 @@
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/topology/line.hpp"
 #include "viennagrid/topology/quadrilateral.hpp"
+#include "viennagrid/topology/hexahedron.hpp"
+#include "viennagrid/algorithm/detail/refine_quad.hpp"
 
 /** @file viennagrid/algorithm/detail/refine_hex.hpp
     @brief Provides refinement routines for hexahedra
@@ -23,8 +25,14 @@
 
 namespace viennagrid
 {
-   // TODO
+  namespace detail
+  {
+
+    /** @brief Specialization of the refinement class for a hexahedron. The hexahedron is split in each direction in which all four parallel edges are flagged, resulting in two, four or eight hexahedra. */
+    template<>
+    struct element_refinement<hexahedron_tag> : public tensor_cell_refinement<3> {};
+
+  } // namespace detail
 }
 
 #endif
-
@@ -13,9 +13,14 @@
    License:      MIT (X11), see file LICENSE in the base directory
 ======================================================================= */
 
+#include <vector>
+#include <algorithm>
+
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/topology/vertex.hpp"
 #include "viennagrid/topology/line.hpp"
+#include "viennagrid/topology/quadrilateral.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
 
 /** @file viennagrid/algorithm/detail/refine_quad.hpp
     @brief Provides refinement routines for a quadrilateral
@@ -23,8 +28,284 @@
 
 namespace viennagrid
 {
-   // TODO
+  namespace detail
+  {
+
+    /** @brief Local numbering of a quadrilateral (DimV = 2) or a hexahedron (DimV = 3) as a tensor product cell. For internal use only.
+     *
+     * Corner i has the local coordinates given by the bits of i, which is the vertex order of quadrilaterals and hexahedra in ViennaGrid.
+     * An edge is identified by its lower corner and its direction, a facet by its normal direction and its side.
+     */
+    template<typename CellT, int DimV>
+    struct tensor_cell
+    {
+      typedef typename viennagrid::result_of::element<CellT, vertex_tag>::type    VertexType;
+      typedef typename viennagrid::result_of::element<CellT, line_tag>::type      EdgeType;
+      typedef typename viennagrid::result_of::facet<CellT>::type                  FacetType;
+
+      enum { corner_count = 1 << DimV };
+
+      explicit tensor_cell(CellT const & cell)
+      {
+        typedef typename viennagrid::result_of::const_element_range<CellT, vertex_tag>::type   VertexOnCellRange;
+        typedef typename viennagrid::result_of::iterator<VertexOnCellRange>::type              VertexOnCellIterator;
+        typedef typename viennagrid::result_of::const_element_range<CellT, line_tag>::type     EdgeOnCellRange;
+        typedef typename viennagrid::result_of::iterator<EdgeOnCellRange>::type                EdgeOnCellIterator;
+        typedef typename viennagrid::result_of::const_facet_range<CellT>::type                 FacetOnCellRange;
+        typedef typename viennagrid::result_of::iterator<FacetOnCellRange>::type               FacetOnCellIterator;
+
+        int i = 0;
+        VertexOnCellRange vertices_on_cell(cell);
+        for (VertexOnCellIterator vocit = vertices_on_cell.begin(); vocit != vertices_on_cell.end(); ++vocit, ++i)
+          corners[i] = &*vocit;
+
+        EdgeOnCellRange edges_on_cell(cell);
+        for (EdgeOnCellIterator eocit = edges_on_cell.begin(); eocit != edges_on_cell.end(); ++eocit)
+        {
+          int i0 = corner_index( viennagrid::vertices(*eocit)[0] );
+          int i1 = corner_index( viennagrid::vertices(*eocit)[1] );
+          edges[i0 & i1][direction(i0 ^ i1)] = &*eocit;
+        }
+
+        FacetOnCellRange facets_on_cell(cell);
+        for (FacetOnCellIterator focit = facets_on_cell.begin(); focit != facets_on_cell.end(); ++focit)
+        {
+          typedef typename viennagrid::result_of::const_element_range<FacetType, vertex_tag>::type  VertexOnFacetRange;
+          typedef typename viennagrid::result_of::iterator<VertexOnFacetRange>::type               VertexOnFacetIterator;
+
+          int all_set = corner_count - 1;
+          int any_set = 0;
+          VertexOnFacetRange vertices_on_facet(*focit);
+          for (VertexOnFacetIterator vofit = vertices_on_facet.begin(); vofit != vertices_on_facet.end(); ++vofit)
+          {
+            all_set &= corner_index(*vofit);
+            any_set |= corner_index(*vofit);
+          }
+
+          // the normal direction is the only coordinate which is the same for all corners of the facet
+          int normal = direction( (all_set | ~any_set) & (corner_count - 1) );
+          facets[normal][(all_set >> normal) & 1] = &*focit;
+        }
+      }
+
+      /** @brief Returns the local index of a corner of the cell */
+      int corner_index(VertexType const & vertex) const
+      {
+        for (int i = 0; i < corner_count; ++i)
+          if (corners[i]->id() == vertex.id())
+            return i;
+        return corner_count;
+      }
+
+      /** @brief Returns the direction of the single bit set in a local index difference */
+      static int direction(int bit)
+      {
+        return (bit == 1) ? 0 : ((bit == 2) ? 1 : 2);
+      }
+
+      /** @brief Returns true if all edges of the cell in the direction 'dir' are flagged for refinement, i.e. the cell is split in this direction */
+      template<typename EdgeRefinementFlagAccessorT>
+      bool is_split(int dir, EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor) const
+      {
+        for (int base = 0; base < corner_count; ++base)
+          if ( !(base & (1 << dir)) && !edge_refinement_flag_accessor(*edges[base][dir]) )
+            return false;
+        return true;
+      }
+
+      VertexType const * corners[corner_count];
+      EdgeType const * edges[corner_count][DimV];
+      FacetType const * facets[DimV][2];
+    };
+
+
+    /** @brief Vertices created at the centers of facets during refinement, indexed by the ID of the facet in the input mesh, such that both cells sharing a facet use the same vertex. For internal use only. */
+    template<typename VertexHandleT>
+    class refinement_facet_vertex_map
+    {
+    public:
+      typedef VertexHandleT vertex_handle_type;
+
+      bool find(std::size_t facet_id, VertexHandleT & result) const
+      {
+        if (facet_id >= mapped_.size() || !mapped_[facet_id])
+          return false;
+        result = vertices_[facet_id];
+        return true;
+      }
+
+      void insert(std::size_t facet_id, VertexHandleT const & vertex_handle)
+      {
+        if (facet_id >= mapped_.size())
+        {
+          vertices_.resize(facet_id + 1);
+          mapped_.resize(facet_id + 1, false);
+        }
+        vertices_[facet_id] = vertex_handle;
+        mapped_[facet_id] = true;
+      }
+
+    private:
+      std::vector<VertexHandleT> vertices_;
+      std::vector<bool> mapped_;
+    };
+
+
+    /** @brief Refinement of quadrilaterals (DimV = 2) and hexahedra (DimV = 3). For internal use only.
+     *
+     * A cell is split in every direction in which all of its parallel edges are flagged for refinement, which results in 2, 4 or 8 children.
+     * Flagged edges in a direction which is not split are left unchanged. If such an edge is split by a neighbor cell, its refinement vertex becomes a hanging vertex of the refined mesh (cf. viennagrid::hanging_vertices()).
+     * The new vertices at the centers of the facets are shared with the neighbor cells using a refinement_facet_vertex_map.
+     */
+    template<int DimV>
+    struct tensor_cell_refinement
+    {
+      /** @brief Returns the vertex at the lattice node with coordinates 0 (lower corner), 1 (midpoint) or 2 (upper corner) in each direction */
+      template<typename TensorCellT, typename MeshT, typename VertexHandleT,
+               typename VertexCopyMapT, typename EdgeToVertexHandleAccessor, typename FacetToVertexHandleMapT>
+      static VertexHandleT node(TensorCellT const & cell, MeshT & mesh, int const * coordinates,
+                                VertexHandleT * nodes, bool * node_created,
+                                VertexCopyMapT & vertex_copy_map_,
+                                EdgeToVertexHandleAccessor const & edge_to_vertex_handle_accessor,
+                                FacetToVertexHandleMapT & facet_to_vertex_handle_map)
+      {
+        typedef typename viennagrid::result_of::point<MeshT>::type   PointType;
+
+        int index = 0;
+        int base = 0;
+        int midpoint_directions = 0;
+        int midpoint_count = 0;
+        for (int d = DimV-1; d >= 0; --d)
+        {
+          index = 3 * index + coordinates[d];
+          if (coordinates[d] == 2)
+            base |= (1 << d);
+          else if (coordinates[d] == 1)
+          {
+            midpoint_directions |= (1 << d);
+            ++midpoint_count;
+          }
+        }
+
+        if (node_created[index])
+          return nodes[index];
+
+        VertexHandleT result;
+        if (midpoint_count == 0)
+          result = vertex_copy_map_( *cell.corners[base] );
+        else if (midpoint_count == 1)
+          result = edge_to_vertex_handle_accessor( *cell.edges[base][TensorCellT::direction(midpoint_directions)] );
+        else
+        {
+          // Center of a facet (midpoint_count == DimV - 1) or of the cell: mean of the refinement vertices of the edges in the split directions
+          int normal = TensorCellT::direction( ~midpoint_directions & (TensorCellT::corner_count - 1) );
+          std::size_t facet_id = 0;
+          if (midpoint_count < DimV)
+          {
+            facet_id = static_cast<std::size_t>( cell.facets[normal][(base >> normal) & 1]->id().get() );
+            if ( facet_to_vertex_handle_map.find(facet_id, result) )
+            {
+              nodes[index] = result;
+              node_created[index] = true;
+              return result;
+            }
+          }
+
+          PointType center;
+          std::size_t edge_count = 0;
+          for (int edge_base = 0; edge_base < TensorCellT::corner_count; ++edge_base)
+          {
+            if ( (edge_base & ~midpoint_directions) != base )
+              continue;
+            for (int d = 0; d < DimV; ++d)
+              if ( (midpoint_directions & (1 << d)) && !(edge_base & (1 << d)) )
+              {
+                PointType const & p = viennagrid::point( mesh, edge_to_vertex_handle_accessor(*cell.edges[edge_base][d]) );
+                center = (edge_count == 0) ? p : center + p;
+                ++edge_count;
+              }
+          }
+          center /= static_cast<typename viennagrid::result_of::coord<PointType>::type>(edge_count);
+
+          result = viennagrid::make_vertex(mesh, center);
+          if (midpoint_count < DimV)
+            facet_to_vertex_handle_map.insert(facet_id, result);
+        }
+
+        nodes[index] = result;
+        node_created[index] = true;
+        return result;
+      }
+
+
+      /** @brief Public entry function for the refinement of a quadrilateral or a hexahedron.
+       *
+       * @param element_in                        The cell to be refined
+       * @param mesh                              The mesh the refined cells are written to, new vertices at facet and cell centers are created in this mesh
+       * @param elements_vertices                 Container the vertex handles of the refined cells are written to
+       * @param vertex_copy_map_                  Temporary accessor for vertex to vertex mapping
+       * @param edge_refinement_flag_accessor     Accessor storing flags if an edge is marked for refinement
+       * @param edge_to_vertex_handle_accessor    Temporary accessor for refined edge to vertex mapping
+       * @param facet_to_vertex_handle_map        Temporary map for refined facet to vertex mapping
+       */
+      template<typename ElementT, typename MeshT,
+               typename ElementsVerticesHandleContainerT, typename VertexCopyMapT,
+               typename EdgeRefinementFlagAccessor, typename EdgeToVertexHandleAccessor, typename FacetToVertexHandleMapT>
+      static void apply(ElementT const & element_in, MeshT & mesh,
+                        ElementsVerticesHandleContainerT & elements_vertices,
+                        VertexCopyMapT & vertex_copy_map_,
+                        EdgeRefinementFlagAccessor const & edge_refinement_flag_accessor,
+                        EdgeToVertexHandleAccessor const & edge_to_vertex_handle_accessor,
+                        FacetToVertexHandleMapT & facet_to_vertex_handle_map)
+      {
+        typedef tensor_cell<ElementT, DimV>                                     TensorCellType;
+        typedef typename viennagrid::result_of::vertex_handle<MeshT>::type      VertexHandleType;
+
+        TensorCellType cell(element_in);
+
+        bool split[DimV];
+        for (int d = 0; d < DimV; ++d)
+          split[d] = cell.is_split(d, edge_refinement_flag_accessor);
+
+        // lattice nodes with the local coordinates 0, 1 and 2 in each direction
+        VertexHandleType nodes[DimV == 2 ? 9 : 27];
+        bool node_created[DimV == 2 ? 9 : 27];
+        std::fill(node_created, node_created + (DimV == 2 ? 9 : 27), false);
+
+        for (int child = 0; child < TensorCellType::corner_count; ++child)
+        {
+          bool is_child = true;
+          for (int d = 0; d < DimV; ++d)
+            if ( !split[d] && (child & (1 << d)) )
+              is_child = false;
+          if (!is_child)
+            continue;
+
+          elements_vertices.resize( elements_vertices.size()+1 );
+          elements_vertices.back().resize( TensorCellType::corner_count );
+
+          for (int corner = 0; corner < TensorCellType::corner_count; ++corner)
+          {
+            int coordinates[DimV];
+            for (int d = 0; d < DimV; ++d)
+            {
+              int bit = (corner >> d) & 1;
+              coordinates[d] = split[d] ? ((child >> d) & 1) + bit : 2 * bit;
+            }
+
+            elements_vertices.back()[static_cast<std::size_t>(corner)] = node(cell, mesh, coordinates, nodes, node_created,
+                                                                              vertex_copy_map_, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map);
+          }
+        }
+      }
+    };
+
+
+    /** @brief Specialization of the refinement class for a quadrilateral. The quadrilateral is split into two halves if both edges of one direction are flagged and into four quadrilaterals if all edges are flagged. */
+    template<>
+    struct element_refinement<quadrilateral_tag> : public tensor_cell_refinement<2> {};
+
+  } // namespace detail
 }
 
 #endif
-
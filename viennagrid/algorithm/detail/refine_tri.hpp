@@ -342,15 +342,18 @@ namespace viennagrid
        * @param edge_refinement_flag_accessor     Accessor storing flags if an edge is marked for refinement
        * @param vertex_copy_map_                  Temporary accessor for vertex to vertex mapping
        * @param edge_to_vertex_handle_accessor    Temporary accessor for refined edge to vertex mapping
+       * @param facet_to_vertex_handle_map        Unused, the refinement of simplices creates no vertices on facets
        */
       template<typename ElementT, typename MeshT,
                typename ElementsVerticesHandleContainerT, typename VertexCopyMapT,
-               typename EdgeRefinementFlagAccessor, typename EdgeToVertexHandleAccessor>
+               typename EdgeRefinementFlagAccessor, typename EdgeToVertexHandleAccessor,
+               typename FacetToVertexHandleMapT>
       static void apply(ElementT const & element_in, MeshT const & mesh,
                         ElementsVerticesHandleContainerT & elements_vertices,
                         VertexCopyMapT & vertex_copy_map_,
                         EdgeRefinementFlagAccessor const & edge_refinement_flag_accessor,
-                        EdgeToVertexHandleAccessor const & edge_to_vertex_handle_accessor)
+                        EdgeToVertexHandleAccessor const & edge_to_vertex_handle_accessor,
+                        FacetToVertexHandleMapT &)
       {
         typedef typename viennagrid::result_of::const_element_range<ElementT, viennagrid::line_tag>::type            EdgeOnCellRange;
         typedef typename viennagrid::result_of::iterator<EdgeOnCellRange>::type                 EdgeOnCellIterator;
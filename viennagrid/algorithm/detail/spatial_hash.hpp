@@ -0,0 +1,172 @@
+#ifndef VIENNAGRID_ALGORITHM_DETAIL_SPATIAL_HASH_HPP
+#define VIENNAGRID_ALGORITHM_DETAIL_SPATIAL_HASH_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#include "viennagrid/algorithm/norm.hpp"
+
+/** @file viennagrid/algorithm/detail/spatial_hash.hpp
+    @brief A uniform hash grid for fast point proximity queries
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+    /** @brief A uniform grid of cubic cells with edge length 'cell_size' which is hashed into a flat bucket array. Used for finding points within a given tolerance in O(1) on average.
+      *
+      * Entries are chained through indices in a single array, hence no memory is allocated per inserted point.
+      *
+      * @tparam PointT     The point type
+      * @tparam ValueT     The value stored together with each point, usually a vertex handle
+      */
+    template<typename PointT, typename ValueT>
+    class spatial_hash
+    {
+      typedef typename viennagrid::result_of::coord<PointT>::type NumericType;
+
+      struct entry
+      {
+        entry(PointT const & p, ValueT const & v, std::size_t n) : point(p), value(v), next(n) {}
+
+        PointT point;
+        ValueT value;
+        std::size_t next;
+      };
+
+      static std::size_t invalid_index() { return static_cast<std::size_t>(-1); }
+
+    public:
+      spatial_hash() : cell_size_(0) {}
+
+      /** @brief Clears the grid and sets the cell size. Points within distance 'cell_size' are guaranteed to be found by find().
+        *
+        * @param  cell_size             The edge length of a grid cell, has to be greater than zero
+        * @param  expected_size         The expected number of points, used for presizing the bucket array
+        */
+      void init(NumericType cell_size, std::size_t expected_size = 0)
+      {
+        cell_size_ = cell_size;
+        entries_.clear();
+        entries_.reserve(expected_size);
+
+        std::size_t bucket_count = 64;
+        while (bucket_count < 2*expected_size)
+          bucket_count *= 2;
+        heads_.assign(bucket_count, invalid_index());
+      }
+
+      /** @brief Returns the cell size of the grid, zero if the grid was not initialized */
+      NumericType cell_size() const { return cell_size_; }
+
+      /** @brief Returns the number of points in the grid */
+      std::size_t size() const { return entries_.size(); }
+
+      /** @brief Inserts a point together with its value */
+      void insert(PointT const & p, ValueT const & value)
+      {
+        if (entries_.size() >= heads_.size())
+          rehash( heads_.empty() ? 64 : 2*heads_.size() );
+
+        std::size_t bucket = bucket_index(p, 0, 0, 0);
+        entries_.push_back( entry(p, value, heads_[bucket]) );
+        heads_[bucket] = entries_.size()-1;
+      }
+
+      /** @brief Searches for a point which is closer than 'tolerance' to p. Returns true and writes the value of the first point found to 'result' on success.
+        *
+        * @param  p                     The query point
+        * @param  tolerance             The search radius, must not be larger than the cell size
+        * @param  result                Output: the value of a point within the search radius
+        */
+      bool find(PointT const & p, NumericType tolerance, ValueT & result) const
+      {
+        if (entries_.empty())
+          return false;
+
+        int dim = static_cast<int>(p.size());
+        int range_y = dim > 1 ? 1 : 0;
+        int range_z = dim > 2 ? 1 : 0;
+
+        for (int dz = -range_z; dz <= range_z; ++dz)
+          for (int dy = -range_y; dy <= range_y; ++dy)
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+              for (std::size_t i = heads_[bucket_index(p, dx, dy, dz)]; i != invalid_index(); i = entries_[i].next)
+              {
+                if (viennagrid::norm_2(p - entries_[i].point) < tolerance)
+                {
+                  result = entries_[i].value;
+                  return true;
+                }
+              }
+            }
+
+        return false;
+      }
+
+    private:
+
+      /** @brief Returns the grid cell coordinate of a point. Coordinates outside the range of long (and NaN) are clamped, such that the cast is well-defined and neighbor offsets do not overflow. */
+      long cell_coordinate(PointT const & p, std::size_t index) const
+      {
+        NumericType limit = static_cast<NumericType>( std::numeric_limits<long>::max() / 2 );
+        NumericType c = std::floor(p[index] / cell_size_);
+
+        if (c != c)
+          return 0;
+        if (c > limit)
+          return std::numeric_limits<long>::max() / 2;
+        if (c < -limit)
+          return -(std::numeric_limits<long>::max() / 2);
+        return static_cast<long>(c);
+      }
+
+      std::size_t bucket_index(PointT const & p, int dx, int dy, int dz) const
+      {
+        std::size_t dim = p.size();
+
+        std::size_t h = static_cast<std::size_t>( cell_coordinate(p, 0) + dx ) * 73856093u;
+        if (dim > 1)
+          h ^= static_cast<std::size_t>( cell_coordinate(p, 1) + dy ) * 19349663u;
+        if (dim > 2)
+          h ^= static_cast<std::size_t>( cell_coordinate(p, 2) + dz ) * 83492791u;
+
+        return h & (heads_.size()-1);
+      }
+
+      void rehash(std::size_t bucket_count)
+      {
+        heads_.assign(bucket_count, invalid_index());
+        for (std::size_t i = 0; i < entries_.size(); ++i)
+        {
+          std::size_t bucket = bucket_index(entries_[i].point, 0, 0, 0);
+          entries_[i].next = heads_[bucket];
+          heads_[bucket] = i;
+        }
+      }
+
+      NumericType cell_size_;
+      std::vector<std::size_t> heads_;
+      std::vector<entry> entries_;
+    };
+
+  }
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef VIENNAGRID_ALGORITHM_DETAIL_THREAD_PARTIALS_HPP
+#define VIENNAGRID_ALGORITHM_DETAIL_THREAD_PARTIALS_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <cstddef>
+
+#ifdef VIENNAGRID_WITH_OPENMP
+  #include <omp.h>
+#endif
+
+/** @file viennagrid/algorithm/detail/thread_partials.hpp
+    @brief Parallel accumulation into per-thread partial arrays, which are merged in thread order
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+    /** @brief For internal use only. Accumulates the contributions of items (e.g. cells) into arrays of entries (e.g. indexed by element IDs) in parallel.
+      *
+      * Each thread accumulates a contiguous range of items into its own partial arrays of 'stride' entries, which are stored one after the other in arrays of size() entries allocated by the caller.
+      * Afterwards, the partial arrays of all threads are merged into the first one in thread order, hence the result does not depend on thread scheduling.
+      * It does depend on the number of threads if merging is not exact, e.g. for sums of floating point values. Without VIENNAGRID_WITH_OPENMP, there is one partial array only.
+      */
+    class thread_partials
+    {
+    public:
+      explicit thread_partials(std::size_t stride_) : stride(stride_)
+      {
+#ifdef VIENNAGRID_WITH_OPENMP
+        thread_count = omp_get_max_threads();
+#else
+        thread_count = 1;
+#endif
+      }
+
+      /** @brief Returns the number of entries of the partial arrays of all threads */
+      std::size_t size() const { return static_cast<std::size_t>(thread_count) * stride; }
+
+      /** @brief Calls kernel(item, offset) for all items in [0, item_count), where 'offset' is the position of the partial array of the calling thread */
+      template<typename KernelT>
+      void accumulate(std::size_t item_count, KernelT const & kernel) const
+      {
+        long count = static_cast<long>(item_count);
+
+#ifdef VIENNAGRID_WITH_OPENMP
+        #pragma omp parallel num_threads(thread_count)
+#endif
+        {
+#ifdef VIENNAGRID_WITH_OPENMP
+          std::size_t offset = static_cast<std::size_t>(omp_get_thread_num()) * stride;
+#else
+          std::size_t offset = 0;
+#endif
+
+#ifdef VIENNAGRID_WITH_OPENMP
+          #pragma omp for schedule(static)
+#endif
+          for (long i = 0; i < count; ++i)
+            kernel(static_cast<std::size_t>(i), offset);
+        }
+      }
+
+      /** @brief Calls merger(index, partial_index) for each entry of the first partial array and the corresponding entries of the other threads in thread order */
+      template<typename MergerT>
+      void merge(MergerT const & merger) const
+      {
+        if (thread_count < 2)
+          return;
+
+        long count = static_cast<long>(stride);
+#ifdef VIENNAGRID_WITH_OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for (long i = 0; i < count; ++i)
+          for (int t = 1; t < thread_count; ++t)
+            merger(static_cast<std::size_t>(i), static_cast<std::size_t>(t) * stride + static_cast<std::size_t>(i));
+      }
+
+    private:
+      std::size_t stride;
+      int thread_count;
+    };
+
+
+    /** @brief For internal use only. Merges partial arrays by summation. */
+    template<typename ValueT>
+    class thread_partials_sum
+    {
+    public:
+      explicit thread_partials_sum(std::vector<ValueT> & values_) : values(values_) {}
+
+      void operator()(std::size_t index, std::size_t partial_index) const { values[index] += values[partial_index]; }
+
+    private:
+      std::vector<ValueT> & values;
+    };
+  }
+}
+
+#endif
@@ -13,6 +13,10 @@
    License:      MIT (X11), see file LICENSE in the base directory
 ======================================================================= */
 
+#include <map>
+#include <vector>
+#include <algorithm>
+
 #include "viennagrid/mesh/element_creation.hpp"
 #include "viennagrid/mesh/mesh_operations.hpp"
 #include "viennagrid/algorithm/boundary.hpp"
@@ -75,6 +79,110 @@ namespace viennagrid
   }
 
 
+  namespace detail
+  {
+    /** @brief For internal use only. Lexicographical order of point lists, used for identifying hull elements by the coordinates of their vertices. */
+    struct point_list_less
+    {
+      template<typename PointListT>
+      bool operator()(PointListT const & lhs, PointListT const & rhs) const
+      {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), viennagrid::point_less());
+      }
+    };
+  }
+
+
+  /** @brief Extracts the hull of a mesh which is given as a sequence of pieces, e.g. the pieces of a multi-piece VTK dataset streamed by viennagrid::io::stream_vtk_pieces().
+   *
+   * The pieces are not kept in memory. Each piece contributes the elements on its boundary, which are identified by the coordinates of their vertices.
+   * A boundary element shared by two pieces is an interface between them and is dropped, thus only the open boundary of the pieces seen so far is kept in memory.
+   * Call finish() after the last piece for creating the hull mesh.
+   *
+   * @tparam HullTypeOrTagT                The type or tag of the hull element
+   * @tparam HullMeshT                     The type of the output hull mesh
+   */
+  template<typename HullTypeOrTagT, typename HullMeshT>
+  class boundary_stream_extractor
+  {
+    typedef typename viennagrid::result_of::point<HullMeshT>::type                          PointType;
+    typedef std::vector<PointType>                                                          PointListType;
+    typedef std::map<PointListType, PointListType, viennagrid::detail::point_list_less>    OpenElementMapType;
+
+  public:
+
+    /** @brief Adds the boundary elements of a piece. Boundary elements matching an open boundary element of a previous piece are removed.
+     *
+     * @param piece_mesh    The mesh of the piece
+     */
+    template<typename VolumeMeshT>
+    void operator()(VolumeMeshT const & piece_mesh)
+    {
+      typedef typename viennagrid::result_of::const_element_range<VolumeMeshT, HullTypeOrTagT>::type    HullRangeType;
+      typedef typename viennagrid::result_of::iterator<HullRangeType>::type                             HullRangeIterator;
+      typedef typename viennagrid::result_of::element<VolumeMeshT, HullTypeOrTagT>::type                VolumeHullElement;
+
+      HullRangeType hull_elements( piece_mesh );
+      for (HullRangeIterator hit = hull_elements.begin(); hit != hull_elements.end(); ++hit)
+      {
+        VolumeHullElement const & hull_element = *hit;
+
+        if ( !viennagrid::is_boundary( piece_mesh, hull_element ) )
+          continue;
+
+        PointListType points( viennagrid::vertices(hull_element).size() );
+        for (std::size_t i = 0; i < points.size(); ++i)
+          points[i] = viennagrid::point( viennagrid::vertices(hull_element)[i] );
+
+        PointListType key = points;
+        std::sort( key.begin(), key.end(), viennagrid::point_less() );
+
+        typename OpenElementMapType::iterator it = open_elements_.find(key);
+        if (it != open_elements_.end())
+          open_elements_.erase(it);
+        else
+          open_elements_.insert( std::make_pair(key, points) );
+      }
+    }
+
+    /** @brief Returns the number of boundary elements which are not matched by another piece so far */
+    std::size_t open_element_count() const { return open_elements_.size(); }
+
+    /** @brief Creates the hull mesh from the open boundary elements of all pieces
+     *
+     * @param hull_mesh    The output hull mesh
+     */
+    void finish(HullMeshT & hull_mesh) const
+    {
+      typedef typename viennagrid::result_of::vertex_handle<HullMeshT>::type HullVertexHandleType;
+      typedef typename viennagrid::result_of::element<HullMeshT, HullTypeOrTagT>::type HullHullElement;
+
+      viennagrid::clear(hull_mesh);
+
+      std::map<PointType, HullVertexHandleType, viennagrid::point_less> vertex_map;
+
+      for (typename OpenElementMapType::const_iterator it = open_elements_.begin(); it != open_elements_.end(); ++it)
+      {
+        PointListType const & points = it->second;
+
+        std::vector<HullVertexHandleType> vertices( points.size() );
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+          typename std::map<PointType, HullVertexHandleType, viennagrid::point_less>::iterator vit = vertex_map.find( points[i] );
+          if (vit == vertex_map.end())
+            vit = vertex_map.insert( std::make_pair(points[i], viennagrid::make_vertex(hull_mesh, points[i])) ).first;
+          vertices[i] = vit->second;
+        }
+
+        viennagrid::make_element<HullHullElement>( hull_mesh, vertices.begin(), vertices.end() );
+      }
+    }
+
+  private:
+    OpenElementMapType open_elements_;
+  };
+
+
   /** @brief Extracts the hull of mesh and a segmentation using viennagrid::boundary, e.g. the triangular hull of a tetrahedral mesh.
    *
    * @tparam HullTypeOrTagT                The type or tag of the hull element
@@ -0,0 +1,285 @@
+#ifndef VIENNAGRID_ALGORITHM_HALO_EXCHANGE_HPP
+#define VIENNAGRID_ALGORITHM_HALO_EXCHANGE_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <map>
+#include <deque>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+#include <stdexcept>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/algorithm/partition.hpp"
+
+/** @file viennagrid/algorithm/halo_exchange.hpp
+    @brief Descriptors for the exchange of values of ghost elements between the parts of a partitioned mesh
+*/
+
+namespace viennagrid
+{
+  /** @brief The send and receive lists of one kind of elements (vertices or cells) of one part.
+    *
+    * For each neighbor part, 'send' holds the local IDs of the owned elements which are ghosts in the neighbor part and 'receive' the local IDs of the ghost elements owned by the neighbor part.
+    * Both lists are ordered by global IDs, hence the send list of a part matches the receive list of the neighbor part element by element.
+    */
+  struct halo_lists
+  {
+    typedef std::map< std::size_t, std::vector<std::size_t> > index_map_type;
+
+    /** @brief The number of the part these lists belong to */
+    std::size_t part;
+
+    index_map_type send;
+    index_map_type receive;
+  };
+
+
+  /** @brief The ownership information and the halo lists of one part of a partitioned mesh */
+  class halo_descriptor
+  {
+  public:
+    /** @brief Returns the number of the part */
+    std::size_t part() const { return vertex_lists_.part; }
+
+    /** @brief Returns true if the vertex with the given local ID is owned by this part */
+    bool is_owned_vertex(std::size_t local_id) const { return owned_vertices_[local_id] != 0; }
+    /** @brief Returns true if the cell with the given local ID is owned by this part */
+    bool is_owned_cell(std::size_t local_id) const { return owned_cells_[local_id] != 0; }
+
+    /** @brief Returns the send and receive lists for vertices */
+    halo_lists const & vertex_lists() const { return vertex_lists_; }
+    /** @brief Returns the send and receive lists for cells */
+    halo_lists const & cell_lists() const { return cell_lists_; }
+
+    /** @brief Returns the parts exchanging vertices or cells with this part */
+    std::vector<std::size_t> neighbors() const
+    {
+      std::vector<std::size_t> result;
+      add_neighbors(vertex_lists_.send, result);
+      add_neighbors(vertex_lists_.receive, result);
+      add_neighbors(cell_lists_.send, result);
+      add_neighbors(cell_lists_.receive, result);
+      std::sort(result.begin(), result.end());
+      result.erase( std::unique(result.begin(), result.end()), result.end() );
+      return result;
+    }
+
+  private:
+    template<typename SubmeshT>
+    friend void make_halo_descriptors(std::vector<SubmeshT> const &, std::vector<halo_descriptor> &);
+
+    static void add_neighbors(halo_lists::index_map_type const & lists, std::vector<std::size_t> & result)
+    {
+      for (halo_lists::index_map_type::const_iterator it = lists.begin(); it != lists.end(); ++it)
+        result.push_back(it->first);
+    }
+
+    std::vector<char> owned_vertices_;
+    std::vector<char> owned_cells_;
+
+    halo_lists vertex_lists_;
+    halo_lists cell_lists_;
+  };
+
+
+  /** @brief Creates the halo descriptors for all parts of a partitioned mesh.
+    *
+    * @param submeshes            The submeshes of all parts, e.g. obtained from viennagrid::extract_submeshes()
+    * @param halos                The resulting descriptors, one for each part
+    */
+  template<typename SubmeshT>
+  void make_halo_descriptors(std::vector<SubmeshT> const & submeshes, std::vector<halo_descriptor> & halos)
+  {
+    halos.clear();
+    halos.resize( submeshes.size() );
+
+    for (std::size_t part = 0; part < submeshes.size(); ++part)
+    {
+      halos[part].vertex_lists_.part = part;
+      halos[part].cell_lists_.part = part;
+    }
+
+    for (std::size_t part = 0; part < submeshes.size(); ++part)
+    {
+      SubmeshT const & sub = submeshes[part];
+      halo_descriptor & halo = halos[part];
+
+      std::size_t vertex_count = viennagrid::vertices(sub.mesh()).size();
+      halo.owned_vertices_.resize(vertex_count);
+      for (std::size_t i = 0; i < vertex_count; ++i)
+      {
+        std::size_t owner = sub.vertex_owner(i);
+        halo.owned_vertices_[i] = (owner == part) ? 1 : 0;
+        if (owner == part)
+          continue;
+
+        // the owner sends the value of the vertex, which is received in the order of the global IDs
+        std::size_t owner_local_id = submeshes[owner].local_vertex_id( sub.global_vertex_id(i) );
+        assert(owner_local_id != SubmeshT::invalid_id());
+        halo.vertex_lists_.receive[owner].push_back(i);
+        halos[owner].vertex_lists_.send[part].push_back(owner_local_id);
+      }
+
+      std::size_t cell_count = viennagrid::cells(sub.mesh()).size();
+      halo.owned_cells_.resize(cell_count);
+      for (std::size_t i = 0; i < cell_count; ++i)
+      {
+        std::size_t owner = sub.cell_owner(i);
+        halo.owned_cells_[i] = (owner == part) ? 1 : 0;
+        if (owner == part)
+          continue;
+
+        std::size_t owner_local_id = submeshes[owner].local_cell_id( sub.global_cell_id(i) );
+        assert(owner_local_id != SubmeshT::invalid_id());
+        halo.cell_lists_.receive[owner].push_back(i);
+        halos[owner].cell_lists_.send[part].push_back(owner_local_id);
+      }
+    }
+  }
+
+
+
+  /** @brief A transport passing messages between parts within one process, e.g. for testing or for running all parts in one process.
+    *
+    * A transport provides send(source, destination, data) and receive(destination, source, data) for std::vector of any value type.
+    * Messages between two parts are received in the order they were sent. A transport for distributed runs wraps the respective message passing library in the same interface.
+    * The local transport copies the values bytewise, hence the value type has to be a plain old data type.
+    */
+  class local_transport
+  {
+  public:
+    /** @brief Sends a message from part 'source' to part 'destination' */
+    template<typename ValueT>
+    void send(std::size_t source, std::size_t destination, std::vector<ValueT> const & data)
+    {
+      std::deque< std::vector<char> > & queue = messages_[ std::make_pair(source, destination) ];
+      queue.push_back( std::vector<char>(data.size() * sizeof(ValueT)) );
+      if (!data.empty())
+        std::memcpy( &queue.back()[0], &data[0], data.size() * sizeof(ValueT) );
+    }
+
+    /** @brief Receives the next message sent from part 'source' to part 'destination'. Throws std::runtime_error if there is no such message. */
+    template<typename ValueT>
+    void receive(std::size_t destination, std::size_t source, std::vector<ValueT> & data)
+    {
+      std::deque< std::vector<char> > & queue = messages_[ std::make_pair(source, destination) ];
+      if (queue.empty())
+        throw std::runtime_error("local_transport::receive(): no message has been sent!");
+
+      data.resize( queue.front().size() / sizeof(ValueT) );
+      if (!data.empty())
+        std::memcpy( &data[0], &queue.front()[0], data.size() * sizeof(ValueT) );
+      queue.pop_front();
+    }
+
+    /** @brief Returns the number of messages sent but not yet received */
+    std::size_t pending() const
+    {
+      std::size_t count = 0;
+      for (message_map_type::const_iterator it = messages_.begin(); it != messages_.end(); ++it)
+        count += it->second.size();
+      return count;
+    }
+
+  private:
+    typedef std::map< std::pair<std::size_t, std::size_t>, std::deque< std::vector<char> > > message_map_type;
+    message_map_type messages_;
+  };
+
+
+
+  /** @brief Gathers the values of all owned elements which are ghosts in neighbor parts and sends them, one message per neighbor.
+    *
+    * @param lists                The halo lists of the part, e.g. halo.vertex_lists()
+    * @param values               The values of the part indexed by the local ID, e.g. a std::vector
+    * @param transport            The transport, e.g. viennagrid::local_transport
+    */
+  template<typename ContainerT, typename TransportT>
+  void halo_send(halo_lists const & lists, ContainerT const & values, TransportT & transport)
+  {
+    typedef typename ContainerT::value_type ValueType;
+
+    std::vector<ValueType> buffer;
+    for (halo_lists::index_map_type::const_iterator it = lists.send.begin(); it != lists.send.end(); ++it)
+    {
+      std::vector<std::size_t> const & indices = it->second;
+      buffer.resize( indices.size() );
+      for (std::size_t i = 0; i < indices.size(); ++i)
+        buffer[i] = values[ indices[i] ];
+      transport.send(lists.part, it->first, buffer);
+    }
+  }
+
+  /** @brief Receives the values of all ghost elements from their owners and scatters them.
+    *
+    * Throws std::runtime_error if the size of a message does not match the receive list, e.g. if the halo lists of the parts do not belong together.
+    *
+    * @param lists                The halo lists of the part, e.g. halo.vertex_lists()
+    * @param values               The values of the part indexed by the local ID, e.g. a std::vector
+    * @param transport            The transport, e.g. viennagrid::local_transport
+    */
+  template<typename ContainerT, typename TransportT>
+  void halo_receive(halo_lists const & lists, ContainerT & values, TransportT & transport)
+  {
+    typedef typename ContainerT::value_type ValueType;
+
+    std::vector<ValueType> buffer;
+    for (halo_lists::index_map_type::const_iterator it = lists.receive.begin(); it != lists.receive.end(); ++it)
+    {
+      std::vector<std::size_t> const & indices = it->second;
+      transport.receive(lists.part, it->first, buffer);
+      if (buffer.size() != indices.size())
+        throw std::runtime_error("halo_receive(): size of the message does not match the receive list!");
+      for (std::size_t i = 0; i < indices.size(); ++i)
+        values[ indices[i] ] = buffer[i];
+    }
+  }
+
+
+  /** @brief Updates the values of the ghost vertices of all parts within one process.
+    *
+    * @param halos                The halo descriptors of all parts
+    * @param values               The values of each part indexed by the local vertex ID
+    * @param transport            The transport, e.g. viennagrid::local_transport
+    */
+  template<typename ContainerT, typename TransportT>
+  void update_vertex_halos(std::vector<halo_descriptor> const & halos, std::vector<ContainerT> & values, TransportT & transport)
+  {
+    for (std::size_t part = 0; part < halos.size(); ++part)
+      halo_send(halos[part].vertex_lists(), values[part], transport);
+    for (std::size_t part = 0; part < halos.size(); ++part)
+      halo_receive(halos[part].vertex_lists(), values[part], transport);
+  }
+
+  /** @brief Updates the values of the ghost cells of all parts within one process.
+    *
+    * @param halos                The halo descriptors of all parts
+    * @param values               The values of each part indexed by the local cell ID
+    * @param transport            The transport, e.g. viennagrid::local_transport
+    */
+  template<typename ContainerT, typename TransportT>
+  void update_cell_halos(std::vector<halo_descriptor> const & halos, std::vector<ContainerT> & values, TransportT & transport)
+  {
+    for (std::size_t part = 0; part < halos.size(); ++part)
+      halo_send(halos[part].cell_lists(), values[part], transport);
+    for (std::size_t part = 0; part < halos.size(); ++part)
+      halo_receive(halos[part].cell_lists(), values[part], transport);
+  }
+
+}
+
+#endif
@@ -0,0 +1,346 @@
+#ifndef VIENNAGRID_ALGORITHM_HANGING_VERTICES_HPP
+#define VIENNAGRID_ALGORITHM_HANGING_VERTICES_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <algorithm>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/mesh/mesh.hpp"
+#include "viennagrid/algorithm/norm.hpp"
+#include "viennagrid/algorithm/detail/refine_quad.hpp"
+
+/** @file viennagrid/algorithm/hanging_vertices.hpp
+    @brief Detection of hanging vertices in locally refined quadrilateral and hexahedral meshes
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+
+    /** @brief A hanging vertex together with the line or facet it hangs on. For internal use only. */
+    template<typename VertexT>
+    struct hanging_vertex_info
+    {
+      VertexT const * vertex;
+      VertexT const * parents[4];
+      std::size_t parent_count;   // 2 for a line, 4 for a facet
+      std::size_t parent_id;      // ID of the line or facet
+    };
+
+    /** @brief Returns true if the point p is the mean of the points of the parent vertices */
+    template<typename MeshT, typename PointT, typename VertexT>
+    bool is_parent_mean(MeshT const & mesh, PointT const & p, VertexT const * const * parents, std::size_t parent_count)
+    {
+      PointT mean = viennagrid::point(mesh, *parents[0]);
+      for (std::size_t i = 1; i < parent_count; ++i)
+        mean += viennagrid::point(mesh, *parents[i]);
+      mean /= static_cast<typename viennagrid::result_of::coord<PointT>::type>(parent_count);
+
+      return viennagrid::norm_2(p - mean) <= 1e-8 * viennagrid::norm_2( viennagrid::point(mesh, *parents[0]) - viennagrid::point(mesh, *parents[parent_count-1]) );
+    }
+
+    /** @brief Vertices hanging on facets, only for hexahedral meshes. For internal use only. */
+    template<typename MeshT, typename VertexT, typename CellTagT>
+    void find_facet_hanging_vertices(MeshT const &, std::vector<VertexT const *> const &, std::vector< std::vector<std::size_t> > const &,
+                                     std::vector<VertexT const *> const &, std::vector< hanging_vertex_info<VertexT> > &, CellTagT) {}
+
+    /** @brief Finds the vertices hanging on the quadrilateral facets of a hexahedral mesh: a vertex hangs on a facet if it is connected to the vertices hanging on two lines of the facet and located at the facet center. For internal use only. */
+    template<typename MeshT, typename VertexT>
+    void find_facet_hanging_vertices(MeshT const & mesh,
+                                     std::vector<VertexT const *> const & vertex_by_id,
+                                     std::vector< std::vector<std::size_t> > const & adjacent,
+                                     std::vector<VertexT const *> const & hanging_on_line,
+                                     std::vector< hanging_vertex_info<VertexT> > & result,
+                                     hexahedron_tag)
+    {
+      typedef typename viennagrid::result_of::point<MeshT>::type                         PointType;
+      typedef typename viennagrid::result_of::facet<MeshT>::type                         FacetType;
+      typedef typename viennagrid::result_of::const_facet_range<MeshT>::type             FacetRangeType;
+      typedef typename viennagrid::result_of::iterator<FacetRangeType>::type             FacetIteratorType;
+      typedef typename viennagrid::result_of::const_line_range<FacetType>::type          LineOnFacetRangeType;
+      typedef typename viennagrid::result_of::iterator<LineOnFacetRangeType>::type       LineOnFacetIteratorType;
+      typedef typename viennagrid::result_of::const_vertex_range<FacetType>::type        VertexOnFacetRangeType;
+
+      FacetRangeType facets(mesh);
+      for (FacetIteratorType fit = facets.begin(); fit != facets.end(); ++fit)
+      {
+        VertexOnFacetRangeType vertices_on_facet(*fit);
+        if (vertices_on_facet.size() != 4)
+          continue;
+
+        hanging_vertex_info<VertexT> info;
+        info.parent_count = 4;
+        info.parent_id = static_cast<std::size_t>( (*fit).id().get() );
+        for (std::size_t i = 0; i < 4; ++i)
+          info.parents[i] = &vertices_on_facet[i];
+        info.vertex = NULL;
+
+        LineOnFacetRangeType lines_on_facet(*fit);
+        for (LineOnFacetIteratorType l0 = lines_on_facet.begin(); l0 != lines_on_facet.end() && !info.vertex; ++l0)
+          for (LineOnFacetIteratorType l1 = l0; l1 != lines_on_facet.end() && !info.vertex; ++l1)
+          {
+            VertexT const * m0 = hanging_on_line[ static_cast<std::size_t>((*l0).id().get()) ];
+            VertexT const * m1 = hanging_on_line[ static_cast<std::size_t>((*l1).id().get()) ];
+            if (!m0 || !m1 || m0 == m1)
+              continue;
+
+            // the center is adjacent to the vertices hanging on two opposite lines
+            std::vector<std::size_t> const & adjacent_0 = adjacent[ static_cast<std::size_t>(m0->id().get()) ];
+            std::vector<std::size_t> const & adjacent_1 = adjacent[ static_cast<std::size_t>(m1->id().get()) ];
+            for (std::size_t i = 0; i < adjacent_0.size(); ++i)
+            {
+              VertexT const * candidate = vertex_by_id[ adjacent_0[i] ];
+              PointType const & p = viennagrid::point(mesh, *candidate);
+              if ( std::binary_search(adjacent_1.begin(), adjacent_1.end(), adjacent_0[i]) && is_parent_mean(mesh, p, info.parents, 4) )
+              {
+                info.vertex = candidate;
+                break;
+              }
+            }
+          }
+
+        if (info.vertex)
+          result.push_back(info);
+      }
+    }
+
+    /** @brief Finds all vertices of a quadrilateral or hexahedral mesh which hang on a line or facet. For internal use only.
+     *
+     * A vertex m hangs on the line [a, b] if the lines [a, m] and [m, b] exist and m is the midpoint of [a, b].
+     */
+    template<typename MeshT, typename VertexT>
+    void find_hanging_vertices(MeshT const & mesh, std::vector< hanging_vertex_info<VertexT> > & result)
+    {
+      typedef typename viennagrid::result_of::line<MeshT>::type                          LineType;
+
+      typedef typename viennagrid::result_of::const_vertex_range<MeshT>::type            VertexRangeType;
+      typedef typename viennagrid::result_of::iterator<VertexRangeType>::type            VertexIteratorType;
+      typedef typename viennagrid::result_of::const_line_range<MeshT>::type              LineRangeType;
+      typedef typename viennagrid::result_of::iterator<LineRangeType>::type              LineIteratorType;
+
+      result.clear();
+
+      std::vector<VertexT const *> vertex_by_id( static_cast<std::size_t>(viennagrid::id_upper_bound<VertexT>(mesh).get()), NULL );
+      VertexRangeType vertices(mesh);
+      for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+        vertex_by_id[ static_cast<std::size_t>((*vit).id().get()) ] = &*vit;
+
+      // vertex adjacency, sorted for binary search
+      std::vector< std::vector<std::size_t> > adjacent( vertex_by_id.size() );
+      LineRangeType lines(mesh);
+      for (LineIteratorType lit = lines.begin(); lit != lines.end(); ++lit)
+      {
+        std::size_t a = static_cast<std::size_t>( viennagrid::vertices(*lit)[0].id().get() );
+        std::size_t b = static_cast<std::size_t>( viennagrid::vertices(*lit)[1].id().get() );
+        adjacent[a].push_back(b);
+        adjacent[b].push_back(a);
+      }
+      for (std::size_t i = 0; i < adjacent.size(); ++i)
+        std::sort(adjacent[i].begin(), adjacent[i].end());
+
+      //
+      // Vertices hanging on lines
+      //
+      std::vector<VertexT const *> hanging_on_line( static_cast<std::size_t>(viennagrid::id_upper_bound<LineType>(mesh).get()), NULL );
+      for (LineIteratorType lit = lines.begin(); lit != lines.end(); ++lit)
+      {
+        hanging_vertex_info<VertexT> info;
+        info.parents[0] = &viennagrid::vertices(*lit)[0];
+        info.parents[1] = &viennagrid::vertices(*lit)[1];
+        info.parent_count = 2;
+        info.parent_id = static_cast<std::size_t>( (*lit).id().get() );
+
+        std::vector<std::size_t> const & adjacent_a = adjacent[ static_cast<std::size_t>(info.parents[0]->id().get()) ];
+        std::vector<std::size_t> const & adjacent_b = adjacent[ static_cast<std::size_t>(info.parents[1]->id().get()) ];
+        for (std::size_t i = 0; i < adjacent_a.size(); ++i)
+        {
+          VertexT const * candidate = vertex_by_id[ adjacent_a[i] ];
+          if ( candidate != info.parents[1] && std::binary_search(adjacent_b.begin(), adjacent_b.end(), adjacent_a[i]) &&
+               is_parent_mean(mesh, viennagrid::point(mesh, *candidate), info.parents, 2) )
+          {
+            info.vertex = candidate;
+            hanging_on_line[info.parent_id] = candidate;
+            result.push_back(info);
+            break;
+          }
+        }
+      }
+
+      find_facet_hanging_vertices(mesh, vertex_by_id, adjacent, hanging_on_line, result, typename viennagrid::result_of::cell_tag<MeshT>::type());
+    }
+
+  } // namespace detail
+
+
+  /** @brief A hanging vertex of a locally refined mesh: a vertex located on a line or facet of a neighbor cell without being a vertex of that cell.
+   *
+   * For a conforming discretization, the value at the hanging vertex is constrained to the mean of the values at the parent vertices,
+   * which are the two end points of the line or the four corners of the quadrilateral facet.
+   */
+  template<typename VertexHandleT>
+  struct hanging_vertex
+  {
+    VertexHandleT vertex;
+    std::vector<VertexHandleT> parents;
+  };
+
+  namespace result_of
+  {
+    /** @brief Metafunction returning the type of a hanging vertex of a mesh */
+    template<typename MeshT>
+    struct hanging_vertex
+    {
+      typedef viennagrid::hanging_vertex<typename viennagrid::result_of::const_vertex_handle<MeshT>::type> type;
+    };
+  }
+
+
+  /** @brief Finds all hanging vertices of a quadrilateral or hexahedral mesh, e.g. after a refinement with viennagrid::element_refine().
+   *
+   * Hanging vertices on lines are reported with two parent vertices, vertices at the center of a quadrilateral facet of a hexahedral mesh with the four corners of the facet.
+   * The parents of a hanging vertex may be hanging vertices themselves (e.g. at the end points of lines hanging on a facet).
+   *
+   * @param mesh                The mesh
+   * @param hanging_vertices    Output: The hanging vertices with their parent vertices
+   */
+  template<typename MeshT>
+  void hanging_vertices(MeshT const & mesh, std::vector<typename viennagrid::result_of::hanging_vertex<MeshT>::type> & hanging_vertices)
+  {
+    typedef typename viennagrid::result_of::vertex<MeshT>::type           VertexType;
+    typedef typename viennagrid::result_of::hanging_vertex<MeshT>::type   HangingVertexType;
+
+    std::vector< detail::hanging_vertex_info<VertexType> > infos;
+    detail::find_hanging_vertices(mesh, infos);
+
+    hanging_vertices.resize( infos.size() );
+    for (std::size_t i = 0; i < infos.size(); ++i)
+    {
+      HangingVertexType & hv = hanging_vertices[i];
+      hv.vertex = viennagrid::handle(mesh, *infos[i].vertex);
+      hv.parents.resize( infos[i].parent_count );
+      for (std::size_t j = 0; j < infos[i].parent_count; ++j)
+        hv.parents[j] = viennagrid::handle(mesh, *infos[i].parents[j]);
+    }
+  }
+
+
+  /** @brief Ensures that refinement of a quadrilateral or hexahedral mesh with hanging vertices leaves at most one hanging vertex per line and facet (1-irregular mesh).
+   *
+   * If a line adjacent to a hanging vertex is flagged for refinement, all cells containing the line or facet the vertex hangs on are split in the directions of that line or facet.
+   * Flags are propagated until no further change occurs. viennagrid::element_refine() applies this automatically to quadrilateral and hexahedral meshes.
+   *
+   * @tparam CellTagIn                        The cell tag of the mesh (quadrilateral_tag or hexahedron_tag)
+   * @param mesh_in                           The mesh to be refined
+   * @param edge_refinement_flag_accessor     Accessor storing flags if an edge is marked for refinement, modified in place
+   */
+  template<typename CellTagIn, typename WrappedMeshConfigInT, typename EdgeRefinementFlagAccessorT>
+  void ensure_hanging_vertex_balance(mesh<WrappedMeshConfigInT> const & mesh_in, EdgeRefinementFlagAccessorT edge_refinement_flag_accessor)
+  {
+    typedef mesh<WrappedMeshConfigInT>                                                          MeshInType;
+    typedef typename viennagrid::result_of::element<MeshInType, vertex_tag>::type               VertexType;
+    typedef typename viennagrid::result_of::element<MeshInType, line_tag>::type                 LineType;
+    typedef typename viennagrid::result_of::element<MeshInType, CellTagIn>::type               CellType;
+    typedef detail::tensor_cell<CellType, CellTagIn::dim>                                       TensorCellType;
+
+    typedef typename viennagrid::result_of::const_line_range<MeshInType>::type                  LineRangeType;
+    typedef typename viennagrid::result_of::iterator<LineRangeType>::type                       LineIteratorType;
+    typedef typename viennagrid::result_of::const_element_range<MeshInType, CellTagIn>::type    CellRangeType;
+    typedef typename viennagrid::result_of::iterator<CellRangeType>::type                       CellIteratorType;
+
+    std::vector< detail::hanging_vertex_info<VertexType> > infos;
+    detail::find_hanging_vertices(mesh_in, infos);
+    if (infos.empty())
+      return;
+
+    std::size_t vertex_id_bound = static_cast<std::size_t>( viennagrid::id_upper_bound<VertexType>(mesh_in).get() );
+
+    // lines adjacent to each vertex
+    std::vector< std::vector<LineType const *> > vertex_lines(vertex_id_bound);
+    LineRangeType lines(mesh_in);
+    for (LineIteratorType lit = lines.begin(); lit != lines.end(); ++lit)
+      for (std::size_t i = 0; i < 2; ++i)
+        vertex_lines[ static_cast<std::size_t>(viennagrid::vertices(*lit)[i].id().get()) ].push_back( &*lit );
+
+    // cells adjacent to each vertex
+    std::vector<TensorCellType> cells;
+    std::vector< std::vector<std::size_t> > vertex_cells(vertex_id_bound);
+    CellRangeType cell_range(mesh_in);
+    cells.reserve( cell_range.size() );
+    for (CellIteratorType cit = cell_range.begin(); cit != cell_range.end(); ++cit)
+    {
+      cells.push_back( TensorCellType(*cit) );
+      for (int i = 0; i < TensorCellType::corner_count; ++i)
+        vertex_cells[ static_cast<std::size_t>(cells.back().corners[i]->id().get()) ].push_back( cells.size()-1 );
+    }
+
+    // for each hanging vertex: the cells containing its parents and the local directions of the parent line or facet
+    std::vector< std::vector< std::pair<std::size_t, int> > > constrained_cells( infos.size() );
+    for (std::size_t i = 0; i < infos.size(); ++i)
+    {
+      std::vector<std::size_t> const & candidates = vertex_cells[ static_cast<std::size_t>(infos[i].parents[0]->id().get()) ];
+      for (std::size_t j = 0; j < candidates.size(); ++j)
+      {
+        TensorCellType const & cell = cells[ candidates[j] ];
+        int first = cell.corner_index( *infos[i].parents[0] );
+        int directions = 0;
+        bool contains_parents = true;
+        for (std::size_t k = 1; k < infos[i].parent_count && contains_parents; ++k)
+        {
+          int index = cell.corner_index( *infos[i].parents[k] );
+          contains_parents = (index < TensorCellType::corner_count);
+          directions |= (index ^ first);
+        }
+        if (contains_parents)
+          constrained_cells[i].push_back( std::make_pair(candidates[j], directions) );
+      }
+    }
+
+    bool something_changed = true;
+    while (something_changed)
+    {
+      something_changed = false;
+
+      for (std::size_t i = 0; i < infos.size(); ++i)
+      {
+        std::vector<LineType const *> const & adjacent_lines = vertex_lines[ static_cast<std::size_t>(infos[i].vertex->id().get()) ];
+        bool is_refined = false;
+        for (std::size_t j = 0; j < adjacent_lines.size() && !is_refined; ++j)
+          is_refined = edge_refinement_flag_accessor( *adjacent_lines[j] );
+        if (!is_refined)
+          continue;
+
+        for (std::size_t j = 0; j < constrained_cells[i].size(); ++j)
+        {
+          TensorCellType const & cell = cells[ constrained_cells[i][j].first ];
+          for (int d = 0; d < CellTagIn::dim; ++d)
+          {
+            if ( !(constrained_cells[i][j].second & (1 << d)) )
+              continue;
+            for (int base = 0; base < TensorCellType::corner_count; ++base)
+              if ( !(base & (1 << d)) && !edge_refinement_flag_accessor(*cell.edges[base][d]) )
+              {
+                edge_refinement_flag_accessor(*cell.edges[base][d]) = true;
+                something_changed = true;
+              }
+          }
+        }
+      }
+    }
+  }
+
+}
+
+#endif
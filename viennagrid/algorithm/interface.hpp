@@ -93,14 +93,69 @@ namespace viennagrid
     };
 
 
-    /** @brief For internal use only. */
+    /** @brief For internal use only. The element tags with interface flags transferred from the facets, i.e. all element tags except the facet tag. */
+    template<typename SegmentationT>
+    struct transferred_interface_information_taglist
+    {
+      typedef typename viennagrid::result_of::cell_tag< segment_handle<SegmentationT> >::type cell_tag;
+      typedef typename viennagrid::result_of::facet_tag< cell_tag >::type facet_tag;
+
+      typedef typename viennagrid::detail::result_of::erase<
+          typename viennagrid::detail::result_of::key_typelist<
+              typename viennagrid::detail::result_of::lookup<
+                  typename SegmentationT::appendix_type,
+                  interface_information_collection_tag
+              >::type::typemap
+          >::type,
+          facet_tag
+      >::type type;
+    };
+
+
+    /** @brief For internal use only. Checks if the transferred interface flags of any element type are out of date. The dependencies are the same as for the boundary flags, see boundary_information_dependencies. */
+    template<typename SegmentationT>
+    class interface_information_obsolete_functor
+    {
+    public:
+      typedef segment_handle<SegmentationT> SegmentHandleType;
+
+      interface_information_obsolete_functor(SegmentHandleType const & seg0_, SegmentHandleType const & seg1_, bool & obsolete_) : seg0(seg0_), seg1(seg1_), obsolete(obsolete_) {}
+
+      template<typename something>
+      void operator()( viennagrid::detail::tag<something> )
+      {
+        typedef typename viennagrid::result_of::element_tag< something >::type element_tag;
+        typedef typename boundary_information_dependencies<SegmentHandleType, element_tag>::type dependency_taglist;
+
+        typedef typename viennagrid::detail::result_of::lookup<
+                typename viennagrid::detail::result_of::lookup<
+                    typename SegmentationT::appendix_type,
+                    interface_information_collection_tag
+                  >::type,
+                  element_tag
+                >::type::segment_interface_information_wrapper_type interface_information_container_wrapper_type;
+        interface_information_container_wrapper_type const & interface_information_container_wrapper = interface_information_collection<element_tag>( seg0, seg1 );
+
+        if ( detail::is_dependency_obsolete<dependency_taglist>(seg0, interface_information_container_wrapper.seg0_change_counter) ||
+             detail::is_dependency_obsolete<dependency_taglist>(seg1, interface_information_container_wrapper.seg1_change_counter) )
+          obsolete = true;
+      }
+    private:
+
+      SegmentHandleType const & seg0;
+      SegmentHandleType const & seg1;
+      bool & obsolete;
+    };
+
+
+    /** @brief For internal use only. If obsolete_only is set, only interface flags which are out of date are transferred. */
     template<typename SegmentationT>
     class interface_setter_functor
     {
     public:
       typedef segment_handle<SegmentationT> SegmentHandleType;
 
-      interface_setter_functor(SegmentHandleType & seg0_, SegmentHandleType & seg1_) : seg0(seg0_), seg1(seg1_) {}
+      interface_setter_functor(SegmentHandleType & seg0_, SegmentHandleType & seg1_, bool obsolete_only_ = false) : seg0(seg0_), seg1(seg1_), obsolete_only(obsolete_only_) {}
 
       template<typename something>
       void operator()( viennagrid::detail::tag<something> )
@@ -137,43 +192,35 @@ namespace viennagrid
         dst_interface_information_container_wrapper_type & dst_interface_information_container_wrapper = interface_information_collection<element_tag>( seg0, seg1 );
         typename viennagrid::result_of::accessor< typename dst_interface_information_container_wrapper_type::container_type, element_type >::type dst_accessor( dst_interface_information_container_wrapper.container );
 
+        typedef typename boundary_information_dependencies<SegmentHandleType, element_tag>::type dependency_taglist;
+        if ( obsolete_only &&
+             !detail::is_dependency_obsolete<dependency_taglist>(seg0, dst_interface_information_container_wrapper.seg0_change_counter) &&
+             !detail::is_dependency_obsolete<dependency_taglist>(seg1, dst_interface_information_container_wrapper.seg1_change_counter) )
+          return;
+
         transfer_boundary_information(seg0, viennagrid::make_field<facet_type>(src_interface_information_container_wrapper.container), dst_accessor);
         transfer_boundary_information(seg1, viennagrid::make_field<facet_type>(src_interface_information_container_wrapper.container), dst_accessor);
 
-        detail::update_change_counter( seg0, dst_interface_information_container_wrapper.seg0_change_counter );
-        detail::update_change_counter( seg1, dst_interface_information_container_wrapper.seg1_change_counter );
+        detail::update_dependency_change_counter<dependency_taglist>( seg0, dst_interface_information_container_wrapper.seg0_change_counter );
+        detail::update_dependency_change_counter<dependency_taglist>( seg1, dst_interface_information_container_wrapper.seg1_change_counter );
       }
     private:
 
       SegmentHandleType & seg0;
       SegmentHandleType & seg1;
+      bool obsolete_only;
     };
 
 
 
     /** @brief For internal use only. */
     template<typename SegmentationT>
-    void transfer_interface_information( segment_handle<SegmentationT> & seg0, segment_handle<SegmentationT> & seg1 )
+    void transfer_interface_information( segment_handle<SegmentationT> & seg0, segment_handle<SegmentationT> & seg1, bool obsolete_only = false )
     {
       assert( &seg0.parent() == &seg1.parent() );
 
-      typedef segment_handle<SegmentationT> segment_handle_type;
-      typedef typename viennagrid::result_of::cell_tag< segment_handle_type >::type cell_tag;
-      typedef typename viennagrid::result_of::facet_tag< cell_tag >::type facet_tag;
-
-      typedef typename viennagrid::detail::result_of::erase<
-          typename viennagrid::detail::result_of::key_typelist<
-              typename viennagrid::detail::result_of::lookup<
-                  typename SegmentationT::appendix_type,
-                  interface_information_collection_tag
-              >::type::typemap
-          >::type,
-          facet_tag
-      >::type typelist;
-
-      interface_setter_functor<SegmentationT> functor(seg0, seg1);
-
-      viennagrid::detail::for_each< typelist >( functor );
+      interface_setter_functor<SegmentationT> functor(seg0, seg1, obsolete_only);
+      viennagrid::detail::for_each< typename transferred_interface_information_taglist<SegmentationT>::type >( functor );
     }
 
 
@@ -232,12 +279,65 @@ namespace viennagrid
     detail::detect_interface( seg0, seg1, viennagrid::make_field<FacetType>(interface_information_container_wrapper.container) );
 
     transfer_interface_information( seg0, seg1 );
-    detail::update_change_counter( seg0, interface_information_container_wrapper.seg0_change_counter );
-    detail::update_change_counter( seg1, interface_information_container_wrapper.seg1_change_counter );
+
+    typedef typename viennagrid::make_typelist<CellTag, FacetTag>::type dependency_taglist;
+    detail::update_dependency_change_counter<dependency_taglist>( seg0, interface_information_container_wrapper.seg0_change_counter );
+    detail::update_dependency_change_counter<dependency_taglist>( seg1, interface_information_container_wrapper.seg1_change_counter );
   }
 
 
 
+  /** @brief Detects the interface between two segments if the interface information is out of date. Call this function before calling is_interface() on shared segments from multiple threads, afterwards is_interface() does not modify the segmentation.
+   *
+   * The interface facets are only re-detected if cells or facets of one of the segments changed, the flags of any other element type are only re-transferred if elements of this type changed.
+   *
+   * @param seg0  The first segment
+   * @param seg1  The second segment
+   */
+  template <typename SegmentationT>
+  void prepare_interface(segment_handle<SegmentationT> const & seg0,
+                         segment_handle<SegmentationT> const & seg1)
+  {
+    assert( &seg0.parent() == &seg1.parent() );
+
+    typedef segment_handle<SegmentationT> SegmentHandleType;
+    typedef typename result_of::cell_tag< SegmentHandleType >::type CellTag;
+    typedef typename result_of::facet_tag<CellTag>::type FacetTag;
+
+    typedef typename viennagrid::detail::result_of::lookup<
+            typename viennagrid::detail::result_of::lookup<
+                typename SegmentationT::appendix_type,
+                interface_information_collection_tag
+              >::type,
+              FacetTag
+            >::type::segment_interface_information_wrapper_type interface_information_container_wrapper_type;
+    interface_information_container_wrapper_type const & interface_information_container_wrapper = detail::interface_information_collection<FacetTag>( seg0, seg1 );
+
+    typedef typename viennagrid::make_typelist<CellTag, FacetTag>::type dependency_taglist;
+
+    if ( detail::is_dependency_obsolete<dependency_taglist>(seg0, interface_information_container_wrapper.seg0_change_counter) ||
+         detail::is_dependency_obsolete<dependency_taglist>(seg1, interface_information_container_wrapper.seg1_change_counter) )
+    {
+      detail::cache_update_guard guard;
+      if ( detail::is_dependency_obsolete<dependency_taglist>(seg0, interface_information_container_wrapper.seg0_change_counter) ||
+           detail::is_dependency_obsolete<dependency_taglist>(seg1, interface_information_container_wrapper.seg1_change_counter) )
+        detect_interface( const_cast<SegmentHandleType&>(seg0), const_cast<SegmentHandleType&>(seg1) );
+    }
+    else
+    {
+      bool obsolete = false;
+      detail::interface_information_obsolete_functor<SegmentationT> functor(seg0, seg1, obsolete);
+      viennagrid::detail::for_each< typename detail::transferred_interface_information_taglist<SegmentationT>::type >( functor );
+
+      if (obsolete)
+      {
+        detail::cache_update_guard guard;
+        detail::transfer_interface_information( const_cast<SegmentHandleType&>(seg0), const_cast<SegmentHandleType&>(seg1), true );
+      }
+    }
+  }
+
+
   /** @brief Returns true if the n-cell is located at the interface between two segments
    *
    * @param seg0      The first segment
@@ -251,8 +351,6 @@ namespace viennagrid
   {
     assert( &seg0.parent() == &seg1.parent() );
 
-    typedef segment_handle<SegmentationT> SegmentHandleType;
-
     typedef typename viennagrid::result_of::element_tag<ElementT>::type element_tag;
 
 
@@ -265,9 +363,7 @@ namespace viennagrid
             >::type::segment_interface_information_wrapper_type interface_information_container_wrapper_type;
     interface_information_container_wrapper_type const & interface_information_container_wrapper = detail::interface_information_collection<element_tag>( seg0, seg1 );
 
-    if ( (detail::is_obsolete(seg0, interface_information_container_wrapper.seg0_change_counter)) ||
-         (detail::is_obsolete(seg1, interface_information_container_wrapper.seg1_change_counter) ))
-        detect_interface( const_cast<SegmentHandleType&>(seg0), const_cast<SegmentHandleType&>(seg1) );
+    prepare_interface(seg0, seg1);
 
     return detail::is_interface( viennagrid::make_field<ElementT>(interface_information_container_wrapper.container), element );
   }
@@ -0,0 +1,570 @@
+#ifndef VIENNAGRID_ALGORITHM_INTERPOLATE_HPP
+#define VIENNAGRID_ALGORITHM_INTERPOLATE_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/mesh/mesh.hpp"
+
+#ifdef VIENNAGRID_WITH_OPENMP
+  #include <omp.h>
+#endif
+
+/** @file viennagrid/algorithm/interpolate.hpp
+    @brief Interpolation of vertex fields between non-matching meshes using a point locator
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+    /** @brief Cell types supported by the point locator: simplices (barycentric coordinates) and hypercubes (multilinear coordinates). For internal use only. */
+    template<typename CellTagT>
+    struct point_locator_cell;
+
+    template<int DimV>
+    struct point_locator_cell< simplex_tag<DimV> >
+    {
+      static const bool is_simplex = true;
+      static const int dim = DimV;
+    };
+
+    template<int DimV>
+    struct point_locator_cell< hypercube_tag<DimV> >
+    {
+      static const bool is_simplex = false;
+      static const int dim = DimV;
+    };
+
+    /** @brief The dimension of the cells of a mesh with the given point type, fails to compile if the cell dimension does not match the geometric dimension (e.g. triangles in 3D). For internal use only. */
+    template<typename CellTagT, typename PointT>
+    struct point_locator_dimension
+    {
+      typedef typename STATIC_ASSERT< static_cast<int>(PointT::dim) == point_locator_cell<CellTagT>::dim >::type ERROR_CELL_DIMENSION_HAS_TO_MATCH_GEOMETRIC_DIMENSION;
+      static const int value = point_locator_cell<CellTagT>::dim;
+    };
+
+    /** @brief The sorted vertex indices of a cell face, used to match the faces of neighbor cells. For internal use only. */
+    struct point_locator_face
+    {
+      std::size_t vertices[4];
+      std::size_t cell;
+      std::size_t face;
+
+      bool operator<(point_locator_face const & other) const
+      {
+        return std::lexicographical_compare(vertices, vertices + 4, other.vertices, other.vertices + 4);
+      }
+
+      bool same_vertices(point_locator_face const & other) const
+      {
+        return std::equal(vertices, vertices + 4, other.vertices);
+      }
+    };
+
+    /** @brief Solves the dense system A x = b of dimension n <= 3 (row major) by Gaussian elimination with partial pivoting. Returns false if A is singular. */
+    inline bool point_locator_solve(double * A, double * b, std::size_t n)
+    {
+      for (std::size_t k = 0; k < n; ++k)
+      {
+        std::size_t pivot = k;
+        for (std::size_t i = k+1; i < n; ++i)
+          if ( std::fabs(A[i*n+k]) > std::fabs(A[pivot*n+k]) )
+            pivot = i;
+        if (A[pivot*n+k] == 0.0)
+          return false;
+        if (pivot != k)
+        {
+          for (std::size_t j = 0; j < n; ++j)
+            std::swap(A[k*n+j], A[pivot*n+j]);
+          std::swap(b[k], b[pivot]);
+        }
+        for (std::size_t i = k+1; i < n; ++i)
+        {
+          double factor = A[i*n+k] / A[k*n+k];
+          for (std::size_t j = k; j < n; ++j)
+            A[i*n+j] -= factor * A[k*n+j];
+          b[i] -= factor * b[k];
+        }
+      }
+      for (std::size_t k = n; k-- > 0; )
+      {
+        for (std::size_t j = k+1; j < n; ++j)
+          b[k] -= A[k*n+j] * b[j];
+        b[k] /= A[k*n+k];
+      }
+      return true;
+    }
+  }
+
+
+  /** @brief Locates points in the cells of a mesh or segment and provides the interpolation weights of the cell vertices.
+    *
+    * Supported are simplex cells (lines, triangles, tetrahedra) with barycentric weights and hypercube cells (quadrilaterals, hexahedra) with multilinear weights,
+    * where the cell dimension equals the geometric dimension (other meshes, e.g. triangles in 3D, are rejected at compile time). A point is searched by walking through neighbor cells, starting at a hint cell (e.g. the cell of the previous point),
+    * and by a uniform grid of the cell bounding boxes if the walk fails. Queries do not modify the locator and can be issued concurrently.
+    */
+  class point_locator
+  {
+  public:
+    /** @brief Builds the locator for the cells of a mesh or segment */
+    template<typename MeshOrSegmentT>
+    explicit point_locator(MeshOrSegmentT const & source) { build(source); }
+
+    /** @brief Returns the number of cells */
+    std::size_t cell_count() const { return corner_count_ ? cell_vertices_.size() / corner_count_ : 0; }
+
+    /** @brief Returns the number of vertices per cell */
+    std::size_t corner_count() const { return corner_count_; }
+
+    /** @brief Returns the index of the cell containing the point p (up to a relative tolerance), or invalid_index() if p is outside of the mesh.
+      *
+      * @param p          The point
+      * @param hint       The cell where the walk starts, e.g. the result of the previous query of a nearby point. invalid_index() for no hint.
+      * @param indices    Output: The indices of the vertices of the cell in the order of the vertex range of the source, corner_count() entries
+      * @param weights    Output: The interpolation weights of the cell vertices, corner_count() entries
+      */
+    template<typename PointT>
+    std::size_t locate(PointT const & p, std::size_t hint, std::size_t * indices, double * weights) const
+    {
+      double q[3] = {0.0, 0.0, 0.0};
+      for (std::size_t i = 0; i < dim_; ++i)
+        q[i] = static_cast<double>(p[i]);
+
+      std::size_t cell = locate(q, hint, weights);
+      if (cell != invalid_index())
+        for (std::size_t i = 0; i < corner_count_; ++i)
+          indices[i] = cell_vertices_[cell * corner_count_ + i];
+      return cell;
+    }
+
+    static std::size_t invalid_index() { return static_cast<std::size_t>(-1); }
+
+  private:
+
+    std::size_t locate(double const * q, std::size_t hint, double * weights) const
+    {
+      if (cell_vertices_.empty())
+        return invalid_index();
+
+      // walk from the hint towards the point, crossing the face with the most negative local coordinate
+      std::size_t cell = hint;
+      for (std::size_t step = 0; step < max_walk_steps_ && cell < cell_count(); ++step)
+      {
+        std::size_t exit_face;
+        if ( local_weights(cell, q, weights, exit_face) )
+          return cell;
+        cell = neighbors_[cell * face_count_ + exit_face];
+      }
+
+      // uniform grid of the cell bounding boxes
+      std::size_t bucket = 0;
+      for (std::size_t i = dim_; i-- > 0; )
+      {
+        double extent = upper_[i] - lower_[i];
+        if (q[i] < lower_[i] - tolerance_ * extent || q[i] > upper_[i] + tolerance_ * extent)
+          return invalid_index();
+        bucket = bucket * resolution_ + bucket_index(q[i], i);
+      }
+
+      for (std::size_t i = bucket_offsets_[bucket]; i < bucket_offsets_[bucket+1]; ++i)
+      {
+        std::size_t exit_face;
+        if ( local_weights(bucket_cells_[i], q, weights, exit_face) )
+          return bucket_cells_[i];
+      }
+      return invalid_index();
+    }
+
+    /** @brief Computes the weights of the vertices of a cell for the point q. Returns true if q is inside the cell, otherwise exit_face is the face q is behind. */
+    bool local_weights(std::size_t cell, double const * q, double * weights, std::size_t & exit_face) const
+    {
+      std::size_t const * vertices = &cell_vertices_[cell * corner_count_];
+      double violation = 0.0;
+      exit_face = 0;
+
+      if (simplex_)
+      {
+        // barycentric coordinates: solve sum_i lambda_i (x_i - x_0) = q - x_0
+        double const * x0 = point(vertices[0]);
+        double A[9], b[3];
+        for (std::size_t i = 0; i < dim_; ++i)
+        {
+          for (std::size_t j = 0; j < dim_; ++j)
+            A[i*dim_+j] = point(vertices[j+1])[i] - x0[i];
+          b[i] = q[i] - x0[i];
+        }
+        if ( !detail::point_locator_solve(A, b, dim_) )
+          return false;
+
+        weights[0] = 1.0;
+        for (std::size_t i = 0; i < dim_; ++i)
+        {
+          weights[i+1] = b[i];
+          weights[0] -= b[i];
+        }
+
+        // face i is opposite to vertex i
+        for (std::size_t i = 0; i < corner_count_; ++i)
+          if (weights[i] < violation)
+          {
+            violation = weights[i];
+            exit_face = i;
+          }
+      }
+      else
+      {
+        // multilinear coordinates in [0,1]^dim by Newton's method, vertices are in tensor product order
+        double xi[3] = {0.5, 0.5, 0.5};
+        for (std::size_t iteration = 0; iteration < 20; ++iteration)
+        {
+          double r[3] = {0.0, 0.0, 0.0};
+          double J[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+          for (std::size_t c = 0; c < corner_count_; ++c)
+          {
+            double const * x = point(vertices[c]);
+            for (std::size_t d = 0; d < dim_; ++d)
+            {
+              // derivative of the shape function of corner c with respect to xi_d
+              double derivative = (c & (std::size_t(1) << d)) ? 1.0 : -1.0;
+              for (std::size_t e = 0; e < dim_; ++e)
+                if (e != d)
+                  derivative *= (c & (std::size_t(1) << e)) ? xi[e] : 1.0 - xi[e];
+              for (std::size_t i = 0; i < dim_; ++i)
+                J[i*dim_+d] += derivative * x[i];
+            }
+            double shape = multilinear_shape(c, xi);
+            for (std::size_t i = 0; i < dim_; ++i)
+              r[i] += shape * x[i];
+          }
+          for (std::size_t i = 0; i < dim_; ++i)
+            r[i] = q[i] - r[i];
+          if ( !detail::point_locator_solve(J, r, dim_) )
+            return false;
+
+          double update = 0.0;
+          for (std::size_t d = 0; d < dim_; ++d)
+          {
+            xi[d] += r[d];
+            update = std::max(update, std::fabs(r[d]));
+          }
+          if (update < 1e-14)
+            break;
+        }
+
+        for (std::size_t c = 0; c < corner_count_; ++c)
+          weights[c] = multilinear_shape(c, xi);
+
+        // face 2d is the facet xi_d = 0, face 2d+1 is the facet xi_d = 1
+        for (std::size_t d = 0; d < dim_; ++d)
+        {
+          if (xi[d] < violation)
+          {
+            violation = xi[d];
+            exit_face = 2*d;
+          }
+          if (1.0 - xi[d] < violation)
+          {
+            violation = 1.0 - xi[d];
+            exit_face = 2*d+1;
+          }
+        }
+      }
+
+      return violation >= -tolerance_;
+    }
+
+    double multilinear_shape(std::size_t corner, double const * xi) const
+    {
+      double shape = 1.0;
+      for (std::size_t d = 0; d < dim_; ++d)
+        shape *= (corner & (std::size_t(1) << d)) ? xi[d] : 1.0 - xi[d];
+      return shape;
+    }
+
+    double const * point(std::size_t vertex) const { return &points_[3*vertex]; }
+
+    template<typename MeshOrSegmentT>
+    void build(MeshOrSegmentT const & source)
+    {
+      typedef typename viennagrid::result_of::cell_tag<MeshOrSegmentT>::type                     CellTag;
+      typedef typename viennagrid::result_of::point<MeshOrSegmentT>::type                        PointType;
+      typedef typename viennagrid::result_of::const_vertex_range<MeshOrSegmentT>::type           ConstVertexRangeType;
+      typedef typename viennagrid::result_of::iterator<ConstVertexRangeType>::type               ConstVertexIteratorType;
+      typedef typename viennagrid::result_of::const_cell_range<MeshOrSegmentT>::type             ConstCellRangeType;
+      typedef typename viennagrid::result_of::iterator<ConstCellRangeType>::type                 ConstCellIteratorType;
+      typedef typename viennagrid::result_of::const_vertex_range<typename viennagrid::result_of::cell<MeshOrSegmentT>::type>::type ConstVertexOnCellRangeType;
+      typedef typename viennagrid::result_of::iterator<ConstVertexOnCellRangeType>::type         ConstVertexOnCellIteratorType;
+
+      dim_ = static_cast<std::size_t>(detail::point_locator_dimension<CellTag, PointType>::value);
+      simplex_ = detail::point_locator_cell<CellTag>::is_simplex;
+      corner_count_ = simplex_ ? dim_ + 1 : (std::size_t(1) << dim_);
+      face_count_ = simplex_ ? dim_ + 1 : 2 * dim_;
+      max_walk_steps_ = 64;
+      tolerance_ = 1e-10;
+
+      typename viennagrid::result_of::default_point_accessor<MeshOrSegmentT>::type point_accessor = viennagrid::default_point_accessor(source);
+
+      // vertices are numbered in the order of the vertex range
+      std::vector<std::size_t> vertex_index;
+      ConstVertexRangeType vertices(source);
+      points_.clear();
+      points_.reserve( 3 * vertices.size() );
+      for (ConstVertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+      {
+        std::size_t id = static_cast<std::size_t>( vit->id().get() );
+        if (id >= vertex_index.size())
+          vertex_index.resize(id + 1, invalid_index());
+        vertex_index[id] = points_.size() / 3;
+
+        for (std::size_t i = 0; i < 3; ++i)
+          points_.push_back( (i < dim_) ? static_cast<double>(point_accessor(*vit)[i]) : 0.0 );
+      }
+
+      ConstCellRangeType cells(source);
+      cell_vertices_.clear();
+      cell_vertices_.reserve( corner_count_ * cells.size() );
+      for (ConstCellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+      {
+        ConstVertexOnCellRangeType cell_vertices(*cit);
+        for (ConstVertexOnCellIteratorType vit = cell_vertices.begin(); vit != cell_vertices.end(); ++vit)
+          cell_vertices_.push_back( vertex_index[ static_cast<std::size_t>(vit->id().get()) ] );
+      }
+
+      build_neighbors();
+      build_grid();
+    }
+
+    /** @brief Cells sharing a face are found by sorting the faces by their vertices */
+    void build_neighbors()
+    {
+      std::vector<detail::point_locator_face> faces;
+      faces.reserve( cell_count() * face_count_ );
+      for (std::size_t cell = 0; cell < cell_count(); ++cell)
+        for (std::size_t face = 0; face < face_count_; ++face)
+        {
+          detail::point_locator_face f;
+          f.cell = cell;
+          f.face = face;
+          std::fill(f.vertices, f.vertices + 4, invalid_index());
+
+          std::size_t count = 0;
+          for (std::size_t c = 0; c < corner_count_; ++c)
+          {
+            // simplices: face i is opposite to vertex i, hypercubes: face 2d+s contains the vertices with bit d equal to s
+            bool on_face = simplex_ ? (c != face) : (((c >> (face / 2)) & 1) == (face & 1));
+            if (on_face)
+              f.vertices[count++] = cell_vertices_[cell * corner_count_ + c];
+          }
+          std::sort(f.vertices, f.vertices + count);
+          faces.push_back(f);
+        }
+      std::sort(faces.begin(), faces.end());
+
+      neighbors_.assign( cell_count() * face_count_, invalid_index() );
+      for (std::size_t i = 0; i + 1 < faces.size(); ++i)
+        if ( faces[i].same_vertices(faces[i+1]) )
+        {
+          neighbors_[ faces[i].cell   * face_count_ + faces[i].face   ] = faces[i+1].cell;
+          neighbors_[ faces[i+1].cell * face_count_ + faces[i+1].face ] = faces[i].cell;
+          ++i;
+        }
+    }
+
+    /** @brief Each cell is stored in all buckets overlapped by its bounding box. The resolution is chosen such that there is about one cell per bucket. */
+    void build_grid()
+    {
+      std::fill(lower_, lower_ + 3, std::numeric_limits<double>::max());
+      std::fill(upper_, upper_ + 3, -std::numeric_limits<double>::max());
+      for (std::size_t v = 0; v < points_.size() / 3; ++v)
+        for (std::size_t i = 0; i < dim_; ++i)
+        {
+          lower_[i] = std::min(lower_[i], point(v)[i]);
+          upper_[i] = std::max(upper_[i], point(v)[i]);
+        }
+
+      resolution_ = std::max<std::size_t>(1, static_cast<std::size_t>( std::pow(static_cast<double>(cell_count()), 1.0 / static_cast<double>(dim_)) ));
+      std::size_t bucket_count = 1;
+      for (std::size_t i = 0; i < dim_; ++i)
+        bucket_count *= resolution_;
+
+      // two passes: count, then fill
+      bucket_offsets_.assign(bucket_count + 1, 0);
+      std::vector<std::size_t> fill;
+      for (std::size_t pass = 0; pass < 2; ++pass)
+      {
+        if (pass == 1)
+        {
+          for (std::size_t b = 0; b < bucket_count; ++b)
+            bucket_offsets_[b+1] += bucket_offsets_[b];
+          bucket_cells_.resize( bucket_offsets_[bucket_count] );
+          fill.assign( bucket_offsets_.begin(), bucket_offsets_.end() - 1 );
+        }
+
+        for (std::size_t cell = 0; cell < cell_count(); ++cell)
+        {
+          std::size_t first[3] = {0, 0, 0};
+          std::size_t last[3] = {0, 0, 0};
+          for (std::size_t i = 0; i < dim_; ++i)
+          {
+            double cell_lower = std::numeric_limits<double>::max();
+            double cell_upper = -std::numeric_limits<double>::max();
+            for (std::size_t c = 0; c < corner_count_; ++c)
+            {
+              cell_lower = std::min(cell_lower, point(cell_vertices_[cell * corner_count_ + c])[i]);
+              cell_upper = std::max(cell_upper, point(cell_vertices_[cell * corner_count_ + c])[i]);
+            }
+            first[i] = bucket_index(cell_lower, i);
+            last[i] = bucket_index(cell_upper, i);
+          }
+
+          for (std::size_t k = first[2]; k <= last[2]; ++k)
+            for (std::size_t j = first[1]; j <= last[1]; ++j)
+              for (std::size_t i = first[0]; i <= last[0]; ++i)
+              {
+                std::size_t bucket = (k * resolution_ + j) * resolution_ + i;
+                if (pass == 0)
+                  ++bucket_offsets_[bucket+1];
+                else
+                  bucket_cells_[ fill[bucket]++ ] = cell;
+              }
+        }
+      }
+    }
+
+    std::size_t bucket_index(double x, std::size_t axis) const
+    {
+      double extent = upper_[axis] - lower_[axis];
+      if (extent <= 0.0)
+        return 0;
+      double index = (x - lower_[axis]) / extent * static_cast<double>(resolution_);
+      return static_cast<std::size_t>( std::max(0.0, std::min(index, static_cast<double>(resolution_ - 1))) );
+    }
+
+    std::size_t dim_;
+    bool simplex_;
+    std::size_t corner_count_;
+    std::size_t face_count_;
+    std::size_t max_walk_steps_;
+    double tolerance_;
+
+    std::vector<double> points_;
+    std::vector<std::size_t> cell_vertices_;
+    std::vector<std::size_t> neighbors_;
+
+    double lower_[3];
+    double upper_[3];
+    std::size_t resolution_;
+    std::vector<std::size_t> bucket_offsets_;
+    std::vector<std::size_t> bucket_cells_;
+  };
+
+
+
+  /** @brief Interpolates a vertex field from a source mesh or segment to the vertices of a destination mesh or segment.
+    *
+    * Each destination vertex is located in a source cell using a point_locator, the value is the barycentric (simplices) or multilinear (quadrilaterals, hexahedra)
+    * interpolation of the source values at the cell vertices. Consecutive destination vertices start the search at the cell of the previous vertex, hence
+    * spatially ordered destination vertices (cf. viennagrid::reorder()) are located fastest. The destination vertices are processed in parallel if VIENNAGRID_WITH_OPENMP is defined.
+    *
+    * @param source                   The mesh or segment the field is defined on
+    * @param source_field             The field (accessor) on the vertices of the source, e.g. obtained by viennagrid::make_field()
+    * @param destination              The mesh or segment on whose vertices the field is interpolated
+    * @param destination_field        The field (accessor) on the vertices of the destination
+    * @return                         The number of destination vertices outside of the source, their values are not modified
+    */
+  template<typename SourceMeshOrSegmentT, typename SourceFieldT, typename DestinationMeshOrSegmentT, typename DestinationFieldT>
+  std::size_t interpolate_field(SourceMeshOrSegmentT const & source, SourceFieldT const & source_field,
+                                DestinationMeshOrSegmentT const & destination, DestinationFieldT destination_field)
+  {
+    typedef typename viennagrid::result_of::const_vertex_range<SourceMeshOrSegmentT>::type       ConstSourceVertexRangeType;
+    typedef typename viennagrid::result_of::iterator<ConstSourceVertexRangeType>::type           ConstSourceVertexIteratorType;
+    typedef typename viennagrid::result_of::vertex<DestinationMeshOrSegmentT>::type              DestinationVertexType;
+    typedef typename viennagrid::result_of::point<DestinationMeshOrSegmentT>::type               DestinationPointType;
+    typedef typename viennagrid::result_of::const_vertex_range<DestinationMeshOrSegmentT>::type  ConstDestinationVertexRangeType;
+    typedef typename viennagrid::result_of::iterator<ConstDestinationVertexRangeType>::type      ConstDestinationVertexIteratorType;
+    typedef typename SourceFieldT::value_type                                                    ValueType;
+
+    point_locator locator(source);
+
+    // source values in the vertex order of the locator
+    std::vector<ValueType> source_values;
+    ConstSourceVertexRangeType source_vertices(source);
+    source_values.reserve( source_vertices.size() );
+    for (ConstSourceVertexIteratorType vit = source_vertices.begin(); vit != source_vertices.end(); ++vit)
+      source_values.push_back( source_field(*vit) );
+
+    typename viennagrid::result_of::default_point_accessor<DestinationMeshOrSegmentT>::type point_accessor = viennagrid::default_point_accessor(destination);
+
+    ConstDestinationVertexRangeType destination_vertices(destination);
+    std::vector<DestinationVertexType const *> vertex_pointers;
+    std::vector<DestinationPointType> points;
+    vertex_pointers.reserve( destination_vertices.size() );
+    points.reserve( destination_vertices.size() );
+    for (ConstDestinationVertexIteratorType vit = destination_vertices.begin(); vit != destination_vertices.end(); ++vit)
+    {
+      vertex_pointers.push_back( &*vit );
+      points.push_back( point_accessor(*vit) );
+    }
+
+    std::vector<ValueType> values( points.size() );
+    std::vector<char> located( points.size() );
+    long vertex_count = static_cast<long>(points.size());
+
+#ifdef VIENNAGRID_WITH_OPENMP
+    #pragma omp parallel
+#endif
+    {
+      // each thread walks from the cell of its previous vertex
+      std::size_t hint = point_locator::invalid_index();
+      std::size_t indices[8];
+      double weights[8];
+
+#ifdef VIENNAGRID_WITH_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for (long i = 0; i < vertex_count; ++i)
+      {
+        std::size_t index = static_cast<std::size_t>(i);
+        std::size_t cell = locator.locate(points[index], hint, indices, weights);
+        if (cell == point_locator::invalid_index())
+          continue;
+
+        ValueType value = source_values[indices[0]] * weights[0];
+        for (std::size_t j = 1; j < locator.corner_count(); ++j)
+          value += source_values[indices[j]] * weights[j];
+        values[index] = value;
+        located[index] = 1;
+        hint = cell;
+      }
+    }
+
+    std::size_t outside = 0;
+    for (std::size_t i = 0; i < vertex_pointers.size(); ++i)
+    {
+      if (located[i])
+        destination_field( *vertex_pointers[i] ) = values[i];
+      else
+        ++outside;
+    }
+    return outside;
+  }
+
+}
+
+#endif
@@ -0,0 +1,602 @@
+#ifndef VIENNAGRID_ALGORITHM_PARTITION_HPP
+#define VIENNAGRID_ALGORITHM_PARTITION_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <iterator>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/mesh/mesh.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/algorithm/reorder.hpp"
+
+/** @file viennagrid/algorithm/partition.hpp
+    @brief Partitioning of a mesh into k parts and extraction of the submeshes including ghost layers for distributed computations
+*/
+
+namespace viennagrid
+{
+  /** @brief A tag selecting the partitioning of the cell dual graph by recursive bisection. Each bisection grows one part from a pseudo-peripheral cell and improves the cut by swapping cells across it. */
+  struct graph_bisection_partitioning_tag {};
+
+  /** @brief A tag selecting the geometric recursive coordinate bisection (RCB) of the cell centers. Each bisection splits at the median along the longest extent. */
+  struct coordinate_bisection_partitioning_tag {};
+
+
+  /** @brief The dual graph of the cells of a mesh in compressed row storage. Two cells are adjacent if they share a facet, the nodes are the cells in the order of the cell range. */
+  struct cell_graph
+  {
+    /** @brief Returns the number of nodes (cells) */
+    std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    /** @brief Returns the number of neighbors of a node */
+    std::size_t degree(std::size_t node) const { return offsets[node+1] - offsets[node]; }
+
+    /** @brief The neighbors of node i are adjacency[offsets[i]] to adjacency[offsets[i+1]-1] */
+    std::vector<std::size_t> offsets;
+    std::vector<std::size_t> adjacency;
+  };
+
+
+  /** @brief Builds the dual graph of the cells of a mesh from the facets shared by the cells. Requires the facets to be stored in the mesh.
+    *
+    * @param mesh                 The mesh
+    * @return                     The dual graph, the nodes are the cells in the order of the cell range of the mesh
+    */
+  template<typename MeshT>
+  cell_graph make_cell_graph(MeshT const & mesh)
+  {
+    typedef typename viennagrid::result_of::cell<MeshT>::type                           CellType;
+    typedef typename viennagrid::result_of::facet<MeshT>::type                          FacetType;
+    typedef typename viennagrid::result_of::const_cell_range<MeshT>::type               CellRangeType;
+    typedef typename viennagrid::result_of::iterator<CellRangeType>::type               CellIteratorType;
+    typedef typename viennagrid::result_of::const_facet_range<CellType>::type           FacetOnCellRangeType;
+    typedef typename viennagrid::result_of::iterator<FacetOnCellRangeType>::type        FacetOnCellIteratorType;
+
+    std::size_t invalid = std::numeric_limits<std::size_t>::max();
+
+    // the first cell found on each facet, the second one is a neighbor
+    std::vector<std::size_t> facet_cell( static_cast<std::size_t>(viennagrid::id_upper_bound<FacetType>(mesh).get()), invalid );
+    std::vector< std::pair<std::size_t, std::size_t> > edges;
+
+    CellRangeType cells(mesh);
+    std::size_t index = 0;
+    for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit, ++index)
+    {
+      FacetOnCellRangeType facets(*cit);
+      for (FacetOnCellIteratorType fit = facets.begin(); fit != facets.end(); ++fit)
+      {
+        std::size_t & other = facet_cell[ static_cast<std::size_t>((*fit).id().get()) ];
+        if (other == invalid)
+          other = index;
+        else
+        {
+          edges.push_back( std::make_pair(other, index) );
+          edges.push_back( std::make_pair(index, other) );
+        }
+      }
+    }
+
+    std::sort(edges.begin(), edges.end());
+
+    cell_graph graph;
+    graph.offsets.resize(index + 1, 0);
+    graph.adjacency.resize( edges.size() );
+    for (std::size_t i = 0; i < edges.size(); ++i)
+    {
+      ++graph.offsets[edges[i].first + 1];
+      graph.adjacency[i] = edges[i].second;
+    }
+    for (std::size_t i = 0; i < index; ++i)
+      graph.offsets[i+1] += graph.offsets[i];
+
+    return graph;
+  }
+
+
+  namespace detail
+  {
+    /** @brief For internal use only. Breadth-first search within the nodes marked by 'stamp', starting at 'start'. Appends the visited nodes to 'order' and returns the last visited node. */
+    inline std::size_t graph_bisection_search(cell_graph const & graph, std::vector<std::size_t> & marks, std::size_t stamp,
+                                              std::size_t start, std::vector<std::size_t> & order)
+    {
+      std::size_t first = order.size();
+      marks[start] = stamp + 1;
+      order.push_back(start);
+
+      for (std::size_t pos = first; pos < order.size(); ++pos)
+      {
+        std::size_t node = order[pos];
+        for (std::size_t i = graph.offsets[node]; i < graph.offsets[node+1]; ++i)
+        {
+          std::size_t neighbor = graph.adjacency[i];
+          if (marks[neighbor] == stamp)
+          {
+            marks[neighbor] = stamp + 1;
+            order.push_back(neighbor);
+          }
+        }
+      }
+
+      return order.back();
+    }
+
+    /** @brief For internal use only. The gain in cut edges if 'node' moves to the other side of a bisection. 'cut_edges' is set to the number of cut edges of the node. */
+    inline long graph_bisection_gain(cell_graph const & graph, std::vector<char> const & side, std::vector<std::size_t> const & marks, std::size_t stamp,
+                                     std::size_t node, long & cut_edges)
+    {
+      long gain = 0;
+      cut_edges = 0;
+      for (std::size_t i = graph.offsets[node]; i < graph.offsets[node+1]; ++i)
+      {
+        std::size_t neighbor = graph.adjacency[i];
+        if (marks[neighbor] != stamp)
+          continue;
+
+        if (side[neighbor] != side[node])
+        {
+          ++gain;
+          ++cut_edges;
+        }
+        else
+          --gain;
+      }
+      return gain;
+    }
+
+    /** @brief For internal use only. Splits 'nodes' into a first part of 'first_size' nodes and the remaining nodes. */
+    inline void graph_bisection(cell_graph const & graph, std::vector<std::size_t> & nodes, std::size_t first_size,
+                                std::vector<std::size_t> & marks, std::size_t & stamp, std::vector<char> & side)
+    {
+      // mark the nodes of this subgraph
+      stamp += 2;
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+        marks[nodes[i]] = stamp;
+
+      // a pseudo-peripheral node is the last node found by a search from any node
+      std::vector<std::size_t> order;
+      order.reserve( nodes.size() );
+      std::size_t start = graph_bisection_search(graph, marks, stamp, nodes.front(), order);
+      for (std::size_t i = 0; i < order.size(); ++i)
+        marks[order[i]] = stamp;
+
+      // grow the first part from the pseudo-peripheral node, disconnected components are appended in their order
+      order.clear();
+      graph_bisection_search(graph, marks, stamp, start, order);
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+        if (marks[nodes[i]] == stamp)
+          graph_bisection_search(graph, marks, stamp, nodes[i], order);
+
+      for (std::size_t i = 0; i < order.size(); ++i)
+      {
+        marks[order[i]] = stamp;
+        side[order[i]] = (i < first_size) ? 0 : 1;
+      }
+
+      // improve the cut by swapping pairs of boundary nodes with a positive total gain, the sizes of the parts are preserved
+      for (int pass = 0; pass < 4; ++pass)
+      {
+        std::vector< std::pair<long, std::size_t> > candidates[2];
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+          long cut_edges;
+          long gain = graph_bisection_gain(graph, side, marks, stamp, order[i], cut_edges);
+          if (cut_edges > 0)
+            candidates[ static_cast<std::size_t>(side[order[i]]) ].push_back( std::make_pair(-gain, order[i]) );
+        }
+        std::sort(candidates[0].begin(), candidates[0].end());
+        std::sort(candidates[1].begin(), candidates[1].end());
+
+        bool improved = false;
+        std::size_t count = std::min(candidates[0].size(), candidates[1].size());
+        for (std::size_t i = 0; i < count; ++i)
+        {
+          std::size_t first = candidates[0][i].second;
+          std::size_t second = candidates[1][i].second;
+
+          // gains have changed by earlier swaps, moving both nodes of an adjacent pair keeps their common edge cut
+          long cut_edges;
+          long gain = graph_bisection_gain(graph, side, marks, stamp, first, cut_edges) + graph_bisection_gain(graph, side, marks, stamp, second, cut_edges);
+          if (side[first] == side[second])
+            continue;
+          for (std::size_t j = graph.offsets[first]; j < graph.offsets[first+1]; ++j)
+            if (graph.adjacency[j] == second)
+              gain -= 2;
+
+          if (gain <= 0)
+            continue;
+
+          std::swap(side[first], side[second]);
+          improved = true;
+        }
+
+        if (!improved)
+          break;
+      }
+
+      std::vector<std::size_t> second_part;
+      std::size_t first_count = 0;
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+      {
+        if (side[nodes[i]] == 0)
+          nodes[first_count++] = nodes[i];
+        else
+          second_part.push_back(nodes[i]);
+      }
+      std::copy(second_part.begin(), second_part.end(), nodes.begin() + static_cast<long>(first_count));
+    }
+
+    /** @brief For internal use only. Splits 'nodes' into a first part of 'first_size' nodes and the remaining nodes at the median along the longest extent of their centers. */
+    template<typename PointT>
+    void coordinate_bisection(std::vector<PointT> const & centers, std::vector<std::size_t> & nodes, std::size_t first_size)
+    {
+      PointT lower = centers[nodes.front()];
+      PointT upper = centers[nodes.front()];
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+        for (std::size_t j = 0; j < lower.size(); ++j)
+        {
+          lower[j] = std::min(lower[j], centers[nodes[i]][j]);
+          upper[j] = std::max(upper[j], centers[nodes[i]][j]);
+        }
+
+      std::size_t axis = 0;
+      for (std::size_t j = 1; j < lower.size(); ++j)
+        if (upper[j] - lower[j] > upper[axis] - lower[axis])
+          axis = j;
+
+      std::vector< std::pair<typename viennagrid::result_of::coord<PointT>::type, std::size_t> > keys( nodes.size() );
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+        keys[i] = std::make_pair(centers[nodes[i]][axis], nodes[i]);
+
+      std::nth_element(keys.begin(), keys.begin() + static_cast<long>(first_size), keys.end());
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+        nodes[i] = keys[i].second;
+    }
+
+
+    /** @brief For internal use only. Recursively bisects 'nodes' into 'part_count' parts numbered from 'first_part', the sizes of the parts differ by at most one. */
+    template<typename BisectorT>
+    void recursive_bisection(BisectorT & bisector, std::vector<std::size_t> & nodes,
+                             std::size_t part_count, std::size_t first_part, std::vector<std::size_t> & partition)
+    {
+      if (part_count == 1 || nodes.size() <= 1)
+      {
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+          partition[nodes[i]] = first_part;
+        return;
+      }
+
+      std::size_t first_part_count = part_count / 2;
+      std::size_t first_size = (nodes.size() * first_part_count) / part_count;
+
+      bisector(nodes, first_size);
+
+      std::vector<std::size_t> second_nodes(nodes.begin() + static_cast<long>(first_size), nodes.end());
+      nodes.resize(first_size);
+
+      recursive_bisection(bisector, nodes, first_part_count, first_part, partition);
+      recursive_bisection(bisector, second_nodes, part_count - first_part_count, first_part + first_part_count, partition);
+    }
+
+    /** @brief For internal use only */
+    struct graph_bisector
+    {
+      graph_bisector(cell_graph const & graph_) : graph(graph_), marks(graph_.size(), 0), stamp(0), side(graph_.size(), 0) {}
+
+      void operator()(std::vector<std::size_t> & nodes, std::size_t first_size) { graph_bisection(graph, nodes, first_size, marks, stamp, side); }
+
+      cell_graph const & graph;
+      std::vector<std::size_t> marks;
+      std::size_t stamp;
+      std::vector<char> side;
+    };
+
+    /** @brief For internal use only */
+    template<typename PointT>
+    struct coordinate_bisector
+    {
+      coordinate_bisector(std::vector<PointT> const & centers_) : centers(centers_) {}
+
+      void operator()(std::vector<std::size_t> & nodes, std::size_t first_size) { coordinate_bisection(centers, nodes, first_size); }
+
+      std::vector<PointT> const & centers;
+    };
+
+
+    /** @brief For internal use only. Partitions the cells given by their position in the cell range. */
+    template<typename MeshT>
+    void partition_cells(MeshT const & mesh, reordering_input<MeshT> const &, std::size_t part_count,
+                         std::vector<std::size_t> & partition, graph_bisection_partitioning_tag)
+    {
+      cell_graph graph = make_cell_graph(mesh);
+      graph_bisector bisector(graph);
+
+      std::vector<std::size_t> nodes( graph.size() );
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+        nodes[i] = i;
+      recursive_bisection(bisector, nodes, part_count, 0, partition);
+    }
+
+    /** @brief For internal use only. Partitions the cells given by their position in the cell range. */
+    template<typename MeshT>
+    void partition_cells(MeshT const &, reordering_input<MeshT> const & input, std::size_t part_count,
+                         std::vector<std::size_t> & partition, coordinate_bisection_partitioning_tag)
+    {
+      typedef typename reordering_input<MeshT>::PointType PointType;
+
+      std::vector<PointType> centers( input.cells.size() );
+      for (std::size_t i = 0; i < input.cells.size(); ++i)
+      {
+        centers[i] = input.points[ input.cell_vertices[input.cell_offsets[i]] ];
+        for (std::size_t j = input.cell_offsets[i] + 1; j < input.cell_offsets[i+1]; ++j)
+          centers[i] += input.points[ input.cell_vertices[j] ];
+        centers[i] /= static_cast<double>(input.cell_offsets[i+1] - input.cell_offsets[i]);
+      }
+
+      coordinate_bisector<PointType> bisector(centers);
+
+      std::vector<std::size_t> nodes( centers.size() );
+      for (std::size_t i = 0; i < nodes.size(); ++i)
+        nodes[i] = i;
+      recursive_bisection(bisector, nodes, part_count, 0, partition);
+    }
+  }
+
+
+  /** @brief Partitions the cells of a mesh into parts of equal size (up to one cell).
+    *
+    * @param mesh                 The mesh to be partitioned
+    * @param part_count           The number of parts
+    * @param strategy             The partitioning strategy: graph_bisection_partitioning_tag (requires facets to be stored in the mesh) or coordinate_bisection_partitioning_tag
+    * @return                     The part of each cell, indexed by the cell ID
+    */
+  template<typename MeshT, typename StrategyTagT>
+  std::vector<std::size_t> partition(MeshT const & mesh, std::size_t part_count, StrategyTagT strategy)
+  {
+    typedef typename viennagrid::result_of::cell<MeshT>::type CellType;
+
+    detail::reordering_input<MeshT> input(mesh);
+
+    std::vector<std::size_t> cell_part( input.cells.size(), 0 );
+    if (part_count > 1 && !input.cells.empty())
+      detail::partition_cells(mesh, input, part_count, cell_part, strategy);
+
+    std::vector<std::size_t> result( static_cast<std::size_t>(viennagrid::id_upper_bound<CellType>(mesh).get()), 0 );
+    for (std::size_t i = 0; i < input.cells.size(); ++i)
+      result[ static_cast<std::size_t>(input.cells[i]->id().get()) ] = cell_part[i];
+    return result;
+  }
+
+
+
+  /** @brief One part of a partitioned mesh: The owned cells of the part, the ghost cells surrounding them and the relation between the local and the global numbering.
+    *
+    * Vertices and cells are stored in the order of their global IDs, the local ID of an element is its position. Hence, the local-to-global maps are sorted and the global-to-local lookup is a binary search.
+    *
+    * @tparam MeshT               The mesh type of the submesh
+    */
+  template<typename MeshT>
+  class submesh
+  {
+  public:
+    typedef MeshT mesh_type;
+
+    /** @brief Returns the mesh of this part */
+    mesh_type & mesh() { return mesh_; }
+    /** @brief Returns the mesh of this part, const version */
+    mesh_type const & mesh() const { return mesh_; }
+
+    /** @brief Returns the number of this part */
+    std::size_t part() const { return part_; }
+
+    /** @brief Returns the global ID of the vertex with the given local ID */
+    std::size_t global_vertex_id(std::size_t local_id) const { return vertex_global_ids[local_id]; }
+    /** @brief Returns the global ID of the cell with the given local ID */
+    std::size_t global_cell_id(std::size_t local_id) const { return cell_global_ids[local_id]; }
+
+    /** @brief Returns the local ID of the vertex with the given global ID or invalid_id() if the vertex is not part of this submesh */
+    std::size_t local_vertex_id(std::size_t global_id) const { return local_id(vertex_global_ids, global_id); }
+    /** @brief Returns the local ID of the cell with the given global ID or invalid_id() if the cell is not part of this submesh */
+    std::size_t local_cell_id(std::size_t global_id) const { return local_id(cell_global_ids, global_id); }
+
+    /** @brief Returns the part owning the vertex with the given local ID. A vertex is owned by the smallest part owning one of its cells. */
+    std::size_t vertex_owner(std::size_t local_id) const { return vertex_owners[local_id]; }
+    /** @brief Returns the part owning the cell with the given local ID */
+    std::size_t cell_owner(std::size_t local_id) const { return cell_owners[local_id]; }
+
+    /** @brief Returns true if the cell with the given local ID is a ghost cell, i.e. owned by another part */
+    bool is_ghost_cell(std::size_t local_id) const { return cell_owners[local_id] != part_; }
+    /** @brief Returns true if the vertex with the given local ID is owned by another part */
+    bool is_ghost_vertex(std::size_t local_id) const { return vertex_owners[local_id] != part_; }
+
+    /** @brief Returns the number of owned cells */
+    std::size_t owned_cell_count() const { return owned_cell_count_; }
+
+    /** @brief The vertices shared with other parts: For each neighbor part, the local IDs of all vertices present in both submeshes in the order of their global IDs, hence the lists of two neighboring parts correspond to each other. */
+    std::map< std::size_t, std::vector<std::size_t> > const & shared_vertices() const { return shared_vertices_; }
+
+    /** @brief The value returned by local_vertex_id() and local_cell_id() for elements which are not part of this submesh */
+    static std::size_t invalid_id() { return std::numeric_limits<std::size_t>::max(); }
+
+  private:
+    template<typename SrcMeshT, typename SubmeshT>
+    friend void extract_submeshes(SrcMeshT const &, std::vector<std::size_t> const &, std::size_t, std::size_t, std::vector<SubmeshT> &);
+
+    static std::size_t local_id(std::vector<std::size_t> const & global_ids, std::size_t global_id)
+    {
+      std::vector<std::size_t>::const_iterator it = std::lower_bound(global_ids.begin(), global_ids.end(), global_id);
+      if (it == global_ids.end() || *it != global_id)
+        return invalid_id();
+      return static_cast<std::size_t>(it - global_ids.begin());
+    }
+
+    mesh_type mesh_;
+    std::size_t part_;
+    std::size_t owned_cell_count_;
+
+    std::vector<std::size_t> vertex_global_ids;
+    std::vector<std::size_t> cell_global_ids;
+    std::vector<std::size_t> vertex_owners;
+    std::vector<std::size_t> cell_owners;
+    std::map< std::size_t, std::vector<std::size_t> > shared_vertices_;
+  };
+
+
+  namespace detail
+  {
+    /** @brief For internal use only. Inserts the elements of the sorted range [begin, end) into the sorted vector 'values'. */
+    template<typename IteratorT>
+    void merge_sorted(std::vector<std::size_t> & values, IteratorT begin, IteratorT end, std::vector<std::size_t> & buffer)
+    {
+      buffer.clear();
+      std::set_union(values.begin(), values.end(), begin, end, std::back_inserter(buffer));
+      values.swap(buffer);
+    }
+  }
+
+
+  /** @brief Extracts the submeshes of all parts of a partitioned mesh in one pass.
+    *
+    * Each submesh consists of the cells owned by the part and 'ghost_layers' layers of ghost cells: The first layer contains all cells sharing a vertex with an owned cell, each further layer the cells sharing a vertex with the previous layers.
+    * The submeshes contain vertices and cells only, boundary elements are created according to the configuration of the submesh type.
+    *
+    * @param mesh                 The partitioned mesh
+    * @param cell_part            The part of each cell indexed by the cell ID, e.g. obtained from viennagrid::partition()
+    * @param part_count           The number of parts
+    * @param ghost_layers         The number of layers of ghost cells
+    * @param submeshes            The resulting submeshes, one for each part
+    */
+  template<typename MeshT, typename SubmeshT>
+  void extract_submeshes(MeshT const & mesh, std::vector<std::size_t> const & cell_part, std::size_t part_count, std::size_t ghost_layers,
+                         std::vector<SubmeshT> & submeshes)
+  {
+    typedef typename SubmeshT::mesh_type                                           SubmeshMeshType;
+    typedef typename viennagrid::result_of::cell_tag<SubmeshMeshType>::type        CellTag;
+    typedef typename viennagrid::result_of::vertex_handle<SubmeshMeshType>::type   VertexHandleType;
+
+    detail::reordering_input<MeshT> input(mesh);
+
+    std::size_t vertex_count = input.vertices.size();
+    std::size_t cell_count = input.cells.size();
+
+    // process vertices and cells in the order of their global IDs
+    std::vector<std::size_t> vertex_ids(vertex_count);
+    for (std::size_t i = 0; i < vertex_count; ++i)
+      vertex_ids[i] = static_cast<std::size_t>( input.vertices[i]->id().get() );
+    std::vector<std::size_t> cell_ids(cell_count);
+    for (std::size_t i = 0; i < cell_count; ++i)
+      cell_ids[i] = static_cast<std::size_t>( input.cells[i]->id().get() );
+
+    std::vector<std::size_t> vertex_order = detail::order_by_keys(vertex_ids);
+    std::vector<std::size_t> cell_order = detail::order_by_keys(cell_ids);
+
+    // owners and the parts each element belongs to (as owned or ghost element), sorted
+    std::size_t no_owner = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> vertex_owner(vertex_count, no_owner);
+    std::vector< std::vector<std::size_t> > cell_parts(cell_count);
+    std::vector< std::vector<std::size_t> > vertex_parts(vertex_count);
+    std::vector<std::size_t> buffer;
+
+    for (std::size_t i = 0; i < cell_count; ++i)
+    {
+      std::size_t part = cell_part[ cell_ids[i] ];
+      cell_parts[i].push_back(part);
+      for (std::size_t j = input.cell_offsets[i]; j < input.cell_offsets[i+1]; ++j)
+        vertex_owner[input.cell_vertices[j]] = std::min(vertex_owner[input.cell_vertices[j]], part);
+    }
+
+    for (std::size_t layer = 0; ; ++layer)
+    {
+      for (std::size_t i = 0; i < cell_count; ++i)
+        for (std::size_t j = input.cell_offsets[i]; j < input.cell_offsets[i+1]; ++j)
+          detail::merge_sorted(vertex_parts[input.cell_vertices[j]], cell_parts[i].begin(), cell_parts[i].end(), buffer);
+
+      if (layer == ghost_layers)
+        break;
+
+      for (std::size_t i = 0; i < cell_count; ++i)
+        for (std::size_t j = input.cell_offsets[i]; j < input.cell_offsets[i+1]; ++j)
+          detail::merge_sorted(cell_parts[i], vertex_parts[input.cell_vertices[j]].begin(), vertex_parts[input.cell_vertices[j]].end(), buffer);
+    }
+
+    submeshes.clear();
+    submeshes.resize(part_count);
+    for (std::size_t part = 0; part < part_count; ++part)
+    {
+      submeshes[part].part_ = part;
+      submeshes[part].owned_cell_count_ = 0;
+    }
+
+    // vertices, ghost and owned cells go to all parts they belong to
+    std::vector< std::vector<VertexHandleType> > vertex_handles(vertex_count);
+    for (std::size_t k = 0; k < vertex_count; ++k)
+    {
+      std::size_t i = vertex_order[k];
+      for (std::size_t p = 0; p < vertex_parts[i].size(); ++p)
+      {
+        SubmeshT & sub = submeshes[ vertex_parts[i][p] ];
+        vertex_handles[i].push_back( viennagrid::make_vertex(sub.mesh(), input.points[i]) );
+        sub.vertex_global_ids.push_back( vertex_ids[i] );
+        sub.vertex_owners.push_back( vertex_owner[i] );
+      }
+    }
+
+    std::vector<VertexHandleType> vertices_on_cell;
+    for (std::size_t k = 0; k < cell_count; ++k)
+    {
+      std::size_t i = cell_order[k];
+      for (std::size_t p = 0; p < cell_parts[i].size(); ++p)
+      {
+        std::size_t part = cell_parts[i][p];
+        SubmeshT & sub = submeshes[part];
+
+        vertices_on_cell.clear();
+        for (std::size_t j = input.cell_offsets[i]; j < input.cell_offsets[i+1]; ++j)
+        {
+          std::size_t vertex = input.cell_vertices[j];
+          std::size_t index = static_cast<std::size_t>( std::lower_bound(vertex_parts[vertex].begin(), vertex_parts[vertex].end(), part) - vertex_parts[vertex].begin() );
+          vertices_on_cell.push_back( vertex_handles[vertex][index] );
+        }
+
+        viennagrid::make_element<CellTag>( sub.mesh(), vertices_on_cell.begin(), vertices_on_cell.end() );
+        sub.cell_global_ids.push_back( cell_ids[i] );
+        sub.cell_owners.push_back( cell_part[cell_ids[i]] );
+        if (cell_part[cell_ids[i]] == part)
+          ++sub.owned_cell_count_;
+      }
+    }
+
+    // shared vertices, the local ID is the position in the vertex list of the part
+    std::vector<std::size_t> local_vertex_count(part_count, 0);
+    for (std::size_t k = 0; k < vertex_count; ++k)
+    {
+      std::size_t i = vertex_order[k];
+      std::vector<std::size_t> const & parts = vertex_parts[i];
+      for (std::size_t p = 0; p < parts.size(); ++p)
+      {
+        for (std::size_t q = 0; q < parts.size(); ++q)
+          if (p != q)
+            submeshes[parts[p]].shared_vertices_[parts[q]].push_back( local_vertex_count[parts[p]] );
+        ++local_vertex_count[parts[p]];
+      }
+    }
+  }
+
+}
+
+#endif
@@ -13,9 +13,13 @@
    License:      MIT (X11), see file LICENSE in the base directory
 ======================================================================= */
 
+#include <map>
 #include <vector>
+#include <algorithm>
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/mesh/mesh.hpp"
+#include "viennagrid/mesh/implicit_boundary.hpp"
+#include "viennagrid/algorithm/detail/thread_partials.hpp"
 
 /** @file viennagrid/algorithm/quantity_transfer.hpp
     @brief Provides routines for transferring quantities defined for elements of one topological dimensions to elements of other topological dimension.
@@ -23,6 +27,174 @@
 
 namespace viennagrid
 {
+  /** @brief Averager computing the arithmetic mean of the values of the adjacent source elements.
+    *
+    * Can be used as container-based averager and as streaming averager, see quantity_transfer().
+    */
+  struct arithmetic_averager
+  {
+    template <typename ContainerT>
+    typename ContainerT::value_type operator()(ContainerT const & values) const
+    {
+      typename ContainerT::value_type result = typename ContainerT::value_type();
+      for (typename ContainerT::const_iterator it = values.begin(); it != values.end(); ++it)
+        result += *it;
+      return values.empty() ? result : result / static_cast<double>(values.size());
+    }
+
+    template <typename ValueT, typename SourceElementT>
+    void accumulate(ValueT & value, double & weight, ValueT const & source_value, SourceElementT const &) const
+    {
+      value += source_value;
+      weight += 1.0;
+    }
+
+    template <typename ValueT>
+    void merge(ValueT & value, double & weight, ValueT const & other_value, double other_weight) const
+    {
+      value += other_value;
+      weight += other_weight;
+    }
+
+    template <typename ValueT>
+    ValueT finalize(ValueT const & value, double weight) const { return value / weight; }
+  };
+
+  /** @brief Averager computing the minimum of the values of the adjacent source elements. */
+  struct min_averager
+  {
+    template <typename ContainerT>
+    typename ContainerT::value_type operator()(ContainerT const & values) const
+    {
+      return values.empty() ? typename ContainerT::value_type() : *std::min_element(values.begin(), values.end());
+    }
+
+    template <typename ValueT, typename SourceElementT>
+    void accumulate(ValueT & value, double & weight, ValueT const & source_value, SourceElementT const &) const
+    {
+      merge(value, weight, source_value, 1.0);
+    }
+
+    template <typename ValueT>
+    void merge(ValueT & value, double & weight, ValueT const & other_value, double other_weight) const
+    {
+      if (other_weight > 0 && (weight <= 0 || other_value < value))
+        value = other_value;
+      weight += other_weight;
+    }
+
+    template <typename ValueT>
+    ValueT finalize(ValueT const & value, double) const { return value; }
+  };
+
+  /** @brief Averager computing the maximum of the values of the adjacent source elements. */
+  struct max_averager
+  {
+    template <typename ContainerT>
+    typename ContainerT::value_type operator()(ContainerT const & values) const
+    {
+      return values.empty() ? typename ContainerT::value_type() : *std::max_element(values.begin(), values.end());
+    }
+
+    template <typename ValueT, typename SourceElementT>
+    void accumulate(ValueT & value, double & weight, ValueT const & source_value, SourceElementT const &) const
+    {
+      merge(value, weight, source_value, 1.0);
+    }
+
+    template <typename ValueT>
+    void merge(ValueT & value, double & weight, ValueT const & other_value, double other_weight) const
+    {
+      if (other_weight > 0 && (weight <= 0 || value < other_value))
+        value = other_value;
+      weight += other_weight;
+    }
+
+    template <typename ValueT>
+    ValueT finalize(ValueT const & value, double) const { return value; }
+  };
+
+  /** @brief Averager computing the mean of the values of the adjacent source elements weighted by a quantity of the source elements (e.g. their volume).
+    *
+    * Only usable as streaming averager, since the weights are obtained from the source elements.
+    *
+    * @tparam WeightAccessorT    An accessor returning the weight of a source element
+    */
+  template <typename WeightAccessorT>
+  class weighted_averager
+  {
+  public:
+    weighted_averager(WeightAccessorT const & weight_accessor) : weight_accessor_(weight_accessor) {}
+
+    template <typename ValueT, typename SourceElementT>
+    void accumulate(ValueT & value, double & weight, ValueT const & source_value, SourceElementT const & source_element) const
+    {
+      double source_weight = weight_accessor_(source_element);
+      value += source_weight * source_value;
+      weight += source_weight;
+    }
+
+    template <typename ValueT>
+    void merge(ValueT & value, double & weight, ValueT const & other_value, double other_weight) const
+    {
+      value += other_value;
+      weight += other_weight;
+    }
+
+    template <typename ValueT>
+    ValueT finalize(ValueT const & value, double weight) const { return value / weight; }
+
+  private:
+    WeightAccessorT weight_accessor_;
+  };
+
+  /** @brief Convenience function for creating a weighted_averager from an accessor for the weights of the source elements */
+  template <typename WeightAccessorT>
+  weighted_averager<WeightAccessorT> make_weighted_averager(WeightAccessorT const & weight_accessor)
+  {
+    return weighted_averager<WeightAccessorT>(weight_accessor);
+  }
+
+
+  namespace result_of
+  {
+    /** @brief Metafunction telling whether an averager provides the streaming interface accumulate(), merge() and finalize(). Specialize for user-defined streaming averagers.
+      *
+      * Streaming averagers are evaluated without collecting the values of the source elements in containers.
+      */
+    template <typename AveragerT>
+    struct is_streaming_averager
+    {
+      static const bool value = false;
+    };
+
+    /** \cond */
+    template <>
+    struct is_streaming_averager<arithmetic_averager>
+    {
+      static const bool value = true;
+    };
+
+    template <>
+    struct is_streaming_averager<min_averager>
+    {
+      static const bool value = true;
+    };
+
+    template <>
+    struct is_streaming_averager<max_averager>
+    {
+      static const bool value = true;
+    };
+
+    template <typename WeightAccessorT>
+    struct is_streaming_averager< weighted_averager<WeightAccessorT> >
+    {
+      static const bool value = true;
+    };
+    /** \endcond */
+  }
+
   namespace detail
   {
     /** @brief Indicates a transfer from higher to lower topological dimension (boundary operation) */
@@ -31,6 +203,24 @@ namespace viennagrid
     /** @brief Indicates a transfer from lower to higher topological dimension (coboundary operation) */
     struct coboundary_quantity_transfer_tag {};
 
+    /** @brief Indicates an averager operating on a container of all values of the adjacent source elements */
+    struct container_averager_tag {};
+
+    /** @brief Indicates an averager accumulating the values of the adjacent source elements one by one, see result_of::is_streaming_averager */
+    struct streaming_averager_tag {};
+
+    template <typename AveragerT, bool is_streaming = viennagrid::result_of::is_streaming_averager<AveragerT>::value>
+    struct averager_dispatcher
+    {
+      typedef container_averager_tag  type;
+    };
+
+    template <typename AveragerT>
+    struct averager_dispatcher<AveragerT, true>
+    {
+      typedef streaming_averager_tag  type;
+    };
+
     template <typename SourceTag, typename DestinationTag,
               bool less_than = (SourceTag::dim < DestinationTag::dim),
               bool larger_than = (SourceTag::dim > DestinationTag::dim)>
@@ -55,7 +245,7 @@ namespace viennagrid
               typename AveragerT,      typename SourceFilterT,   typename DestinationFilterT>
     void quantity_transfer(MeshOrSegmentT const & mesh_or_segment, SourceAccessorT const & accessor_src, DestinationSetterT & setter_dest,
                            AveragerT const & averager, SourceFilterT const & filter_src, DestinationFilterT const & filter_dest,
-                           boundary_quantity_transfer_tag)
+                           boundary_quantity_transfer_tag, container_averager_tag)
     {
       typedef typename viennagrid::result_of::element<MeshOrSegmentT, SourceTag>::type              SourceElementType;
       typedef typename viennagrid::result_of::element<MeshOrSegmentT, DestinationTag>::type         DestElementType;
@@ -108,7 +298,7 @@ namespace viennagrid
               typename AveragerT,      typename SourceFilterT,   typename DestinationFilterT>
     void quantity_transfer(MeshOrSegmentT const & mesh_or_segment, SourceAccessorT const & accessor_src, DestinationSetterT       & setter_dest,
                            AveragerT      const & averager,        SourceFilterT   const & filter_src,   DestinationFilterT const & filter_dest,
-                           coboundary_quantity_transfer_tag)
+                           coboundary_quantity_transfer_tag, container_averager_tag)
     {
       typedef typename viennagrid::result_of::element<MeshOrSegmentT, DestinationTag>::type         DestElementType;
 
@@ -136,7 +326,7 @@ namespace viennagrid
                                 ++sodit)
           {
             if (filter_src(*sodit))
-              destination_value_container.push_back(accessor_src(*dit));
+              destination_value_container.push_back(accessor_src(*sodit));
           }
 
           //
@@ -145,18 +335,217 @@ namespace viennagrid
       }
     }
 
+
+    /** @brief For internal use only. Merges the per-thread partial values and weights of a streaming averager, see thread_partials. */
+    template <typename AveragerT, typename ValueT>
+    class quantity_transfer_merger
+    {
+    public:
+      quantity_transfer_merger(AveragerT const & averager_, std::vector<ValueT> & values_, std::vector<double> & weights_) :
+          averager(averager_), values(values_), weights(weights_) {}
+
+      void operator()(std::size_t index, std::size_t partial_index) const
+      {
+        if (weights[partial_index] > 0)
+          averager.merge(values[index], weights[index], values[partial_index], weights[partial_index]);
+      }
+
+    private:
+      AveragerT const & averager;
+      std::vector<ValueT> & values;
+      std::vector<double> & weights;
+    };
+
+    /** @brief For internal use only. Accumulates the value of a source element into all its boundary elements of the destination type, see thread_partials. */
+    template <typename DestinationTag, typename SourceElementT, typename SourceAccessorT, typename AveragerT>
+    class quantity_transfer_boundary_kernel
+    {
+      typedef typename SourceAccessorT::value_type      value_type;
+
+      typedef typename viennagrid::result_of::const_element_range<SourceElementT, DestinationTag>::type  DestOnSrcContainer;
+      typedef typename viennagrid::result_of::iterator<DestOnSrcContainer>::type                         DestOnSrcIterator;
+
+    public:
+      quantity_transfer_boundary_kernel(std::vector<SourceElementT const *> const & source_cells_, SourceAccessorT const & accessor_src_, AveragerT const & averager_,
+                                        std::vector<value_type> & values_, std::vector<double> & weights_) :
+          source_cells(source_cells_), accessor_src(accessor_src_), averager(averager_), values(values_), weights(weights_) {}
+
+      void operator()(std::size_t i, std::size_t offset) const
+      {
+        SourceElementT const & source_cell = *source_cells[i];
+        value_type source_value = accessor_src(source_cell);
+
+        DestOnSrcContainer dest_on_src(source_cell);
+        for (DestOnSrcIterator dosit = dest_on_src.begin(); dosit != dest_on_src.end(); ++dosit)
+        {
+          std::size_t index = offset + static_cast<std::size_t>( (*dosit).id().get() );
+          averager.accumulate(values[index], weights[index], source_value, source_cell);
+        }
+      }
+
+    private:
+      std::vector<SourceElementT const *> const & source_cells;
+      SourceAccessorT const & accessor_src;
+      AveragerT const & averager;
+      std::vector<value_type> & values;
+      std::vector<double> & weights;
+    };
+
+    /** @brief For internal use only. Accumulates the value of a cell into all its implicit boundary elements, see thread_partials. */
+    template <typename BoundaryElementsT, typename SourceAccessorT, typename AveragerT>
+    class quantity_transfer_implicit_kernel
+    {
+      typedef typename BoundaryElementsT::cell_type     CellType;
+      typedef typename SourceAccessorT::value_type      value_type;
+
+    public:
+      quantity_transfer_implicit_kernel(BoundaryElementsT const & boundary_elements_, std::vector<CellType const *> const & cells_,
+                                        SourceAccessorT const & accessor_src_, AveragerT const & averager_,
+                                        std::vector<value_type> & values_, std::vector<double> & weights_) :
+          boundary_elements(boundary_elements_), cells(cells_), accessor_src(accessor_src_), averager(averager_), values(values_), weights(weights_) {}
+
+      void operator()(std::size_t i, std::size_t offset) const
+      {
+        CellType const & cell = *cells[i];
+        value_type source_value = accessor_src(cell);
+
+        for (int j = 0; j < BoundaryElementsT::num_per_cell; ++j)
+        {
+          std::size_t index = offset + boundary_elements.id(cell, j);
+          averager.accumulate(values[index], weights[index], source_value, cell);
+        }
+      }
+
+    private:
+      BoundaryElementsT const & boundary_elements;
+      std::vector<CellType const *> const & cells;
+      SourceAccessorT const & accessor_src;
+      AveragerT const & averager;
+      std::vector<value_type> & values;
+      std::vector<double> & weights;
+    };
+
+    /** @brief For internal use only. Passes the accumulated values of all destination elements accepted by the filter and reached by at least one source element to the setter. */
+    template <typename DestinationTag,
+              typename MeshOrSegmentT, typename ValueT, typename DestinationSetterT,
+              typename AveragerT,      typename DestinationFilterT>
+    void quantity_transfer_write(MeshOrSegmentT const & mesh_or_segment,
+                                 std::vector<ValueT> const & values, std::vector<double> const & weights,
+                                 DestinationSetterT & setter_dest, AveragerT const & averager, DestinationFilterT const & filter_dest)
+    {
+      typedef typename viennagrid::result_of::const_element_range<MeshOrSegmentT, DestinationTag>::type DestContainer;
+      typedef typename viennagrid::result_of::iterator<DestContainer>::type                             DestIterator;
+
+      DestContainer dest_cells(mesh_or_segment);
+      for (DestIterator dit = dest_cells.begin(); dit != dest_cells.end(); ++dit)
+      {
+        std::size_t index = static_cast<std::size_t>( (*dit).id().get() );
+        if ( weights[index] > 0 && filter_dest(*dit) )
+          setter_dest(*dit, averager.finalize(values[index], weights[index]));
+      }
+    }
+
+    /** @brief For internal use only. Collects pointers to all elements of a mesh or segment accepted by a filter, such that they can be processed by index. */
+    template <typename ElementTag, typename MeshOrSegmentT, typename ElementT, typename FilterT>
+    void quantity_transfer_collect(MeshOrSegmentT const & mesh_or_segment, std::vector<ElementT const *> & elements, FilterT const & filter)
+    {
+      typedef typename viennagrid::result_of::const_element_range<MeshOrSegmentT, ElementTag>::type ElementContainer;
+      typedef typename viennagrid::result_of::iterator<ElementContainer>::type                      ElementIterator;
+
+      ElementContainer range(mesh_or_segment);
+      elements.reserve(range.size());
+      for (ElementIterator it = range.begin(); it != range.end(); ++it)
+        if ( filter(*it) )
+          elements.push_back( &(*it) );
+    }
+
+
+    /** @brief For internal use only. Boundary transfer with a streaming averager. The source elements are processed in parallel, accumulating into per-thread arrays indexed by the destination element IDs (see thread_partials). */
+    template <typename SourceTag,      typename DestinationTag,
+              typename MeshOrSegmentT, typename SourceAccessorT, typename DestinationSetterT,
+              typename AveragerT,      typename SourceFilterT,   typename DestinationFilterT>
+    void quantity_transfer(MeshOrSegmentT const & mesh_or_segment, SourceAccessorT const & accessor_src, DestinationSetterT & setter_dest,
+                           AveragerT const & averager, SourceFilterT const & filter_src, DestinationFilterT const & filter_dest,
+                           boundary_quantity_transfer_tag, streaming_averager_tag)
+    {
+      typedef typename viennagrid::result_of::element<MeshOrSegmentT, SourceTag>::type              SourceElementType;
+
+      typedef typename SourceAccessorT::value_type              value_type;
+
+      std::vector<SourceElementType const *> source_cells;
+      quantity_transfer_collect<SourceTag>(mesh_or_segment, source_cells, filter_src);
+
+      thread_partials partials( static_cast<std::size_t>( viennagrid::id_upper_bound<DestinationTag>(mesh_or_segment).get() ) );
+      std::vector<value_type> values( partials.size(), value_type() );
+      std::vector<double>     weights( partials.size(), 0.0 );
+
+      partials.accumulate( source_cells.size(),
+                           quantity_transfer_boundary_kernel<DestinationTag, SourceElementType, SourceAccessorT, AveragerT>(source_cells, accessor_src, averager, values, weights) );
+      partials.merge( quantity_transfer_merger<AveragerT, value_type>(averager, values, weights) );
+
+      quantity_transfer_write<DestinationTag>(mesh_or_segment, values, weights, setter_dest, averager, filter_dest);
+    }
+
+    /** @brief For internal use only. Coboundary transfer with a streaming averager. The destination elements are processed in parallel, each one accumulating the values of its boundary elements. */
+    template <typename SourceTag,      typename DestinationTag,
+              typename MeshOrSegmentT, typename SourceAccessorT, typename DestinationSetterT,
+              typename AveragerT,      typename SourceFilterT,   typename DestinationFilterT>
+    void quantity_transfer(MeshOrSegmentT const & mesh_or_segment, SourceAccessorT const & accessor_src, DestinationSetterT & setter_dest,
+                           AveragerT const & averager, SourceFilterT const & filter_src, DestinationFilterT const & filter_dest,
+                           coboundary_quantity_transfer_tag, streaming_averager_tag)
+    {
+      typedef typename viennagrid::result_of::element<MeshOrSegmentT, DestinationTag>::type         DestElementType;
+
+      typedef typename viennagrid::result_of::const_element_range<DestElementType, SourceTag>::type  SrcOnDestContainer;
+      typedef typename viennagrid::result_of::iterator<SrcOnDestContainer>::type                     SrcOnDestIterator;
+
+      typedef typename SourceAccessorT::value_type              value_type;
+
+      std::vector<DestElementType const *> dest_cells;
+      quantity_transfer_collect<DestinationTag>(mesh_or_segment, dest_cells, filter_dest);
+
+      std::size_t dest_id_upper_bound = static_cast<std::size_t>( viennagrid::id_upper_bound<DestinationTag>(mesh_or_segment).get() );
+      std::vector<value_type> values( dest_id_upper_bound, value_type() );
+      std::vector<double>     weights( dest_id_upper_bound, 0.0 );
+
+      long dest_count = static_cast<long>(dest_cells.size());
+
+#ifdef VIENNAGRID_WITH_OPENMP
+      #pragma omp parallel for schedule(static)
+#endif
+      for (long i = 0; i < dest_count; ++i)
+      {
+        DestElementType const & dest_cell = *dest_cells[static_cast<std::size_t>(i)];
+        std::size_t index = static_cast<std::size_t>( dest_cell.id().get() );
+
+        SrcOnDestContainer src_on_dest(dest_cell);
+        for (SrcOnDestIterator sodit = src_on_dest.begin(); sodit != src_on_dest.end(); ++sodit)
+        {
+          if (filter_src(*sodit))
+            averager.accumulate(values[index], weights[index], accessor_src(*sodit), *sodit);
+        }
+      }
+
+      quantity_transfer_write<DestinationTag>(mesh_or_segment, values, weights, setter_dest, averager, filter_dest);
+    }
+
   }
 
   /** @brief Transfers data defined on 'source' elements to 'destination' elements. For example, values defined on cells are tranferred to vertices.
    *
    * Even though this functionality is sometimes referred to as interpolation, it is not an interpolation in the strict mathematical sense.
    *
+   * The averager either computes the value of the destination element from an STL-compatible container holding the values of all adjacent source elements,
+   * or it is a streaming averager (see result_of::is_streaming_averager) like arithmetic_averager, min_averager, max_averager and weighted_averager.
+   * Streaming averagers accumulate the values in arrays indexed by the element IDs without per-element allocations and run in parallel if VIENNAGRID_WITH_OPENMP is defined.
+   * In this case, the accessor, averager and filters have to support concurrent calls. Only destination elements adjacent to at least one accepted source element are passed to the setter.
+   *
    * @tparam SourceTypeOrTag        Topological source element or tag, e.g., cell_tag
    * @tparam DestinationTypeOrTag   Topological destination element or tag, e.g., vertex_tag
    * @param mesh_or_segment    A mesh or segment, in which the source and destination elements reside
    * @param accessor_src       An accessor functor for retrieving the data defined on each source element
    * @param setter_dest        A setter for storing the data on each destination element (first argument is the destination n-cell, second argument is the value)
-   * @param averager           A functor which computes the value of the destination element from an STL-compatible container holding the values of all adjacent source elements
+   * @param averager           A streaming averager or a functor which computes the value of the destination element from an STL-compatible container holding the values of all adjacent source elements
    * @param filter_src         A functor which returns true for all source elements considered for the transfer, false otherwise
    * @param filter_dest        A functor which returns true for all destination elements considered for the transfer, false otherwise
    */
@@ -171,7 +560,50 @@ namespace viennagrid
 
     detail::quantity_transfer<SourceTag, DestinationTag>(mesh_or_segment, accessor_src, setter_dest,
                                                  averager, filter_src, filter_dest,
-                                                 typename detail::quantity_transfer_dispatcher<SourceTag, DestinationTag>::type());
+                                                 typename detail::quantity_transfer_dispatcher<SourceTag, DestinationTag>::type(),
+                                                 typename detail::averager_dispatcher<AveragerT>::type());
+  }
+
+  /** @brief Transfers data defined on the cells of a mesh or segment to implicit boundary elements (see implicit_boundary_elements), e.g. to the facets of a thin mesh.
+   *
+   * Only streaming averagers are supported. The resulting values are stored by the compact IDs of the boundary elements.
+   * Boundary elements not adjacent to any accepted cell obtain a default-constructed value.
+   *
+   * @param mesh_or_segment    The mesh or segment the implicit boundary elements were built for
+   * @param boundary_elements  The implicit boundary elements
+   * @param accessor_src       An accessor functor for retrieving the data defined on each cell
+   * @param values_dest        A container where the values for the boundary elements are written to, resized to boundary_elements.size()
+   * @param averager           A streaming averager, see result_of::is_streaming_averager
+   * @param filter_src         A functor which returns true for all cells considered for the transfer, false otherwise
+   */
+  template <typename MeshOrSegmentT, typename BoundaryTagT, typename SourceAccessorT, typename AveragerT, typename SourceFilterT>
+  void quantity_transfer(MeshOrSegmentT const & mesh_or_segment,
+                         implicit_boundary_elements<MeshOrSegmentT, BoundaryTagT> const & boundary_elements,
+                         SourceAccessorT const & accessor_src,
+                         std::vector<typename SourceAccessorT::value_type> & values_dest,
+                         AveragerT const & averager, SourceFilterT const & filter_src)
+  {
+    typedef implicit_boundary_elements<MeshOrSegmentT, BoundaryTagT>    BoundaryElementsType;
+    typedef typename BoundaryElementsType::cell_tag                     CellTag;
+    typedef typename BoundaryElementsType::cell_type                    CellType;
+    typedef typename SourceAccessorT::value_type                        value_type;
+
+    std::vector<CellType const *> cells;
+    detail::quantity_transfer_collect<CellTag>(mesh_or_segment, cells, filter_src);
+
+    std::size_t element_count = boundary_elements.size();
+
+    detail::thread_partials partials(element_count);
+    std::vector<value_type> values( partials.size(), value_type() );
+    std::vector<double>     weights( partials.size(), 0.0 );
+
+    partials.accumulate( cells.size(),
+                         detail::quantity_transfer_implicit_kernel<BoundaryElementsType, SourceAccessorT, AveragerT>(boundary_elements, cells, accessor_src, averager, values, weights) );
+    partials.merge( detail::quantity_transfer_merger<AveragerT, value_type>(averager, values, weights) );
+
+    values_dest.resize(element_count);
+    for (std::size_t i = 0; i < element_count; ++i)
+      values_dest[i] = (weights[i] > 0) ? averager.finalize(values[i], weights[i]) : value_type();
   }
 
 }
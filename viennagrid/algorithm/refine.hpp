@@ -13,6 +13,8 @@
    License:      MIT (X11), see file LICENSE in the base directory
 ======================================================================= */
 
+#include <map>
+
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/algorithm/centroid.hpp"
 #include "viennagrid/algorithm/norm.hpp"
@@ -22,6 +24,9 @@
 
 #include "viennagrid/algorithm/detail/refine_tri.hpp"
 #include "viennagrid/algorithm/detail/refine_tet.hpp"
+#include "viennagrid/algorithm/detail/refine_quad.hpp"
+#include "viennagrid/algorithm/detail/refine_hex.hpp"
+#include "viennagrid/algorithm/hanging_vertices.hpp"
 
 #include "viennagrid/algorithm/detail/numeric.hpp"
 
@@ -32,6 +37,103 @@
 namespace viennagrid
 {
 
+  namespace detail
+  {
+    /** @brief Refines the elements of a mesh based on edge information, facet center vertices are shared using a facet to vertex map. For internal use only. */
+    template<typename ElementTypeOrTagT,
+              typename WrappedMeshConfigInT,
+              typename WrappedMeshConfigOutT,
+              typename VertexCopyMapT,
+              typename EdgeRefinementFlagAccessorT, typename RefinementVertexAccessorT,
+              typename FacetToVertexHandleMapT>
+    void simple_refine_impl(mesh<WrappedMeshConfigInT> const & mesh_in,
+                            mesh<WrappedMeshConfigOutT> & mesh_out,
+                            VertexCopyMapT & vertex_copy_map_,
+                            EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
+                            RefinementVertexAccessorT const & edge_to_vertex_handle_accessor,
+                            FacetToVertexHandleMapT & facet_to_vertex_handle_map)
+    {
+      typedef mesh<WrappedMeshConfigInT>       InputMeshType;
+      typedef mesh<WrappedMeshConfigOutT>      OutputMeshType;
+
+      typedef typename viennagrid::result_of::element_tag<ElementTypeOrTagT>::type                         ElementTag;
+      typedef typename viennagrid::result_of::const_element_range<InputMeshType, ElementTypeOrTagT>::type  ElementRange;
+      typedef typename viennagrid::result_of::iterator<ElementRange>::type                                 ElementIterator;
+
+      ElementRange cells(mesh_in);
+      for (ElementIterator cit  = cells.begin();
+                        cit != cells.end();
+                      ++cit)
+      {
+        typedef typename viennagrid::result_of::vertex_handle<OutputMeshType>::type OutputVertexHandleType;
+        typedef std::vector<OutputVertexHandleType> VertexHandlesContainerType;
+        typedef std::vector<VertexHandlesContainerType> ElementsContainerType;
+        ElementsContainerType elements_vertices;
+
+        detail::element_refinement<ElementTag>::apply(*cit, mesh_out, elements_vertices, vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map);
+
+        for (typename ElementsContainerType::iterator it = elements_vertices.begin();
+              it != elements_vertices.end();
+              ++it)
+          viennagrid::make_element<ElementTypeOrTagT>( mesh_out, it->begin(), it->end() );
+      }
+    }
+
+
+    /** @brief Refines the elements of a mesh and a segmentation based on edge information, facet center vertices are shared using a facet to vertex map. For internal use only. */
+    template<typename ElementTypeOrTagT,
+              typename WrappedMeshConfigInT,  typename WrappedSegmentationConfigInT,
+              typename WrappedMeshConfigOutT, typename WrappedSegmentationConfigOutT,
+              typename VertexCopyMapT,
+              typename EdgeRefinementFlagAccessorT, typename RefinementVertexAccessorT,
+              typename FacetToVertexHandleMapT>
+    void simple_refine_impl(mesh<WrappedMeshConfigInT>                 const & mesh_in,
+                            segmentation<WrappedSegmentationConfigInT> const & segmentation_in,
+                            mesh<WrappedMeshConfigOutT>                      & mesh_out,
+                            segmentation<WrappedSegmentationConfigOutT>      & segmentation_out,
+                            VertexCopyMapT & vertex_copy_map_,
+                            EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
+                            RefinementVertexAccessorT const & edge_to_vertex_handle_accessor,
+                            FacetToVertexHandleMapT & facet_to_vertex_handle_map)
+    {
+      typedef mesh<WrappedMeshConfigInT>    InputMeshType;
+      typedef mesh<WrappedMeshConfigOutT>   OutputMeshType;
+
+      typedef segmentation<WrappedSegmentationConfigInT>      InputSegmentationType;
+
+      typedef typename viennagrid::result_of::element_tag<ElementTypeOrTagT>::type                        ElementTag;
+      typedef typename viennagrid::result_of::const_element_range<InputMeshType, ElementTypeOrTagT>::type ElementRange;
+      typedef typename viennagrid::result_of::iterator<ElementRange>::type                                ElementIterator;
+
+      ElementRange cells(mesh_in);
+      for (ElementIterator cit  = cells.begin();
+                        cit != cells.end();
+                      ++cit)
+      {
+        typedef typename viennagrid::result_of::segment_id_range<InputSegmentationType, ElementTypeOrTagT>::type SegmentIDRangeType;
+
+        SegmentIDRangeType segment_ids = viennagrid::segment_ids( segmentation_in, *cit );
+
+        typedef typename viennagrid::result_of::vertex_handle<OutputMeshType>::type OutputVertexHandleType;
+        typedef typename viennagrid::result_of::handle<OutputMeshType, ElementTypeOrTagT>::type OutputCellHandleType;
+        typedef std::vector<OutputVertexHandleType> VertexHandlesContainerType;
+        typedef std::vector<VertexHandlesContainerType> ElementsContainerType;
+        ElementsContainerType elements_vertices;
+
+        detail::element_refinement<ElementTag>::apply(*cit, mesh_out, elements_vertices, vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map);
+
+        for (typename ElementsContainerType::iterator it = elements_vertices.begin();
+              it != elements_vertices.end();
+              ++it)
+        {
+          OutputCellHandleType new_cell = viennagrid::make_element<ElementTypeOrTagT>( mesh_out, it->begin(), it->end() );
+          viennagrid::add( segmentation_out, segment_ids.begin(), segment_ids.end(), new_cell );
+        }
+      }
+    }
+  } //namespace detail
+
+
   /** @brief Refines a mesh based on edge information. A bool accessor, indicating if an edge should be refined, and a vertex handle accessor, representing the new vertex of an edge to refine, are used for the refinement process.
    *
    * @tparam ElementTypeOrTagT                The element type/tag which elements are refined
@@ -52,29 +154,10 @@ namespace viennagrid
                      EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
                      RefinementVertexAccessorT const & edge_to_vertex_handle_accessor)
   {
-    typedef mesh<WrappedMeshConfigInT>       InputMeshType;
-    typedef mesh<WrappedMeshConfigOutT>      OutputMeshType;
-
-    typedef typename viennagrid::result_of::const_element_range<InputMeshType, ElementTypeOrTagT>::type  ElementRange;
-    typedef typename viennagrid::result_of::iterator<ElementRange>::type                                 ElementIterator;
-
-    ElementRange cells(mesh_in);
-    for (ElementIterator cit  = cells.begin();
-                      cit != cells.end();
-                    ++cit)
-    {
-      typedef typename viennagrid::result_of::vertex_handle<OutputMeshType>::type OutputVertexHandleType;
-      typedef std::vector<OutputVertexHandleType> VertexHandlesContainerType;
-      typedef std::vector<VertexHandlesContainerType> ElementsContainerType;
-      ElementsContainerType elements_vertices;
-
-      detail::element_refinement<ElementTypeOrTagT>::apply(*cit, mesh_out, elements_vertices, vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor);
+    typedef typename viennagrid::result_of::vertex_handle< mesh<WrappedMeshConfigOutT> >::type OutputVertexHandleType;
 
-      for (typename ElementsContainerType::iterator it = elements_vertices.begin();
-            it != elements_vertices.end();
-            ++it)
-        viennagrid::make_element<ElementTypeOrTagT>( mesh_out, it->begin(), it->end() );
-    }
+    detail::refinement_facet_vertex_map<OutputVertexHandleType> facet_to_vertex_handle_map;
+    detail::simple_refine_impl<ElementTypeOrTagT>(mesh_in, mesh_out, vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map);
   }
 
 
@@ -102,47 +185,246 @@ namespace viennagrid
                      EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
                      RefinementVertexAccessorT const & edge_to_vertex_handle_accessor)
   {
-    typedef mesh<WrappedMeshConfigInT>    InputMeshType;
-    typedef mesh<WrappedMeshConfigOutT>   OutputMeshType;
+    typedef typename viennagrid::result_of::vertex_handle< mesh<WrappedMeshConfigOutT> >::type OutputVertexHandleType;
 
-    typedef segmentation<WrappedSegmentationConfigInT>      InputSegmentationType;
+    detail::refinement_facet_vertex_map<OutputVertexHandleType> facet_to_vertex_handle_map;
+    detail::simple_refine_impl<ElementTypeOrTagT>(mesh_in, segmentation_in, mesh_out, segmentation_out,
+                                                  vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map);
+  }
 
-    typedef typename viennagrid::result_of::const_element_range<InputMeshType, ElementTypeOrTagT>::type ElementRange;
-    typedef typename viennagrid::result_of::iterator<ElementRange>::type                                ElementIterator;
 
-    ElementRange cells(mesh_in);
-    for (ElementIterator cit  = cells.begin();
-                      cit != cells.end();
-                    ++cit)
+
+
+  namespace detail
+  {
+
+    /** @brief Creates the refinement vertices of all tagged edges (simplices). For internal use only. */
+    template<typename WrappedMeshConfigInT, typename WrappedMeshConfigOutT,
+              typename PointAccessorT,
+              typename VertexCopyMapT,
+              typename EdgeRefinementFlagAccessorT, typename RefinementVertexAccessorT,
+              typename FacetToVertexHandleMapT, typename CellTagT>
+    void make_refinement_vertices(mesh<WrappedMeshConfigInT> const & mesh_in,
+                                  mesh<WrappedMeshConfigOutT> & mesh_out,
+                                  PointAccessorT const point_accessor_in,
+                                  VertexCopyMapT &,
+                                  EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
+                                  RefinementVertexAccessorT & edge_to_vertex_handle_accessor,
+                                  FacetToVertexHandleMapT &,
+                                  CellTagT)
+    {
+      typedef mesh<WrappedMeshConfigInT>       InputMeshType;
+
+      typedef typename viennagrid::result_of::const_line_range<InputMeshType>::type                 EdgeRange;
+      typedef typename viennagrid::result_of::iterator<EdgeRange>::type                             EdgeIterator;
+
+      EdgeRange edges(mesh_in);
+      for (EdgeIterator eit = edges.begin();
+                        eit != edges.end();
+                      ++eit)
+      {
+        if ( edge_refinement_flag_accessor(*eit) )
+        {
+          edge_to_vertex_handle_accessor( *eit ) = viennagrid::make_vertex( mesh_out, viennagrid::centroid(point_accessor_in, *eit) );
+        }
+      }
+    }
+
+    /** @brief Facets of a quadrilateral mesh are lines, there are no facet centers to share. For internal use only. */
+    template<typename MeshT, typename VertexT, typename RefinementVertexAccessorT, typename FacetToVertexHandleMapT, typename CellTagT>
+    void share_split_facet_centers(MeshT const &, std::vector<VertexT const *> const &, std::vector<bool> const &,
+                                   RefinementVertexAccessorT &, FacetToVertexHandleMapT &, CellTagT) {}
+
+    /** @brief A facet of a hexahedral mesh which is crossed by a line connecting the vertices hanging on two opposite edges (left by an anisotropic split of the neighbor)
+     * shares its center with the refinement vertex of that line. For internal use only.
+     */
+    template<typename MeshT, typename VertexT, typename RefinementVertexAccessorT, typename FacetToVertexHandleMapT>
+    void share_split_facet_centers(MeshT const & mesh_in,
+                                   std::vector<VertexT const *> const & hanging_on_edge,
+                                   std::vector<bool> const & split_edges,
+                                   RefinementVertexAccessorT & edge_to_vertex_handle_accessor,
+                                   FacetToVertexHandleMapT & facet_to_vertex_handle_map,
+                                   hexahedron_tag)
     {
-      typedef typename viennagrid::result_of::segment_id_range<InputSegmentationType, ElementTypeOrTagT>::type SegmentIDRangeType;
+      typedef typename viennagrid::result_of::line<MeshT>::type                          EdgeType;
+      typedef typename viennagrid::result_of::facet<MeshT>::type                         FacetType;
+      typedef typename viennagrid::result_of::const_line_range<MeshT>::type              EdgeRange;
+      typedef typename viennagrid::result_of::iterator<EdgeRange>::type                  EdgeIterator;
+      typedef typename viennagrid::result_of::const_facet_range<MeshT>::type             FacetRange;
+      typedef typename viennagrid::result_of::iterator<FacetRange>::type                 FacetIterator;
+      typedef typename viennagrid::result_of::const_line_range<FacetType>::type          EdgeOnFacetRange;
+      typedef typename viennagrid::result_of::iterator<EdgeOnFacetRange>::type           EdgeOnFacetIterator;
+      typedef typename FacetToVertexHandleMapT::vertex_handle_type                       VertexHandleType;
+      typedef std::pair<std::size_t, std::size_t>                                         VertexIDPairType;
+
+      std::map<VertexIDPairType, EdgeType const *> edge_by_vertices;
+      EdgeRange edges(mesh_in);
+      for (EdgeIterator eit = edges.begin(); eit != edges.end(); ++eit)
+      {
+        std::size_t a = static_cast<std::size_t>( viennagrid::vertices(*eit)[0].id().get() );
+        std::size_t b = static_cast<std::size_t>( viennagrid::vertices(*eit)[1].id().get() );
+        edge_by_vertices[ VertexIDPairType(std::min(a, b), std::max(a, b)) ] = &*eit;
+      }
+
+      FacetRange facets(mesh_in);
+      for (FacetIterator fit = facets.begin(); fit != facets.end(); ++fit)
+      {
+        std::size_t facet_id = static_cast<std::size_t>( (*fit).id().get() );
+        VertexHandleType center;
+        if ( facet_to_vertex_handle_map.find(facet_id, center) )
+          continue;
+
+        bool found = false;
+        EdgeOnFacetRange edges_on_facet(*fit);
+        for (EdgeOnFacetIterator e0 = edges_on_facet.begin(); e0 != edges_on_facet.end() && !found; ++e0)
+          for (EdgeOnFacetIterator e1 = e0; e1 != edges_on_facet.end() && !found; ++e1)
+          {
+            VertexT const * m0 = hanging_on_edge[ static_cast<std::size_t>((*e0).id().get()) ];
+            VertexT const * m1 = hanging_on_edge[ static_cast<std::size_t>((*e1).id().get()) ];
+            if (!m0 || !m1 || m0 == m1)
+              continue;
+
+            std::size_t a = static_cast<std::size_t>( m0->id().get() );
+            std::size_t b = static_cast<std::size_t>( m1->id().get() );
+            typename std::map<VertexIDPairType, EdgeType const *>::const_iterator it = edge_by_vertices.find( VertexIDPairType(std::min(a, b), std::max(a, b)) );
+            if ( it != edge_by_vertices.end() && split_edges[ static_cast<std::size_t>(it->second->id().get()) ] )
+            {
+              facet_to_vertex_handle_map.insert( facet_id, edge_to_vertex_handle_accessor(*it->second) );
+              found = true;
+            }
+          }
+      }
+    }
 
-      SegmentIDRangeType segment_ids = viennagrid::segment_ids( segmentation_in, *cit );
+    /** @brief Creates the refinement vertices of quadrilateral and hexahedral meshes. For internal use only.
+     *
+     * Only edges which are split by at least one cell obtain a refinement vertex. Vertices hanging on an edge or facet of the input mesh are reused as refinement vertices of that edge or facet.
+     */
+    template<typename CellTagT,
+              typename WrappedMeshConfigInT, typename WrappedMeshConfigOutT,
+              typename PointAccessorT,
+              typename VertexCopyMapT,
+              typename EdgeRefinementFlagAccessorT, typename RefinementVertexAccessorT,
+              typename FacetToVertexHandleMapT>
+    void make_tensor_cell_refinement_vertices(mesh<WrappedMeshConfigInT> const & mesh_in,
+                                              mesh<WrappedMeshConfigOutT> & mesh_out,
+                                              PointAccessorT const point_accessor_in,
+                                              VertexCopyMapT & vertex_copy_map_,
+                                              EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
+                                              RefinementVertexAccessorT & edge_to_vertex_handle_accessor,
+                                              FacetToVertexHandleMapT & facet_to_vertex_handle_map)
+    {
+      typedef mesh<WrappedMeshConfigInT>                                                          InputMeshType;
+      typedef typename viennagrid::result_of::element<InputMeshType, vertex_tag>::type            VertexType;
+      typedef typename viennagrid::result_of::element<InputMeshType, line_tag>::type              EdgeType;
+      typedef typename viennagrid::result_of::element<InputMeshType, CellTagT>::type              CellType;
+      typedef detail::tensor_cell<CellType, CellTagT::dim>                                        TensorCellType;
+
+      typedef typename viennagrid::result_of::const_line_range<InputMeshType>::type               EdgeRange;
+      typedef typename viennagrid::result_of::iterator<EdgeRange>::type                           EdgeIterator;
+      typedef typename viennagrid::result_of::const_element_range<InputMeshType, CellTagT>::type  CellRange;
+      typedef typename viennagrid::result_of::iterator<CellRange>::type                           CellIterator;
+
+      std::size_t edge_id_bound = static_cast<std::size_t>( viennagrid::id_upper_bound<EdgeType>(mesh_in).get() );
+
+      // edges split by at least one cell
+      std::vector<bool> split_edges(edge_id_bound, false);
+      CellRange cells(mesh_in);
+      for (CellIterator cit = cells.begin(); cit != cells.end(); ++cit)
+      {
+        TensorCellType cell(*cit);
+        for (int d = 0; d < CellTagT::dim; ++d)
+          if ( cell.is_split(d, edge_refinement_flag_accessor) )
+            for (int base = 0; base < TensorCellType::corner_count; ++base)
+              if ( !(base & (1 << d)) )
+                split_edges[ static_cast<std::size_t>(cell.edges[base][d]->id().get()) ] = true;
+      }
 
-      typedef typename viennagrid::result_of::vertex_handle<OutputMeshType>::type OutputVertexHandleType;
-      typedef typename viennagrid::result_of::handle<OutputMeshType, ElementTypeOrTagT>::type OutputCellHandleType;
-      typedef std::vector<OutputVertexHandleType> VertexHandlesContainerType;
-      typedef std::vector<VertexHandlesContainerType> ElementsContainerType;
-      ElementsContainerType elements_vertices;
+      // hanging vertices become the refinement vertices of their lines and facets
+      std::vector< detail::hanging_vertex_info<VertexType> > hanging_vertices;
+      detail::find_hanging_vertices(mesh_in, hanging_vertices);
 
-      detail::element_refinement<ElementTypeOrTagT>::apply(*cit, mesh_out, elements_vertices, vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor);
+      std::vector<VertexType const *> hanging_on_edge(edge_id_bound, NULL);
+      for (std::size_t i = 0; i < hanging_vertices.size(); ++i)
+      {
+        if (hanging_vertices[i].parent_count == 2)
+          hanging_on_edge[ hanging_vertices[i].parent_id ] = hanging_vertices[i].vertex;
+        else
+          facet_to_vertex_handle_map.insert( hanging_vertices[i].parent_id, vertex_copy_map_(*hanging_vertices[i].vertex) );
+      }
 
-      for (typename ElementsContainerType::iterator it = elements_vertices.begin();
-            it != elements_vertices.end();
-            ++it)
+      EdgeRange edges(mesh_in);
+      for (EdgeIterator eit = edges.begin(); eit != edges.end(); ++eit)
       {
-        OutputCellHandleType new_cell = viennagrid::make_element<ElementTypeOrTagT>( mesh_out, it->begin(), it->end() );
-        viennagrid::add( segmentation_out, segment_ids.begin(), segment_ids.end(), new_cell );
+        std::size_t id = static_cast<std::size_t>( (*eit).id().get() );
+        if (!split_edges[id])
+          continue;
+
+        if (hanging_on_edge[id])
+          edge_to_vertex_handle_accessor( *eit ) = vertex_copy_map_( *hanging_on_edge[id] );
+        else
+          edge_to_vertex_handle_accessor( *eit ) = viennagrid::make_vertex( mesh_out, viennagrid::centroid(point_accessor_in, *eit) );
       }
+
+      share_split_facet_centers(mesh_in, hanging_on_edge, split_edges, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map, CellTagT());
     }
-  }
 
+    /** @brief Creates the refinement vertices of a quadrilateral mesh. For internal use only. */
+    template<typename WrappedMeshConfigInT, typename WrappedMeshConfigOutT,
+              typename PointAccessorT,
+              typename VertexCopyMapT,
+              typename EdgeRefinementFlagAccessorT, typename RefinementVertexAccessorT,
+              typename FacetToVertexHandleMapT>
+    void make_refinement_vertices(mesh<WrappedMeshConfigInT> const & mesh_in,
+                                  mesh<WrappedMeshConfigOutT> & mesh_out,
+                                  PointAccessorT const point_accessor_in,
+                                  VertexCopyMapT & vertex_copy_map_,
+                                  EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
+                                  RefinementVertexAccessorT & edge_to_vertex_handle_accessor,
+                                  FacetToVertexHandleMapT & facet_to_vertex_handle_map,
+                                  quadrilateral_tag)
+    {
+      make_tensor_cell_refinement_vertices<quadrilateral_tag>(mesh_in, mesh_out, point_accessor_in, vertex_copy_map_,
+                                                              edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map);
+    }
 
+    /** @brief Creates the refinement vertices of a hexahedral mesh. For internal use only. */
+    template<typename WrappedMeshConfigInT, typename WrappedMeshConfigOutT,
+              typename PointAccessorT,
+              typename VertexCopyMapT,
+              typename EdgeRefinementFlagAccessorT, typename RefinementVertexAccessorT,
+              typename FacetToVertexHandleMapT>
+    void make_refinement_vertices(mesh<WrappedMeshConfigInT> const & mesh_in,
+                                  mesh<WrappedMeshConfigOutT> & mesh_out,
+                                  PointAccessorT const point_accessor_in,
+                                  VertexCopyMapT & vertex_copy_map_,
+                                  EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
+                                  RefinementVertexAccessorT & edge_to_vertex_handle_accessor,
+                                  FacetToVertexHandleMapT & facet_to_vertex_handle_map,
+                                  hexahedron_tag)
+    {
+      make_tensor_cell_refinement_vertices<hexahedron_tag>(mesh_in, mesh_out, point_accessor_in, vertex_copy_map_,
+                                                           edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map);
+    }
 
 
-  namespace detail
-  {
+    /** @brief Closure of cell refinement flags (simplices: nothing to do, the refinement is conforming). For internal use only. */
+    template<typename WrappedMeshConfigInT, typename EdgeRefinementFlagAccessorT, typename CellTagT>
+    void ensure_refinement_closure(mesh<WrappedMeshConfigInT> const &, EdgeRefinementFlagAccessorT, CellTagT) {}
 
+    /** @brief Closure of cell refinement flags for quadrilateral meshes. For internal use only. */
+    template<typename WrappedMeshConfigInT, typename EdgeRefinementFlagAccessorT>
+    void ensure_refinement_closure(mesh<WrappedMeshConfigInT> const & mesh_in, EdgeRefinementFlagAccessorT edge_refinement_flag_accessor, quadrilateral_tag)
+    {
+      ensure_hanging_vertex_balance<quadrilateral_tag>(mesh_in, edge_refinement_flag_accessor);
+    }
+
+    /** @brief Closure of cell refinement flags for hexahedral meshes. For internal use only. */
+    template<typename WrappedMeshConfigInT, typename EdgeRefinementFlagAccessorT>
+    void ensure_refinement_closure(mesh<WrappedMeshConfigInT> const & mesh_in, EdgeRefinementFlagAccessorT edge_refinement_flag_accessor, hexahedron_tag)
+    {
+      ensure_hanging_vertex_balance<hexahedron_tag>(mesh_in, edge_refinement_flag_accessor);
+    }
 
 
     /** @brief For internal use only */
@@ -159,29 +441,20 @@ namespace viennagrid
                      EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
                      RefinementVertexAccessorT & edge_to_vertex_handle_accessor)
     {
-      typedef mesh<WrappedMeshConfigInT>       InputMeshType;
+      typedef typename viennagrid::result_of::vertex_handle< mesh<WrappedMeshConfigOutT> >::type OutputVertexHandleType;
 
-      typedef typename viennagrid::result_of::const_line_range<InputMeshType>::type                 EdgeRange;
-      typedef typename viennagrid::result_of::iterator<EdgeRange>::type                             EdgeIterator;
+      detail::refinement_facet_vertex_map<OutputVertexHandleType> facet_to_vertex_handle_map;
 
       //
       // Step 1: Each tagged edge in old mesh results in a new vertex (temporarily store new vertex IDs on old mesh)
       //
-      EdgeRange edges(mesh_in);
-      for (EdgeIterator eit = edges.begin();
-                        eit != edges.end();
-                      ++eit)
-      {
-        if ( edge_refinement_flag_accessor(*eit) )
-        {
-          edge_to_vertex_handle_accessor( *eit ) = viennagrid::make_vertex( mesh_out, viennagrid::centroid(point_accessor_in, *eit) );
-        }
-      }
+      make_refinement_vertices(mesh_in, mesh_out, point_accessor_in, vertex_copy_map_,
+                               edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map, CellTagT());
 
       //
       // Step 2: Now write new cells to new mesh
       //
-      simple_refine<CellTagT>(mesh_in, mesh_out, vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor);
+      simple_refine_impl<CellTagT>(mesh_in, mesh_out, vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map);
     }
 
 
@@ -202,30 +475,20 @@ namespace viennagrid
                      EdgeRefinementFlagAccessorT const & edge_refinement_flag_accessor,
                      RefinementVertexAccessorT & edge_to_vertex_handle_accessor)
     {
-      typedef mesh<WrappedMeshConfigInT>    InputMeshType;
-
-      typedef typename viennagrid::result_of::const_line_range<InputMeshType>::type       EdgeRange;
-      typedef typename viennagrid::result_of::iterator<EdgeRange>::type                               EdgeIterator;
+      typedef typename viennagrid::result_of::vertex_handle< mesh<WrappedMeshConfigOutT> >::type OutputVertexHandleType;
 
+      detail::refinement_facet_vertex_map<OutputVertexHandleType> facet_to_vertex_handle_map;
 
       //
       // Step 1: Each tagged edge in old mesh results in a new vertex (temporarily store new vertex IDs on old mesh)
       //
-      EdgeRange edges(mesh_in);
-      for (EdgeIterator eit = edges.begin();
-                        eit != edges.end();
-                      ++eit)
-      {
-        if ( edge_refinement_flag_accessor(*eit) )
-        {
-          edge_to_vertex_handle_accessor( *eit ) = viennagrid::make_vertex( mesh_out, viennagrid::centroid(point_accessor_in, *eit) );
-        }
-      }
+      make_refinement_vertices(mesh_in, mesh_out, point_accessor_in, vertex_copy_map_,
+                               edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map, CellTagT());
 
       //
       // Step 2: Now write new cells to new mesh
       //
-      simple_refine<CellTagT>( mesh_in, segmentation_in, mesh_out, segmentation_out, vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor );
+      simple_refine_impl<CellTagT>( mesh_in, segmentation_in, mesh_out, segmentation_out, vertex_copy_map_, edge_refinement_flag_accessor, edge_to_vertex_handle_accessor, facet_to_vertex_handle_map );
     }
 
 
@@ -528,6 +791,9 @@ namespace viennagrid
                                         cell_refinement_flag_accessor,
                                         viennagrid::make_accessor<EdgeType>(edge_refinement_flag));
 
+    detail::ensure_refinement_closure(mesh_in, viennagrid::make_accessor<EdgeType>(edge_refinement_flag),
+                                      typename viennagrid::result_of::element_tag<ElementTypeOrTagT>::type());
+
     refine<ElementTypeOrTagT>(mesh_in, mesh_out, point_accessor_in,
                     viennagrid::make_accessor<EdgeType>(edge_refinement_flag));
   }
@@ -849,6 +1115,9 @@ namespace viennagrid
                                         cell_refinement_flag_accessor,
                                         viennagrid::make_accessor<EdgeType>(edge_refinement_flag));
 
+    detail::ensure_refinement_closure(mesh_in, viennagrid::make_accessor<EdgeType>(edge_refinement_flag),
+                                      typename viennagrid::result_of::element_tag<ElementTypeOrTagT>::type());
+
     refine<ElementTypeOrTagT>(mesh_in, segmentation_in,
                            mesh_out, segmentation_out,
                            point_accessor_in,
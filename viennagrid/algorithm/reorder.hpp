@@ -0,0 +1,564 @@
+#ifndef VIENNAGRID_ALGORITHM_REORDER_HPP
+#define VIENNAGRID_ALGORITHM_REORDER_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <limits>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/mesh/mesh.hpp"
+#include "viennagrid/mesh/segmentation.hpp"
+#include "viennagrid/mesh/element_creation.hpp"
+
+/** @file viennagrid/algorithm/reorder.hpp
+    @brief Reordering of the vertices and cells of a mesh for cache locality (space-filling curves, reverse Cuthill-McKee)
+*/
+
+namespace viennagrid
+{
+  /** @brief A tag selecting the reordering of vertices and cells along a Hilbert curve through the bounding box of the mesh */
+  struct hilbert_reordering_tag {};
+
+  /** @brief A tag selecting the reordering of vertices and cells along a Morton (Z-order) curve through the bounding box of the mesh */
+  struct morton_reordering_tag {};
+
+  /** @brief A tag selecting the reverse Cuthill-McKee reordering of the vertices (reducing the bandwidth of the vertex-vertex connectivity), cells are ordered by their first vertex */
+  struct reverse_cuthill_mckee_reordering_tag {};
+
+
+  /** @brief The permutation applied by reorder(). Both vectors map the new ID (which equals the new position) to the old ID of a vertex or cell, respectively. */
+  struct mesh_permutation
+  {
+    std::vector<std::size_t> vertices;
+    std::vector<std::size_t> cells;
+  };
+
+  /** @brief Permutes values stored by old IDs such that they are stored by new IDs afterwards, e.g. values attached to the vertices of a reordered mesh
+    *
+    * @param values               The values, indexed by the old IDs. Values of elements no longer present are dropped.
+    * @param permutation          The permutation from new IDs to old IDs, e.g. mesh_permutation::vertices
+    */
+  template<typename ValueT, typename AllocatorT>
+  void permute(std::vector<ValueT, AllocatorT> & values, std::vector<std::size_t> const & permutation)
+  {
+    std::vector<ValueT, AllocatorT> permuted_values( permutation.size() );
+    for (std::size_t i = 0; i < permutation.size(); ++i)
+      permuted_values[i] = values[ permutation[i] ];
+    values.swap(permuted_values);
+  }
+
+
+  namespace detail
+  {
+    /** @brief For internal use only. A key of up to 64 bits on a space-filling curve, composed of two 32 bit words. */
+    struct curve_key
+    {
+      curve_key() : high(0), low(0) {}
+
+      void push_bit(unsigned int bit)
+      {
+        high = (high << 1) | (low >> 31);
+        low  = (low << 1) | bit;
+      }
+
+      bool operator<(curve_key const & other) const { return high < other.high || (high == other.high && low < other.low); }
+
+      unsigned int high;
+      unsigned int low;
+    };
+
+    /** @brief For internal use only. Converts grid coordinates to the transposed Hilbert index (J. Skilling, Programming the Hilbert curve, AIP Conf. Proc. 707, 2004). */
+    inline void hilbert_transpose(unsigned int * coords, int dimension, int bits)
+    {
+      unsigned int m = 1u << (bits - 1);
+
+      // inverse undo excess work
+      for (unsigned int q = m; q > 1; q >>= 1)
+      {
+        unsigned int p = q - 1;
+        for (int i = 0; i < dimension; ++i)
+        {
+          if (coords[i] & q)
+            coords[0] ^= p;
+          else
+          {
+            unsigned int t = (coords[0] ^ coords[i]) & p;
+            coords[0] ^= t;
+            coords[i] ^= t;
+          }
+        }
+      }
+
+      // gray encode
+      for (int i = 1; i < dimension; ++i)
+        coords[i] ^= coords[i-1];
+
+      unsigned int t = 0;
+      for (unsigned int q = m; q > 1; q >>= 1)
+        if (coords[dimension-1] & q)
+          t ^= q - 1;
+      for (int i = 0; i < dimension; ++i)
+        coords[i] ^= t;
+    }
+
+    /** @brief For internal use only. Interleaves the bits of the grid coordinates, most significant bits first. */
+    inline curve_key interleave_bits(unsigned int const * coords, int dimension, int bits)
+    {
+      curve_key key;
+      for (int b = bits - 1; b >= 0; --b)
+        for (int i = 0; i < dimension; ++i)
+          key.push_bit( (coords[i] >> b) & 1u );
+      return key;
+    }
+
+    /** @brief For internal use only. Computes the curve keys of points with respect to a bounding box. */
+    template<typename PointT>
+    class curve_key_generator
+    {
+    public:
+      typedef typename viennagrid::result_of::coord<PointT>::type coord_type;
+
+      template<typename PointIteratorT>
+      curve_key_generator(PointIteratorT begin, PointIteratorT end)
+      {
+        if (begin == end)
+          return;
+
+        lower_ = *begin;
+        upper_ = *begin;
+        for (; begin != end; ++begin)
+          for (std::size_t i = 0; i < lower_.size(); ++i)
+          {
+            lower_[i] = std::min(lower_[i], (*begin)[i]);
+            upper_[i] = std::max(upper_[i], (*begin)[i]);
+          }
+      }
+
+      curve_key operator()(PointT const & point, hilbert_reordering_tag) const
+      {
+        unsigned int coords[max_dimension];
+        int dimension = grid_coordinates(point, coords);
+        hilbert_transpose(coords, dimension, bits(dimension));
+        return interleave_bits(coords, dimension, bits(dimension));
+      }
+
+      curve_key operator()(PointT const & point, morton_reordering_tag) const
+      {
+        unsigned int coords[max_dimension];
+        int dimension = grid_coordinates(point, coords);
+        return interleave_bits(coords, dimension, bits(dimension));
+      }
+
+    private:
+      static const int max_dimension = 3;
+
+      // at most 64 bits in total
+      static int bits(int dimension) { return dimension == 1 ? 32 : 64 / dimension; }
+
+      int grid_coordinates(PointT const & point, unsigned int * coords) const
+      {
+        int dimension = static_cast<int>( std::min<std::size_t>(point.size(), max_dimension) );
+        double cells = static_cast<double>( bits(dimension) == 32 ? std::numeric_limits<unsigned int>::max() : (1u << bits(dimension)) - 1u );
+
+        for (int i = 0; i < dimension; ++i)
+        {
+          double extent = static_cast<double>(upper_[i] - lower_[i]);
+          double relative = extent > 0 ? static_cast<double>(point[i] - lower_[i]) / extent : 0.0;
+          relative = std::max(0.0, std::min(1.0, relative));
+          coords[i] = static_cast<unsigned int>(relative * cells);
+        }
+        return dimension;
+      }
+
+      PointT lower_;
+      PointT upper_;
+    };
+
+
+    /** @brief For internal use only */
+    template<typename KeyT>
+    bool compare_first(std::pair<KeyT, std::size_t> const & lhs, std::pair<KeyT, std::size_t> const & rhs)
+    {
+      return lhs.first < rhs.first;
+    }
+
+    /** @brief For internal use only. Orders the elements of a container by their keys, ties are resolved by the original order. */
+    template<typename KeyT>
+    std::vector<std::size_t> order_by_keys(std::vector<KeyT> const & keys)
+    {
+      std::vector< std::pair<KeyT, std::size_t> > sorted_keys( keys.size() );
+      for (std::size_t i = 0; i < keys.size(); ++i)
+        sorted_keys[i] = std::make_pair(keys[i], i);
+      std::stable_sort(sorted_keys.begin(), sorted_keys.end(), compare_first<KeyT>);
+
+      std::vector<std::size_t> order( keys.size() );
+      for (std::size_t i = 0; i < keys.size(); ++i)
+        order[i] = sorted_keys[i].second;
+      return order;
+    }
+
+
+    /** @brief For internal use only. The vertices and cells of a mesh, with the vertices of each cell given as indices into the vertex array. */
+    template<typename MeshT>
+    struct reordering_input
+    {
+      typedef typename viennagrid::result_of::vertex<MeshT>::type   VertexType;
+      typedef typename viennagrid::result_of::cell<MeshT>::type     CellType;
+      typedef typename viennagrid::result_of::point<MeshT>::type    PointType;
+
+      reordering_input(MeshT const & mesh)
+      {
+        typedef typename viennagrid::result_of::const_vertex_range<MeshT>::type   VertexRangeType;
+        typedef typename viennagrid::result_of::iterator<VertexRangeType>::type   VertexIteratorType;
+        typedef typename viennagrid::result_of::const_cell_range<MeshT>::type     CellRangeType;
+        typedef typename viennagrid::result_of::iterator<CellRangeType>::type     CellIteratorType;
+        typedef typename viennagrid::result_of::const_vertex_range<CellType>::type            VertexOnCellRangeType;
+        typedef typename viennagrid::result_of::iterator<VertexOnCellRangeType>::type         VertexOnCellIteratorType;
+
+        std::vector<std::size_t> vertex_index( static_cast<std::size_t>(viennagrid::id_upper_bound<viennagrid::vertex_tag>(mesh).get()) );
+
+        VertexRangeType vertex_range(mesh);
+        for (VertexIteratorType vit = vertex_range.begin(); vit != vertex_range.end(); ++vit)
+        {
+          vertex_index[ static_cast<std::size_t>((*vit).id().get()) ] = vertices.size();
+          vertices.push_back( &*vit );
+          points.push_back( viennagrid::point(*vit) );
+        }
+
+        CellRangeType cell_range(mesh);
+        cell_offsets.push_back(0);
+        for (CellIteratorType cit = cell_range.begin(); cit != cell_range.end(); ++cit)
+        {
+          cells.push_back( &*cit );
+
+          VertexOnCellRangeType vertices_on_cell(*cit);
+          for (VertexOnCellIteratorType vocit = vertices_on_cell.begin(); vocit != vertices_on_cell.end(); ++vocit)
+            cell_vertices.push_back( vertex_index[ static_cast<std::size_t>((*vocit).id().get()) ] );
+          cell_offsets.push_back( cell_vertices.size() );
+        }
+      }
+
+      std::vector<VertexType const *> vertices;
+      std::vector<PointType> points;
+
+      std::vector<CellType const *> cells;
+      std::vector<std::size_t> cell_offsets;
+      std::vector<std::size_t> cell_vertices;
+    };
+
+
+    /** @brief For internal use only. Orders vertices and cells along a space-filling curve, cells are ordered by the curve key of the mean of their vertices. */
+    template<typename MeshT, typename CurveTagT>
+    void reordering(reordering_input<MeshT> const & input,
+                    std::vector<std::size_t> & vertex_order, std::vector<std::size_t> & cell_order,
+                    CurveTagT curve_tag)
+    {
+      typedef typename reordering_input<MeshT>::PointType PointType;
+
+      curve_key_generator<PointType> generator(input.points.begin(), input.points.end());
+
+      std::vector<curve_key> keys( input.points.size() );
+      for (std::size_t i = 0; i < input.points.size(); ++i)
+        keys[i] = generator(input.points[i], curve_tag);
+      vertex_order = order_by_keys(keys);
+
+      keys.resize( input.cells.size() );
+      for (std::size_t i = 0; i < input.cells.size(); ++i)
+      {
+        PointType center = input.points[ input.cell_vertices[input.cell_offsets[i]] ];
+        for (std::size_t j = input.cell_offsets[i] + 1; j < input.cell_offsets[i+1]; ++j)
+          center += input.points[ input.cell_vertices[j] ];
+        center /= static_cast<double>(input.cell_offsets[i+1] - input.cell_offsets[i]);
+
+        keys[i] = generator(center, curve_tag);
+      }
+      cell_order = order_by_keys(keys);
+    }
+
+
+    /** @brief For internal use only. Breadth-first search from 'start' visiting the neighbors in the order of increasing degree. Returns the number of levels, the vertices of the last level are at the end of 'order'. */
+    inline std::size_t cuthill_mckee_search(std::vector<std::size_t> const & offsets, std::vector<std::size_t> const & adjacency,
+                                            std::size_t start, std::vector<char> & visited, std::vector<std::size_t> & order,
+                                            std::vector< std::pair<std::size_t, std::size_t> > & buffer,
+                                            std::size_t & last_level_begin)
+    {
+      last_level_begin = order.size();
+      std::size_t level_end = last_level_begin + 1;
+      std::size_t levels = 1;
+
+      visited[start] = 1;
+      order.push_back(start);
+
+      for (std::size_t pos = last_level_begin; pos < order.size(); ++pos)
+      {
+        if (pos == level_end)
+        {
+          last_level_begin = level_end;
+          level_end = order.size();
+          ++levels;
+        }
+
+        std::size_t vertex = order[pos];
+        buffer.clear();
+        for (std::size_t i = offsets[vertex]; i < offsets[vertex+1]; ++i)
+        {
+          std::size_t neighbor = adjacency[i];
+          if (!visited[neighbor])
+          {
+            visited[neighbor] = 1;
+            buffer.push_back( std::make_pair(offsets[neighbor+1] - offsets[neighbor], neighbor) );
+          }
+        }
+
+        std::sort(buffer.begin(), buffer.end());
+        for (std::size_t i = 0; i < buffer.size(); ++i)
+          order.push_back( buffer[i].second );
+      }
+
+      return levels;
+    }
+
+    /** @brief For internal use only. Reverse Cuthill-McKee ordering of the vertex graph (vertices are adjacent if they share a cell), each connected component starts at a pseudo-peripheral vertex. Cells are ordered by their smallest new vertex index. */
+    template<typename MeshT>
+    void reordering(reordering_input<MeshT> const & input,
+                    std::vector<std::size_t> & vertex_order, std::vector<std::size_t> & cell_order,
+                    reverse_cuthill_mckee_reordering_tag)
+    {
+      std::size_t vertex_count = input.vertices.size();
+
+      // vertex graph in compressed row storage
+      std::vector< std::pair<std::size_t, std::size_t> > edges;
+      for (std::size_t i = 0; i < input.cells.size(); ++i)
+        for (std::size_t j = input.cell_offsets[i]; j < input.cell_offsets[i+1]; ++j)
+          for (std::size_t k = input.cell_offsets[i]; k < input.cell_offsets[i+1]; ++k)
+            if (j != k)
+              edges.push_back( std::make_pair(input.cell_vertices[j], input.cell_vertices[k]) );
+
+      std::sort(edges.begin(), edges.end());
+      edges.erase( std::unique(edges.begin(), edges.end()), edges.end() );
+
+      std::vector<std::size_t> offsets(vertex_count + 1, 0);
+      std::vector<std::size_t> adjacency( edges.size() );
+      for (std::size_t i = 0; i < edges.size(); ++i)
+      {
+        ++offsets[edges[i].first + 1];
+        adjacency[i] = edges[i].second;
+      }
+      for (std::size_t i = 0; i < vertex_count; ++i)
+        offsets[i+1] += offsets[i];
+
+      std::vector<char> visited(vertex_count, 0);
+      std::vector<char> probe_visited;
+      std::vector<std::size_t> probe_order;
+      std::vector< std::pair<std::size_t, std::size_t> > buffer;
+
+      vertex_order.clear();
+      vertex_order.reserve(vertex_count);
+
+      for (std::size_t seed = 0; seed < vertex_count; ++seed)
+      {
+        if (visited[seed])
+          continue;
+
+        // pseudo-peripheral vertex: restart from a vertex of smallest degree in the last level as long as the number of levels grows
+        std::size_t start = seed;
+        std::size_t levels = 0;
+        for (int iteration = 0; iteration < 8; ++iteration)
+        {
+          probe_visited = visited;
+          probe_order.clear();
+          std::size_t last_level_begin;
+          std::size_t new_levels = cuthill_mckee_search(offsets, adjacency, start, probe_visited, probe_order, buffer, last_level_begin);
+          if (new_levels <= levels)
+            break;
+          levels = new_levels;
+
+          std::size_t candidate = probe_order[last_level_begin];
+          for (std::size_t i = last_level_begin; i < probe_order.size(); ++i)
+            if ( offsets[probe_order[i]+1] - offsets[probe_order[i]] < offsets[candidate+1] - offsets[candidate] )
+              candidate = probe_order[i];
+
+          if (candidate == start)
+            break;
+          start = candidate;
+        }
+
+        std::size_t last_level_begin;
+        cuthill_mckee_search(offsets, adjacency, start, visited, vertex_order, buffer, last_level_begin);
+      }
+
+      std::reverse(vertex_order.begin(), vertex_order.end());
+
+      std::vector<std::size_t> new_vertex_index(vertex_count);
+      for (std::size_t i = 0; i < vertex_count; ++i)
+        new_vertex_index[ vertex_order[i] ] = i;
+
+      std::vector<std::size_t> keys( input.cells.size() );
+      for (std::size_t i = 0; i < input.cells.size(); ++i)
+      {
+        keys[i] = vertex_count;
+        for (std::size_t j = input.cell_offsets[i]; j < input.cell_offsets[i+1]; ++j)
+          keys[i] = std::min(keys[i], new_vertex_index[ input.cell_vertices[j] ]);
+      }
+      cell_order = order_by_keys(keys);
+    }
+
+
+    /** @brief For internal use only. Copies vertices and cells in the given order to an empty mesh. */
+    template<typename SrcMeshT, typename DstMeshT>
+    void copy_reordered(reordering_input<SrcMeshT> const & input,
+                        std::vector<std::size_t> const & vertex_order, std::vector<std::size_t> const & cell_order,
+                        DstMeshT & dst_mesh,
+                        std::vector<typename viennagrid::result_of::cell_handle<DstMeshT>::type> & cell_handles)
+    {
+      typedef typename viennagrid::result_of::cell_tag<DstMeshT>::type             CellTag;
+      typedef typename viennagrid::result_of::vertex_handle<DstMeshT>::type        VertexHandleType;
+
+      std::vector<VertexHandleType> vertex_handles( input.vertices.size() );
+      for (std::size_t i = 0; i < vertex_order.size(); ++i)
+        vertex_handles[ vertex_order[i] ] = viennagrid::make_vertex( dst_mesh, input.points[vertex_order[i]] );
+
+      std::vector<VertexHandleType> vertices_on_cell;
+      cell_handles.resize( cell_order.size() );
+      for (std::size_t i = 0; i < cell_order.size(); ++i)
+      {
+        std::size_t cell = cell_order[i];
+
+        vertices_on_cell.clear();
+        for (std::size_t j = input.cell_offsets[cell]; j < input.cell_offsets[cell+1]; ++j)
+          vertices_on_cell.push_back( vertex_handles[ input.cell_vertices[j] ] );
+
+        cell_handles[i] = viennagrid::make_element<CellTag>( dst_mesh, vertices_on_cell.begin(), vertices_on_cell.end() );
+      }
+    }
+
+    /** @brief For internal use only. Computes the permutation for a mesh and rebuilds the mesh in the new order. */
+    template<typename MeshT, typename StrategyTagT>
+    mesh_permutation reorder_mesh(MeshT & mesh, StrategyTagT strategy,
+                                  std::vector<typename viennagrid::result_of::cell_handle<MeshT>::type> & cell_handles)
+    {
+      mesh_permutation permutation;
+      std::vector<std::size_t> vertex_order;
+      std::vector<std::size_t> cell_order;
+
+      MeshT reordered_mesh;
+      {
+        reordering_input<MeshT> input(mesh);
+        reordering(input, vertex_order, cell_order, strategy);
+
+        permutation.vertices.resize( vertex_order.size() );
+        for (std::size_t i = 0; i < vertex_order.size(); ++i)
+          permutation.vertices[i] = static_cast<std::size_t>( input.vertices[vertex_order[i]]->id().get() );
+        permutation.cells.resize( cell_order.size() );
+        for (std::size_t i = 0; i < cell_order.size(); ++i)
+          permutation.cells[i] = static_cast<std::size_t>( input.cells[cell_order[i]]->id().get() );
+
+        copy_reordered(input, vertex_order, cell_order, reordered_mesh, cell_handles);
+      }
+
+      // copy back in the new order, ids start from zero in the cleared mesh
+      mesh.clear();
+      {
+        reordering_input<MeshT> input(reordered_mesh);
+        for (std::size_t i = 0; i < vertex_order.size(); ++i)
+          vertex_order[i] = i;
+        for (std::size_t i = 0; i < cell_order.size(); ++i)
+          cell_order[i] = i;
+        copy_reordered(input, vertex_order, cell_order, mesh, cell_handles);
+      }
+
+      return permutation;
+    }
+  }
+
+
+  /** @brief Reorders the vertices and cells of a mesh for cache locality. The mesh is rebuilt with vertices and cells stored in the new order and renumbered starting from zero.
+    *
+    * Boundary elements (e.g. edges and facets) are recreated in the order of the cells. All handles stored outside of the mesh are invalidated.
+    * Data attached to vertices or cells by ID can be transferred using viennagrid::permute() with the returned permutation.
+    *
+    * @param mesh                 The mesh to be reordered
+    * @param strategy             The reordering strategy: hilbert_reordering_tag, morton_reordering_tag or reverse_cuthill_mckee_reordering_tag
+    * @return                     The permutation from the new to the old IDs of vertices and cells
+    */
+  template<typename WrappedConfigT, typename StrategyTagT>
+  mesh_permutation reorder(viennagrid::mesh<WrappedConfigT> & mesh, StrategyTagT strategy)
+  {
+    typedef viennagrid::mesh<WrappedConfigT> MeshType;
+
+    std::vector<typename viennagrid::result_of::cell_handle<MeshType>::type> cell_handles;
+    return detail::reorder_mesh(mesh, strategy, cell_handles);
+  }
+
+  /** @brief Reorders the vertices and cells of a mesh and its segmentation for cache locality. The mesh is rebuilt with vertices and cells stored in the new order and renumbered starting from zero.
+    *
+    * The segments keep their IDs and names, the cells are assigned to the same segments as before.
+    * Boundary elements (e.g. edges and facets) are recreated in the order of the cells. All handles stored outside of the mesh are invalidated.
+    * Data attached to vertices or cells by ID can be transferred using viennagrid::permute() with the returned permutation.
+    *
+    * @param mesh                 The mesh to be reordered
+    * @param segmentation         The segmentation of the mesh
+    * @param strategy             The reordering strategy: hilbert_reordering_tag, morton_reordering_tag or reverse_cuthill_mckee_reordering_tag
+    * @return                     The permutation from the new to the old IDs of vertices and cells
+    */
+  template<typename WrappedConfigT, typename SegmentationT, typename StrategyTagT>
+  mesh_permutation reorder(viennagrid::mesh<WrappedConfigT> & mesh, SegmentationT & segmentation, StrategyTagT strategy)
+  {
+    typedef viennagrid::mesh<WrappedConfigT>                                              MeshType;
+    typedef typename viennagrid::result_of::segment_id<SegmentationT>::type              SegmentIDType;
+    typedef typename viennagrid::result_of::cell<MeshType>::type                         CellType;
+    typedef typename viennagrid::result_of::const_cell_range<MeshType>::type             CellRangeType;
+    typedef typename viennagrid::result_of::iterator<CellRangeType>::type                CellIteratorType;
+    typedef typename viennagrid::result_of::segment_id_range<SegmentationT, CellType>::type  SegmentIDRangeType;
+    typedef typename SegmentationT::iterator                                             SegmentIteratorType;
+
+    // remember the segments and the segments of each cell by cell ID
+    std::vector< std::pair<SegmentIDType, std::string> > segments;
+    for (SegmentIteratorType sit = segmentation.begin(); sit != segmentation.end(); ++sit)
+      segments.push_back( std::make_pair((*sit).id(), (*sit).name()) );
+
+    std::vector< std::vector<SegmentIDType> > cell_segments( static_cast<std::size_t>(viennagrid::id_upper_bound<CellType>(mesh).get()) );
+    CellRangeType cells(mesh);
+    for (CellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+    {
+      SegmentIDRangeType segment_ids = viennagrid::segment_ids(segmentation, *cit);
+      cell_segments[ static_cast<std::size_t>((*cit).id().get()) ].assign( segment_ids.begin(), segment_ids.end() );
+    }
+
+    std::vector<typename viennagrid::result_of::cell_handle<MeshType>::type> cell_handles;
+    mesh_permutation permutation = detail::reorder_mesh(mesh, strategy, cell_handles);
+
+    segmentation.clear();
+    for (std::size_t i = 0; i < segments.size(); ++i)
+    {
+      typename viennagrid::result_of::segment_handle<SegmentationT>::type & segment = segmentation.get_make_segment(segments[i].first);
+      if (segment.name() != segments[i].second)
+        segment.set_name(segments[i].second);
+    }
+
+    for (std::size_t i = 0; i < cell_handles.size(); ++i)
+    {
+      std::vector<SegmentIDType> const & ids = cell_segments[ permutation.cells[i] ];
+      viennagrid::add( segmentation, ids.begin(), ids.end(), cell_handles[i] );
+    }
+
+    return permutation;
+  }
+
+}
+
+#endif
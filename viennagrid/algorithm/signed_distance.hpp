@@ -0,0 +1,701 @@
+#ifndef VIENNAGRID_ALGORITHM_SIGNED_DISTANCE_HPP
+#define VIENNAGRID_ALGORITHM_SIGNED_DISTANCE_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <map>
+#include <deque>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/mesh/mesh.hpp"
+#include "viennagrid/algorithm/boundary.hpp"
+
+#ifdef VIENNAGRID_WITH_OPENMP
+  #include <omp.h>
+#endif
+
+/** @file viennagrid/algorithm/signed_distance.hpp
+    @brief Signed distances to the boundary of a mesh or segment using a bounding volume hierarchy of the boundary facets
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+    inline void sdf_sub(double const * a, double const * b, double * r) { r[0] = a[0]-b[0]; r[1] = a[1]-b[1]; r[2] = a[2]-b[2]; }
+    inline double sdf_dot(double const * a, double const * b) { return a[0]*b[0] + a[1]*b[1] + a[2]*b[2]; }
+    inline void sdf_cross(double const * a, double const * b, double * r)
+    {
+      r[0] = a[1]*b[2] - a[2]*b[1];
+      r[1] = a[2]*b[0] - a[0]*b[2];
+      r[2] = a[0]*b[1] - a[1]*b[0];
+    }
+    inline void sdf_add_scaled(double * r, double const * a, double s) { r[0] += s*a[0]; r[1] += s*a[1]; r[2] += s*a[2]; }
+
+    /** @brief A boundary facet (line in 2D, triangle in 3D, quadrilaterals are split into two triangles) with outward unit normal */
+    struct signed_distance_primitive
+    {
+      std::size_t vertex_count;
+      std::size_t vertices[3];
+      /** @brief The pseudo-normals of the edges (v0,v1), (v1,v2), (v2,v0), triangles only */
+      std::size_t edges[3];
+      double normal[3];
+    };
+
+    /** @brief A node of the bounding volume hierarchy. Leaves hold the primitives [begin, end) of the reordered primitive array. */
+    struct signed_distance_node
+    {
+      double lower[3];
+      double upper[3];
+      std::size_t begin;
+      std::size_t end;
+      std::size_t left;
+      std::size_t right;
+    };
+
+    /** @brief Squared distance between a point and an axis aligned box, zero inside the box */
+    inline double box_distance_squared(signed_distance_node const & node, double const * p)
+    {
+      double result = 0.0;
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        double d = std::max( std::max(node.lower[i] - p[i], p[i] - node.upper[i]), 0.0 );
+        result += d*d;
+      }
+      return result;
+    }
+
+    /** @brief The feature of a primitive the closest point lies on */
+    enum signed_distance_feature { feature_face, feature_vertex, feature_edge };
+
+    /** @brief Closest point on the line segment [a, b]. Returns the feature and its local index. */
+    inline signed_distance_feature closest_point_on_line(double const * p, double const * a, double const * b, double * closest, std::size_t & index)
+    {
+      double ab[3], ap[3];
+      sdf_sub(b, a, ab);
+      sdf_sub(p, a, ap);
+      double length_squared = sdf_dot(ab, ab);
+      double t = (length_squared > 0.0) ? sdf_dot(ap, ab) / length_squared : 0.0;
+
+      if (t <= 0.0)
+      {
+        std::copy(a, a+3, closest);
+        index = 0;
+        return feature_vertex;
+      }
+      if (t >= 1.0)
+      {
+        std::copy(b, b+3, closest);
+        index = 1;
+        return feature_vertex;
+      }
+
+      std::copy(a, a+3, closest);
+      sdf_add_scaled(closest, ab, t);
+      return feature_face;
+    }
+
+    /** @brief Closest point on the triangle [a, b, c] by Voronoi region classification (see Ericson, Real-Time Collision Detection). Returns the feature and its local index. */
+    inline signed_distance_feature closest_point_on_triangle(double const * p, double const * a, double const * b, double const * c, double * closest, std::size_t & index)
+    {
+      double ab[3], ac[3], ap[3], bp[3], cp[3];
+      sdf_sub(b, a, ab);
+      sdf_sub(c, a, ac);
+      sdf_sub(p, a, ap);
+
+      double d1 = sdf_dot(ab, ap);
+      double d2 = sdf_dot(ac, ap);
+      if (d1 <= 0.0 && d2 <= 0.0)
+      {
+        std::copy(a, a+3, closest);
+        index = 0;
+        return feature_vertex;
+      }
+
+      sdf_sub(p, b, bp);
+      double d3 = sdf_dot(ab, bp);
+      double d4 = sdf_dot(ac, bp);
+      if (d3 >= 0.0 && d4 <= d3)
+      {
+        std::copy(b, b+3, closest);
+        index = 1;
+        return feature_vertex;
+      }
+
+      double vc = d1*d4 - d3*d2;
+      if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+      {
+        std::copy(a, a+3, closest);
+        sdf_add_scaled(closest, ab, d1 / (d1 - d3));
+        index = 0;
+        return feature_edge;
+      }
+
+      sdf_sub(p, c, cp);
+      double d5 = sdf_dot(ab, cp);
+      double d6 = sdf_dot(ac, cp);
+      if (d6 >= 0.0 && d5 <= d6)
+      {
+        std::copy(c, c+3, closest);
+        index = 2;
+        return feature_vertex;
+      }
+
+      double vb = d5*d2 - d1*d6;
+      if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+      {
+        std::copy(a, a+3, closest);
+        sdf_add_scaled(closest, ac, d2 / (d2 - d6));
+        index = 2;
+        return feature_edge;
+      }
+
+      double va = d3*d6 - d5*d4;
+      if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+      {
+        double bc[3];
+        sdf_sub(c, b, bc);
+        std::copy(b, b+3, closest);
+        sdf_add_scaled(closest, bc, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        index = 1;
+        return feature_edge;
+      }
+
+      double denominator = 1.0 / (va + vb + vc);
+      std::copy(a, a+3, closest);
+      sdf_add_scaled(closest, ab, vb * denominator);
+      sdf_add_scaled(closest, ac, vc * denominator);
+      return feature_face;
+    }
+
+    /** @brief Copies the coordinates of a point to a 3D array, missing coordinates are zero */
+    template<typename PointT>
+    void sdf_copy_point(PointT const & p, double * r)
+    {
+      r[0] = r[1] = r[2] = 0.0;
+      for (std::size_t i = 0; i < p.size() && i < 3; ++i)
+        r[i] = static_cast<double>(p[i]);
+    }
+  }
+
+
+  /** @brief A bounding volume hierarchy over the boundary facets of a mesh or segment for signed distance queries.
+    *
+    * The boundary facets are oriented outwards using their adjacent cell, quadrilateral facets are split into two triangles.
+    * The sign of a distance is obtained from the angle-weighted pseudo-normal of the closest feature (face, edge or vertex), see Baerentzen and Aanaes, IEEE TVCG 11(3), 2005:
+    * Distances are negative inside the mesh or segment and positive outside. Supported are 2D meshes (boundary lines) and 3D meshes (boundary triangles or quadrilaterals).
+    * Queries do not modify the tree and can be issued concurrently.
+    */
+  class signed_distance_tree
+  {
+  public:
+    /** @brief Builds the tree from the boundary facets of a mesh or segment */
+    template<typename MeshOrSegmentT>
+    explicit signed_distance_tree(MeshOrSegmentT const & source) { build(source); }
+
+    /** @brief Returns the number of boundary primitives */
+    std::size_t size() const { return primitives_.size(); }
+
+    /** @brief Returns the signed distance of a point to the boundary, or +infinity if the boundary is empty */
+    template<typename PointT>
+    double operator()(PointT const & p) const
+    {
+      return (*this)(p, std::numeric_limits<double>::infinity());
+    }
+
+    /** @brief Returns the signed distance of a point to the boundary, or +infinity if the boundary is farther away than max_distance */
+    template<typename PointT>
+    double operator()(PointT const & p, double max_distance) const
+    {
+      double q[3];
+      detail::sdf_copy_point(p, q);
+      return signed_distance(q, max_distance);
+    }
+
+  private:
+
+    double signed_distance(double const * p, double max_distance) const
+    {
+      double best = (max_distance < std::numeric_limits<double>::infinity()) ? max_distance * max_distance : std::numeric_limits<double>::infinity();
+      double best_closest[3] = {0.0, 0.0, 0.0};
+      double const * best_normal = NULL;
+
+      if (nodes_.empty())
+        return std::numeric_limits<double>::infinity();
+
+      std::size_t stack[64];
+      std::size_t stack_size = 0;
+      stack[stack_size++] = 0;
+
+      while (stack_size > 0)
+      {
+        detail::signed_distance_node const & node = nodes_[ stack[--stack_size] ];
+        if (detail::box_distance_squared(node, p) > best)
+          continue;
+
+        if (node.left == node.right)
+        {
+          for (std::size_t k = node.begin; k < node.end; ++k)
+          {
+            detail::signed_distance_primitive const & prim = primitives_[k];
+            double closest[3];
+            std::size_t index = 0;
+            detail::signed_distance_feature feature = (prim.vertex_count == 2) ?
+                detail::closest_point_on_line(p, point(prim.vertices[0]), point(prim.vertices[1]), closest, index) :
+                detail::closest_point_on_triangle(p, point(prim.vertices[0]), point(prim.vertices[1]), point(prim.vertices[2]), closest, index);
+
+            double diff[3];
+            detail::sdf_sub(p, closest, diff);
+            double distance_squared = detail::sdf_dot(diff, diff);
+            if (distance_squared < best || (best_normal == NULL && distance_squared <= best))
+            {
+              best = distance_squared;
+              std::copy(closest, closest+3, best_closest);
+              if (feature == detail::feature_vertex)
+                best_normal = &vertex_normals_[3 * prim.vertices[index]];
+              else if (feature == detail::feature_edge)
+                best_normal = &edge_normals_[3 * prim.edges[index]];
+              else
+                best_normal = prim.normal;
+            }
+          }
+        }
+        else
+        {
+          // visit the nearer child first
+          double left_distance = detail::box_distance_squared(nodes_[node.left], p);
+          double right_distance = detail::box_distance_squared(nodes_[node.right], p);
+          std::size_t nearer = (left_distance <= right_distance) ? node.left : node.right;
+          std::size_t farther = (left_distance <= right_distance) ? node.right : node.left;
+          if (std::max(left_distance, right_distance) <= best)
+            stack[stack_size++] = farther;
+          if (std::min(left_distance, right_distance) <= best)
+            stack[stack_size++] = nearer;
+        }
+      }
+
+      if (best_normal == NULL)
+        return std::numeric_limits<double>::infinity();
+
+      double diff[3];
+      detail::sdf_sub(p, best_closest, diff);
+      double distance = std::sqrt(best);
+      return (detail::sdf_dot(diff, best_normal) < 0.0) ? -distance : distance;
+    }
+
+    double const * point(std::size_t index) const { return &points_[3 * index]; }
+
+    std::size_t add_point(long vertex_id, double const * p)
+    {
+      if (static_cast<std::size_t>(vertex_id) >= point_index_.size())
+        point_index_.resize( static_cast<std::size_t>(vertex_id) + 1, invalid_index() );
+      std::size_t & index = point_index_[static_cast<std::size_t>(vertex_id)];
+      if (index == invalid_index())
+      {
+        index = points_.size() / 3;
+        points_.insert(points_.end(), p, p+3);
+      }
+      return index;
+    }
+
+    void add_primitive(std::size_t vertex_count, std::size_t const * vertices, double const * cell_center)
+    {
+      detail::signed_distance_primitive prim;
+      prim.vertex_count = vertex_count;
+      std::copy(vertices, vertices + vertex_count, prim.vertices);
+
+      double e0[3];
+      detail::sdf_sub(point(vertices[1]), point(vertices[0]), e0);
+      if (vertex_count == 2)
+      {
+        prim.normal[0] = e0[1];
+        prim.normal[1] = -e0[0];
+        prim.normal[2] = 0.0;
+      }
+      else
+      {
+        double e1[3];
+        detail::sdf_sub(point(vertices[2]), point(vertices[0]), e1);
+        detail::sdf_cross(e0, e1, prim.normal);
+      }
+
+      double length = std::sqrt( detail::sdf_dot(prim.normal, prim.normal) );
+      if (length <= 0.0)
+        return;     // degenerated facet
+
+      // orient outwards, i.e. away from the adjacent cell
+      double outward[3];
+      detail::sdf_sub(point(vertices[0]), cell_center, outward);
+      double scale = (detail::sdf_dot(prim.normal, outward) < 0.0) ? -1.0 / length : 1.0 / length;
+      for (std::size_t i = 0; i < 3; ++i)
+        prim.normal[i] *= scale;
+
+      primitives_.push_back(prim);
+    }
+
+    template<typename MeshOrSegmentT>
+    void build(MeshOrSegmentT const & source)
+    {
+      typedef typename viennagrid::result_of::const_cell_range<MeshOrSegmentT>::type              ConstCellRangeType;
+      typedef typename viennagrid::result_of::iterator<ConstCellRangeType>::type                  ConstCellIteratorType;
+      typedef typename viennagrid::result_of::const_facet_range<typename viennagrid::result_of::cell<MeshOrSegmentT>::type>::type  ConstFacetOnCellRangeType;
+      typedef typename viennagrid::result_of::iterator<ConstFacetOnCellRangeType>::type           ConstFacetOnCellIteratorType;
+      typedef typename viennagrid::result_of::const_vertex_range<typename viennagrid::result_of::cell<MeshOrSegmentT>::type>::type ConstVertexOnCellRangeType;
+      typedef typename viennagrid::result_of::iterator<ConstVertexOnCellRangeType>::type          ConstVertexOnCellIteratorType;
+      typedef typename viennagrid::result_of::const_vertex_range<typename viennagrid::result_of::facet<MeshOrSegmentT>::type>::type ConstVertexOnFacetRangeType;
+      typedef typename viennagrid::result_of::iterator<ConstVertexOnFacetRangeType>::type         ConstVertexOnFacetIteratorType;
+
+      typename viennagrid::result_of::default_point_accessor<MeshOrSegmentT>::type point_accessor = viennagrid::default_point_accessor(source);
+
+      //
+      // Boundary facets, oriented by their adjacent cell
+      //
+      ConstCellRangeType cells(source);
+      for (ConstCellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+      {
+        ConstFacetOnCellRangeType facets(*cit);
+        bool has_boundary_facet = false;
+        for (ConstFacetOnCellIteratorType fit = facets.begin(); fit != facets.end() && !has_boundary_facet; ++fit)
+          has_boundary_facet = viennagrid::is_boundary(source, *fit);
+        if (!has_boundary_facet)
+          continue;
+
+        double cell_center[3] = {0.0, 0.0, 0.0};
+        ConstVertexOnCellRangeType cell_vertices(*cit);
+        for (ConstVertexOnCellIteratorType vit = cell_vertices.begin(); vit != cell_vertices.end(); ++vit)
+        {
+          double p[3];
+          detail::sdf_copy_point(point_accessor(*vit), p);
+          detail::sdf_add_scaled(cell_center, p, 1.0 / static_cast<double>(cell_vertices.size()));
+        }
+
+        for (ConstFacetOnCellIteratorType fit = facets.begin(); fit != facets.end(); ++fit)
+        {
+          if (!viennagrid::is_boundary(source, *fit))
+            continue;
+
+          std::size_t local[4];
+          std::size_t count = 0;
+          ConstVertexOnFacetRangeType facet_vertices(*fit);
+          for (ConstVertexOnFacetIteratorType vit = facet_vertices.begin(); vit != facet_vertices.end() && count < 4; ++vit)
+          {
+            double p[3];
+            detail::sdf_copy_point(point_accessor(*vit), p);
+            local[count++] = add_point(vit->id().get(), p);
+          }
+
+          if (count == 4)
+          {
+            // quadrilaterals are numbered in tensor product order, i.e. 0-1-3-2 is the cyclic order
+            std::size_t first[3] = { local[0], local[1], local[3] };
+            std::size_t second[3] = { local[0], local[3], local[2] };
+            add_primitive(3, first, cell_center);
+            add_primitive(3, second, cell_center);
+          }
+          else
+            add_primitive(count, local, cell_center);
+        }
+      }
+
+      compute_pseudo_normals();
+
+      //
+      // Bounding volume hierarchy
+      //
+      nodes_.clear();
+      if (!primitives_.empty())
+      {
+        nodes_.reserve( 2 * primitives_.size() / leaf_size() + 1 );
+        build_node(0, primitives_.size(), 0);
+      }
+    }
+
+    void compute_pseudo_normals()
+    {
+      vertex_normals_.assign(points_.size(), 0.0);
+      edge_normals_.clear();
+
+      std::map< std::pair<std::size_t, std::size_t>, std::size_t > edge_index;
+
+      for (std::size_t k = 0; k < primitives_.size(); ++k)
+      {
+        detail::signed_distance_primitive & prim = primitives_[k];
+        for (std::size_t i = 0; i < prim.vertex_count; ++i)
+        {
+          // weighted by the angle of the facet at the vertex in 3D, lines in 2D are weighted equally
+          double weight = 1.0;
+          if (prim.vertex_count == 3)
+          {
+            double e0[3], e1[3];
+            detail::sdf_sub(point(prim.vertices[(i+1) % 3]), point(prim.vertices[i]), e0);
+            detail::sdf_sub(point(prim.vertices[(i+2) % 3]), point(prim.vertices[i]), e1);
+            double cosine = detail::sdf_dot(e0, e1) / std::sqrt( detail::sdf_dot(e0, e0) * detail::sdf_dot(e1, e1) );
+            weight = std::acos( std::max(-1.0, std::min(1.0, cosine)) );
+          }
+          detail::sdf_add_scaled(&vertex_normals_[3 * prim.vertices[i]], prim.normal, weight);
+        }
+
+        if (prim.vertex_count == 3)
+        {
+          for (std::size_t i = 0; i < 3; ++i)
+          {
+            std::size_t v0 = prim.vertices[i];
+            std::size_t v1 = prim.vertices[(i+1) % 3];
+            std::pair<std::size_t, std::size_t> key( std::min(v0, v1), std::max(v0, v1) );
+
+            std::map< std::pair<std::size_t, std::size_t>, std::size_t >::iterator it = edge_index.find(key);
+            if (it == edge_index.end())
+            {
+              it = edge_index.insert( std::make_pair(key, edge_normals_.size() / 3) ).first;
+              edge_normals_.resize( edge_normals_.size() + 3, 0.0 );
+            }
+            prim.edges[i] = it->second;
+            detail::sdf_add_scaled(&edge_normals_[3 * it->second], prim.normal, 1.0);
+          }
+        }
+      }
+    }
+
+    static std::size_t leaf_size() { return 4; }
+
+    std::size_t build_node(std::size_t begin, std::size_t end, std::size_t depth)
+    {
+      std::size_t index = nodes_.size();
+      nodes_.push_back( detail::signed_distance_node() );
+
+      detail::signed_distance_node node;
+      node.begin = begin;
+      node.end = end;
+      node.left = node.right = 0;
+      for (std::size_t i = 0; i < 3; ++i)
+      {
+        node.lower[i] = std::numeric_limits<double>::max();
+        node.upper[i] = -std::numeric_limits<double>::max();
+      }
+
+      double center_lower[3], center_upper[3];
+      std::copy(node.lower, node.lower+3, center_lower);
+      std::copy(node.upper, node.upper+3, center_upper);
+
+      for (std::size_t k = begin; k < end; ++k)
+      {
+        double center[3];
+        primitive_center(primitives_[k], center);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+          center_lower[i] = std::min(center_lower[i], center[i]);
+          center_upper[i] = std::max(center_upper[i], center[i]);
+        }
+
+        for (std::size_t j = 0; j < primitives_[k].vertex_count; ++j)
+        {
+          double const * p = point(primitives_[k].vertices[j]);
+          for (std::size_t i = 0; i < 3; ++i)
+          {
+            node.lower[i] = std::min(node.lower[i], p[i]);
+            node.upper[i] = std::max(node.upper[i], p[i]);
+          }
+        }
+      }
+
+      // the depth limit keeps the traversal stack bounded, it is not reached by balanced median splits
+      if (end - begin > leaf_size() && depth < 40)
+      {
+        std::size_t axis = 0;
+        for (std::size_t i = 1; i < 3; ++i)
+          if (center_upper[i] - center_lower[i] > center_upper[axis] - center_lower[axis])
+            axis = i;
+
+        std::size_t middle = begin + (end - begin) / 2;
+        std::nth_element(primitives_.begin() + static_cast<std::ptrdiff_t>(begin),
+                         primitives_.begin() + static_cast<std::ptrdiff_t>(middle),
+                         primitives_.begin() + static_cast<std::ptrdiff_t>(end),
+                         center_less(this, axis));
+
+        node.left = build_node(begin, middle, depth + 1);
+        node.right = build_node(middle, end, depth + 1);
+      }
+
+      nodes_[index] = node;
+      return index;
+    }
+
+    void primitive_center(detail::signed_distance_primitive const & prim, double * center) const
+    {
+      center[0] = center[1] = center[2] = 0.0;
+      for (std::size_t j = 0; j < prim.vertex_count; ++j)
+        detail::sdf_add_scaled(center, point(prim.vertices[j]), 1.0 / static_cast<double>(prim.vertex_count));
+    }
+
+    /** @brief Compares primitives by the coordinate of their centers along an axis */
+    struct center_less
+    {
+      center_less(signed_distance_tree const * tree, std::size_t axis) : tree_(tree), axis_(axis) {}
+
+      bool operator()(detail::signed_distance_primitive const & a, detail::signed_distance_primitive const & b) const
+      {
+        double ca[3], cb[3];
+        tree_->primitive_center(a, ca);
+        tree_->primitive_center(b, cb);
+        return ca[axis_] < cb[axis_];
+      }
+
+      signed_distance_tree const * tree_;
+      std::size_t axis_;
+    };
+    friend struct center_less;
+
+    static std::size_t invalid_index() { return static_cast<std::size_t>(-1); }
+
+    std::vector<double> points_;
+    std::vector<std::size_t> point_index_;
+    std::vector<double> vertex_normals_;
+    std::vector<double> edge_normals_;
+    std::vector<detail::signed_distance_primitive> primitives_;
+    std::vector<detail::signed_distance_node> nodes_;
+  };
+
+
+
+  /** @brief Computes the signed distance of each vertex of a mesh or segment to the boundary represented by a signed_distance_tree.
+    *
+    * The distances of the vertices are computed in parallel if VIENNAGRID_WITH_OPENMP is defined. With a positive 'band', only the boundary within this distance is searched.
+    * The distances of vertices farther away are set to +band or -band, the sign is propagated along the edges of the target from the vertices within the band.
+    * Hence the band has to be larger than the edge lengths of the target near the boundary. Vertices of parts of the target without any vertex within the band are queried without cutoff.
+    *
+    * @param target                   The mesh or segment on whose vertices the field is computed
+    * @param tree                     The tree of the boundary
+    * @param field                    The field (accessor) on the vertices of the target, e.g. obtained by viennagrid::make_field()
+    * @param band                     The narrow band width, zero for no cutoff
+    */
+  template<typename TargetMeshOrSegmentT, typename FieldT>
+  void signed_distance_field(TargetMeshOrSegmentT const & target, signed_distance_tree const & tree, FieldT field, double band = 0.0)
+  {
+    typedef typename viennagrid::result_of::vertex<TargetMeshOrSegmentT>::type             VertexType;
+    typedef typename viennagrid::result_of::const_vertex_range<TargetMeshOrSegmentT>::type ConstVertexRangeType;
+    typedef typename viennagrid::result_of::iterator<ConstVertexRangeType>::type           ConstVertexIteratorType;
+    typedef typename viennagrid::result_of::point<TargetMeshOrSegmentT>::type              PointType;
+
+    typename viennagrid::result_of::default_point_accessor<TargetMeshOrSegmentT>::type point_accessor = viennagrid::default_point_accessor(target);
+
+    ConstVertexRangeType vertices(target);
+    std::vector<VertexType const *> vertex_pointers;
+    std::vector<PointType> points;
+    vertex_pointers.reserve( vertices.size() );
+    points.reserve( vertices.size() );
+    for (ConstVertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+    {
+      vertex_pointers.push_back( &*vit );
+      points.push_back( point_accessor(*vit) );
+    }
+
+    double max_distance = (band > 0.0) ? band : std::numeric_limits<double>::infinity();
+    std::vector<double> distances( points.size() );
+    long vertex_count = static_cast<long>(points.size());
+
+#ifdef VIENNAGRID_WITH_OPENMP
+    #pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (long i = 0; i < vertex_count; ++i)
+      distances[static_cast<std::size_t>(i)] = tree( points[static_cast<std::size_t>(i)], max_distance );
+
+    if (band > 0.0)
+    {
+      typedef typename viennagrid::result_of::const_line_range<TargetMeshOrSegmentT>::type    ConstLineRangeType;
+      typedef typename viennagrid::result_of::iterator<ConstLineRangeType>::type              ConstLineIteratorType;
+      typedef typename viennagrid::result_of::const_vertex_range<typename viennagrid::result_of::line<TargetMeshOrSegmentT>::type>::type ConstVertexOnLineRangeType;
+
+      // vertices of the target connected by edges
+      std::map<VertexType const *, std::size_t> vertex_index;
+      for (std::size_t i = 0; i < vertex_pointers.size(); ++i)
+        vertex_index[ vertex_pointers[i] ] = i;
+
+      std::vector< std::vector<std::size_t> > adjacent( vertex_pointers.size() );
+      ConstLineRangeType lines(target);
+      for (ConstLineIteratorType lit = lines.begin(); lit != lines.end(); ++lit)
+      {
+        ConstVertexOnLineRangeType line_vertices(*lit);
+        std::size_t v0 = vertex_index[ &line_vertices[0] ];
+        std::size_t v1 = vertex_index[ &line_vertices[1] ];
+        adjacent[v0].push_back(v1);
+        adjacent[v1].push_back(v0);
+      }
+
+      // breadth-first propagation of the sign from the vertices within the band
+      std::vector<char> known( distances.size() );
+      std::deque<std::size_t> queue;
+      for (std::size_t i = 0; i < distances.size(); ++i)
+        if (distances[i] != std::numeric_limits<double>::infinity())
+        {
+          known[i] = 1;
+          queue.push_back(i);
+        }
+
+      std::size_t next_unknown = 0;
+      while (true)
+      {
+        while (!queue.empty())
+        {
+          std::size_t i = queue.front();
+          queue.pop_front();
+          for (std::size_t j = 0; j < adjacent[i].size(); ++j)
+          {
+            std::size_t neighbor = adjacent[i][j];
+            if (known[neighbor])
+              continue;
+            known[neighbor] = 1;
+            distances[neighbor] = (distances[i] < 0.0) ? -band : band;
+            queue.push_back(neighbor);
+          }
+        }
+
+        // a part of the target without vertices within the band: query one vertex without cutoff
+        while (next_unknown < distances.size() && known[next_unknown])
+          ++next_unknown;
+        if (next_unknown == distances.size())
+          break;
+
+        distances[next_unknown] = (tree( points[next_unknown] ) < 0.0) ? -band : band;
+        known[next_unknown] = 1;
+        queue.push_back(next_unknown);
+      }
+    }
+
+    for (std::size_t i = 0; i < vertex_pointers.size(); ++i)
+      field( *vertex_pointers[i] ) = distances[i];
+  }
+
+  /** @brief Computes the signed distance of each vertex of a mesh or segment to the boundary of another mesh or segment, negative inside the source.
+    *
+    * Builds a signed_distance_tree of the source boundary; reuse the tree with the other overload if the source does not change.
+    *
+    * @param target                   The mesh or segment on whose vertices the field is computed
+    * @param source                   The mesh or segment whose boundary is used
+    * @param field                    The field (accessor) on the vertices of the target, e.g. obtained by viennagrid::make_field()
+    * @param band                     The narrow band width, zero for no cutoff
+    */
+  template<typename TargetMeshOrSegmentT, typename SourceMeshOrSegmentT, typename FieldT>
+  void signed_distance_field(TargetMeshOrSegmentT const & target, SourceMeshOrSegmentT const & source, FieldT field, double band = 0.0)
+  {
+    signed_distance_tree tree(source);
+    signed_distance_field(target, tree, field, band);
+  }
+
+}
+
+#endif
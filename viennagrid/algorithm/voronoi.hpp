@@ -17,6 +17,8 @@
 #include <sstream>
 #include <string>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
 
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/mesh/segmentation.hpp"
@@ -25,6 +27,8 @@
 #include "viennagrid/algorithm/spanned_volume.hpp"
 #include "viennagrid/algorithm/volume.hpp"
 #include "viennagrid/algorithm/inner_prod.hpp"
+#include "viennagrid/algorithm/norm.hpp"
+#include "viennagrid/algorithm/detail/thread_partials.hpp"
 
 
 /** @file viennagrid/algorithm/voronoi.hpp
@@ -48,6 +52,80 @@ namespace viennagrid
   }
 
 
+  /** @brief Cell contributions to a Voronoi quantity in compressed sparse row (CSR) layout. Row i holds the contributions to the element with ID i, ordered by cell.
+    *
+    * @tparam ConstCellHandleT    The handle type for cells
+    */
+  template <typename ConstCellHandleT>
+  class voronoi_contribution_csr
+  {
+  public:
+    typedef std::pair<ConstCellHandleT, double>                 value_type;
+    typedef std::size_t                                         size_type;
+    typedef typename std::vector<value_type>::const_iterator    const_iterator;
+
+    /** @brief Returns the number of rows, i.e. the ID upper bound of the elements */
+    size_type size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+    /** @brief Returns the total number of contributions */
+    size_type entry_count() const { return entries_.size(); }
+
+    /** @brief Returns an iterator to the first contribution of the row 'row' */
+    const_iterator row_begin(size_type row) const { return row < size() ? entries_.begin() + static_cast<long>(offsets_[row]) : entries_.end(); }
+    /** @brief Returns the iterator past the last contribution of the row 'row' */
+    const_iterator row_end(size_type row) const { return row < size() ? entries_.begin() + static_cast<long>(offsets_[row+1]) : entries_.end(); }
+
+    /** @brief Returns an iterator to the first contribution to an element */
+    template <typename ElementT>
+    const_iterator begin(ElementT const & element) const { return row_begin( static_cast<size_type>(element.id().get()) ); }
+    /** @brief Returns the iterator past the last contribution to an element */
+    template <typename ElementT>
+    const_iterator end(ElementT const & element) const { return row_end( static_cast<size_type>(element.id().get()) ); }
+
+    /** @brief Returns the sum of all contributions of the row 'row' */
+    double row_sum(size_type row) const
+    {
+      double sum = 0;
+      for (const_iterator it = row_begin(row); it != row_end(row); ++it)
+        sum += it->second;
+      return sum;
+    }
+
+    /** @brief Replaces the content by the given row offsets and contributions. The contributions are swapped in, thus 'entries' is empty afterwards. */
+    void assign(std::vector<size_type> const & offsets, std::vector<value_type> & entries)
+    {
+      offsets_ = offsets;
+      entries_.clear();
+      entries_.swap(entries);
+    }
+
+    /** @brief Removes all rows and releases the memory */
+    void clear()
+    {
+      std::vector<size_type>().swap(offsets_);
+      std::vector<value_type>().swap(entries_);
+    }
+
+  private:
+    std::vector<size_type>  offsets_;
+    std::vector<value_type> entries_;
+  };
+
+  /** @brief Cell contributions to interface areas and box volumes in CSR layout, see apply_voronoi()
+    *
+    * @tparam ConstCellHandleT    The handle type for cells
+    */
+  template <typename ConstCellHandleT>
+  struct voronoi_contributions
+  {
+    /** @brief Contributions to the interface areas, rows indexed by edge ID */
+    voronoi_contribution_csr<ConstCellHandleT> interface_area;
+    /** @brief Contributions to the vertex box volumes, rows indexed by vertex ID */
+    voronoi_contribution_csr<ConstCellHandleT> vertex_box_volume;
+    /** @brief Contributions to the edge box volumes, rows indexed by edge ID */
+    voronoi_contribution_csr<ConstCellHandleT> edge_box_volume;
+  };
+
+
   namespace detail
   {
     /** @brief Adds a pair [CellPtr, contribution] to the Voronoi quantities stored in the container. If data for the particular Cell are already stored, no new element is inserted, but existing 'contribution' is updated.
@@ -888,6 +966,988 @@ namespace viennagrid
 
     }
 
+
+    //
+    // Cache-free computation of Voronoi quantities: Each cell reports its contributions to its own edges and vertices to an accumulator
+    //
+
+    /** @brief For internal use only. The element tag of the edges for which interface areas are computed (the cell itself for one-dimensional meshes). */
+    template <typename CellTag>
+    struct voronoi_edge_tag
+    {
+      typedef viennagrid::line_tag type;
+    };
+
+    template <>
+    struct voronoi_edge_tag< viennagrid::hypercube_tag<1> >
+    {
+      typedef viennagrid::hypercube_tag<1> type;
+    };
+
+
+    /** @brief For internal use only. Number of vertices and edges of a cell for which a cell reports Voronoi contributions. */
+    template <typename CellTag>
+    struct voronoi_local_size
+    {
+      static const int vertices = viennagrid::boundary_elements<CellTag, viennagrid::vertex_tag>::num;
+      static const int edges = viennagrid::boundary_elements<CellTag, viennagrid::line_tag>::num;
+    };
+
+    template <>
+    struct voronoi_local_size< viennagrid::simplex_tag<1> >
+    {
+      static const int vertices = 2;
+      static const int edges = 1;
+    };
+
+    template <>
+    struct voronoi_local_size< viennagrid::hypercube_tag<1> >
+    {
+      static const int vertices = 2;
+      static const int edges = 1;
+    };
+
+
+    /** @brief For internal use only. Writes pointers to the edges of a cell to 'edges'. */
+    template <typename CellT, typename EdgeT>
+    void voronoi_cell_edges(CellT const & cell, EdgeT const ** edges, viennagrid::simplex_tag<1>)
+    {
+      edges[0] = &cell;
+    }
+
+    template <typename CellT, typename EdgeT>
+    void voronoi_cell_edges(CellT const & cell, EdgeT const ** edges, viennagrid::hypercube_tag<1>)
+    {
+      edges[0] = &cell;
+    }
+
+    template <typename CellT, typename EdgeT, typename CellTag>
+    void voronoi_cell_edges(CellT const & cell, EdgeT const ** edges, CellTag)
+    {
+      typedef typename viennagrid::result_of::const_element_range<CellT, viennagrid::line_tag>::type    EdgeOnCellRange;
+      typedef typename viennagrid::result_of::iterator<EdgeOnCellRange>::type                           EdgeOnCellIterator;
+
+      EdgeOnCellRange edges_on_cell = viennagrid::elements<viennagrid::line_tag>(cell);
+      int i = 0;
+      for (EdgeOnCellIterator eocit = edges_on_cell.begin(); eocit != edges_on_cell.end(); ++eocit, ++i)
+        edges[i] = &*eocit;
+    }
+
+    /** @brief For internal use only. Writes pointers to the vertices of a cell to 'vertices'. */
+    template <typename CellT, typename VertexT>
+    void voronoi_cell_vertices(CellT const & cell, VertexT const ** vertices)
+    {
+      typedef typename viennagrid::result_of::const_element_range<CellT, viennagrid::vertex_tag>::type  VertexOnCellRange;
+      typedef typename viennagrid::result_of::iterator<VertexOnCellRange>::type                         VertexOnCellIterator;
+
+      VertexOnCellRange vertices_on_cell = viennagrid::elements<viennagrid::vertex_tag>(cell);
+      int i = 0;
+      for (VertexOnCellIterator vocit = vertices_on_cell.begin(); vocit != vertices_on_cell.end(); ++vocit, ++i)
+        vertices[i] = &*vocit;
+    }
+
+
+    /** @brief For internal use only. Counts the cells of a mesh or segment on each edge (saturated at 2), indexed by edge ID. Only required for triangular meshes, where the contributions of cells with circumcenter outside depend on whether the opposite edge is on the boundary. */
+    template <typename CellT>
+    void voronoi_edge_cell_counts(std::vector<CellT const *> const &, std::vector<unsigned char> &, std::size_t, viennagrid::simplex_tag<1>) {}
+
+    template <typename CellT>
+    void voronoi_edge_cell_counts(std::vector<CellT const *> const &, std::vector<unsigned char> &, std::size_t, viennagrid::hypercube_tag<1>) {}
+
+    template <typename CellT, typename CellTag>
+    void voronoi_edge_cell_counts(std::vector<CellT const *> const &, std::vector<unsigned char> &, std::size_t, CellTag) {}
+
+    template <typename CellT>
+    void voronoi_edge_cell_counts(std::vector<CellT const *> const & cells, std::vector<unsigned char> & edge_cell_counts, std::size_t edge_id_upper_bound, viennagrid::triangle_tag)
+    {
+      typedef typename viennagrid::result_of::const_element_range<CellT, viennagrid::line_tag>::type    EdgeOnCellRange;
+      typedef typename viennagrid::result_of::iterator<EdgeOnCellRange>::type                           EdgeOnCellIterator;
+
+      edge_cell_counts.assign(edge_id_upper_bound, 0);
+      for (std::size_t i = 0; i < cells.size(); ++i)
+      {
+        EdgeOnCellRange edges_on_cell = viennagrid::elements<viennagrid::line_tag>(*cells[i]);
+        for (EdgeOnCellIterator eocit = edges_on_cell.begin(); eocit != edges_on_cell.end(); ++eocit)
+        {
+          unsigned char & count = edge_cell_counts[static_cast<std::size_t>(eocit->id().get())];
+          if (count < 2)
+            ++count;
+        }
+      }
+    }
+
+
+    /** @brief For internal use only. Tells whether an edge is shared by two cells using the cell counts from voronoi_edge_cell_counts(). */
+    class voronoi_edge_count_predicate
+    {
+    public:
+      voronoi_edge_count_predicate(std::vector<unsigned char> const & edge_cell_counts) : edge_cell_counts_(edge_cell_counts) {}
+
+      template <typename EdgeT>
+      bool operator()(EdgeT const & edge) const { return edge_cell_counts_[static_cast<std::size_t>(edge.id().get())] > 1; }
+
+    private:
+      std::vector<unsigned char> const & edge_cell_counts_;
+    };
+
+
+    /** @brief For internal use only. Accumulates Voronoi contributions into flat arrays indexed by element ID. */
+    class voronoi_id_accumulator
+    {
+    public:
+      voronoi_id_accumulator(double * interface_areas, double * edge_box_volumes, double * vertex_box_volumes) :
+          interface_areas_(interface_areas), edge_box_volumes_(edge_box_volumes), vertex_box_volumes_(vertex_box_volumes) {}
+
+      template <typename EdgeT>
+      void add_interface_area(EdgeT const & edge, double value) { interface_areas_[static_cast<std::size_t>(edge.id().get())] += value; }
+
+      template <typename EdgeT>
+      void add_edge_box_volume(EdgeT const & edge, double value) { edge_box_volumes_[static_cast<std::size_t>(edge.id().get())] += value; }
+
+      template <typename VertexT>
+      void add_vertex_box_volume(VertexT const & vertex, double value) { vertex_box_volumes_[static_cast<std::size_t>(vertex.id().get())] += value; }
+
+    private:
+      double * interface_areas_;
+      double * edge_box_volumes_;
+      double * vertex_box_volumes_;
+    };
+
+
+    /** @brief For internal use only. Accumulates the Voronoi contributions of a single cell into a local array, ordered as the edges and vertices of the cell.
+      *
+      * Layout of the local array: interface areas of all edges, box volumes of all edges, box volumes of all vertices.
+      */
+    template <typename CellTag, typename VertexT, typename EdgeT>
+    class voronoi_local_accumulator
+    {
+    public:
+      static const int vertex_count = voronoi_local_size<CellTag>::vertices;
+      static const int edge_count = voronoi_local_size<CellTag>::edges;
+      static const int value_count = 2 * edge_count + vertex_count;
+
+      voronoi_local_accumulator() : values_(NULL) {}
+
+      template <typename CellT>
+      void reset(CellT const & cell, double * values)
+      {
+        voronoi_cell_edges(cell, edges_, CellTag());
+        voronoi_cell_vertices(cell, vertices_);
+        values_ = values;
+        std::fill(values_, values_ + value_count, 0.0);
+      }
+
+      void add_interface_area(EdgeT const & edge, double value) { values_[edge_index(edge)] += value; }
+      void add_edge_box_volume(EdgeT const & edge, double value) { values_[edge_count + edge_index(edge)] += value; }
+      void add_vertex_box_volume(VertexT const & vertex, double value) { values_[2 * edge_count + vertex_index(vertex)] += value; }
+
+    private:
+      int edge_index(EdgeT const & edge) const
+      {
+        int i = 0;
+        while (edges_[i] != &edge)
+          ++i;
+        return i;
+      }
+
+      int vertex_index(VertexT const & vertex) const
+      {
+        int i = 0;
+        while (vertices_[i] != &vertex)
+          ++i;
+        return i;
+      }
+
+      EdgeT const * edges_[edge_count];
+      VertexT const * vertices_[vertex_count];
+      double * values_;
+    };
+
+
+    /** @brief For internal use only. Reports the Voronoi contributions of a line (1-simplex) to an accumulator */
+    template <typename MeshT, typename CellT, typename EdgeSharedT, typename AccumulatorT>
+    void voronoi_cell_contributions(MeshT const &, CellT const & cell, EdgeSharedT const &, AccumulatorT & accumulator, viennagrid::simplex_tag<1>)
+    {
+      typedef typename viennagrid::result_of::const_element_range<CellT, vertex_tag>::type  VertexOnCellRange;
+      typedef typename viennagrid::result_of::iterator<VertexOnCellRange>::type             VertexOnCellIterator;
+
+      accumulator.add_interface_area(cell, 1);
+
+      double edge_contribution = 0;
+      VertexOnCellRange vertices_on_cell = viennagrid::elements<vertex_tag>(cell);
+      for (VertexOnCellIterator vocit  = vertices_on_cell.begin();
+                                vocit != vertices_on_cell.end();
+                              ++vocit)
+      {
+        double contribution = volume(cell) / 2.0;
+        edge_contribution += contribution;
+        accumulator.add_vertex_box_volume(*vocit, contribution);
+      }
+
+      accumulator.add_edge_box_volume(cell, edge_contribution);
+    }
+
+    /** @brief For internal use only. Reports the Voronoi contributions of a line (1-hypercube) to an accumulator */
+    template <typename MeshT, typename CellT, typename EdgeSharedT, typename AccumulatorT>
+    void voronoi_cell_contributions(MeshT const & mesh_obj, CellT const & cell, EdgeSharedT const & edge_is_shared, AccumulatorT & accumulator, viennagrid::hypercube_tag<1>)
+    {
+      voronoi_cell_contributions(mesh_obj, cell, edge_is_shared, accumulator, viennagrid::simplex_tag<1>());
+    }
+
+    /** @brief For internal use only. Reports the Voronoi contributions of a quadrilateral to an accumulator */
+    template <typename MeshT, typename CellT, typename EdgeSharedT, typename AccumulatorT>
+    void voronoi_cell_contributions(MeshT const &, CellT const & cell, EdgeSharedT const &, AccumulatorT & accumulator, viennagrid::quadrilateral_tag)
+    {
+      typedef typename viennagrid::result_of::point<MeshT>::type                                PointType;
+      typedef typename viennagrid::result_of::element<MeshT, line_tag>::type                    EdgeType;
+
+      typedef typename viennagrid::result_of::const_element_range<CellT, line_tag>::type        EdgeOnCellRange;
+      typedef typename viennagrid::result_of::iterator<EdgeOnCellRange>::type                   EdgeOnCellIterator;
+
+      typedef typename viennagrid::result_of::const_element_range<EdgeType, vertex_tag>::type   VertexOnEdgeRange;
+      typedef typename viennagrid::result_of::iterator<VertexOnEdgeRange>::type                 VertexOnEdgeIterator;
+
+      PointType circ_center = circumcenter(cell);
+
+      EdgeOnCellRange edges_on_cell = viennagrid::elements<line_tag>(cell);
+      for (EdgeOnCellIterator eocit  = edges_on_cell.begin();
+                              eocit != edges_on_cell.end();
+                            ++eocit)
+      {
+        PointType edge_midpoint = circumcenter(*eocit);
+
+        accumulator.add_interface_area(*eocit, spanned_volume(circ_center, edge_midpoint));
+
+        double edge_contribution = 0;
+        VertexOnEdgeRange vertices_on_edge = viennagrid::elements<vertex_tag>(*eocit);
+        for (VertexOnEdgeIterator voeit  = vertices_on_edge.begin();
+                                  voeit != vertices_on_edge.end();
+                                ++voeit)
+        {
+          double contribution = spanned_volume(circ_center, edge_midpoint, viennagrid::point(*voeit));
+          edge_contribution += contribution;
+          accumulator.add_vertex_box_volume(*voeit, contribution);
+        }
+
+        accumulator.add_edge_box_volume(*eocit, edge_contribution);
+      }
+    }
+
+    /** @brief For internal use only. Reports the Voronoi contributions of a triangle to an accumulator.
+      *
+      * Same decomposition as write_voronoi_info() for triangles, except that all contributions are attributed to the cell itself.
+      * If the circumcenter is outside, the predicate 'edge_is_shared' tells whether the intersected edge is shared with another cell.
+      */
+    template <typename MeshT, typename CellT, typename EdgeSharedT, typename AccumulatorT>
+    void voronoi_cell_contributions(MeshT const &, CellT const & cell, EdgeSharedT const & edge_is_shared, AccumulatorT & accumulator, viennagrid::triangle_tag)
+    {
+      typedef typename viennagrid::result_of::point<MeshT>::type                                PointType;
+      typedef typename viennagrid::result_of::element<MeshT, vertex_tag>::type                  VertexType;
+      typedef typename viennagrid::result_of::element<MeshT, line_tag>::type                    EdgeType;
+
+      typedef typename viennagrid::result_of::const_element_range<CellT, vertex_tag>::type      VertexOnCellRange;
+      typedef typename viennagrid::result_of::const_element_range<CellT, line_tag>::type        EdgeOnCellRange;
+      typedef typename viennagrid::result_of::iterator<EdgeOnCellRange>::type                   EdgeOnCellIterator;
+
+      typedef typename viennagrid::result_of::const_element_range<EdgeType, vertex_tag>::type   VertexOnEdgeRange;
+      typedef typename viennagrid::result_of::iterator<VertexOnEdgeRange>::type                 VertexOnEdgeIterator;
+
+      PointType circ_center = circumcenter(cell);
+      PointType circ_center_local = point_to_local_coordinates(circ_center, cell);
+
+      EdgeOnCellRange edges_on_cell = viennagrid::elements<line_tag>(cell);
+
+      if (    (circ_center_local[0] < 0)
+           || (circ_center_local[1] < 0)
+           || (circ_center_local[0] + circ_center_local[1] > 1.0) )   //circumcenter is outside triangle
+      {
+        VertexOnCellRange vertices_on_cell = viennagrid::elements<vertex_tag>(cell);
+
+        EdgeType const * intersected_edge_ptr = NULL;
+        VertexType const * opposite_vertex_ptr = NULL;
+        if (circ_center_local[1] < 0)
+        {
+          intersected_edge_ptr = &(edges_on_cell[0]);
+          opposite_vertex_ptr = &(vertices_on_cell[2]);
+        }
+        else if (circ_center_local[0] < 0)
+        {
+          intersected_edge_ptr = &(edges_on_cell[1]);
+          opposite_vertex_ptr = &(vertices_on_cell[1]);
+        }
+        else
+        {
+          intersected_edge_ptr = &(edges_on_cell[2]);
+          opposite_vertex_ptr = &(vertices_on_cell[0]);
+        }
+
+        bool has_other_cell = edge_is_shared(*intersected_edge_ptr);
+
+        VertexOnEdgeRange vertices_on_intersected_edge = viennagrid::elements<vertex_tag>(*intersected_edge_ptr);
+        PointType opposite_vertex_edge_intersection = line_intersection( viennagrid::point(*opposite_vertex_ptr), circ_center,
+                                                                         viennagrid::point(vertices_on_intersected_edge[0]),
+                                                                         viennagrid::point(vertices_on_intersected_edge[1]));
+
+        for (EdgeOnCellIterator eocit  = edges_on_cell.begin();
+                                eocit != edges_on_cell.end();
+                              ++eocit)
+        {
+          PointType edge_midpoint = circumcenter(*eocit);
+
+          if ( intersected_edge_ptr != &(*eocit) )
+          {
+            PointType edge_intersection = line_intersection( edge_midpoint, circ_center,
+                                                             viennagrid::point(vertices_on_intersected_edge[0]),
+                                                             viennagrid::point(vertices_on_intersected_edge[1]));
+
+            accumulator.add_interface_area(*eocit, spanned_volume(edge_intersection, edge_midpoint));
+            accumulator.add_interface_area(*eocit, spanned_volume(edge_intersection, circ_center));
+
+            double edge_contribution = 0;
+            VertexOnEdgeRange vertices_on_edge = viennagrid::elements<vertex_tag>(*eocit);
+            for (VertexOnEdgeIterator voeit  = vertices_on_edge.begin();
+                                      voeit != vertices_on_edge.end();
+                                    ++voeit)
+            {
+              double contribution = spanned_volume(edge_intersection, edge_midpoint, viennagrid::point(*voeit));
+              edge_contribution += contribution;
+              accumulator.add_vertex_box_volume(*voeit, contribution);
+
+              if ( &(*voeit) != opposite_vertex_ptr )
+              {
+                if (has_other_cell)
+                {
+                  double contribution_other = spanned_volume(circ_center, edge_intersection, viennagrid::point(*voeit));
+                  accumulator.add_vertex_box_volume(*voeit, contribution_other);
+                  accumulator.add_edge_box_volume(*eocit, contribution_other);
+                }
+              }
+              else
+              {
+                double contribution_cell = spanned_volume(opposite_vertex_edge_intersection, edge_intersection, viennagrid::point(*voeit));
+                accumulator.add_vertex_box_volume(*voeit, contribution_cell);
+                accumulator.add_edge_box_volume(*eocit, contribution_cell);
+
+                if (has_other_cell)
+                {
+                  double contribution_other = spanned_volume(circ_center, edge_intersection, opposite_vertex_edge_intersection);
+                  accumulator.add_vertex_box_volume(*voeit, contribution_other);
+                  accumulator.add_edge_box_volume(*eocit, contribution_other);
+                }
+              }
+            }
+            accumulator.add_edge_box_volume(*eocit, edge_contribution);
+          }
+          else if (has_other_cell)  // intersected edge: negative contributions
+          {
+            accumulator.add_interface_area(*eocit, -1.0 * spanned_volume(circ_center, edge_midpoint));
+
+            double edge_contribution = 0;
+            VertexOnEdgeRange vertices_on_edge = viennagrid::elements<vertex_tag>(*eocit);
+            for (VertexOnEdgeIterator voeit  = vertices_on_edge.begin();
+                                      voeit != vertices_on_edge.end();
+                                    ++voeit)
+            {
+              double contribution = spanned_volume(circ_center, edge_midpoint, viennagrid::point(*voeit));
+              edge_contribution += contribution;
+              accumulator.add_vertex_box_volume(*voeit, -1.0 * contribution);
+            }
+            accumulator.add_edge_box_volume(*eocit, -1.0 * edge_contribution);
+          }
+        }
+      }
+      else    // circumcenter is inside triangle
+      {
+        for (EdgeOnCellIterator eocit  = edges_on_cell.begin();
+                                eocit != edges_on_cell.end();
+                              ++eocit)
+        {
+          PointType edge_midpoint = circumcenter(*eocit);
+
+          accumulator.add_interface_area(*eocit, spanned_volume(circ_center, edge_midpoint));
+
+          double edge_contribution = 0;
+          VertexOnEdgeRange vertices_on_edge = viennagrid::elements<vertex_tag>(*eocit);
+          for (VertexOnEdgeIterator voeit  = vertices_on_edge.begin();
+                                    voeit != vertices_on_edge.end();
+                                  ++voeit)
+          {
+            double contribution = spanned_volume(circ_center, edge_midpoint, viennagrid::point(*voeit));
+            edge_contribution += contribution;
+            accumulator.add_vertex_box_volume(*voeit, contribution);
+          }
+          accumulator.add_edge_box_volume(*eocit, edge_contribution);
+        }
+      }
+    }
+
+    /** @brief For internal use only. Reports the Voronoi contributions of a tetrahedron to an accumulator.
+      *
+      * The interface polygon of an edge is decomposed into the triangles [edge midpoint, facet circumcenter, cell circumcenter] of all pairs of cells and facets around the edge.
+      * Each triangle is signed, hence circumcenters outside of their cell are accounted for without the polygon of all cells around the edge.
+      * For Delaunay meshes the result agrees with write_voronoi_info() for tetrahedra.
+      */
+    template <typename MeshT, typename CellT, typename EdgeSharedT, typename AccumulatorT>
+    void voronoi_cell_contributions(MeshT const & mesh_obj, CellT const & cell, EdgeSharedT const &, AccumulatorT & accumulator, viennagrid::tetrahedron_tag)
+    {
+      typedef typename viennagrid::result_of::point<MeshT>::type                                PointType;
+      typedef typename viennagrid::result_of::element<MeshT, vertex_tag>::type                  VertexType;
+      typedef typename viennagrid::result_of::element<MeshT, triangle_tag>::type                FacetType;
+
+      typedef typename viennagrid::result_of::const_element_range<CellT, vertex_tag>::type      VertexOnCellRange;
+      typedef typename viennagrid::result_of::iterator<VertexOnCellRange>::type                 VertexOnCellIterator;
+
+      typedef typename viennagrid::result_of::const_element_range<CellT, triangle_tag>::type    FacetOnCellRange;
+      typedef typename viennagrid::result_of::iterator<FacetOnCellRange>::type                  FacetOnCellIterator;
+
+      typedef typename viennagrid::result_of::const_element_range<FacetType, vertex_tag>::type  VertexOnFacetRange;
+      typedef typename viennagrid::result_of::const_element_range<FacetType, line_tag>::type    EdgeOnFacetRange;
+      typedef typename viennagrid::result_of::iterator<EdgeOnFacetRange>::type                  EdgeOnFacetIterator;
+
+      PointType circ_center = circumcenter(cell);
+      VertexOnCellRange vertices_on_cell = viennagrid::elements<vertex_tag>(cell);
+
+      FacetOnCellRange facets_on_cell = viennagrid::elements<triangle_tag>(cell);
+      for (FacetOnCellIterator focit  = facets_on_cell.begin();
+                               focit != facets_on_cell.end();
+                             ++focit)
+      {
+        PointType facet_circ_center = circumcenter(*focit);
+        VertexOnFacetRange vertices_on_facet = viennagrid::elements<vertex_tag>(*focit);
+
+        // signed distance of the cell circumcenter from the facet, positive on the side of the cell:
+        VertexType const * opposite_vertex_ptr = NULL;
+        for (VertexOnCellIterator vocit = vertices_on_cell.begin(); vocit != vertices_on_cell.end(); ++vocit)
+          if (&*vocit != &vertices_on_facet[0] && &*vocit != &vertices_on_facet[1] && &*vocit != &vertices_on_facet[2])
+            opposite_vertex_ptr = &*vocit;
+
+        double cell_height = viennagrid::norm_2(circ_center - facet_circ_center);
+        if (viennagrid::inner_prod(circ_center - facet_circ_center, viennagrid::point(mesh_obj, *opposite_vertex_ptr) - facet_circ_center) < 0)
+          cell_height = -cell_height;
+
+        EdgeOnFacetRange edges_on_facet = viennagrid::elements<line_tag>(*focit);
+        for (EdgeOnFacetIterator eofit  = edges_on_facet.begin();
+                                 eofit != edges_on_facet.end();
+                               ++eofit)
+        {
+          VertexType const & v0 = viennagrid::vertices(*eofit)[0];
+          VertexType const & v1 = viennagrid::vertices(*eofit)[1];
+
+          // signed distance of the facet circumcenter from the edge, positive on the side of the facet:
+          VertexType const * facet_opposite_vertex_ptr = &vertices_on_facet[0];
+          for (int i = 1; facet_opposite_vertex_ptr == &v0 || facet_opposite_vertex_ptr == &v1; ++i)
+            facet_opposite_vertex_ptr = &vertices_on_facet[i];
+
+          PointType edge_midpoint = circumcenter(*eofit);
+          double facet_height = viennagrid::norm_2(facet_circ_center - edge_midpoint);
+          if (viennagrid::inner_prod(facet_circ_center - edge_midpoint, viennagrid::point(mesh_obj, *facet_opposite_vertex_ptr) - edge_midpoint) < 0)
+            facet_height = -facet_height;
+
+          double interface_contribution = facet_height * cell_height / 2.0;
+          double volume_contribution = interface_contribution * spanned_volume(viennagrid::point(mesh_obj, v0), viennagrid::point(mesh_obj, v1)) / 6.0;
+
+          accumulator.add_interface_area(*eofit, interface_contribution);
+          accumulator.add_edge_box_volume(*eofit, 2.0 * volume_contribution); //volume contribution of both box volumes associated with the edge
+          accumulator.add_vertex_box_volume(v0, volume_contribution);
+          accumulator.add_vertex_box_volume(v1, volume_contribution);
+        }
+      }
+    }
+
+    /** @brief For internal use only. Reports the Voronoi contributions of a hexahedron to an accumulator */
+    template <typename MeshT, typename CellT, typename EdgeSharedT, typename AccumulatorT>
+    void voronoi_cell_contributions(MeshT const & mesh_obj, CellT const & cell, EdgeSharedT const &, AccumulatorT & accumulator, viennagrid::hexahedron_tag)
+    {
+      typedef typename viennagrid::result_of::point<MeshT>::type                                    PointType;
+      typedef typename viennagrid::result_of::element<MeshT, line_tag>::type                        EdgeType;
+      typedef typename viennagrid::result_of::element<MeshT, quadrilateral_tag>::type               FacetType;
+
+      typedef typename viennagrid::result_of::const_element_range<CellT, quadrilateral_tag>::type   FacetOnCellRange;
+      typedef typename viennagrid::result_of::iterator<FacetOnCellRange>::type                      FacetOnCellIterator;
+
+      typedef typename viennagrid::result_of::const_element_range<FacetType, line_tag>::type        EdgeOnFacetRange;
+      typedef typename viennagrid::result_of::iterator<EdgeOnFacetRange>::type                      EdgeOnFacetIterator;
+
+      typedef typename viennagrid::result_of::const_element_range<EdgeType, vertex_tag>::type       VertexOnEdgeRange;
+      typedef typename viennagrid::result_of::iterator<VertexOnEdgeRange>::type                     VertexOnEdgeIterator;
+
+      PointType cell_center = circumcenter(cell);
+
+      FacetOnCellRange facets_on_cell = viennagrid::elements<quadrilateral_tag>(cell);
+      for (FacetOnCellIterator focit  = facets_on_cell.begin();
+                               focit != facets_on_cell.end();
+                             ++focit)
+      {
+        PointType facet_center = circumcenter(*focit);
+
+        EdgeOnFacetRange edges_on_facet = viennagrid::elements<line_tag>(*focit);
+        for (EdgeOnFacetIterator eofit  = edges_on_facet.begin();
+                                 eofit != edges_on_facet.end();
+                               ++eofit)
+        {
+          PointType edge_midpoint = viennagrid::circumcenter(*eofit);
+
+          accumulator.add_interface_area(*eofit, spanned_volume(cell_center, facet_center, edge_midpoint));
+
+          double edge_contribution = 0;
+          VertexOnEdgeRange vertices_on_edge = viennagrid::elements<vertex_tag>(*eofit);
+          for (VertexOnEdgeIterator voeit  = vertices_on_edge.begin();
+                                    voeit != vertices_on_edge.end();
+                                  ++voeit)
+          {
+            double contribution = spanned_volume(cell_center, facet_center, edge_midpoint, viennagrid::point(mesh_obj, *voeit));
+            accumulator.add_vertex_box_volume(*voeit, contribution);
+            edge_contribution += contribution;
+          }
+          accumulator.add_edge_box_volume(*eofit, edge_contribution);
+        }
+      }
+    }
+
+
+    /** @brief For internal use only. Returns pointers to all cells of a mesh or segment in iteration order, optionally also their handles. */
+    template <typename CellTag, typename MeshT, typename CellT, typename ConstCellHandleT>
+    void voronoi_collect_cells(MeshT const & mesh_obj, std::vector<CellT const *> & cells, std::vector<ConstCellHandleT> * cell_handles)
+    {
+      typedef typename viennagrid::result_of::const_element_range<MeshT, CellTag>::type  CellRange;
+      typedef typename viennagrid::result_of::iterator<CellRange>::type                  CellIterator;
+
+      CellRange cell_range = viennagrid::elements<CellTag>(mesh_obj);
+      cells.reserve(cell_range.size());
+      if (cell_handles)
+        cell_handles->reserve(cell_range.size());
+
+      for (CellIterator cit = cell_range.begin(); cit != cell_range.end(); ++cit)
+      {
+        cells.push_back( &*cit );
+        if (cell_handles)
+          cell_handles->push_back( cit.handle() );
+      }
+    }
+
+    /** @brief For internal use only. Writes flat arrays indexed by element ID to the accessors of all elements of the given type in a mesh or segment. */
+    template <typename ElementTag, typename MeshT, typename AccessorT>
+    void voronoi_write_field(MeshT const & mesh_obj, std::vector<double> const & values, std::size_t offset, AccessorT accessor)
+    {
+      typedef typename viennagrid::result_of::const_element_range<MeshT, ElementTag>::type  ElementRange;
+      typedef typename viennagrid::result_of::iterator<ElementRange>::type                  ElementIterator;
+
+      ElementRange elements = viennagrid::elements<ElementTag>(mesh_obj);
+      for (ElementIterator it = elements.begin(); it != elements.end(); ++it)
+        accessor(*it) = values[offset + static_cast<std::size_t>((*it).id().get())];
+    }
+
+    /** @brief For internal use only. Accumulates the Voronoi contributions of a cell into the partial arrays of the calling thread, see thread_partials.
+      *
+      * Layout of the partial arrays: interface areas, edge box volumes, vertex box volumes.
+      */
+    template <typename CellTag, typename MeshT, typename CellT, typename EdgeSharedT>
+    class voronoi_flat_kernel
+    {
+    public:
+      voronoi_flat_kernel(MeshT const & mesh_obj, std::vector<CellT const *> const & cells, EdgeSharedT const & edge_is_shared,
+                          std::vector<double> & values, std::size_t edge_id_upper_bound) :
+          mesh_obj_(mesh_obj), cells_(cells), edge_is_shared_(edge_is_shared), values_(values), edge_id_upper_bound_(edge_id_upper_bound) {}
+
+      void operator()(std::size_t i, std::size_t offset) const
+      {
+        double * thread_values = &values_[0] + offset;
+        voronoi_id_accumulator accumulator(thread_values, thread_values + edge_id_upper_bound_, thread_values + 2 * edge_id_upper_bound_);
+        voronoi_cell_contributions(mesh_obj_, *cells_[i], edge_is_shared_, accumulator, CellTag());
+      }
+
+    private:
+      MeshT const & mesh_obj_;
+      std::vector<CellT const *> const & cells_;
+      EdgeSharedT const & edge_is_shared_;
+      std::vector<double> & values_;
+      std::size_t edge_id_upper_bound_;
+    };
+
+
+    /** @brief For internal use only. Computes interface areas and box volumes into flat arrays without per-element contribution lists.
+      *
+      * The cells are processed in parallel and the per-thread sums are added up in thread order (see thread_partials),
+      * hence the rounding of the results depends on the number of threads, but not on thread scheduling.
+      */
+    template <typename CellTag,
+              typename MeshT,
+              typename InterfaceAreaAccessorT,
+              typename VertexBoxVolumeAccessorT,
+              typename EdgeBoxVolumeAccessorT>
+    void write_voronoi_info_flat(MeshT const & mesh_obj,
+                                 InterfaceAreaAccessorT   interface_area_accessor,
+                                 VertexBoxVolumeAccessorT vertex_box_volume_accessor,
+                                 EdgeBoxVolumeAccessorT   edge_box_volume_accessor)
+    {
+      typedef typename viennagrid::result_of::element<MeshT, CellTag>::type              CellType;
+      typedef typename viennagrid::result_of::const_handle<MeshT, CellTag>::type         ConstCellHandleType;
+      typedef typename voronoi_edge_tag<CellTag>::type                                   EdgeTag;
+
+      std::vector<CellType const *> cells;
+      voronoi_collect_cells<CellTag>(mesh_obj, cells, static_cast<std::vector<ConstCellHandleType> *>(NULL));
+
+      std::size_t edge_id_upper_bound = static_cast<std::size_t>( viennagrid::id_upper_bound<EdgeTag>(mesh_obj).get() );
+      std::size_t vertex_id_upper_bound = static_cast<std::size_t>( viennagrid::id_upper_bound<vertex_tag>(mesh_obj).get() );
+
+      std::vector<unsigned char> edge_cell_counts;
+      voronoi_edge_cell_counts(cells, edge_cell_counts, edge_id_upper_bound, CellTag());
+      voronoi_edge_count_predicate edge_is_shared(edge_cell_counts);
+
+      thread_partials partials(2 * edge_id_upper_bound + vertex_id_upper_bound);
+      std::vector<double> values( partials.size() );
+
+      partials.accumulate( cells.size(),
+                           voronoi_flat_kernel<CellTag, MeshT, CellType, voronoi_edge_count_predicate>(mesh_obj, cells, edge_is_shared, values, edge_id_upper_bound) );
+      partials.merge( thread_partials_sum<double>(values) );
+
+      voronoi_write_field<EdgeTag>(mesh_obj, values, 0, interface_area_accessor);
+      voronoi_write_field<EdgeTag>(mesh_obj, values, edge_id_upper_bound, edge_box_volume_accessor);
+      voronoi_write_field<vertex_tag>(mesh_obj, values, 2 * edge_id_upper_bound, vertex_box_volume_accessor);
+    }
+
+
+    /** @brief For internal use only. Computes interface areas and box volumes together with their cell contributions in CSR layout.
+      *
+      * The contributions of each cell are computed in parallel into a local array per cell, then scattered to the rows in cell order.
+      * The totals are the row sums, hence they do not depend on the number of threads.
+      */
+    template <typename CellTag,
+              typename MeshT,
+              typename InterfaceAreaAccessorT,
+              typename VertexBoxVolumeAccessorT,
+              typename EdgeBoxVolumeAccessorT,
+              typename ConstCellHandleT>
+    void write_voronoi_info_csr(MeshT const & mesh_obj,
+                                InterfaceAreaAccessorT   interface_area_accessor,
+                                VertexBoxVolumeAccessorT vertex_box_volume_accessor,
+                                EdgeBoxVolumeAccessorT   edge_box_volume_accessor,
+                                voronoi_contributions<ConstCellHandleT> & contributions)
+    {
+      typedef typename viennagrid::result_of::element<MeshT, CellTag>::type              CellType;
+      typedef typename viennagrid::result_of::element<MeshT, vertex_tag>::type           VertexType;
+      typedef typename voronoi_edge_tag<CellTag>::type                                   EdgeTag;
+      typedef typename viennagrid::result_of::element<MeshT, EdgeTag>::type              EdgeType;
+
+      typedef voronoi_local_accumulator<CellTag, VertexType, EdgeType>                   LocalAccumulatorType;
+      typedef typename voronoi_contribution_csr<ConstCellHandleT>::size_type             SizeType;
+      typedef typename voronoi_contribution_csr<ConstCellHandleT>::value_type            ValueType;
+
+      static const int vertex_count = LocalAccumulatorType::vertex_count;
+      static const int edge_count = LocalAccumulatorType::edge_count;
+      static const int value_count = LocalAccumulatorType::value_count;
+
+      std::vector<CellType const *> cells;
+      std::vector<ConstCellHandleT> cell_handles;
+      voronoi_collect_cells<CellTag>(mesh_obj, cells, &cell_handles);
+
+      std::size_t edge_id_upper_bound = static_cast<std::size_t>( viennagrid::id_upper_bound<EdgeTag>(mesh_obj).get() );
+      std::size_t vertex_id_upper_bound = static_cast<std::size_t>( viennagrid::id_upper_bound<vertex_tag>(mesh_obj).get() );
+
+      std::vector<unsigned char> edge_cell_counts;
+      voronoi_edge_cell_counts(cells, edge_cell_counts, edge_id_upper_bound, CellTag());
+      voronoi_edge_count_predicate edge_is_shared(edge_cell_counts);
+
+      //
+      // Step 1: Local contributions of each cell
+      //
+      std::vector<double> local_values( cells.size() * static_cast<std::size_t>(value_count) );
+      long cell_count = static_cast<long>(cells.size());
+
+#ifdef VIENNAGRID_WITH_OPENMP
+      #pragma omp parallel
+#endif
+      {
+        LocalAccumulatorType accumulator;
+
+#ifdef VIENNAGRID_WITH_OPENMP
+        #pragma omp for schedule(static)
+#endif
+        for (long i = 0; i < cell_count; ++i)
+        {
+          std::size_t index = static_cast<std::size_t>(i);
+          accumulator.reset(*cells[index], &local_values[index * static_cast<std::size_t>(value_count)]);
+          voronoi_cell_contributions(mesh_obj, *cells[index], edge_is_shared, accumulator, CellTag());
+        }
+      }
+
+      //
+      // Step 2: Row offsets
+      //
+      std::vector<SizeType> edge_offsets(edge_id_upper_bound + 1, 0);
+      std::vector<SizeType> vertex_offsets(vertex_id_upper_bound + 1, 0);
+
+      EdgeType const * edges[edge_count];
+      VertexType const * vertices[vertex_count];
+
+      for (std::size_t i = 0; i < cells.size(); ++i)
+      {
+        voronoi_cell_edges(*cells[i], edges, CellTag());
+        voronoi_cell_vertices(*cells[i], vertices);
+        for (int j = 0; j < edge_count; ++j)
+          ++edge_offsets[static_cast<std::size_t>(edges[j]->id().get()) + 1];
+        for (int j = 0; j < vertex_count; ++j)
+          ++vertex_offsets[static_cast<std::size_t>(vertices[j]->id().get()) + 1];
+      }
+
+      for (std::size_t i = 1; i < edge_offsets.size(); ++i)
+        edge_offsets[i] += edge_offsets[i-1];
+      for (std::size_t i = 1; i < vertex_offsets.size(); ++i)
+        vertex_offsets[i] += vertex_offsets[i-1];
+
+      //
+      // Step 3: Scatter the local contributions to the rows in cell order
+      //
+      std::vector<ValueType> interface_area_entries( edge_offsets.back() );
+      std::vector<ValueType> edge_box_volume_entries( edge_offsets.back() );
+      std::vector<ValueType> vertex_box_volume_entries( vertex_offsets.back() );
+
+      std::vector<SizeType> edge_positions(edge_offsets.begin(), edge_offsets.end() - 1);
+      std::vector<SizeType> vertex_positions(vertex_offsets.begin(), vertex_offsets.end() - 1);
+
+      for (std::size_t i = 0; i < cells.size(); ++i)
+      {
+        double const * values = &local_values[i * static_cast<std::size_t>(value_count)];
+
+        voronoi_cell_edges(*cells[i], edges, CellTag());
+        voronoi_cell_vertices(*cells[i], vertices);
+        for (int j = 0; j < edge_count; ++j)
+        {
+          SizeType position = edge_positions[static_cast<std::size_t>(edges[j]->id().get())]++;
+          interface_area_entries[position] = ValueType(cell_handles[i], values[j]);
+          edge_box_volume_entries[position] = ValueType(cell_handles[i], values[edge_count + j]);
+        }
+        for (int j = 0; j < vertex_count; ++j)
+        {
+          SizeType position = vertex_positions[static_cast<std::size_t>(vertices[j]->id().get())]++;
+          vertex_box_volume_entries[position] = ValueType(cell_handles[i], values[2 * edge_count + j]);
+        }
+      }
+
+      contributions.interface_area.assign(edge_offsets, interface_area_entries);
+      contributions.edge_box_volume.assign(edge_offsets, edge_box_volume_entries);
+      contributions.vertex_box_volume.assign(vertex_offsets, vertex_box_volume_entries);
+
+      //
+      // Step 4: Totals are the row sums
+      //
+      std::vector<double> totals( 2 * edge_id_upper_bound + vertex_id_upper_bound );
+      long edge_rows = static_cast<long>(edge_id_upper_bound);
+      long vertex_rows = static_cast<long>(vertex_id_upper_bound);
+
+#ifdef VIENNAGRID_WITH_OPENMP
+      #pragma omp parallel for schedule(static)
+#endif
+      for (long i = 0; i < edge_rows; ++i)
+      {
+        std::size_t row = static_cast<std::size_t>(i);
+        totals[row] = contributions.interface_area.row_sum(row);
+        totals[edge_id_upper_bound + row] = contributions.edge_box_volume.row_sum(row);
+      }
+
+#ifdef VIENNAGRID_WITH_OPENMP
+      #pragma omp parallel for schedule(static)
+#endif
+      for (long i = 0; i < vertex_rows; ++i)
+      {
+        std::size_t row = static_cast<std::size_t>(i);
+        totals[2 * edge_id_upper_bound + row] = contributions.vertex_box_volume.row_sum(row);
+      }
+
+      voronoi_write_field<EdgeTag>(mesh_obj, totals, 0, interface_area_accessor);
+      voronoi_write_field<EdgeTag>(mesh_obj, totals, edge_id_upper_bound, edge_box_volume_accessor);
+      voronoi_write_field<vertex_tag>(mesh_obj, totals, 2 * edge_id_upper_bound, vertex_box_volume_accessor);
+    }
+
+
+    /** @brief For internal use only. Tells whether an edge is shared by two cells using the coboundary information of the mesh or segment. Cells in the sorted list 'excluded' are not counted. */
+    template <typename MeshT, typename CellTag>
+    class voronoi_coboundary_predicate
+    {
+    public:
+      typedef typename viennagrid::result_of::element<MeshT, CellTag>::type CellType;
+
+      voronoi_coboundary_predicate(MeshT const & mesh_obj, std::vector<CellType const *> const * excluded = NULL) : mesh_obj_(mesh_obj), excluded_(excluded) {}
+
+      template <typename EdgeT>
+      bool operator()(EdgeT const & edge) const
+      {
+        typedef typename viennagrid::result_of::const_coboundary_range<MeshT, EdgeT, CellTag>::type   CellOnEdgeRange;
+        typedef typename viennagrid::result_of::iterator<CellOnEdgeRange>::type                       CellOnEdgeIterator;
+
+        CellOnEdgeRange cells_on_edge = viennagrid::coboundary_elements<EdgeT, CellTag>(mesh_obj_, viennagrid::handle(mesh_obj_, edge));
+        if (!excluded_)
+          return cells_on_edge.size() > 1;
+
+        std::size_t count = 0;
+        for (CellOnEdgeIterator it = cells_on_edge.begin(); it != cells_on_edge.end(); ++it)
+          if ( !std::binary_search(excluded_->begin(), excluded_->end(), &*it) )
+            ++count;
+        return count > 1;
+      }
+
+    private:
+      MeshT const & mesh_obj_;
+      std::vector<CellType const *> const * excluded_;
+    };
+
+
+    /** @brief For internal use only. A predicate recording the edge it is asked for, which is the edge crossed by the circumcenter of a triangle. */
+    template <typename EdgeT>
+    class voronoi_crossed_edge_recorder
+    {
+    public:
+      voronoi_crossed_edge_recorder() : edge_(NULL) {}
+
+      bool operator()(EdgeT const & edge) const
+      {
+        edge_ = &edge;
+        return false;
+      }
+
+      EdgeT const * edge() const { return edge_; }
+
+    private:
+      mutable EdgeT const * edge_;
+    };
+
+
+    /** @brief For internal use only. Discards all Voronoi contributions. */
+    class voronoi_null_accumulator
+    {
+    public:
+      template <typename EdgeT>
+      void add_interface_area(EdgeT const &, double) {}
+
+      template <typename EdgeT>
+      void add_edge_box_volume(EdgeT const &, double) {}
+
+      template <typename VertexT>
+      void add_vertex_box_volume(VertexT const &, double) {}
+    };
+
+
+    /** @brief For internal use only. The contributions of cells other than triangles do not depend on their neighbors, hence no neighbors are affected. */
+    template <typename MeshT, typename CellT, typename CellTag>
+    void voronoi_affected_neighbors(MeshT const &, std::vector<CellT const *> const &, std::vector<CellT const *> &, CellTag) {}
+
+    /** @brief For internal use only. Collects the triangles not in the sorted list 'cells' whose circumcenter crosses an edge of these cells.
+      *
+      * The contributions of such a triangle depend on whether the crossed edge is shared, hence they change if the cells are added or removed.
+      */
+    template <typename MeshT, typename CellT>
+    void voronoi_affected_neighbors(MeshT const & mesh_obj, std::vector<CellT const *> const & cells, std::vector<CellT const *> & neighbors, viennagrid::triangle_tag)
+    {
+      typedef typename viennagrid::result_of::element<MeshT, line_tag>::type                            EdgeType;
+      typedef typename viennagrid::result_of::const_element_range<CellT, line_tag>::type                EdgeOnCellRange;
+      typedef typename viennagrid::result_of::iterator<EdgeOnCellRange>::type                           EdgeOnCellIterator;
+      typedef typename viennagrid::result_of::const_coboundary_range<MeshT, EdgeType, triangle_tag>::type CellOnEdgeRange;
+      typedef typename viennagrid::result_of::iterator<CellOnEdgeRange>::type                           CellOnEdgeIterator;
+
+      voronoi_null_accumulator null_accumulator;
+
+      for (std::size_t i = 0; i < cells.size(); ++i)
+      {
+        EdgeOnCellRange edges_on_cell(*cells[i]);
+        for (EdgeOnCellIterator eit = edges_on_cell.begin(); eit != edges_on_cell.end(); ++eit)
+        {
+          CellOnEdgeRange cells_on_edge = viennagrid::coboundary_elements<EdgeType, triangle_tag>(mesh_obj, eit.handle());
+          for (CellOnEdgeIterator cit = cells_on_edge.begin(); cit != cells_on_edge.end(); ++cit)
+          {
+            if ( std::binary_search(cells.begin(), cells.end(), &*cit) )
+              continue;
+
+            voronoi_crossed_edge_recorder<EdgeType> crossed_edge;
+            voronoi_cell_contributions(mesh_obj, *cit, crossed_edge, null_accumulator, triangle_tag());
+            if (crossed_edge.edge() == &*eit)
+              neighbors.push_back( &*cit );
+          }
+        }
+      }
+
+      std::sort(neighbors.begin(), neighbors.end());
+      neighbors.erase( std::unique(neighbors.begin(), neighbors.end()), neighbors.end() );
+    }
+
+
+    /** @brief For internal use only. Adds Voronoi contributions, multiplied by a factor, to the values of accessors. */
+    template <typename InterfaceAreaAccessorT, typename VertexBoxVolumeAccessorT, typename EdgeBoxVolumeAccessorT>
+    class voronoi_accessor_accumulator
+    {
+    public:
+      voronoi_accessor_accumulator(InterfaceAreaAccessorT interface_area_accessor,
+                                   VertexBoxVolumeAccessorT vertex_box_volume_accessor,
+                                   EdgeBoxVolumeAccessorT edge_box_volume_accessor,
+                                   double factor) :
+          interface_area_accessor_(interface_area_accessor),
+          vertex_box_volume_accessor_(vertex_box_volume_accessor),
+          edge_box_volume_accessor_(edge_box_volume_accessor),
+          factor_(factor) {}
+
+      template <typename EdgeT>
+      void add_interface_area(EdgeT const & edge, double value) { interface_area_accessor_(edge) += factor_ * value; }
+
+      template <typename EdgeT>
+      void add_edge_box_volume(EdgeT const & edge, double value) { edge_box_volume_accessor_(edge) += factor_ * value; }
+
+      template <typename VertexT>
+      void add_vertex_box_volume(VertexT const & vertex, double value) { vertex_box_volume_accessor_(vertex) += factor_ * value; }
+
+    private:
+      InterfaceAreaAccessorT   interface_area_accessor_;
+      VertexBoxVolumeAccessorT vertex_box_volume_accessor_;
+      EdgeBoxVolumeAccessorT   edge_box_volume_accessor_;
+      double factor_;
+    };
+
+
+    /** @brief For internal use only. Adds (factor > 0) or subtracts (factor < 0) the Voronoi contributions of the cells referenced by the handles in [cells_begin, cells_end) to or from interface areas and box volumes.
+      *
+      * The mesh has to contain the cells. The contributions of neighboring triangles whose circumcenter crosses an edge of the cells are updated as well,
+      * i.e. their contributions for the mesh with the cells are added (or subtracted) and their contributions for the mesh without the cells are subtracted (or added).
+      */
+    template <typename CellTag,
+              typename MeshT,
+              typename CellHandleIteratorT,
+              typename InterfaceAreaAccessorT,
+              typename VertexBoxVolumeAccessorT,
+              typename EdgeBoxVolumeAccessorT>
+    void update_voronoi_info(MeshT const & mesh_obj,
+                             CellHandleIteratorT cells_begin, CellHandleIteratorT cells_end,
+                             InterfaceAreaAccessorT   interface_area_accessor,
+                             VertexBoxVolumeAccessorT vertex_box_volume_accessor,
+                             EdgeBoxVolumeAccessorT   edge_box_volume_accessor,
+                             double factor)
+    {
+      typedef typename viennagrid::result_of::element<MeshT, CellTag>::type CellType;
+      typedef voronoi_accessor_accumulator<InterfaceAreaAccessorT, VertexBoxVolumeAccessorT, EdgeBoxVolumeAccessorT> AccumulatorType;
+
+      std::vector<CellType const *> cells;
+      for (CellHandleIteratorT it = cells_begin; it != cells_end; ++it)
+        cells.push_back( &viennagrid::dereference_handle(mesh_obj, *it) );
+      std::sort(cells.begin(), cells.end());
+      cells.erase( std::unique(cells.begin(), cells.end()), cells.end() );
+
+      std::vector<CellType const *> neighbors;
+      voronoi_affected_neighbors(mesh_obj, cells, neighbors, CellTag());
+
+      voronoi_coboundary_predicate<MeshT, CellTag> edge_is_shared(mesh_obj);
+      voronoi_coboundary_predicate<MeshT, CellTag> edge_is_shared_without_cells(mesh_obj, &cells);
+
+      // the current state of the mesh (with the cells) is weighted by 'factor', the state without the cells by '-factor'
+      AccumulatorType accumulator(interface_area_accessor, vertex_box_volume_accessor, edge_box_volume_accessor, factor);
+      AccumulatorType inverse_accumulator(interface_area_accessor, vertex_box_volume_accessor, edge_box_volume_accessor, -factor);
+
+      for (std::size_t i = 0; i < cells.size(); ++i)
+        voronoi_cell_contributions(mesh_obj, *cells[i], edge_is_shared, accumulator, CellTag());
+
+      for (std::size_t i = 0; i < neighbors.size(); ++i)
+      {
+        voronoi_cell_contributions(mesh_obj, *neighbors[i], edge_is_shared, accumulator, CellTag());
+        voronoi_cell_contributions(mesh_obj, *neighbors[i], edge_is_shared_without_cells, inverse_accumulator, CellTag());
+      }
+    }
+
   } //namespace detail
 
   //
@@ -933,5 +1993,136 @@ namespace viennagrid
                                ElementTag());
   }
 
+
+  /** @brief Writes interface areas and box volumes to the mesh or segment using the provided accessors, without per-cell contributions
+   *
+   * Computes the same quantities as the overload with contribution accessors, but accumulates into flat arrays indexed by element ID instead of filling per-element contribution lists.
+   * If VIENNAGRID_WITH_OPENMP is defined, the cells are processed in parallel. The values of all vertices and edges of the mesh or segment are overwritten.
+   * The results are bitwise reproducible only for a fixed number of threads, since the partial sums of the threads are rounded differently. Use the overload with CSR contributions for results independent of the number of threads.
+   * For tetrahedral meshes, the interface areas are computed from signed per-cell contributions, which agree with the overload with contribution accessors for Delaunay meshes.
+   *
+   * @tparam ElementTypeOrTagT                              The element/cell type/tag for which the voronoi information is calculated
+   * @param  mesh_obj                                       The mesh or segment
+   * @param  interface_area_accessor                        An accessor where the interface areas are stored
+   * @param  vertex_box_volume_accessor                     An accessor where the vertex box volumes are stored
+   * @param  edge_box_volume_accessor                       An accessor where the edge box volumes are stored
+   */
+  template <typename ElementTypeOrTagT,
+            typename MeshT,
+            typename InterfaceAreaAccessorT,
+            typename VertexBoxVolumeAccessorT,
+            typename EdgeBoxVolumeAccessorT>
+  void apply_voronoi(MeshT const & mesh_obj,
+                     InterfaceAreaAccessorT                     interface_area_accessor,
+                     VertexBoxVolumeAccessorT                   vertex_box_volume_accessor,
+                     EdgeBoxVolumeAccessorT                     edge_box_volume_accessor)
+  {
+    typedef typename viennagrid::result_of::element_tag<ElementTypeOrTagT>::type ElementTag;
+
+    detail::write_voronoi_info_flat<ElementTag>(mesh_obj,
+                                                interface_area_accessor,
+                                                vertex_box_volume_accessor,
+                                                edge_box_volume_accessor);
+  }
+
+  /** @brief Writes interface areas and box volumes to the mesh or segment using the provided accessors and the cell contributions in CSR layout to 'contributions'
+   *
+   * Each cell contributes exactly one entry to each of its vertices and edges, the rows are ordered by cell. The totals are the sums of the rows, thus independent of the number of threads.
+   *
+   * @tparam ElementTypeOrTagT                              The element/cell type/tag for which the voronoi information is calculated
+   * @param  mesh_obj                                       The mesh or segment
+   * @param  interface_area_accessor                        An accessor where the interface areas are stored
+   * @param  vertex_box_volume_accessor                     An accessor where the vertex box volumes are stored
+   * @param  edge_box_volume_accessor                       An accessor where the edge box volumes are stored
+   * @param  contributions                                  The cell contributions of all three quantities
+   */
+  template <typename ElementTypeOrTagT,
+            typename MeshT,
+            typename InterfaceAreaAccessorT,
+            typename VertexBoxVolumeAccessorT,
+            typename EdgeBoxVolumeAccessorT,
+            typename ConstCellHandleT>
+  void apply_voronoi(MeshT const & mesh_obj,
+                     InterfaceAreaAccessorT                     interface_area_accessor,
+                     VertexBoxVolumeAccessorT                   vertex_box_volume_accessor,
+                     EdgeBoxVolumeAccessorT                     edge_box_volume_accessor,
+                     voronoi_contributions<ConstCellHandleT> &  contributions)
+  {
+    typedef typename viennagrid::result_of::element_tag<ElementTypeOrTagT>::type ElementTag;
+
+    detail::write_voronoi_info_csr<ElementTag>(mesh_obj,
+                                               interface_area_accessor,
+                                               vertex_box_volume_accessor,
+                                               edge_box_volume_accessor,
+                                               contributions);
+  }
+
+
+  /** @brief Subtracts the Voronoi contributions of the given cells from interface areas and box volumes computed by the overloads of apply_voronoi() without contribution accessors.
+   *
+   * Call before the cells are erased from the mesh and add_voronoi_contributions() for the new cells afterwards. Both functions can also be used on their own, e.g. for erasing cells without replacement.
+   * Only the vertices and edges of the given cells are touched. For triangular meshes, the contributions of a triangle with its circumcenter outside depend on whether the edge crossed by the circumcenter is shared with another triangle,
+   * hence neighboring triangles whose circumcenter crosses an edge of the given cells are found using the coboundary information and updated as well.
+   *
+   * @tparam ElementTypeOrTagT                              The element/cell type/tag for which the voronoi information is calculated
+   * @param  mesh_obj                                       The mesh or segment
+   * @param  cells_begin                                    Iterator to the first handle of the cells to be removed
+   * @param  cells_end                                      Iterator past the last handle of the cells to be removed
+   * @param  interface_area_accessor                        An accessor where the interface areas are stored
+   * @param  vertex_box_volume_accessor                     An accessor where the vertex box volumes are stored
+   * @param  edge_box_volume_accessor                       An accessor where the edge box volumes are stored
+   */
+  template <typename ElementTypeOrTagT,
+            typename MeshT,
+            typename CellHandleIteratorT,
+            typename InterfaceAreaAccessorT,
+            typename VertexBoxVolumeAccessorT,
+            typename EdgeBoxVolumeAccessorT>
+  void subtract_voronoi_contributions(MeshT const & mesh_obj,
+                                      CellHandleIteratorT cells_begin, CellHandleIteratorT cells_end,
+                                      InterfaceAreaAccessorT                     interface_area_accessor,
+                                      VertexBoxVolumeAccessorT                   vertex_box_volume_accessor,
+                                      EdgeBoxVolumeAccessorT                     edge_box_volume_accessor)
+  {
+    typedef typename viennagrid::result_of::element_tag<ElementTypeOrTagT>::type ElementTag;
+
+    detail::update_voronoi_info<ElementTag>(mesh_obj, cells_begin, cells_end,
+                                            interface_area_accessor,
+                                            vertex_box_volume_accessor,
+                                            edge_box_volume_accessor,
+                                            -1.0);
+  }
+
+  /** @brief Adds the Voronoi contributions of the given cells to interface areas and box volumes computed by the overloads of apply_voronoi() without contribution accessors, see subtract_voronoi_contributions()
+   *
+   * @tparam ElementTypeOrTagT                              The element/cell type/tag for which the voronoi information is calculated
+   * @param  mesh_obj                                       The mesh or segment
+   * @param  cells_begin                                    Iterator to the first handle of the added cells
+   * @param  cells_end                                      Iterator past the last handle of the added cells
+   * @param  interface_area_accessor                        An accessor where the interface areas are stored
+   * @param  vertex_box_volume_accessor                     An accessor where the vertex box volumes are stored
+   * @param  edge_box_volume_accessor                       An accessor where the edge box volumes are stored
+   */
+  template <typename ElementTypeOrTagT,
+            typename MeshT,
+            typename CellHandleIteratorT,
+            typename InterfaceAreaAccessorT,
+            typename VertexBoxVolumeAccessorT,
+            typename EdgeBoxVolumeAccessorT>
+  void add_voronoi_contributions(MeshT const & mesh_obj,
+                                 CellHandleIteratorT cells_begin, CellHandleIteratorT cells_end,
+                                 InterfaceAreaAccessorT                     interface_area_accessor,
+                                 VertexBoxVolumeAccessorT                   vertex_box_volume_accessor,
+                                 EdgeBoxVolumeAccessorT                     edge_box_volume_accessor)
+  {
+    typedef typename viennagrid::result_of::element_tag<ElementTypeOrTagT>::type ElementTag;
+
+    detail::update_voronoi_info<ElementTag>(mesh_obj, cells_begin, cells_end,
+                                            interface_area_accessor,
+                                            vertex_box_volume_accessor,
+                                            edge_box_volume_accessor,
+                                            1.0);
+  }
+
 } //namespace viennagrid
 #endif
@@ -489,4 +489,8 @@ namespace viennagrid
 }
 
 
+#ifdef VIENNAGRID_WITH_PRECOMPILED_INSTANCES
+  #include "viennagrid/config/default_instances.hpp"
+#endif
+
 #endif
@@ -0,0 +1,19 @@
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+/** @file viennagrid/config/default_instances.cpp
+    @brief Source of the library viennagrid_instances: explicit instantiations for the default configurations, see default_instances.hpp
+*/
+
+#include "viennagrid/config/default_instances.hpp"
+
+VIENNAGRID_ALL_DEFAULT_INSTANCES(template)
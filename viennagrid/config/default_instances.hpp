@@ -0,0 +1,59 @@
+#ifndef VIENNAGRID_CONFIG_DEFAULT_INSTANCES_HPP
+#define VIENNAGRID_CONFIG_DEFAULT_INSTANCES_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include "viennagrid/config/default_configs.hpp"
+#include "viennagrid/algorithm/volume.hpp"
+#include "viennagrid/algorithm/surface.hpp"
+#include "viennagrid/algorithm/boundary.hpp"
+#include "viennagrid/algorithm/extract_boundary.hpp"
+
+/** @file viennagrid/config/default_instances.hpp
+    @brief Explicit instantiations of the mesh and segmentation classes and of common algorithms for the default configurations triangular_2d, tetrahedral_3d and hexahedral_3d.
+
+    The instantiations are compiled once into the library viennagrid_instances (CMake option ENABLE_PRECOMPILED_INSTANCES).
+    If VIENNAGRID_WITH_PRECOMPILED_INSTANCES is defined, this file is included by default_configs.hpp and declares the instantiations as extern,
+    thus translation units using the default configurations do not instantiate them again but have to be linked against viennagrid_instances.
+    Extern template declarations require C++11, for older standards the instantiations are only declared for the library itself.
+*/
+
+
+/** @brief For internal use only: Instantiates (INSTANTIATION = template) or declares (INSTANTIATION = extern template) the mesh classes, segmentation classes and algorithms for a mesh type */
+#define VIENNAGRID_DEFAULT_INSTANCES(INSTANTIATION, MeshT, SegmentationT, HullMeshT) \
+  INSTANTIATION class viennagrid::mesh< MeshT::wrapped_config_type >; \
+  INSTANTIATION class viennagrid::segmentation< SegmentationT::wrapped_config_type >; \
+  INSTANTIATION class viennagrid::mesh< SegmentationT::view_type::wrapped_config_type >; \
+  INSTANTIATION class viennagrid::segment_handle< SegmentationT >; \
+  \
+  INSTANTIATION viennagrid::result_of::coord<MeshT>::type viennagrid::volume(MeshT const &); \
+  INSTANTIATION viennagrid::result_of::coord<MeshT>::type viennagrid::volume(SegmentationT::segment_handle_type const &); \
+  INSTANTIATION viennagrid::result_of::coord<MeshT>::type viennagrid::surface(MeshT const &); \
+  INSTANTIATION viennagrid::result_of::coord<MeshT>::type viennagrid::surface(SegmentationT::segment_handle_type const &); \
+  INSTANTIATION void viennagrid::prepare_boundary(MeshT const &); \
+  INSTANTIATION bool viennagrid::is_boundary(MeshT const &, viennagrid::result_of::vertex<MeshT>::type const &); \
+  INSTANTIATION bool viennagrid::is_boundary(MeshT const &, viennagrid::result_of::facet<MeshT>::type const &); \
+  INSTANTIATION void viennagrid::extract_boundary(MeshT const &, HullMeshT &);
+
+/** @brief For internal use only: Applies VIENNAGRID_DEFAULT_INSTANCES to all precompiled default configurations */
+#define VIENNAGRID_ALL_DEFAULT_INSTANCES(INSTANTIATION) \
+  VIENNAGRID_DEFAULT_INSTANCES(INSTANTIATION, viennagrid::triangular_2d_mesh,  viennagrid::triangular_2d_segmentation,  viennagrid::line_2d_mesh) \
+  VIENNAGRID_DEFAULT_INSTANCES(INSTANTIATION, viennagrid::tetrahedral_3d_mesh, viennagrid::tetrahedral_3d_segmentation, viennagrid::triangular_3d_mesh) \
+  VIENNAGRID_DEFAULT_INSTANCES(INSTANTIATION, viennagrid::hexahedral_3d_mesh,  viennagrid::hexahedral_3d_segmentation,  viennagrid::quadrilateral_3d_mesh)
+
+
+#if defined(VIENNAGRID_WITH_PRECOMPILED_INSTANCES) && __cplusplus >= 201103L
+VIENNAGRID_ALL_DEFAULT_INSTANCES(extern template)
+#endif
+
+#endif
@@ -131,6 +131,11 @@ namespace viennagrid
             viennagrid::detail::EQUAL<
                 typename query<WrappedConfigT, viennagrid::no_handling_tag, HostElementTagT, element_boundary_storage_layout_tag, BoundaryElementTagT>::type,
                 viennagrid::full_lazy_handling_tag
+            >::value
+                ||
+            viennagrid::detail::EQUAL<
+                typename query<WrappedConfigT, viennagrid::no_handling_tag, HostElementTagT, element_boundary_storage_layout_tag, BoundaryElementTagT>::type,
+                viennagrid::compact_orientation_handling_tag
             >::value;
       };
 
@@ -201,7 +206,16 @@ namespace viennagrid
 
 
         typedef typename viennagrid::result_of::container<permutator_type, orientation_container_tag>::type orientation_container_type;
-        typedef viennagrid::element_orientation<orientation_container_type> facet_orientation_type;
+
+        typedef typename
+            viennagrid::detail::IF<
+                viennagrid::detail::EQUAL<
+                    typename query<WrappedConfigT, viennagrid::no_handling_tag, HostElementTagT, element_boundary_storage_layout_tag, BoundaryElementTagT>::type,
+                    viennagrid::compact_orientation_handling_tag
+                >::value,
+                viennagrid::compact_element_orientation<BoundaryElementTagT>,
+                viennagrid::element_orientation<orientation_container_type>
+            >::type facet_orientation_type;
 
         typedef typename
             viennagrid::detail::IF<
@@ -21,6 +21,7 @@
 
 #include "viennagrid/topology/simplex.hpp"
 #include "viennagrid/storage/hidden_key_map.hpp"
+#include "viennagrid/storage/pool_allocator.hpp"
 #include "viennagrid/element/element_key.hpp"
 #include "viennagrid/config/element_config.hpp"
 
@@ -38,21 +39,21 @@ namespace viennagrid
       // Meta Functions for creating a default config
       //
 
-      /** @brief Defines the default storage layout for elements: full handling tag is default except for vertex, which don't have orientation. */
-      template<typename ElementTagT, typename boundary_cell_tag>
+      /** @brief Defines the default storage layout for elements: full handling tag is default except for vertex, which don't have orientation. Use compact_orientation_handling_tag as BoundaryHandlingTagT for storing orientations as permutation indices. */
+      template<typename ElementTagT, typename boundary_cell_tag, typename BoundaryHandlingTagT = viennagrid::full_handling_tag>
       struct storage_layout_config
       {
         typedef typename viennagrid::detail::result_of::insert<
-            typename storage_layout_config<ElementTagT, typename boundary_cell_tag::facet_tag>::type,
+            typename storage_layout_config<ElementTagT, typename boundary_cell_tag::facet_tag, BoundaryHandlingTagT>::type,
             viennagrid::static_pair<
                 boundary_cell_tag,
-                viennagrid::full_handling_tag
+                BoundaryHandlingTagT
             >
         >::type type;
       };
 
-      template<typename ElementTagT>
-      struct storage_layout_config<ElementTagT, viennagrid::vertex_tag>
+      template<typename ElementTagT, typename BoundaryHandlingTagT>
+      struct storage_layout_config<ElementTagT, viennagrid::vertex_tag, BoundaryHandlingTagT>
       {
         typedef typename viennagrid::make_typemap<
             viennagrid::vertex_tag,
@@ -60,18 +61,18 @@ namespace viennagrid
         >::type type;
       };
 
-      template<typename ElementTagT>
-      struct storage_layout_config<ElementTagT, viennagrid::null_type>
+      template<typename ElementTagT, typename BoundaryHandlingTagT>
+      struct storage_layout_config<ElementTagT, viennagrid::null_type, BoundaryHandlingTagT>
       {
         typedef viennagrid::null_type type;
       };
 
 
-      /** @brief Defines the default container tag for all elements in a domain. For vertices and cells specific given containers are used, for all others, hidden key maps are used to ensure the uniqueness of elements (taking orientation into account) */
+      /** @brief Defines the default container tag for all elements in a domain. For vertices and cells specific given containers are used, for all others, hidden key maps are used to ensure the uniqueness of elements (taking orientation into account). If the cell container is pool allocated, the hidden key maps are pool allocated as well. */
       template<typename ElementTagT, typename boundary_cell_tag, typename VertexContainerT, typename CellContainerT>
       struct default_container_tag
       {
-        typedef viennagrid::hidden_key_map_tag< viennagrid::element_key_tag > type;
+        typedef typename viennagrid::result_of::allocation_alike< CellContainerT, viennagrid::hidden_key_map_tag< viennagrid::element_key_tag > >::type type;
       };
 
       template<typename ElementTagT, typename VertexContainerT, typename CellContainerT>
@@ -94,14 +95,16 @@ namespace viennagrid
 
 
       /** @brief Creates the complete configuration for one element. ID tag is smart_id_tag<int>, element_container_tag is defined based default_container_tag meta function, boundary_storage_layout is defined based on storage_layout_config, no appendix type. For vertex no boundary storage layout is defined. */
-      template<typename CellTagT, typename ElementTagT, typename HandleTagT, typename VertexContainerT, typename CellContainerT>
+      template<typename CellTagT, typename ElementTagT, typename HandleTagT, typename VertexContainerT, typename CellContainerT,
+               typename BoundaryHandlingTagT = viennagrid::full_handling_tag>
       struct full_element_config
       {
         typedef typename viennagrid::result_of::handled_container<typename default_container_tag<CellTagT, ElementTagT, VertexContainerT, CellContainerT>::type,
                                                                             HandleTagT>::tag                     container_tag;
 
         typedef typename storage_layout_config<CellTagT,
-                                                typename ElementTagT::facet_tag>::type   boundary_storage_layout;
+                                                typename ElementTagT::facet_tag,
+                                                BoundaryHandlingTagT>::type   boundary_storage_layout;
 
         typedef typename viennagrid::make_typemap<
             viennagrid::config::element_id_tag,
@@ -118,8 +121,8 @@ namespace viennagrid
         >::type type;
       };
 
-      template<typename CellTagT, typename HandleTagT, typename VertexContainerT, typename CellContainerT>
-      struct full_element_config<CellTagT, viennagrid::vertex_tag, HandleTagT, VertexContainerT, CellContainerT>
+      template<typename CellTagT, typename HandleTagT, typename VertexContainerT, typename CellContainerT, typename BoundaryHandlingTagT>
+      struct full_element_config<CellTagT, viennagrid::vertex_tag, HandleTagT, VertexContainerT, CellContainerT, BoundaryHandlingTagT>
       {
         typedef typename viennagrid::result_of::handled_container<typename default_container_tag<CellTagT, viennagrid::vertex_tag, VertexContainerT, CellContainerT>::type,
                                                                             HandleTagT>::tag                     container_tag;
@@ -141,24 +144,25 @@ namespace viennagrid
 
 
       /** @brief Helper meta function for creating topologic configuration using full_element_config for each element. Terminates at vertex level. */
-      template<typename CellTagT, typename ElementTagT, typename HandleTagT, typename VertexContainerTagT, typename CellContainerTagT>
+      template<typename CellTagT, typename ElementTagT, typename HandleTagT, typename VertexContainerTagT, typename CellContainerTagT,
+               typename BoundaryHandlingTagT = viennagrid::full_handling_tag>
       struct full_topology_config_helper
       {
         typedef typename viennagrid::detail::result_of::insert<
-            typename full_topology_config_helper<CellTagT, typename ElementTagT::facet_tag, HandleTagT, VertexContainerTagT, CellContainerTagT>::type,
+            typename full_topology_config_helper<CellTagT, typename ElementTagT::facet_tag, HandleTagT, VertexContainerTagT, CellContainerTagT, BoundaryHandlingTagT>::type,
             viennagrid::static_pair<
                 ElementTagT,
-                typename full_element_config<CellTagT, ElementTagT, HandleTagT, VertexContainerTagT, CellContainerTagT>::type
+                typename full_element_config<CellTagT, ElementTagT, HandleTagT, VertexContainerTagT, CellContainerTagT, BoundaryHandlingTagT>::type
             >
         >::type type;
       };
 
-      template<typename CellTagT, typename HandleTagT, typename VertexContainerTagT, typename CellContainerTagT>
-      struct full_topology_config_helper<CellTagT, viennagrid::vertex_tag, HandleTagT, VertexContainerTagT, CellContainerTagT>
+      template<typename CellTagT, typename HandleTagT, typename VertexContainerTagT, typename CellContainerTagT, typename BoundaryHandlingTagT>
+      struct full_topology_config_helper<CellTagT, viennagrid::vertex_tag, HandleTagT, VertexContainerTagT, CellContainerTagT, BoundaryHandlingTagT>
       {
         typedef typename viennagrid::make_typemap<
             viennagrid::vertex_tag,
-            typename full_element_config<CellTagT, viennagrid::vertex_tag, HandleTagT, VertexContainerTagT, CellContainerTagT>::type
+            typename full_element_config<CellTagT, viennagrid::vertex_tag, HandleTagT, VertexContainerTagT, CellContainerTagT, BoundaryHandlingTagT>::type
         >::type type;
       };
 
@@ -168,14 +172,16 @@ namespace viennagrid
        *  @tparam HandleTagT            Defines, which handle type should be used for all elements. Default is pointer handle
        *  @tparam VertexContainerTagT   Defines, which container type should be used for vertices. Default is std::deque
        *  @tparam CellContainerTagT     Defines, which container type should be used for cells. Default is std::deque
+       *  @tparam BoundaryHandlingTagT  Defines, how boundary elements are stored. Default is full_handling_tag, compact_orientation_handling_tag stores each orientation as a single permutation index
        */
       template<typename CellTagT,
                typename HandleTagT  = viennagrid::pointer_handle_tag,
                typename VertexContainerTagT = viennagrid::std_deque_tag,
-               typename CellContainerTagT = viennagrid::std_deque_tag>
+               typename CellContainerTagT = viennagrid::std_deque_tag,
+               typename BoundaryHandlingTagT = viennagrid::full_handling_tag>
       struct full_topology_config
       {
-        typedef typename full_topology_config_helper<CellTagT, CellTagT, HandleTagT, VertexContainerTagT, CellContainerTagT>::type type;
+        typedef typename full_topology_config_helper<CellTagT, CellTagT, HandleTagT, VertexContainerTagT, CellContainerTagT, BoundaryHandlingTagT>::type type;
       };
 
 
@@ -236,15 +242,17 @@ namespace viennagrid
        *  @tparam HandleTagT            Defines, which handle type should be used for all elements. Default is pointer handle
        *  @tparam VertexContainerTagT   Defines, which container type should be used for vertices. Default is std::deque
        *  @tparam CellContainerTagT     Defines, which container type should be used for cells. Default is std::deque
+       *  @tparam BoundaryHandlingTagT  Defines, how boundary elements are stored. Default is full_handling_tag, compact_orientation_handling_tag stores each orientation as a single permutation index
        */
       template<typename CellTagT,
                 typename PointType,
                 typename HandleTagT = viennagrid::pointer_handle_tag,
                 typename VertexContainerTagT = viennagrid::std_deque_tag,
-                typename CellContainerTagT = viennagrid::std_deque_tag>
+                typename CellContainerTagT = viennagrid::std_deque_tag,
+                typename BoundaryHandlingTagT = viennagrid::full_handling_tag>
       struct full_mesh_config
       {
-        typedef typename full_topology_config<CellTagT, HandleTagT, VertexContainerTagT, CellContainerTagT>::type MeshConfig;
+        typedef typename full_topology_config<CellTagT, HandleTagT, VertexContainerTagT, CellContainerTagT, BoundaryHandlingTagT>::type MeshConfig;
         typedef typename query<MeshConfig, null_type, vertex_tag>::type VertexConfig;
 
         typedef typename viennagrid::detail::result_of::insert_or_modify<
@@ -264,10 +272,10 @@ namespace viennagrid
         >::type type;
       };
 
-      template<typename CellTagT, typename HandleTagT, typename VertexContainerTagT, typename CellContainerTagT>
-      struct full_mesh_config<CellTagT, void, HandleTagT, VertexContainerTagT, CellContainerTagT>
+      template<typename CellTagT, typename HandleTagT, typename VertexContainerTagT, typename CellContainerTagT, typename BoundaryHandlingTagT>
+      struct full_mesh_config<CellTagT, void, HandleTagT, VertexContainerTagT, CellContainerTagT, BoundaryHandlingTagT>
       {
-        typedef typename viennagrid::config::result_of::full_topology_config<CellTagT, HandleTagT, VertexContainerTagT, CellContainerTagT>::type type;
+        typedef typename viennagrid::config::result_of::full_topology_config<CellTagT, HandleTagT, VertexContainerTagT, CellContainerTagT, BoundaryHandlingTagT>::type type;
       };
 
 
@@ -127,6 +127,7 @@ namespace viennagrid
           typedef typename result_of::iterator<VertexOnElementRange>::type                   VertexOnElementIterator;
 
           long i=0; dim_type j=0;
+          dim_type permutation[boundary_elements<bnd_cell_tag, vertex_tag>::num];
 
           //set orientation:
           VertexOnElementRange vertices_on_element = elements<vertex_tag>( elements_[pos] );
@@ -141,12 +142,13 @@ namespace viennagrid
             {
               if (voeit.handle() == voeit2.handle())
               {
-                orientations_[pos].setPermutation(j,static_cast<dim_type>(i));
+                permutation[j] = static_cast<dim_type>(i);
                 break;
               }
             }
             j=0;
           }
+          orientations_[pos].setPermutation(permutation);
         }
     }
 
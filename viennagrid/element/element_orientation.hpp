@@ -16,6 +16,8 @@
 
 #include <vector>
 #include <iostream>
+#include <cassert>
+#include <stdexcept>
 
 #include "viennagrid/forwards.hpp"
 
@@ -83,6 +85,14 @@ namespace viennagrid
 
       void setPermutation(size_type index, size_type mappedTo) { (*this)[index] = static_cast<permutator_type>(mappedTo); }
 
+      /** @brief Sets the whole permutation, 'permutation' holds the mapped indices of all vertices */
+      template<typename IndexT>
+      void setPermutation(IndexT const * permutation)
+      {
+        for (size_type index = 0; index < container_type::size(); ++index)
+          (*this)[index] = static_cast<permutator_type>(permutation[index]);
+      }
+
       void print() const
       {
         unsigned int index = 0;
@@ -92,6 +102,120 @@ namespace viennagrid
       }
     };
 
+
+
+  namespace detail
+  {
+    /** @brief For internal use only. The table of all vertex permutations of a reference element which map the element onto itself. The identity is the first entry. */
+    template<typename ElementTagT>
+    struct orientation_permutations;
+
+    template<>
+    struct orientation_permutations<line_tag>
+    {
+      static const int num = 2;
+      static const int num_vertices = 2;
+
+      static unsigned char value(int permutation, int index)
+      {
+        static const unsigned char table[num][num_vertices] = { {0,1}, {1,0} };
+        return table[permutation][index];
+      }
+    };
+
+    template<>
+    struct orientation_permutations<triangle_tag>
+    {
+      static const int num = 6;
+      static const int num_vertices = 3;
+
+      static unsigned char value(int permutation, int index)
+      {
+        static const unsigned char table[num][num_vertices] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+        return table[permutation][index];
+      }
+    };
+
+    /** @brief The reference quadrilateral has the vertices 0,1,2,3 with edges 0-1, 0-2, 1-3, 2-3, its symmetries are the eight rotations and reflections */
+    template<>
+    struct orientation_permutations<quadrilateral_tag>
+    {
+      static const int num = 8;
+      static const int num_vertices = 4;
+
+      static unsigned char value(int permutation, int index)
+      {
+        static const unsigned char table[num][num_vertices] = { {0,1,2,3}, {0,2,1,3}, {1,0,3,2}, {1,3,0,2},
+                                                                {2,0,3,1}, {2,3,0,1}, {3,1,2,0}, {3,2,1,0} };
+        return table[permutation][index];
+      }
+    };
+  }
+
+
+  /** @brief An orienter for a boundary k-cell storing the permutation from global to local ordering as a single index into the table of valid permutations of the reference element
+   *
+   * Provides the same interface as element_orientation, but uses one byte per boundary element.
+   *
+   * @tparam ElementTagT    The tag of the boundary element, e.g. triangle_tag
+   */
+  template<typename ElementTagT>
+  class compact_element_orientation
+  {
+    typedef detail::orientation_permutations<ElementTagT>   permutations_type;
+
+  public:
+    typedef std::size_t size_type;
+
+    compact_element_orientation() : permutation_(0) {}
+
+    void setDefaultOrientation() { permutation_ = 0; }
+
+    size_type operator()(size_type in) const { return static_cast<size_type>( permutations_type::value(permutation_, static_cast<int>(in)) ); }
+
+    /** @brief Sets the whole permutation, 'permutation' holds the mapped indices of all vertices. Throws std::runtime_error if the permutation is not a symmetry of the reference element, e.g. for a boundary element with a vertex ordering not matching the reference element. */
+    template<typename IndexT>
+    void setPermutation(IndexT const * permutation)
+    {
+      for (int i = 0; i < permutations_type::num; ++i)
+      {
+        int j = 0;
+        while (j < permutations_type::num_vertices && static_cast<IndexT>(permutations_type::value(i, j)) == permutation[j])
+          ++j;
+
+        if (j == permutations_type::num_vertices)
+        {
+          permutation_ = static_cast<unsigned char>(i);
+          return;
+        }
+      }
+      throw std::runtime_error("Permutation is not a symmetry of the reference element!");
+    }
+
+    /** @brief Returns the index of the permutation in the table of permutations of the reference element */
+    size_type index() const { return permutation_; }
+
+    size_type size() const { return static_cast<size_type>(permutations_type::num_vertices); }
+
+    void print() const
+    {
+      for (size_type index = 0; index < size(); ++index)
+        std::cout << index << "->" << (*this)(index) << ",";
+      std::cout << std::endl;
+    }
+
+  private:
+    unsigned char permutation_;
+  };
+
+  template<typename ElementTagT>
+  std::ostream & operator<<(std::ostream & os, compact_element_orientation<ElementTagT> const & orientation)
+  {
+    for (std::size_t index = 0; index < orientation.size(); ++index)
+      os << orientation(index) << " ";
+    return os;
+  }
+
 }
 
 
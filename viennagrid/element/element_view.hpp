@@ -63,7 +63,7 @@ namespace viennagrid
   }
 
 
-  /** @brief Returns a view object derived from the respective mesh or segment. Whenever the provided filter functor evaluates to true for an element, it is added to the view. Non-const version. */
+  /** @brief Returns a view object derived from the respective mesh or segment. Whenever the provided filter functor evaluates to true for an element, it is added to the view. Non-const version. For selections of many elements with frequent membership tests see viennagrid::make_selection() in viennagrid/mesh/selection.hpp. */
   template<typename element_type_or_tag, typename something, typename functor>
   typename result_of::element_view<something, element_type_or_tag>::type
   element_view( something & s, functor f )
@@ -121,6 +121,8 @@ namespace viennagrid
 
   /** @brief A tag denoting that the boundary elements should stored without orientation */
   struct no_orientation_handling_tag {};
+  /** @brief A tag denoting full storage of boundary elements, where each orientation is stored as a single index into the table of permutations of the reference element */
+  struct compact_orientation_handling_tag {};
 
 //   Lazy storage reserved for future use
   /** @brief A tag denoting that orientation should be stored/computed only on request ('lazy'). */
@@ -0,0 +1,200 @@
+#ifndef VIENNAGRID_INSTRUMENTATION_HPP
+#define VIENNAGRID_INSTRUMENTATION_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+/** @file viennagrid/instrumentation.hpp
+    @brief Opt-in counters and scoped timers for the hot paths of ViennaGrid (cache builds, key map lookups, view inserts, handle dereferences, IO phases)
+
+    The instrumentation is compiled in only if VIENNAGRID_WITH_INSTRUMENTATION is defined, otherwise the macros VIENNAGRID_INSTRUMENT_COUNT()
+    and VIENNAGRID_INSTRUMENT_SCOPE() expand to nothing. Each probe is identified by its name, probes with the same name share their counts.
+    A report of all probes is written to std::cerr at program exit (see report_at_exit()) or on demand using report().
+    If VIENNAGRID_WITH_OPENMP is defined, counting is thread-safe.
+*/
+
+#ifdef VIENNAGRID_WITH_INSTRUMENTATION
+
+#include <map>
+#include <string>
+#include <iostream>
+#include <iomanip>
+
+#ifdef VIENNAGRID_WITH_OPENMP
+  #include <omp.h>
+#elif defined(_WIN32)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <sys/time.h>
+#endif
+
+namespace viennagrid
+{
+  namespace instrumentation
+  {
+    /** @brief A probe: the number of times it was hit and, for timers, the accumulated wall clock time in seconds */
+    struct probe
+    {
+      probe() : count(0), seconds(0.0) {}
+
+      unsigned long count;
+      double seconds;
+    };
+
+    namespace detail
+    {
+      /** @brief For internal use only. Returns the wall clock time in seconds */
+      inline double wall_time()
+      {
+#ifdef VIENNAGRID_WITH_OPENMP
+        return omp_get_wtime();
+#elif defined(_WIN32)
+        LARGE_INTEGER frequency;
+        LARGE_INTEGER now;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&now);
+        return static_cast<double>(now.QuadPart) / static_cast<double>(frequency.QuadPart);
+#else
+        struct timeval tval;
+        gettimeofday(&tval, NULL);
+        return static_cast<double>(tval.tv_sec) + 1e-6 * static_cast<double>(tval.tv_usec);
+#endif
+      }
+
+      /** @brief For internal use only. Holds all probes by name, writes the report on destruction if enabled */
+      class registry
+      {
+      public:
+        typedef std::map<std::string, probe> probe_map_type;
+
+        registry() : report_at_exit(true) {}
+        ~registry()
+        {
+          if (report_at_exit)
+            write_report(std::cerr);
+        }
+
+        void write_report(std::ostream & stream) const
+        {
+          stream << "ViennaGrid instrumentation report" << std::endl;
+          stream << std::setw(48) << std::left << "probe" << std::setw(14) << std::right << "count" << std::setw(14) << "seconds" << std::endl;
+          for (probe_map_type::const_iterator it = probes.begin(); it != probes.end(); ++it)
+          {
+            stream << std::setw(48) << std::left << it->first << std::setw(14) << std::right << it->second.count;
+            if (it->second.seconds > 0.0)
+              stream << std::setw(14) << it->second.seconds;
+            stream << std::endl;
+          }
+        }
+
+        probe_map_type probes;
+        bool report_at_exit;
+      };
+
+      /** @brief For internal use only. Returns the process-wide registry, which is created on first use */
+      inline registry & get_registry()
+      {
+        static registry registry_;
+        return registry_;
+      }
+    }
+
+
+    /** @brief Returns the probe with the given name, the probe is created if it does not exist. References to probes stay valid until program exit. */
+    inline probe & get_probe(std::string const & name)
+    {
+      probe * result;
+#ifdef VIENNAGRID_WITH_OPENMP
+      #pragma omp critical (viennagrid_instrumentation_registry)
+#endif
+      result = &detail::get_registry().probes[name];
+      return *result;
+    }
+
+    /** @brief Counts a hit of a probe */
+    inline void count(probe & p)
+    {
+#ifdef VIENNAGRID_WITH_OPENMP
+      #pragma omp atomic
+#endif
+      ++p.count;
+    }
+
+    /** @brief Counts a hit of a probe and adds the time spent */
+    inline void add_time(probe & p, double seconds)
+    {
+      count(p);
+#ifdef VIENNAGRID_WITH_OPENMP
+      #pragma omp atomic
+#endif
+      p.seconds += seconds;
+    }
+
+
+    /** @brief Measures the wall clock time of its lifetime and adds it to a probe on destruction */
+    class scoped_timer
+    {
+    public:
+      explicit scoped_timer(probe & p) : probe_(p), start_(detail::wall_time()) {}
+      ~scoped_timer() { add_time(probe_, detail::wall_time() - start_); }
+
+    private:
+      scoped_timer(scoped_timer const &);
+      scoped_timer & operator=(scoped_timer const &);
+
+      probe & probe_;
+      double start_;
+    };
+
+
+    /** @brief Writes the counts and times of all probes, sorted by name */
+    inline void report(std::ostream & stream = std::cerr) { detail::get_registry().write_report(stream); }
+
+    /** @brief Resets the counts and times of all probes */
+    inline void reset()
+    {
+      detail::registry::probe_map_type & probes = detail::get_registry().probes;
+      for (detail::registry::probe_map_type::iterator it = probes.begin(); it != probes.end(); ++it)
+        it->second = probe();
+    }
+
+    /** @brief Enables or disables the report to std::cerr at program exit, enabled by default */
+    inline void report_at_exit(bool enabled) { detail::get_registry().report_at_exit = enabled; }
+  }
+}
+
+/** @brief Counts a hit of the probe NAME (a string literal) */
+#define VIENNAGRID_INSTRUMENT_COUNT(NAME) \
+  do { \
+    static viennagrid::instrumentation::probe & viennagrid_instrumentation_probe = viennagrid::instrumentation::get_probe(NAME); \
+    viennagrid::instrumentation::count(viennagrid_instrumentation_probe); \
+  } while (false)
+
+/** @brief Counts a hit of the probe NAME (a string literal) and adds the time until the end of the enclosing scope. At most one per scope. */
+#define VIENNAGRID_INSTRUMENT_SCOPE(NAME) \
+  static viennagrid::instrumentation::probe & viennagrid_instrumentation_scope_probe = viennagrid::instrumentation::get_probe(NAME); \
+  viennagrid::instrumentation::scoped_timer viennagrid_instrumentation_scope_timer(viennagrid_instrumentation_scope_probe)
+
+#else
+
+#define VIENNAGRID_INSTRUMENT_COUNT(NAME) ((void)0)
+#define VIENNAGRID_INSTRUMENT_SCOPE(NAME) ((void)0)
+
+#endif
+
+#endif
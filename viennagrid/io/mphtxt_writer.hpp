@@ -16,6 +16,7 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <vector>
 
 #include "viennagrid/algorithm/centroid.hpp"
 #include "viennagrid/algorithm/boundary.hpp"
@@ -24,6 +25,8 @@
 #include "viennagrid/mesh/coboundary_iteration.hpp"
 #include "viennagrid/mesh/neighbor_iteration.hpp"
 
+#include "viennagrid/io/output_buffer.hpp"
+
 /** @file viennagrid/io/mphtxt_writer.hpp
     @brief Provides a writer for Comsol .mphtxt files.
 */
@@ -159,8 +162,6 @@ namespace viennagrid
       void operator()(MeshT const & mesh, SegmentationT const & segmentation, std::string const & filename) const
       {
         typedef typename viennagrid::result_of::point<MeshT>::type PointType;
-        typedef typename viennagrid::result_of::vertex_id<MeshT>::type VertexIDType;
-        typedef typename viennagrid::result_of::triangle_id<MeshT>::type TriangleIDType;
 
         typedef typename viennagrid::result_of::triangle<MeshT>::type TriangleType;
 
@@ -180,7 +181,11 @@ namespace viennagrid
           ss << filename;
         else
           ss << filename << ".mphtxt";
-        std::ofstream writer(ss.str().c_str());
+        std::ofstream file(ss.str().c_str());
+        if (!file)
+          throw cannot_open_file_exception("* ViennaGrid: mphtxt_writer::operator(): File " + ss.str() + ": Cannot open file!");
+
+        output_buffer writer(file);
 
         // writing the file header
         writer << "# Created by ViennaGrid mphtxt writer\n";
@@ -213,7 +218,7 @@ namespace viennagrid
         // geometric dimension
         writer << viennagrid::result_of::geometric_dimension<MeshT>::value << " # sdim\n";
         // number of vertices
-        writer << viennagrid::vertices(mesh).size() << " # number of mesh points\n";
+        writer << static_cast<unsigned long>(viennagrid::vertices(mesh).size()) << " # number of mesh points\n";
         // lowest index = 0
         writer << "0 # lowest mesh point index\n";
         writer << "\n";
@@ -222,17 +227,19 @@ namespace viennagrid
         // writing the points and the coordinates
         writer << "# Mesh point coordinates\n";
         ConstVertexRangeType vertices(mesh);
-        std::map<VertexIDType, int> vertex_index_map;
 
-        std::size_t vertex_index = 0;
+        // vertex indices in the file, indexed by vertex ID
+        std::vector<unsigned long> vertex_index_map( viennagrid::id_upper_bound<viennagrid::vertex_tag>(mesh).get() );
+
+        writer.precision( std::numeric_limits<typename PointType::value_type>::digits10 );
+        unsigned long vertex_index = 0;
         for (ConstVertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit, ++vertex_index)
         {
-          vertex_index_map[ vit->id() ] = vertex_index;
+          vertex_index_map[ static_cast<std::size_t>(vit->id().get()) ] = vertex_index;
 
-          writer.precision( std::numeric_limits<typename PointType::value_type>::digits10 );
           PointType const & point = viennagrid::point(*vit);
           for (std::size_t i = 0; i < point.size(); ++i)
-            writer << point[i] << " ";
+            writer << point[i] << ' ';
           writer << "\n";
         }
         writer << "\n";
@@ -253,7 +260,10 @@ namespace viennagrid
         typedef typename viennagrid::result_of::const_triangle_handle<MeshT>::type ConstTriangleHandleType;
         typedef triangle_information<ConstTriangleHandleType> TriInfoType;
 
-        std::map<TriangleIDType, TriInfoType> used_triangles;
+        // boundary and interface triangles, the position within used_triangles is stored in used_triangle_index (indexed by triangle ID)
+        std::vector<TriInfoType> used_triangles;
+        std::size_t triangle_id_upper_bound = static_cast<std::size_t>( viennagrid::id_upper_bound<viennagrid::triangle_tag>(mesh).get() );
+        std::vector<std::size_t> used_triangle_index( triangle_id_upper_bound, static_cast<std::size_t>(-1) );
         typedef typename viennagrid::result_of::segment_handle<SegmentationT>::type SegmentHandleType;
 
         // saving only boundary and interface triangles explicitly
@@ -269,9 +279,13 @@ namespace viennagrid
           {
             if ( viennagrid::is_boundary(*sit, *tit) )
             {
-              typename std::map<TriangleIDType, TriInfoType>::iterator utit = used_triangles.find( tit->id() );
-              if (utit == used_triangles.end())
-                utit = used_triangles.insert( std::make_pair(tit->id(), TriInfoType(tit.handle())) ).first;
+              std::size_t & index = used_triangle_index[ static_cast<std::size_t>(tit->id().get()) ];
+              if (index == static_cast<std::size_t>(-1))
+              {
+                index = used_triangles.size();
+                used_triangles.push_back( TriInfoType(tit.handle()) );
+              }
+              TriInfoType & info = used_triangles[index];
 
               PointType triangle_normal = viennagrid::normal_vector(*tit);
               PointType triangle_center = viennagrid::centroid(*tit);
@@ -290,21 +304,21 @@ namespace viennagrid
 
               if (orientation)
               {
-                if (utit->second.up_index != 0)
+                if (info.up_index != 0)
                 {
                   std::cout << "FEHLER!!!" << std::endl;
                 }
 
-                utit->second.up_index = sit->id()+1;
+                info.up_index = sit->id()+1;
               }
               else
               {
-                if (utit->second.down_index != 0)
+                if (info.down_index != 0)
                 {
                   std::cout << "FEHLER!!!" << std::endl;
                 }
 
-                utit->second.down_index = sit->id()+1;
+                info.down_index = sit->id()+1;
               }
             }
           }
@@ -319,24 +333,31 @@ namespace viennagrid
         mark_segment_hull_contacts( segmentation, contact_index_field );
 
 
+        // the triangles are written ordered by their ID
+        std::vector<std::size_t> triangle_order;
+        triangle_order.reserve( used_triangles.size() );
+        for (std::size_t id = 0; id < triangle_id_upper_bound; ++id)
+          if (used_triangle_index[id] != static_cast<std::size_t>(-1))
+            triangle_order.push_back( used_triangle_index[id] );
+
         // writing the triangles to the file
 //         writer << viennagrid::triangles(mesh).size() << " # number of triangles\n";
-        writer << used_triangles.size() << " # number of triangles\n";
+        writer << static_cast<unsigned long>(used_triangles.size()) << " # number of triangles\n";
         writer << "\n";
 
         // writing the vertex indices of the triangles
-        for (typename std::map<TriangleIDType, TriInfoType>::const_iterator utit = used_triangles.begin(); utit != used_triangles.end(); ++utit)
+        for (std::size_t i = 0; i < triangle_order.size(); ++i)
         {
           typedef typename viennagrid::result_of::triangle<MeshT>::type TriangleType;
           typedef typename viennagrid::result_of::const_vertex_range<TriangleType>::type VertexOnTriangleRangeType;
           typedef typename viennagrid::result_of::iterator<VertexOnTriangleRangeType>::type VertexOnTriangleIteratorType;
 
-          VertexOnTriangleRangeType vertices_on_triangle( viennagrid::dereference_handle(mesh, utit->second.handle) );
+          VertexOnTriangleRangeType vertices_on_triangle( viennagrid::dereference_handle(mesh, used_triangles[triangle_order[i]].handle) );
           for (VertexOnTriangleIteratorType vtit = vertices_on_triangle.begin(); vtit != vertices_on_triangle.end(); ++vtit)
           {
-            writer << vertex_index_map[ vtit->id() ] << " ";
+            writer << vertex_index_map[ static_cast<std::size_t>(vtit->id().get()) ] << ' ';
           }
-          writer << "\n";
+          writer << '\n';
         }
 
         writer << "\n";
@@ -344,17 +365,17 @@ namespace viennagrid
         writer << "0\n";
 
         // writing the contact ID for each triangle
-        writer << used_triangles.size() << " # number of triangles\n";
-        for (typename std::map<TriangleIDType, TriInfoType>::const_iterator utit = used_triangles.begin(); utit != used_triangles.end(); ++utit)
-          writer << contact_index_field( viennagrid::dereference_handle(mesh, utit->second.handle) ) << "\n";
+        writer << static_cast<unsigned long>(used_triangles.size()) << " # number of triangles\n";
+        for (std::size_t i = 0; i < triangle_order.size(); ++i)
+          writer << contact_index_field( viennagrid::dereference_handle(mesh, used_triangles[triangle_order[i]].handle) ) << '\n';
 
         // writing the orientation for each triangle, the first value is the segment on the positive side of the triangle, the second value the segment on the negative side;
         // segments start with 1, 0 is reserved for no segment
         writer << "\n";
-        writer << used_triangles.size() << " # number of triangles\n";
+        writer << static_cast<unsigned long>(used_triangles.size()) << " # number of triangles\n";
         writer << "\n";
-        for (typename std::map<TriangleIDType, TriInfoType>::const_iterator utit = used_triangles.begin(); utit != used_triangles.end(); ++utit)
-          writer << utit->second.up_index << " " << utit->second.down_index << "\n";
+        for (std::size_t i = 0; i < triangle_order.size(); ++i)
+          writer << used_triangles[triangle_order[i]].up_index << ' ' << used_triangles[triangle_order[i]].down_index << '\n';
 
 
 
@@ -366,7 +387,7 @@ namespace viennagrid
         writer << "4 # nodes per element\n";
         writer << "\n";
         // number of tetrahedra
-        writer << viennagrid::tetrahedra(mesh).size() << " # number of tetrahedron\n";
+        writer << static_cast<unsigned long>(viennagrid::tetrahedra(mesh).size()) << " # number of tetrahedron\n";
         writer << "\n";
 
         // writing the vertex indices of the tetrahedra
@@ -380,9 +401,9 @@ namespace viennagrid
           VertexOnTetrahedronRangeType vertices_on_tetrahedron(*tit);
           for (VertexOnTetrahedronIteratorType vtit = vertices_on_tetrahedron.begin(); vtit != vertices_on_tetrahedron.end(); ++vtit)
           {
-            writer << vertex_index_map[ vtit->id() ] << " ";
+            writer << vertex_index_map[ static_cast<std::size_t>(vtit->id().get()) ] << ' ';
           }
-          writer << "\n";
+          writer << '\n';
         }
 
         // writing the segment information for the tetrahedra
@@ -390,9 +411,9 @@ namespace viennagrid
         writer << "\n";
         writer << "4\n";
         writer << "0\n";
-//         writer << viennagrid::tetrahedra(mesh).size() << " # number of tetrahedron\n";
+//         writer << static_cast<unsigned long>(viennagrid::tetrahedra(mesh).size()) << " # number of tetrahedron\n";
         writer << "\n";
-        writer << viennagrid::tetrahedra(mesh).size() << " # number of tetrahedron\n";
+        writer << static_cast<unsigned long>(viennagrid::tetrahedra(mesh).size()) << " # number of tetrahedron\n";
 
 //         ConstTetrahedronRangeType tetrahedrons(mesh);
         for (ConstTetrahedronIteratorType tit = tetrahedrons.begin(); tit != tetrahedrons.end(); ++tit)
@@ -402,7 +423,7 @@ namespace viennagrid
           typedef typename viennagrid::result_of::segment_id_range<SegmentationT, TetrahedronType>::type SegmentIDRange;
 
           SegmentIDRange segment_ids = viennagrid::segment_ids( segmentation, *tit );
-          writer << *(segment_ids.begin())+1 << "\n";
+          writer << *(segment_ids.begin())+1 << '\n';
         }
 
         writer << "\n";
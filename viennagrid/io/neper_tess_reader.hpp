@@ -21,6 +21,7 @@
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/mesh/mesh.hpp"
 #include "viennagrid/io/helper.hpp"
+#include "viennagrid/io/tokenizer.hpp"
 
 /** @file viennagrid/io/neper_tess_reader.hpp
     @brief Provides a reader for Neper .tess files. See http://neper.sourceforge.net/docs/neper.pdf page 49-52
@@ -44,11 +45,11 @@ namespace viennagrid
        * @param filename      Name of the file
        */
       template <typename MeshT>
-      int operator()(MeshT & mesh_obj, std::string const & filename) const
+      void operator()(MeshT & mesh_obj, std::string const & filename) const
       {
         std::vector< std::pair<typename viennagrid::result_of::point<MeshT>::type, int> > seed_points;
 
-        return (*this)(mesh_obj, filename, seed_points);
+        (*this)(mesh_obj, filename, seed_points);
       }
 
       /** @brief The functor interface triggering the read operation. Segmentations are not supported in this version.
@@ -68,57 +69,64 @@ namespace viennagrid
         typedef typename result_of::vertex_handle<MeshT>::type          VertexHandleType;
         typedef typename result_of::line_handle<MeshT>::type            LineHandleType;
 
-        std::ifstream reader(filename.c_str());
-
         #if defined VIENNAGRID_DEBUG_STATUS || defined VIENNAGRID_DEBUG_IO
-        std::cout << "* poly_reader::operator(): Reading file " << filename << std::endl;
+        std::cout << "* neper_tess_reader::operator(): Reading file " << filename << std::endl;
         #endif
 
-        if (!reader)
-        {
-          throw cannot_open_file_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": Cannot open file!");
-        }
+        tokenizer reader;
+        reader.open(filename);
 
         seed_points.clear();
 
-        std::string tmp;
-        std::istringstream current_line;
+        if (reader.eof())
+          throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + " is empty.");
 
+        std::string tmp;
 
-        if (!reader.good())
-          throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + " is empty.");
+        // vertex IDs of .tess files are numbered consecutively starting from 1, hence vectors are used for translating IDs to handles
+        std::vector<VertexHandleType> vertices;
+        std::vector<bool> vertex_present;
 
+        // lines are stored with their smaller vertex ID, together with the larger vertex ID
+        std::vector< std::vector< std::pair<int, LineHandleType> > > lines;
 
-        std::map<int, VertexHandleType> vertices;
-        std::map< std::pair<int, int>, LineHandleType > lines;
+        std::vector<int> vertex_ids;
+        std::vector<LineHandleType> plc_line_handles;
 
-        while (std::getline(reader, tmp))
+        while (reader.read_line(tmp))
         {
 
           if (tmp.find("**vertex") != std::string::npos)
           {
-            std::getline(reader, tmp);
-
             int num_vertices;
-            current_line.str(tmp); current_line.clear();
-            current_line >> num_vertices;
+            if (!reader.read_integer(num_vertices) || num_vertices < 0)
+              throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": Invalid number of vertices.");
+            reader.skip_line();
 
             for (int i = 0; i < num_vertices; ++i)
             {
-              std::getline(reader, tmp);
               int vertex_id;
-              current_line.str(tmp); current_line.clear();
-              current_line >> vertex_id;
-
-              std::getline(reader, tmp);
-              std::getline(reader, tmp);
+              if (!reader.read_integer(vertex_id) || vertex_id < 0)
+                throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": Invalid vertex ID.");
+              reader.skip_line();
+              reader.skip_line();
 
               PointType p;
-              current_line.str(tmp); current_line.clear();
               for (int j = 0; j < std::min(point_dim,3); ++j)
-                current_line >> p[j];
+                if (!reader.read_float(p[static_cast<std::size_t>(j)]))
+                  throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": EOF encountered while reading vertices.");
+              reader.skip_line();
+
+              std::size_t index = static_cast<std::size_t>(vertex_id);
+              if (index >= vertices.size())
+              {
+                vertices.resize(index+1);
+                vertex_present.resize(index+1, false);
+                lines.resize(index+1);
+              }
 
-              vertices[vertex_id] = viennagrid::make_vertex(mesh_obj, p);
+              vertices[index] = viennagrid::make_vertex(mesh_obj, p);
+              vertex_present[index] = true;
             }
           }
 
@@ -126,69 +134,36 @@ namespace viennagrid
 
           if (tmp.find("**face") != std::string::npos)
           {
-            std::getline(reader, tmp);
-
             int num_faces;
-            current_line.str(tmp); current_line.clear();
-            current_line >> num_faces;
+            if (!reader.read_integer(num_faces) || num_faces < 0)
+              throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": Invalid number of faces.");
+            reader.skip_line();
 
             for (int i = 0; i < num_faces; ++i)
             {
-              std::getline(reader, tmp);
-              std::getline(reader, tmp);
-              std::getline(reader, tmp);
-              std::getline(reader, tmp);
+              reader.skip_lines(3);
 
               int num_vertex_ids;
-              std::vector<int> vertex_ids;
-              current_line.str(tmp); current_line.clear();
-              current_line >> num_vertex_ids;
-              vertex_ids.resize(num_vertex_ids);
-
-              for (int j = 0; j < num_vertex_ids; ++j)
-                current_line >> vertex_ids[j];
-
-              std::vector<LineHandleType> plc_line_handles;
-              for (int j = 1; j < num_vertex_ids; ++j)
-              {
-                std::pair<int, int> line;
-                line.first = std::min( vertex_ids[j-1], vertex_ids[j] );
-                line.second = std::max( vertex_ids[j-1], vertex_ids[j] );
-
-                typename std::map< std::pair<int, int>, LineHandleType >::iterator lit = lines.find( line );
-                if (lit != lines.end())
-                  plc_line_handles.push_back( lit->second );
-                else
-                {
-                  LineHandleType l = viennagrid::make_line( mesh_obj, vertices[line.first], vertices[line.second] );
-                  lines[line] = l;
-                  plc_line_handles.push_back(l);
-                }
-              }
+              if (!reader.read_integer(num_vertex_ids) || num_vertex_ids < 1)
+                throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": Invalid number of face vertices.");
 
+              vertex_ids.resize(static_cast<std::size_t>(num_vertex_ids));
+              for (std::size_t j = 0; j < vertex_ids.size(); ++j)
               {
-                std::pair<int, int> line;
-                line.first = std::min( vertex_ids.front(), vertex_ids.back() );
-                line.second = std::max( vertex_ids.front(), vertex_ids.back() );
-
-                typename std::map< std::pair<int, int>, LineHandleType >::iterator lit = lines.find( line );
-                if (lit != lines.end())
-                  plc_line_handles.push_back( lit->second );
-                else
-                {
-                  LineHandleType l = viennagrid::make_line( mesh_obj, vertices[line.first], vertices[line.second] );
-                  lines[line] = l;
-                  plc_line_handles.push_back(l);
-                }
+                if (!reader.read_integer(vertex_ids[j]) || vertex_ids[j] < 0 ||
+                    static_cast<std::size_t>(vertex_ids[j]) >= vertex_present.size() || !vertex_present[static_cast<std::size_t>(vertex_ids[j])])
+                  throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": Face references an unknown vertex.");
               }
+              reader.skip_line();
 
-
+              plc_line_handles.clear();
+              for (std::size_t j = 1; j < vertex_ids.size(); ++j)
+                plc_line_handles.push_back( get_line(mesh_obj, vertices, lines, vertex_ids[j-1], vertex_ids[j]) );
+              plc_line_handles.push_back( get_line(mesh_obj, vertices, lines, vertex_ids.front(), vertex_ids.back()) );
 
               viennagrid::make_plc( mesh_obj, plc_line_handles.begin(), plc_line_handles.end() );
 
-              std::getline(reader, tmp);
-              std::getline(reader, tmp);
-              std::getline(reader, tmp);
+              reader.skip_lines(3);
             }
           }
 
@@ -196,33 +171,54 @@ namespace viennagrid
 
           if (tmp.find("**polyhedron") != std::string::npos)
           {
-            std::getline(reader, tmp);
-
             int num_polyhedrons;
-            current_line.str(tmp); current_line.clear();
-            current_line >> num_polyhedrons;
+            if (!reader.read_integer(num_polyhedrons) || num_polyhedrons < 0)
+              throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": Invalid number of polyhedra.");
+            reader.skip_line();
 
             for (int i = 0; i < num_polyhedrons; ++i)
             {
-              std::getline(reader, tmp);
               int polyherdon_id;
-              current_line.str(tmp); current_line.clear();
-              current_line >> polyherdon_id;
+              if (!reader.read_integer(polyherdon_id))
+                throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": EOF encountered while reading polyhedra.");
 
               PointType p;
               for (int j = 0; j < std::min(point_dim,3); ++j)
-                current_line >> p[j];
+                if (!reader.read_float(p[static_cast<std::size_t>(j)]))
+                  throw bad_file_format_exception("* ViennaGrid: neper_tess_reader::operator(): File " + filename + ": EOF encountered while reading polyhedra.");
+              reader.skip_line();
 
               seed_points.push_back( std::make_pair(p, polyherdon_id) );
-              std::getline(reader, tmp);
-              std::getline(reader, tmp);
+              reader.skip_lines(2);
             }
           }
 
         }
       } //operator()
 
-    }; //class tetgen_poly_reader
+    private:
+
+      /** @brief Returns the line between the vertices with IDs id0 and id1, the line is created if not already present */
+      template<typename MeshT, typename VertexHandleContainerT, typename LineContainerT>
+      static typename result_of::line_handle<MeshT>::type get_line(MeshT & mesh_obj, VertexHandleContainerT const & vertices, LineContainerT & lines, int id0, int id1)
+      {
+        typedef typename result_of::line_handle<MeshT>::type LineHandleType;
+        typedef typename LineContainerT::value_type LinesOnVertexType;
+
+        int first = std::min(id0, id1);
+        int second = std::max(id0, id1);
+
+        LinesOnVertexType & lines_on_vertex = lines[static_cast<std::size_t>(first)];
+        for (typename LinesOnVertexType::const_iterator lit = lines_on_vertex.begin(); lit != lines_on_vertex.end(); ++lit)
+          if (lit->first == second)
+            return lit->second;
+
+        LineHandleType l = viennagrid::make_line( mesh_obj, vertices[static_cast<std::size_t>(first)], vertices[static_cast<std::size_t>(second)] );
+        lines_on_vertex.push_back( std::make_pair(second, l) );
+        return l;
+      }
+
+    }; //class neper_tess_reader
 
   } //namespace io
 } //namespace viennagrid
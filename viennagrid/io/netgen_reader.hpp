@@ -24,6 +24,8 @@
 #include "viennagrid/mesh/element_creation.hpp"
 
 #include "viennagrid/io/helper.hpp"
+#include "viennagrid/io/tokenizer.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 /** @file viennagrid/io/netgen_reader.hpp
     @brief Provides a reader for Netgen files
@@ -46,6 +48,7 @@ namespace viennagrid
       template <typename MeshType, typename SegmentationType>
       void operator()(MeshType & mesh_obj, SegmentationType & segmentation, std::string const & filename) const
       {
+        VIENNAGRID_INSTRUMENT_SCOPE("netgen_reader: read");
         typedef typename viennagrid::result_of::point<MeshType>::type    PointType;
 
         const int point_dim = viennagrid::result_of::static_size<PointType>::value;
@@ -56,82 +59,98 @@ namespace viennagrid
         typedef typename result_of::element<MeshType, vertex_tag>::type                           VertexType;
         typedef typename result_of::handle<MeshType, vertex_tag>::type                           VertexHandleType;
 
-        std::ifstream reader(filename.c_str());
+        typedef typename viennagrid::result_of::segment_handle<SegmentationType>::type            SegmentHandleType;
 
         #if defined VIENNAGRID_DEBUG_STATUS || defined VIENNAGRID_DEBUG_IO
         std::cout << "* netgen_reader::operator(): Reading file " << filename << std::endl;
         #endif
 
-        if (!reader)
-        {
-          throw cannot_open_file_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": Cannot open file!");
-        }
+        tokenizer reader;
+        reader.open(filename);
 
         long node_num = 0;
         long cell_num = 0;
 
-        if (!reader.good())
+        if (reader.eof())
           throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + " is empty.");
 
         //
         // Read vertices:
         //
-        reader >> node_num;
-        assert(node_num > 0);
+        if (!reader.read_integer(node_num) || node_num < 0)
+          throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": Invalid number of vertices.");
 
         #if defined VIENNAGRID_DEBUG_STATUS || defined VIENNAGRID_DEBUG_IO
         std::cout << "* netgen_reader::operator(): Reading " << node_num << " vertices... " << std::endl;
         #endif
 
+        viennagrid::reserve<vertex_tag>( mesh_obj, static_cast<std::size_t>(node_num) );
 
+        std::vector<VertexHandleType> vertex_handles;
+        vertex_handles.reserve( static_cast<std::size_t>(node_num) );
 
-        for (int i=0; i<node_num; i++)
+        for (long i=0; i<node_num; i++)
         {
-          if (!reader.good())
-            throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": EOF encountered while reading vertices.");
-
           PointType p;
 
           for (std::size_t j=0; j<static_cast<std::size_t>(point_dim); j++)
-            reader >> p[j];
+            if (!reader.read_float(p[j]))
+              throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": EOF encountered while reading vertices.");
 
-          viennagrid::make_vertex_with_id( mesh_obj, typename VertexType::id_type(i), p );
+          viennagrid::make_vertex_with_id( mesh_obj, typename VertexType::id_type(static_cast<int>(i)), p );
         }
 
-        if (!reader.good())
-          throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": EOF encountered when reading number of cells.");
+        // collect the handles after all vertices are inserted, since inserting might invalidate handles for some containers
+        typedef typename viennagrid::result_of::element_range<MeshType, vertex_tag>::type VertexRangeType;
+        typedef typename viennagrid::result_of::iterator<VertexRangeType>::type VertexIteratorType;
 
+        VertexRangeType vertices(mesh_obj);
+        for (VertexIteratorType vit = vertices.begin(); vit != vertices.end() && vertex_handles.size() < static_cast<std::size_t>(node_num); ++vit)
+          vertex_handles.push_back( vit.handle() );
 
         //
         // Read cells:
         //
-        reader >> cell_num;
+        if (!reader.read_integer(cell_num) || cell_num < 0)
+          throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": EOF encountered when reading number of cells.");
 
         #if defined VIENNAGRID_DEBUG_STATUS || defined VIENNAGRID_DEBUG_IO
         std::cout << "* netgen_reader::operator(): Reading " << cell_num << " cells... " << std::endl;
         #endif
 
-        for (int i=0; i<cell_num; ++i)
+        viennagrid::reserve<CellTag>( mesh_obj, static_cast<std::size_t>(cell_num) );
+
+        // cells are usually grouped by segment, hence the last segment is cached to avoid a segment lookup per cell
+        SegmentHandleType * segment = NULL;
+        int current_segment_index = 0;
+
+        for (long i=0; i<cell_num; ++i)
         {
-          std::size_t vertex_num;
           viennagrid::static_array<VertexHandleType, boundary_elements<CellTag, vertex_tag>::num> cell_vertex_handles;
 
-          if (!reader.good())
-            throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": EOF encountered while reading cells (segment index expected).");
-
           int segment_index;
-          reader >> segment_index;
+          if (!reader.read_integer(segment_index))
+            throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": EOF encountered while reading cells (segment index expected).");
 
           for (std::size_t j=0; j<static_cast<std::size_t>(boundary_elements<CellTag, vertex_tag>::num); ++j)
           {
-            if (!reader.good())
+            long vertex_num;
+            if (!reader.read_integer(vertex_num))
               throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": EOF encountered while reading cells (cell ID expected).");
 
-            reader >> vertex_num;
-            cell_vertex_handles[j] = viennagrid::vertices(mesh_obj).handle_at(vertex_num-1);
+            if (vertex_num < 1 || vertex_num > node_num)
+              throw bad_file_format_exception("* ViennaGrid: netgen_reader::operator(): File " + filename + ": Vertex index out of range.");
+
+            cell_vertex_handles[j] = vertex_handles[static_cast<std::size_t>(vertex_num-1)];
+          }
+
+          if (!segment || segment_index != current_segment_index)
+          {
+            segment = &segmentation[segment_index];
+            current_segment_index = segment_index;
           }
 
-          viennagrid::make_element_with_id<CellType>(segmentation[segment_index], cell_vertex_handles.begin(), cell_vertex_handles.end(), typename CellType::id_type(i));
+          viennagrid::make_element_with_id<CellType>(*segment, cell_vertex_handles.begin(), cell_vertex_handles.end(), typename CellType::id_type(static_cast<int>(i)));
         }
       } //operator()
 
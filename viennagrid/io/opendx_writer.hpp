@@ -15,9 +15,12 @@
 
 #include <fstream>
 #include <iostream>
+#include <vector>
+#include <limits>
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/mesh/mesh.hpp"
 #include "viennagrid/io/helper.hpp"
+#include "viennagrid/io/output_buffer.hpp"
 #include "viennagrid/accessor.hpp"
 
 /** @file viennagrid/io/opendx_writer.hpp
@@ -115,31 +118,47 @@ namespace viennagrid
         {
           typedef DXHelper<geometric_dim>  DXHelper;
 
-          std::ofstream writer(filename.c_str());
-          if (!writer.is_open())
+          std::ofstream file(filename.c_str());
+          if (!file.is_open())
           {
             throw cannot_open_file_exception("* ViennaGrid: opendx_writer::operator(): File " + filename + ": Cannot open file!");
           }
 
-          std::size_t pointnum = viennagrid::elements<vertex_tag>(mesh_obj).size();
+          output_buffer writer(file);
+
+          unsigned long pointnum = static_cast<unsigned long>( viennagrid::elements<vertex_tag>(mesh_obj).size() );
 
           writer << "object \"points\" class array type float rank 1 shape " << geometric_dim << " items ";
-          writer << pointnum << " data follows" << std::endl;
+          writer << pointnum << " data follows\n";
 
           //Nodes:
           VertexRange vertices = viennagrid::elements<vertex_tag>(mesh_obj);
+
+          // vertex indices in the file, indexed by vertex ID
+          std::vector<unsigned long> vertex_index_map( static_cast<std::size_t>(viennagrid::id_upper_bound<vertex_tag>(mesh_obj).get()) );
+
+          writer.precision( std::numeric_limits<CoordType>::digits10 );
+          unsigned long vertex_index = 0;
           for (VertexIterator vit = vertices.begin();
               vit != vertices.end();
-              ++vit)
+              ++vit, ++vertex_index)
           {
-            PointWriter<geometric_dim>::write(writer, viennagrid::point( mesh_obj, *vit ) );
-            writer << std::endl;
+            vertex_index_map[ static_cast<std::size_t>(vit->id().get()) ] = vertex_index;
+
+            PointType const & point = viennagrid::point( mesh_obj, *vit );
+            for (std::size_t i = 0; i < point.size(); ++i)
+            {
+              if (i > 0)
+                writer << ' ';
+              writer << point[i];
+            }
+            writer << '\n';
           }
-          writer << std::endl;
+          writer << '\n';
 
           //Cells:
-          std::size_t cellnum = viennagrid::elements<CellTag>(mesh_obj).size();
-          writer << "object \"grid_Line_One\" class array type int rank 1 shape " << (geometric_dim + 1) << " items " << cellnum << " data follows" << std::endl;
+          unsigned long cellnum = static_cast<unsigned long>( viennagrid::elements<CellTag>(mesh_obj).size() );
+          writer << "object \"grid_Line_One\" class array type int rank 1 shape " << (geometric_dim + 1) << " items " << cellnum << " data follows\n";
 
           CellRange cells = viennagrid::elements<CellTag>(mesh_obj);
           for (CellIterator cit = cells.begin();
@@ -151,24 +170,23 @@ namespace viennagrid
                 vocit != vertices_for_cell.end();
                 ++vocit)
             {
-              VertexType const & vertex = *vocit;
-              writer << vertex.id() << " ";
+              writer << vertex_index_map[ static_cast<std::size_t>(vocit->id().get()) ] << ' ';
             }
-            writer << std::endl;
+            writer << '\n';
           }
 
-          writer << DXHelper::getAttributes() << std::endl;
-          writer << "attribute \"ref\" string \"positions\" " << std::endl;
-          writer << std::endl;
+          writer << DXHelper::getAttributes() << '\n';
+          writer << "attribute \"ref\" string \"positions\" \n";
+          writer << '\n';
 
           //set output-format:
-          writer.flags(std::ios::fixed);
+          writer.fixed(true);
           writer.precision(5);
 
           //write quantity:
           if (vertex_scalar_data.size() > 0)
           {
-            writer << "object \"VisData\" class array items " << pointnum << " data follows" << std::endl;
+            writer << "object \"VisData\" class array items " << pointnum << " data follows\n";
             //some quantity here
 
             for (VertexIterator vit = vertices.begin();
@@ -176,14 +194,14 @@ namespace viennagrid
                 ++vit)
             {
               writer << DXfixer( vertex_scalar_data.begin()->second->at(*vit) );
-              writer << std::endl;
+              writer << '\n';
             }
 
-            writer << "attribute \"dep\" string \"positions\"" << std::endl;
+            writer << "attribute \"dep\" string \"positions\"\n";
           }
           else if (cell_scalar_data.size() > 0)
           {
-            writer << "object \"VisData\" class array items " << cellnum << " data follows" << std::endl;
+            writer << "object \"VisData\" class array items " << cellnum << " data follows\n";
 
             //some quantity here
             for (CellIterator cit = cells.begin();
@@ -191,16 +209,16 @@ namespace viennagrid
                 ++cit)
             {
               writer << DXfixer( cell_scalar_data.begin()->second->at(*cit) );
-              writer << std::endl;
+              writer << '\n';
             }
-            writer << "attribute \"dep\" string \"connections\"" << std::endl;
+            writer << "attribute \"dep\" string \"connections\"\n";
           }
 
-          writer << std::endl;
-          writer << "object \"AttPotential\" class field " << std::endl;
-          writer << "component \"data\" \"VisData\" " << std::endl;
-          writer << "component \"positions\" \"points\"" << std::endl;
-          writer << "component \"connections\" \"grid_Line_One\"" << std::endl;
+          writer << '\n';
+          writer << "object \"AttPotential\" class field \n";
+          writer << "component \"data\" \"VisData\" \n";
+          writer << "component \"positions\" \"points\"\n";
+          writer << "component \"connections\" \"grid_Line_One\"\n";
         } // operator()
 
 
@@ -0,0 +1,339 @@
+#ifndef VIENNAGRID_IO_OUTPUT_BUFFER_HPP
+#define VIENNAGRID_IO_OUTPUT_BUFFER_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "viennagrid/io/helper.hpp"
+#include "viennagrid/io/tokenizer.hpp"
+
+/** @file viennagrid/io/output_buffer.hpp
+    @brief A write buffer with fast integer and floating point formatting used by the plain text writers
+*/
+
+namespace viennagrid
+{
+  namespace io
+  {
+    namespace detail
+    {
+      /** @brief Writes the decimal representation of an unsigned integer to 'out' (at least 'min_digits' digits, zero-padded). Returns a pointer behind the last character written. */
+      inline char * format_unsigned(unsigned long value, char * out, int min_digits = 1)
+      {
+        char tmp[24];
+        int length = 0;
+        do
+        {
+          tmp[length++] = static_cast<char>('0' + value % 10);
+          value /= 10;
+        } while (value != 0);
+
+        while (length < min_digits)
+          tmp[length++] = '0';
+
+        while (length > 0)
+          *out++ = tmp[--length];
+        return out;
+      }
+
+      /** @brief Computes the exact product a*b = product + error using Dekker's algorithm (requires IEEE double arithmetic without extended precision) */
+      inline void exact_product(double a, double b, double & product, double & error)
+      {
+        double ca = 134217729.0 * a;   // 2^27 + 1
+        double a_high = ca - (ca - a);
+        double a_low = a - a_high;
+        double cb = 134217729.0 * b;
+        double b_high = cb - (cb - b);
+        double b_low = b - b_high;
+
+        product = a * b;
+        error = ((a_high*b_high - product) + a_high*b_low + a_low*b_high) + a_low*b_low;
+      }
+
+      /** @brief Rounds value * 10^shift (|shift| <= 22, result below 2^53) to the nearest integer, ties to even, like printf does with the exact binary value */
+      inline unsigned long long scale_and_round(double value, int shift)
+      {
+        double scaled, remainder;
+        if (shift >= 0)
+          exact_product(value, exact_power_of_ten(shift), scaled, remainder);
+        else
+        {
+          double power = exact_power_of_ten(-shift);
+          scaled = value / power;
+
+          double product, error;
+          exact_product(scaled, power, product, error);
+          remainder = (value - product) - error;   // only the sign is relevant
+        }
+
+        double integral = std::floor(scaled);
+        double fraction = scaled - integral;       // exact
+        unsigned long long result = static_cast<unsigned long long>(integral);
+
+        if (fraction > 0.5 || (fraction == 0.5 && (remainder > 0.0 || (remainder == 0.0 && result % 2 == 1))))
+          ++result;
+        return result;
+      }
+
+      /** @brief Formats 'value' like printf("%.*g", precision, value) into 'out' (at least 32 characters). Returns a pointer behind the last character written.
+        *
+        * Values with a magnitude in [1e-5, 1e15) and a precision of at most 15 are scaled by an exact power of ten and rounded using the exact error of the scaling, hence the result is identical to printf.
+        * All other values are handed to sprintf.
+        */
+      inline char * format_general(double value, int precision, char * out)
+      {
+        if (precision < 1)
+          precision = 1;
+
+        if (value == 0.0)
+        {
+          if (1.0/value < 0.0)
+            *out++ = '-';
+          *out++ = '0';
+          return out;
+        }
+
+        double abs_value = std::fabs(value);
+        if (precision > 15 || !(abs_value >= 1e-5 && abs_value < 1e15))
+          return out + std::sprintf(out, "%.*g", precision, value);
+
+        // decimal exponent with 10^exponent <= abs_value < 10^(exponent+1), log10() might be off by one close to powers of ten
+        int exponent = static_cast<int>( std::floor(std::log10(abs_value)) );
+        unsigned long long upper = static_cast<unsigned long long>( exact_power_of_ten(precision) );
+        unsigned long long digits = 0;
+        for (int attempt = 0; attempt < 3; ++attempt)
+        {
+          digits = scale_and_round(abs_value, precision - 1 - exponent);
+
+          if (digits >= upper)   // exponent too small or rounding carried into a new digit, e.g. 9.999 -> 10.00
+            ++exponent;
+          else if (digits < upper/10)
+            --exponent;
+          else
+            break;
+        }
+
+        char digit_string[20];
+        for (int i = precision-1; i >= 0; --i)
+        {
+          digit_string[i] = static_cast<char>('0' + digits % 10);
+          digits /= 10;
+        }
+
+        int significant = precision;
+        while (significant > 1 && digit_string[significant-1] == '0')
+          --significant;
+
+        if (value < 0.0)
+          *out++ = '-';
+
+        if (exponent < -4 || exponent >= precision)
+        {
+          *out++ = digit_string[0];
+          if (significant > 1)
+          {
+            *out++ = '.';
+            for (int i = 1; i < significant; ++i)
+              *out++ = digit_string[i];
+          }
+          *out++ = 'e';
+          *out++ = (exponent < 0) ? '-' : '+';
+          return format_unsigned( static_cast<unsigned long>(exponent < 0 ? -exponent : exponent), out, 2 );
+        }
+
+        if (exponent >= 0)
+        {
+          for (int i = 0; i <= exponent; ++i)
+            *out++ = digit_string[i];
+          if (significant > exponent+1)
+          {
+            *out++ = '.';
+            for (int i = exponent+1; i < significant; ++i)
+              *out++ = digit_string[i];
+          }
+        }
+        else
+        {
+          *out++ = '0';
+          *out++ = '.';
+          for (int i = 0; i < -exponent-1; ++i)
+            *out++ = '0';
+          for (int i = 0; i < significant; ++i)
+            *out++ = digit_string[i];
+        }
+        return out;
+      }
+
+      /** @brief Formats 'value' like printf("%.*f", precision, value) into 'out' (at least 32 characters for values handled by the fast path). Returns a pointer behind the last character written. */
+      inline char * format_fixed(double value, int precision, char * out)
+      {
+        double abs_value = std::fabs(value);
+        if (precision < 0 || precision > 15 || !(abs_value * exact_power_of_ten(precision) < 1e15))
+          return out + std::sprintf(out, "%.*f", precision, value);
+
+        unsigned long long digits = scale_and_round(abs_value, precision);
+        unsigned long long divisor = static_cast<unsigned long long>( exact_power_of_ten(precision) );
+
+        if (value < 0.0 || (value == 0.0 && 1.0/value < 0.0))
+          *out++ = '-';
+
+        out = format_unsigned( static_cast<unsigned long>(digits / divisor), out );
+        if (precision > 0)
+        {
+          *out++ = '.';
+          out = format_unsigned( static_cast<unsigned long>(digits % divisor), out, precision );
+        }
+        return out;
+      }
+    }
+
+
+
+    /** @brief A write buffer on top of an output stream. Numbers are formatted directly into the buffer, which is handed to the stream in large blocks.
+      *
+      * Floating point numbers are written like an std::ostream with the given precision would write them, either in default or in fixed notation.
+      * The buffer is flushed on destruction.
+      */
+    class output_buffer
+    {
+    public:
+
+      /** @brief Constructor
+        *
+        * @param stream_      The stream the buffer is written to
+        * @param capacity_    The size of the buffer in bytes
+        */
+      explicit output_buffer(std::ostream & stream_, std::size_t capacity_ = 1024*1024) :
+        stream(stream_), buffer(capacity_ < 256 ? 256 : capacity_), pos(0), precision_(6), fixed_(false) {}
+
+      ~output_buffer() { flush(); }
+
+      /** @brief Writes the content of the buffer to the stream */
+      void flush()
+      {
+        if (pos > 0)
+          stream.write(&buffer[0], static_cast<std::streamsize>(pos));
+        pos = 0;
+      }
+
+      /** @brief Sets the number of significant digits (default notation) or decimal places (fixed notation) used for floating point numbers */
+      void precision(int precision_new) { precision_ = precision_new; }
+
+      /** @brief Switches between fixed notation (true) and default notation (false) for floating point numbers */
+      void fixed(bool fixed_new) { fixed_ = fixed_new; }
+
+      output_buffer & operator<<(char c)
+      {
+        reserve(1);
+        buffer[pos++] = c;
+        return *this;
+      }
+
+      output_buffer & operator<<(char const * str)
+      {
+        write(str, std::strlen(str));
+        return *this;
+      }
+
+      output_buffer & operator<<(std::string const & str)
+      {
+        write(str.data(), str.size());
+        return *this;
+      }
+
+      output_buffer & operator<<(int value)               { return write_signed(value); }
+      output_buffer & operator<<(long value)              { return write_signed(value); }
+      output_buffer & operator<<(unsigned int value)      { return write_unsigned(value); }
+      output_buffer & operator<<(unsigned long value)     { return write_unsigned(value); }
+
+      output_buffer & operator<<(float value)             { return write_float(value); }
+      output_buffer & operator<<(double value)            { return write_float(value); }
+
+    private:
+
+      void reserve(std::size_t size)
+      {
+        if (pos + size > buffer.size())
+          flush();
+      }
+
+      void write(char const * data, std::size_t size)
+      {
+        if (size > buffer.size())
+        {
+          flush();
+          stream.write(data, static_cast<std::streamsize>(size));
+          return;
+        }
+
+        reserve(size);
+        std::memcpy(&buffer[pos], data, size);
+        pos += size;
+      }
+
+      output_buffer & write_signed(long value)
+      {
+        reserve(24);
+        if (value < 0)
+        {
+          buffer[pos++] = '-';
+          unsigned long abs_value = static_cast<unsigned long>(-(value+1)) + 1;
+          pos = static_cast<std::size_t>( detail::format_unsigned(abs_value, &buffer[pos]) - &buffer[0] );
+        }
+        else
+          pos = static_cast<std::size_t>( detail::format_unsigned(static_cast<unsigned long>(value), &buffer[pos]) - &buffer[0] );
+        return *this;
+      }
+
+      output_buffer & write_unsigned(unsigned long value)
+      {
+        reserve(24);
+        pos = static_cast<std::size_t>( detail::format_unsigned(value, &buffer[pos]) - &buffer[0] );
+        return *this;
+      }
+
+      output_buffer & write_float(double value)
+      {
+        // huge values in fixed notation and large precisions may need more than the usual 32 characters
+        if (precision_ > 30 || (fixed_ && !(std::fabs(value) < 1e15)))
+        {
+          char tmp[512];
+          int length = std::sprintf(tmp, fixed_ ? "%.*f" : "%.*g", precision_ < 100 ? precision_ : 100, value);
+          write(tmp, static_cast<std::size_t>(length));
+          return *this;
+        }
+
+        reserve(64);
+        char * end = fixed_ ? detail::format_fixed(value, precision_, &buffer[pos]) : detail::format_general(value, precision_, &buffer[pos]);
+        pos = static_cast<std::size_t>(end - &buffer[0]);
+        return *this;
+      }
+
+      std::ostream & stream;
+      std::vector<char> buffer;
+      std::size_t pos;
+
+      int precision_;
+      bool fixed_;
+    };
+
+  } //namespace io
+} //namespace viennagrid
+
+#endif
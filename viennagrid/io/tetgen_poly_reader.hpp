@@ -20,6 +20,7 @@
 
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/io/helper.hpp"
+#include "viennagrid/io/tokenizer.hpp"
 
 #include "viennagrid/mesh/mesh.hpp"
 
@@ -130,40 +131,31 @@ namespace viennagrid
 
         typedef typename result_of::handle<MeshT, line_tag>::type            LineHandleType;
 
-        std::ifstream reader(filename.c_str());
-
         #if defined VIENNAGRID_DEBUG_STATUS || defined VIENNAGRID_DEBUG_IO
         std::cout << "* poly_reader::operator(): Reading file " << filename << std::endl;
         #endif
 
-        if (!reader)
-        {
-          throw cannot_open_file_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": Cannot open file!");
-        }
+        tokenizer reader('#');
+        reader.open(filename);
 
         hole_points.clear();
         seed_points.clear();
 
-        std::string tmp;
-        std::istringstream current_line;
-
         long node_num = 0;
         std::size_t dim = 0;
         long attribute_num = 0;
         long boundary_marker_num = 0;
 
 
-        if (!reader.good())
+        if (reader.eof())
           throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": File is empty.");
 
         //
         // Read vertices:
         //
-        if (!get_valid_line(reader, tmp))
+        if (!reader.read_integer(node_num) || !reader.read_integer(dim) || !reader.read_integer(attribute_num) || !reader.read_integer(boundary_marker_num))
           throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
-
-        current_line.str(tmp); current_line.clear();
-        current_line >> node_num >> dim >> attribute_num >> boundary_marker_num;
+        reader.skip_line();
 
         if (node_num < 0)
           throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY file has less than 0 nodes");
@@ -178,38 +170,59 @@ namespace viennagrid
         std::cout << "* poly_reader::operator(): Reading " << node_num << " vertices... " << std::endl;
         #endif
 
-        for (int i=0; i<node_num; i++)
+        for (long i=0; i<node_num; i++)
         {
-          if (!get_valid_line(reader, tmp))
-              throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
-
           typename VertexIDType::base_id_type id;
+          PointType p;
 
-          current_line.str(tmp); current_line.clear();
-          current_line >> id;
+          if (!reader.read_integer(id))
+            throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
 
-          PointType p;
+          if (id < 0)
+            throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY vertex has negative ID");
 
           for (std::size_t j=0; j<point_dim; j++)
-            current_line >> p[j];
+            if (!reader.read_float(p[j]))
+              throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
+
+          reader.skip_line();   // attributes and boundary marker
 
           viennagrid::make_vertex_with_id( mesh_obj, VertexIDType(id), p );
         }
 
-        if (!reader.good())
-          throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading number of cells.");
+        // translation from vertex ID to vertex handle, built after all vertices are inserted since inserting might invalidate handles for some containers
+        std::vector<VertexHandleType> vertex_handles;
+        std::vector<bool> vertex_present;
+        {
+          typedef typename viennagrid::result_of::element_range<MeshT, vertex_tag>::type VertexRangeType;
+          typedef typename viennagrid::result_of::iterator<VertexRangeType>::type VertexIteratorType;
+
+          VertexRangeType vertices(mesh_obj);
+          for (VertexIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
+          {
+            std::size_t index = static_cast<std::size_t>( vit->id().get() );
+            if (index >= vertex_handles.size())
+            {
+              vertex_handles.resize(index+1);
+              vertex_present.resize(index+1, false);
+            }
+            vertex_handles[index] = vit.handle();
+            vertex_present[index] = true;
+          }
+        }
 
 
         //
         // Read facets:
         //
         long facet_num = 0;
-        if (!get_valid_line(reader, tmp))
+        if (!reader.read_integer(facet_num))
           throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
 
-
-        current_line.str(tmp); current_line.clear();
-        current_line >> facet_num >> boundary_marker_num;
+        boundary_marker_num = 0;
+        if (reader.line_has_token())
+          reader.read_integer(boundary_marker_num);
+        reader.skip_line();
 
         if (facet_num < 0)
           throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY file has less than 0 facets");
@@ -217,86 +230,88 @@ namespace viennagrid
           throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY file has not 0 or 1 boundary marker");
 
         #if defined VIENNAGRID_DEBUG_STATUS || defined VIENNAGRID_DEBUG_IO
-        std::cout << "* netgen_reader::operator(): Reading " << cell_num << " cells... " << std::endl;
+        std::cout << "* poly_reader::operator(): Reading " << facet_num << " facets... " << std::endl;
         #endif
 
-        for (int i=0; i<facet_num; ++i)
+        std::vector<LineHandleType> lines;
+        std::vector<VertexHandleType> vertices;
+        std::vector<VertexHandleType> polygon_vertex_handles;
+        std::vector<PointType> hole_points_read;
+
+        for (long i=0; i<facet_num; ++i)
         {
           long polygon_num;
-          long hole_num;
+          long hole_num = 0;
 
-          if (!get_valid_line(reader, tmp))
+          if (!reader.read_integer(polygon_num))
             throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
-
-
-          current_line.str(tmp); current_line.clear();
-          current_line >> polygon_num >> hole_num;
+          if (reader.line_has_token())
+            reader.read_integer(hole_num);
+          reader.skip_line();   // boundary marker
 
           if (polygon_num < 0)
             throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY facet has less than 0 polygons");
           if (hole_num < 0)
             throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY facet has less than 0 holes");
 
-          std::list<LineHandleType> lines;
-          std::list<VertexHandleType> vertices;
+          lines.clear();
+          vertices.clear();
 
-          for (int j = 0; j<polygon_num; ++j)
+          for (long j = 0; j<polygon_num; ++j)
           {
             long vertex_num;
 
-            if (!get_valid_line(reader, tmp))
+            if (!reader.read_integer(vertex_num))
               throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
 
-
-            current_line.str(tmp); current_line.clear();
-            current_line >> vertex_num;
-
             if (vertex_num < 0)
               throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY polygon has less than 0 vertices");
 
-            std::vector<VertexHandleType> vertex_handles(static_cast<std::size_t>(vertex_num));
+            polygon_vertex_handles.resize(static_cast<std::size_t>(vertex_num));
 
             for (std::size_t k = 0; k<static_cast<std::size_t>(vertex_num); ++k)
             {
-              typename VertexIDType::base_id_type id;
-              current_line >> id;
-              vertex_handles[k] = viennagrid::find( mesh_obj, VertexIDType(id) ).handle();
+              long id;
+              if (!reader.read_integer(id))
+                throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
+
+              if (id < 0 || static_cast<std::size_t>(id) >= vertex_present.size() || !vertex_present[static_cast<std::size_t>(id)])
+                throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY polygon references an unknown vertex");
+
+              polygon_vertex_handles[k] = vertex_handles[static_cast<std::size_t>(id)];
             }
+            reader.skip_line();
 
             if (vertex_num == 1)
             {
-              vertices.push_back( vertex_handles.front() );
+              vertices.push_back( polygon_vertex_handles.front() );
             }
             else if (vertex_num == 2)
             {
-              lines.push_back( viennagrid::make_line(mesh_obj, vertex_handles[0], vertex_handles[1]) );
+              lines.push_back( viennagrid::make_line(mesh_obj, polygon_vertex_handles[0], polygon_vertex_handles[1]) );
             }
-            else
+            else if (vertex_num > 2)
             {
-              typename std::vector<VertexHandleType>::iterator it1 = vertex_handles.begin();
-              typename std::vector<VertexHandleType>::iterator it2 = it1; ++it2;
-              for (; it2 != vertex_handles.end(); ++it1, ++it2)
-                  lines.push_back( viennagrid::make_line(mesh_obj, *it1, *it2) );
-              lines.push_back( viennagrid::make_line(mesh_obj, vertex_handles.back(), vertex_handles.front()) );
+              for (std::size_t k = 1; k < polygon_vertex_handles.size(); ++k)
+                  lines.push_back( viennagrid::make_line(mesh_obj, polygon_vertex_handles[k-1], polygon_vertex_handles[k]) );
+              lines.push_back( viennagrid::make_line(mesh_obj, polygon_vertex_handles.back(), polygon_vertex_handles.front()) );
             }
           }
 
-          std::list<PointType> hole_points_read;
+          hole_points_read.clear();
 
-          for (int j = 0; j<hole_num; ++j)
+          for (long j = 0; j<hole_num; ++j)
           {
-            if (!get_valid_line(reader, tmp))
-              throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
-
             long hole_id;
-
-            current_line.str(tmp); current_line.clear();
-            current_line >> hole_id;
-
             PointType p;
 
+            if (!reader.read_integer(hole_id))
+              throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
+
             for (std::size_t k=0; k<point_dim; k++)
-              current_line >> p[k];
+              if (!reader.read_float(p[k]))
+                throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
+            reader.skip_line();
 
             hole_points_read.push_back(p);
           }
@@ -316,31 +331,28 @@ namespace viennagrid
 
         long hole_num;
 
-        if (!get_valid_line(reader, tmp))
+        if (!reader.read_integer(hole_num))
         {
           // no holes -> Okay, SUCCESS xD
           return;
         }
-
-        current_line.str(tmp); current_line.clear();
-        current_line >> hole_num;
+        reader.skip_line();
 
         if (hole_num < 0)
           throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY file has less than 0 holes");
 
-        for (int i=0; i<hole_num; ++i)
+        for (long i=0; i<hole_num; ++i)
         {
-          if (!get_valid_line(reader, tmp))
-            throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
-
           long hole_number;
           PointType hole_point;
 
-          current_line.str(tmp); current_line.clear();
-          current_line >> hole_number;
+          if (!reader.read_integer(hole_number))
+            throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
 
           for (std::size_t j=0; j < point_dim; j++)
-            current_line >> hole_point[j];
+            if (!reader.read_float(hole_point[j]))
+              throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
+          reader.skip_line();
 
           hole_points.push_back( hole_point );
         }
@@ -350,34 +362,32 @@ namespace viennagrid
 
         long segment_num;
 
-        if (!get_valid_line(reader, tmp))
+        if (!reader.read_integer(segment_num))
         {
           // no region -> SUCCESS xD
           return;
         }
-
-        current_line.str(tmp); current_line.clear();
-        current_line >> segment_num;
+        reader.skip_line();
 
         if (segment_num < 0)
           throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": POLY file has less than 0 segments");
 
-        for (int i=0; i<segment_num; ++i)
+        for (long i=0; i<segment_num; ++i)
         {
-          if (!get_valid_line(reader, tmp))
-            throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
-
           long segment_number;
           PointType seed_point;
-          int segment_id;
+          int segment_id = 0;
 
-          current_line.str(tmp); current_line.clear();
-          current_line >> segment_number;
+          if (!reader.read_integer(segment_number))
+            throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
 
           for (std::size_t j=0; j < point_dim; j++)
-            current_line >> seed_point[j];
+            if (!reader.read_float(seed_point[j]))
+              throw bad_file_format_exception("* ViennaGrid: tetgen_poly_reader::operator(): File " + filename + ": EOF encountered when reading information");
 
-          current_line >> segment_id;
+          if (reader.line_has_token())
+            reader.read_integer(segment_id);
+          reader.skip_line();
 
           seed_points.push_back( std::make_pair(seed_point, segment_id) );
         }
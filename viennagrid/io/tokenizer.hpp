@@ -0,0 +1,341 @@
+#ifndef VIENNAGRID_IO_TOKENIZER_HPP
+#define VIENNAGRID_IO_TOKENIZER_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#include "viennagrid/io/helper.hpp"
+
+/** @file viennagrid/io/tokenizer.hpp
+    @brief A buffered tokenizer with fast number parsing used by the plain text readers
+*/
+
+namespace viennagrid
+{
+  namespace io
+  {
+    namespace detail
+    {
+      /** @brief Returns 10^exponent for 0 <= exponent <= 22, all of which are exactly representable as double */
+      inline double exact_power_of_ten(int exponent)
+      {
+        static const double powers[] = {
+          1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+          1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        return powers[exponent];
+      }
+
+      /** @brief Parses a floating point number starting at 'begin'. Returns a pointer behind the last character consumed, or 'begin' if no number could be parsed.
+        *
+        * Numbers with at most 15 significant digits and a decimal exponent of magnitude at most 22 are converted exactly using integer arithmetic and a single multiplication or division.
+        * All other numbers (as well as inf and nan) are handed to std::strtod, hence the result is always correctly rounded.
+        */
+      inline char const * parse_double(char const * begin, char const * end, double & value)
+      {
+        char const * it = begin;
+
+        bool negative = false;
+        if (it != end && (*it == '-' || *it == '+'))
+        {
+          negative = (*it == '-');
+          ++it;
+        }
+
+        unsigned long long mantissa = 0;
+        int significant_digits = 0;
+        int exponent = 0;
+        bool any_digit = false;
+
+        for (; it != end && *it >= '0' && *it <= '9'; ++it)
+        {
+          any_digit = true;
+          if (significant_digits < 19)
+          {
+            mantissa = 10*mantissa + static_cast<unsigned long long>(*it - '0');
+            if (mantissa != 0)
+              ++significant_digits;
+          }
+          else
+          {
+            ++exponent;
+            significant_digits = 20;  // precision lost, use slow path
+          }
+        }
+
+        if (it != end && *it == '.')
+        {
+          ++it;
+          for (; it != end && *it >= '0' && *it <= '9'; ++it)
+          {
+            any_digit = true;
+            if (significant_digits < 19)
+            {
+              mantissa = 10*mantissa + static_cast<unsigned long long>(*it - '0');
+              if (mantissa != 0)
+                ++significant_digits;
+              --exponent;
+            }
+            else if (*it != '0')
+              significant_digits = 20;
+          }
+        }
+
+        if (!any_digit)
+        {
+          // inf, nan, hex floats, ...
+          std::string token(begin, std::min<std::size_t>( static_cast<std::size_t>(end-begin), 64 ));
+          char * token_end;
+          value = std::strtod(token.c_str(), &token_end);
+          return begin + (token_end - token.c_str());
+        }
+
+        if (it != end && (*it == 'e' || *it == 'E' || *it == 'd' || *it == 'D'))
+        {
+          char const * exponent_begin = it;
+          ++it;
+
+          bool negative_exponent = false;
+          if (it != end && (*it == '-' || *it == '+'))
+          {
+            negative_exponent = (*it == '-');
+            ++it;
+          }
+
+          if (it == end || *it < '0' || *it > '9')
+            it = exponent_begin;    // not an exponent, e.g. "1.0e" followed by a separator
+          else
+          {
+            int explicit_exponent = 0;
+            for (; it != end && *it >= '0' && *it <= '9'; ++it)
+              if (explicit_exponent < 100000)
+                explicit_exponent = 10*explicit_exponent + (*it - '0');
+            exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+          }
+        }
+
+        if (significant_digits <= 15 && exponent >= -22 && exponent <= 22)
+        {
+          // mantissa < 10^15 < 2^53 is exact, the power of ten is exact, hence the result is correctly rounded
+          value = static_cast<double>(mantissa);
+          if (exponent < 0)
+            value /= exact_power_of_ten(-exponent);
+          else
+            value *= exact_power_of_ten(exponent);
+        }
+        else if (mantissa == 0 && significant_digits == 0)
+          value = 0.0;
+        else
+        {
+          std::string token(begin, it);
+          for (std::size_t i = 0; i < token.size(); ++i)
+            if (token[i] == 'd' || token[i] == 'D')
+              token[i] = 'e';
+          value = std::strtod(token.c_str(), NULL);
+          return it;
+        }
+
+        if (negative)
+          value = -value;
+        return it;
+      }
+    }
+
+
+
+    /** @brief A tokenizer which reads a whole file with a single read operation and parses whitespace-separated integers and floating point numbers from the buffer.
+      *
+      * Comments started by a user-defined comment character are treated like whitespace up to the end of the line.
+      * Most read operations skip newlines, line-oriented file formats can use skip_line() and line_has_token() in addition.
+      */
+    class tokenizer
+    {
+    public:
+
+      /** @brief Constructor
+        *
+        * @param comment_char_    Character which starts a comment ranging to the end of the line, '\\0' disables comments
+        */
+      explicit tokenizer(char comment_char_ = '\0') : comment_char(comment_char_), pos(0) {}
+
+      /** @brief Reads the whole file into the internal buffer. Throws cannot_open_file_exception if the file cannot be read. */
+      void open(std::string const & filename)
+      {
+        std::ifstream reader(filename.c_str(), std::ios::in | std::ios::binary);
+        if (!reader)
+          throw cannot_open_file_exception("* ViennaGrid: tokenizer::open(): File " + filename + ": Cannot open file!");
+
+        reader.seekg(0, std::ios::end);
+        std::streamoff size = reader.tellg();
+        reader.seekg(0, std::ios::beg);
+
+        buffer.resize( static_cast<std::size_t>(size) );
+        if (size > 0)
+          reader.read( &buffer[0], size );
+
+        if (!reader)
+          throw cannot_open_file_exception("* ViennaGrid: tokenizer::open(): File " + filename + ": Error while reading file!");
+
+        pos = 0;
+      }
+
+      /** @brief Uses the provided string as buffer instead of a file */
+      void open_string(std::string const & content)
+      {
+        buffer.assign(content.begin(), content.end());
+        pos = 0;
+      }
+
+      /** @brief Returns the size of the buffer in bytes */
+      std::size_t size() const { return buffer.size(); }
+
+      /** @brief Returns the current position within the buffer */
+      std::size_t position() const { return pos; }
+
+      /** @brief Skips whitespace (including newlines) and comments. Returns false if the end of the buffer is reached. */
+      bool skip_whitespace()
+      {
+        while (pos < buffer.size())
+        {
+          char c = buffer[pos];
+          if (c == comment_char && comment_char != '\0')
+            skip_line();
+          else if (is_whitespace(c))
+            ++pos;
+          else
+            return true;
+        }
+        return false;
+      }
+
+      /** @brief Returns true if the end of the buffer is reached, whitespace and comments are skipped before */
+      bool eof() { return !skip_whitespace(); }
+
+      /** @brief Skips all characters up to and including the next newline */
+      void skip_line()
+      {
+        char const * begin = buffer.empty() ? NULL : &buffer[0];
+        char const * nl = begin ? static_cast<char const *>( std::memchr(begin + pos, '\n', buffer.size() - pos) ) : NULL;
+        pos = nl ? static_cast<std::size_t>(nl - begin) + 1 : buffer.size();
+      }
+
+      /** @brief Skips 'count' lines */
+      void skip_lines(std::size_t count)
+      {
+        for (std::size_t i = 0; i < count; ++i)
+          skip_line();
+      }
+
+      /** @brief Returns true if another token follows on the current line (blanks and comments are skipped, newlines are not) */
+      bool line_has_token()
+      {
+        while (pos < buffer.size() && (buffer[pos] == ' ' || buffer[pos] == '\t' || buffer[pos] == '\r'))
+          ++pos;
+        return pos < buffer.size() && buffer[pos] != '\n' && !(comment_char != '\0' && buffer[pos] == comment_char);
+      }
+
+      /** @brief Reads the remainder of the current line (without the newline) and advances to the next line. Returns false if the end of the buffer is reached. */
+      bool read_line(std::string & line)
+      {
+        if (pos >= buffer.size())
+          return false;
+
+        std::size_t begin = pos;
+        skip_line();
+
+        std::size_t end = pos;
+        if (end > begin && buffer[end-1] == '\n')
+          --end;
+        if (end > begin && buffer[end-1] == '\r')
+          --end;
+
+        line.assign( buffer.begin() + static_cast<long>(begin), buffer.begin() + static_cast<long>(end) );
+        return true;
+      }
+
+      /** @brief Reads a signed integer. Returns false if no integer could be read. */
+      template<typename IntT>
+      bool read_integer(IntT & value)
+      {
+        if (!skip_whitespace())
+          return false;
+
+        std::size_t it = pos;
+        bool negative = false;
+        if (buffer[it] == '-' || buffer[it] == '+')
+        {
+          negative = (buffer[it] == '-');
+          ++it;
+        }
+
+        if (it == buffer.size() || buffer[it] < '0' || buffer[it] > '9')
+          return false;
+
+        IntT result = 0;
+        for (; it < buffer.size() && buffer[it] >= '0' && buffer[it] <= '9'; ++it)
+          result = static_cast<IntT>( 10*result + (buffer[it] - '0') );
+
+        value = negative ? static_cast<IntT>(-result) : result;
+        pos = it;
+        return true;
+      }
+
+      /** @brief Reads a floating point number. Returns false if no number could be read. */
+      template<typename NumericT>
+      bool read_float(NumericT & value)
+      {
+        if (!skip_whitespace())
+          return false;
+
+        double result;
+        char const * begin = &buffer[0] + pos;
+        char const * end = detail::parse_double( begin, &buffer[0] + buffer.size(), result );
+        if (end == begin)
+          return false;
+
+        value = static_cast<NumericT>(result);
+        pos += static_cast<std::size_t>(end - begin);
+        return true;
+      }
+
+      /** @brief Reads a whitespace-separated word. Returns false if the end of the buffer is reached. */
+      bool read_word(std::string & word)
+      {
+        if (!skip_whitespace())
+          return false;
+
+        std::size_t begin = pos;
+        while (pos < buffer.size() && !is_whitespace(buffer[pos]))
+          ++pos;
+
+        word.assign( buffer.begin() + static_cast<long>(begin), buffer.begin() + static_cast<long>(pos) );
+        return true;
+      }
+
+    private:
+
+      static bool is_whitespace(char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\f' || c == '\v'; }
+
+      char comment_char;
+      std::vector<char> buffer;
+      std::size_t pos;
+    };
+
+  } //namespace io
+} //namespace viennagrid
+
+#endif
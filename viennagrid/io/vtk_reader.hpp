@@ -23,6 +23,7 @@
 #include <sstream>
 #include <vector>
 #include <deque>
+#include <map>
 #include <string>
 #include <algorithm>
 
@@ -32,11 +33,80 @@
 #include "viennagrid/io/helper.hpp"
 #include "viennagrid/io/xml_tag.hpp"
 #include "viennagrid/mesh/element_creation.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 namespace viennagrid
 {
   namespace io
   {
+    namespace detail
+    {
+      /** @brief Reads the collection of a .pvd file.
+       *
+       * @param filename    Name of the .pvd file
+       * @return            The file names of the .vtu files of the collection by part number. The file names include the path of the .pvd file.
+       */
+      inline std::map<int, std::string> read_vtk_collection(std::string const & filename)
+      {
+        std::map<int, std::string> filenames;
+
+        //extract path from .pvd file:
+        std::string::size_type pos = filename.rfind("/");
+        std::string path_to_pvd;
+        if (pos == std::string::npos)
+          pos = filename.rfind("\\"); //a tribute to Windows... ;-)
+
+        if (pos != std::string::npos)
+          path_to_pvd = filename.substr(0, pos + 1);
+
+        std::ifstream reader(filename.c_str());
+        if (!reader)
+          throw cannot_open_file_exception("* ViennaGrid: vtk_reader::openFile(): File " + filename + ": Cannot open file!");
+
+        xml_tag<> tag;
+
+        tag.parse(reader);
+        if (tag.name() != "?xml" && tag.name() != "?xml?")
+          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: No opening <?xml?> tag!");
+
+        tag.parse(reader);
+        if (tag.name() != "vtkfile")
+          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: VTKFile tag expected!");
+
+        if (!tag.has_attribute("type"))
+          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: VTKFile tag has no attribute 'type'!");
+
+        if (string_to_lower(tag.get_value("type")) != "collection")
+          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: Type-attribute of VTKFile tag is not 'Collection'!");
+
+        tag.parse(reader);
+        if (tag.name() != "collection")
+          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: Collection tag expected!");
+
+        while (reader.good())
+        {
+          tag.parse(reader);
+
+          if (tag.name() == "/collection")
+            break;
+
+          if (tag.name() != "dataset")
+            throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: DataSet tag expected!");
+
+          if (!tag.has_attribute("file"))
+            throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: DataSet tag has no file attribute!");
+
+          filenames[ atoi(tag.get_value("part").c_str()) ] = path_to_pvd + tag.get_value("file");
+        }
+
+        tag.parse(reader);
+        if (tag.name() != "/vtkfile")
+          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: Closing VTKFile tag expected!");
+
+        return filenames;
+      }
+    }
+
 
     /** @brief A VTK reader class that allows to read meshes from XML-based VTK files as defined in http://www.vtk.org/pdf/file-formats.pdf
      *
@@ -395,6 +465,7 @@ namespace viennagrid
       /** @brief Pushes the vertices read to the mesh */
       void setupVertices(MeshType & mesh_obj)
       {
+        VIENNAGRID_INSTRUMENT_SCOPE("vtk_reader: setup vertices");
         for (std::size_t i=0; i<global_points_2.size(); ++i)
           viennagrid::make_vertex_with_id( mesh_obj, typename VertexType::id_type(typename VertexType::id_type::base_id_type(i)), global_points_2[i] );
       }
@@ -402,6 +473,7 @@ namespace viennagrid
       /** @brief Pushes the cells read to the mesh. Preserves segment information. */
       void setupCells(MeshType & mesh_obj, SegmentationType & segmentation, segment_id_type seg_id)
       {
+        VIENNAGRID_INSTRUMENT_SCOPE("vtk_reader: setup cells");
         //***************************************************
         // building up the cells in ViennaGrid
         // -------------------------------------------------
@@ -671,6 +743,7 @@ namespace viennagrid
       /** @brief Writes all data read from files to the mesh */
       void setupData(MeshType & mesh_obj, SegmentationType & segmentation, segment_id_type seg_id)
       {
+        VIENNAGRID_INSTRUMENT_SCOPE("vtk_reader: setup data");
         for (size_t i=0; i<local_scalar_vertex_data[seg_id].size(); ++i)
         {
           setupDataVertex(mesh_obj, segmentation[seg_id], seg_id, local_scalar_vertex_data[seg_id][i], 1);
@@ -697,6 +770,7 @@ namespace viennagrid
       /** @brief Parses a .vtu file referring to a segment of the mesh */
       void parse_vtu_segment(std::string filename, segment_id_type seg_id)
       {
+        VIENNAGRID_INSTRUMENT_SCOPE("vtk_reader: parse");
 
         try
         {
@@ -802,76 +876,16 @@ namespace viennagrid
       /** @brief Processes a .pvd file containing the links to the segments stored in individual .vtu files */
       void process_pvd(std::string const & filename)
       {
-        std::map<int, std::string> filenames;
-
-        //extract path from .pvd file:
-        std::string::size_type pos = filename.rfind("/");
-        std::string path_to_pvd;
-        if (pos == std::string::npos)
-          pos = filename.rfind("\\"); //a tribute to Windows... ;-)
-
-        if (pos != std::string::npos)
-          path_to_pvd = filename.substr(0, pos + 1);
-
-        openFile(filename);
-
-        //
-        // Step 1: Get segments from pvd file:
-        //
-        xml_tag<> tag;
-
-        tag.parse(reader);
-        if (tag.name() != "?xml" && tag.name() != "?xml?")
-          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: No opening <?xml?> tag!");
-
-        tag.parse(reader);
-        if (tag.name() != "vtkfile")
-          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: VTKFile tag expected!");
-
-        if (!tag.has_attribute("type"))
-          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: VTKFile tag has no attribute 'type'!");
-
-        if (string_to_lower(tag.get_value("type")) != "collection")
-          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: Type-attribute of VTKFile tag is not 'Collection'!");
-
-        tag.parse(reader);
-        if (tag.name() != "collection")
-          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: Collection tag expected!");
-
-        while (reader.good())
-        {
-          tag.parse(reader);
-
-          if (tag.name() == "/collection")
-            break;
-
-          if (tag.name() != "dataset")
-            throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: DataSet tag expected!");
-
-          if (!tag.has_attribute("file"))
-            throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: DataSet tag has no file attribute!");
-
-          filenames[ atoi(tag.get_value("part").c_str()) ] = tag.get_value("file");
-
-        }
-
-        tag.parse(reader);
-        if (tag.name() != "/vtkfile")
-          throw bad_file_format_exception("* ViennaGrid: vtk_reader::process_pvd(): Parse error: Closing VTKFile tag expected!");
-
-        closeFile();
+        std::map<int, std::string> filenames = detail::read_vtk_collection(filename);
 
         assert(filenames.size() > 0 && "No segments in pvd-file specified!");
 
-        //
-        // Step 2: Parse .vtu files:
-        //
         for (std::map<int, std::string>::iterator it = filenames.begin(); it != filenames.end(); ++it)
         {
           #if defined VIENNAGRID_DEBUG_ALL || defined VIENNAGRID_DEBUG_IO
-          std::cout << "Parsing file " << path_to_pvd + it->second << std::endl;
+          std::cout << "Parsing file " << it->second << std::endl;
           #endif
-          parse_vtu_segment(path_to_pvd + it->second, it->first);
+          parse_vtu_segment(it->second, it->first);
         }
 
       }
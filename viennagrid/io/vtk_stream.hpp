@@ -0,0 +1,128 @@
+#ifndef VIENNAGRID_IO_VTK_STREAM_HPP
+#define VIENNAGRID_IO_VTK_STREAM_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <map>
+#include <vector>
+#include <string>
+#include <sstream>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/io/vtk_reader.hpp"
+#include "viennagrid/io/vtk_writer.hpp"
+
+/** @file viennagrid/io/vtk_stream.hpp
+    @brief Piece-by-piece processing of multi-piece VTK datasets (.pvd collections of .vtu files) with bounded memory
+*/
+
+namespace viennagrid
+{
+  namespace io
+  {
+
+    /** @brief Reads the pieces of a VTK dataset one after another, each into a standalone mesh, and passes them to a functor.
+     *
+     * In contrast to vtk_reader, the pieces of a .pvd file are not merged into one mesh: Each piece is read into a new mesh by its own vtk_reader,
+     * which is released before the next piece is read. Thus, the peak memory is bounded by the largest piece.
+     * The functor is called as functor(part, piece_mesh, piece_reader), where part is the part number of the piece in the .pvd file.
+     * The data read for the piece is available from piece_reader as data of segment 0, e.g. piece_reader.vertex_scalar_field(name, 0).
+     * A .vtu file is processed as a single piece with part number 0.
+     *
+     * @tparam MeshT          The mesh type of a piece
+     * @param  filename       Name of the .pvd or .vtu file
+     * @param  functor        The functor called for each piece
+     * @return                The number of pieces processed
+     */
+    template<typename MeshT, typename FunctorT>
+    std::size_t stream_vtk_pieces(std::string const & filename, FunctorT & functor)
+    {
+      std::string::size_type pos  = filename.rfind(".")+1;
+      std::string extension = filename.substr(pos, filename.size());
+
+      std::map<int, std::string> filenames;
+      if (extension == "pvd")
+        filenames = detail::read_vtk_collection(filename);
+      else
+        filenames[0] = filename;
+
+      for (std::map<int, std::string>::const_iterator it = filenames.begin(); it != filenames.end(); ++it)
+      {
+        MeshT piece_mesh;
+        vtk_reader<MeshT> piece_reader;
+        piece_reader(piece_mesh, it->second);
+
+        functor(it->first, piece_mesh, piece_reader);
+      }
+
+      return filenames.size();
+    }
+
+
+
+    /** @brief Writes a VTK dataset piece by piece, e.g. the pieces streamed by stream_vtk_pieces(). Only the part numbers of the pieces written are kept in memory.
+     *
+     * Each piece is written to filename_<part>.vtu immediately, finish() writes the collection filename_main.pvd referring to all pieces.
+     * The data of a piece is registered at piece_writer() before the piece is written, see vtk_writer.
+     *
+     * @tparam MeshT          The mesh type of a piece
+     */
+    template<typename MeshT>
+    class vtk_stream_writer
+    {
+    public:
+      typedef vtk_writer<MeshT> piece_writer_type;
+
+      /** @brief Constructor
+       *
+       * @param filename    The base name of the files written
+       */
+      explicit vtk_stream_writer(std::string const & filename) : filename_(filename) {}
+
+      /** @brief Returns the writer used for the next piece. Data registered at this writer is written with the next piece only. */
+      piece_writer_type & piece_writer() { return writer_; }
+
+      /** @brief Writes a piece to filename_<part>.vtu
+       *
+       * @param piece_mesh    The mesh of the piece
+       * @param part          The part number of the piece, must be unique
+       */
+      void operator()(MeshT const & piece_mesh, int part)
+      {
+        std::stringstream ss;
+        ss << filename_ << "_" << part;
+        writer_(piece_mesh, ss.str());
+
+        parts_.push_back(part);
+      }
+
+      /** @brief Writes the collection filename_main.pvd referring to all pieces written so far */
+      void finish()
+      {
+        if ( !detail::write_vtk_collection(filename_, parts_.begin(), parts_.end()) )
+          throw cannot_open_file_exception("* ViennaGrid: vtk_stream_writer::finish(): File " + filename_ + ": Cannot open file!");
+      }
+
+      /** @brief Returns the number of pieces written so far */
+      std::size_t size() const { return parts_.size(); }
+
+    private:
+      std::string filename_;
+      piece_writer_type writer_;
+      std::vector<int> parts_;
+    };
+
+  }
+}
+
+#endif
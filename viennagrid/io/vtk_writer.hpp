@@ -17,12 +17,14 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
 
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/mesh/segmentation.hpp"
 #include "viennagrid/mesh/mesh.hpp"
 #include "viennagrid/io/helper.hpp"
 #include "viennagrid/io/vtk_common.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 /** @file viennagrid/io/vtk_writer.hpp
     @brief Provides a writer to VTK files
@@ -65,6 +67,47 @@ namespace viennagrid
     };
 
 
+    namespace detail
+    {
+      /** @brief Writes the .pvd file of a collection of .vtu files. The .pvd file is named filename_main.pvd, the .vtu file of a part is expected at filename_<part>.vtu
+       *
+       * @param filename      The base name of the files
+       * @param parts_begin   Iterator to the first part number
+       * @param parts_end     Iterator past the last part number
+       * @return              false if the file cannot be opened
+       */
+      template<typename PartIteratorT>
+      bool write_vtk_collection(std::string const & filename, PartIteratorT parts_begin, PartIteratorT parts_end)
+      {
+        std::stringstream ss;
+        ss << filename << "_main.pvd";
+        std::ofstream writer(ss.str().c_str());
+
+        std::string short_filename = filename;
+        std::string::size_type pos = filename.rfind("/");
+        if (pos == std::string::npos)
+          pos = filename.rfind("\\");   //A tribute to Windows
+
+        if (pos != std::string::npos)
+          short_filename = filename.substr(pos+1, filename.size());
+
+        if (!writer)
+          return false;
+
+        writer << "<?xml version=\"1.0\"?>" << std::endl;
+        writer << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\" compressor=\"vtkZLibDataCompressor\">" << std::endl;
+        writer << "<Collection>" << std::endl;
+
+        for (PartIteratorT it = parts_begin; it != parts_end; ++it)
+          writer << "    <DataSet part=\"" << *it << "\" file=\"" << short_filename << "_" << *it << ".vtu\" name=\"Segment_" << *it << "\"/>" << std::endl;
+
+        writer << "  </Collection>" << std::endl;
+        writer << "</VTKFile>" << std::endl;
+        return true;
+      }
+    }
+
+
     /////////////////// VTK export ////////////////////////////
 
     //helper: translate element tags to VTK-element types
@@ -236,6 +279,7 @@ namespace viennagrid
       template <typename MeshSegmentHandleT>
       void writePoints(MeshSegmentHandleT const & domseg, std::ofstream & writer, segment_id_type seg_id)
       {
+        VIENNAGRID_INSTRUMENT_SCOPE("vtk_writer: write points");
         std::map< VertexIDType, ConstVertexHandleType > & current_used_vertex_map = used_vertex_map[seg_id];
 
         writer << "   <Points>" << std::endl;
@@ -261,6 +305,7 @@ namespace viennagrid
       template <typename MeshSegmentHandleT>
       void writeCells(MeshSegmentHandleT const & domseg, std::ofstream & writer, segment_id_type seg_id)
       {
+        VIENNAGRID_INSTRUMENT_SCOPE("vtk_writer: write cells");
         typedef typename viennagrid::result_of::const_element_range<CellType, vertex_tag>::type      VertexOnCellRange;
         typedef typename viennagrid::result_of::iterator<VertexOnCellRange>::type         VertexOnCellIterator;
 
@@ -333,6 +378,7 @@ namespace viennagrid
       template <typename SegmentHandleT, typename IOAccessorType>
       void writePointData(SegmentHandleT const & segment, std::ofstream & writer, std::string const & name, IOAccessorType const & accessor, segment_id_type seg_id)
       {
+        VIENNAGRID_INSTRUMENT_SCOPE("vtk_writer: write vertex data");
         typedef typename IOAccessorType::value_type ValueType;
 
         writer << "    <DataArray type=\"" << ValueTypeInformation<ValueType>::type_name() << "\" Name=\"" << name <<
@@ -354,6 +400,7 @@ namespace viennagrid
       template <typename SegmentHandleT, typename IOAccessorType>
       void writeCellData(SegmentHandleT const & segment, std::ofstream & writer, std::string const & name, IOAccessorType const & accessor, segment_id_type seg_id)
       {
+        VIENNAGRID_INSTRUMENT_SCOPE("vtk_writer: write cell data");
         typedef typename IOAccessorType::value_type ValueType;
 
         writer << "    <DataArray type=\"" << ValueTypeInformation<ValueType>::type_name() << "\" Name=\"" << name <<
@@ -464,36 +511,15 @@ namespace viennagrid
           // Step 1: Write meta information
           //
           {
-            std::stringstream ss;
-            ss << filename << "_main.pvd";
-            std::ofstream writer(ss.str().c_str());
-
-            std::string short_filename = filename;
-            std::string::size_type pos = filename.rfind("/");
-            if (pos == std::string::npos)
-              pos = filename.rfind("\\");   //A tribute to Windows
-
-            if (pos != std::string::npos)
-              short_filename = filename.substr(pos+1, filename.size());
+            std::vector<segment_id_type> segment_ids;
+            for (typename SegmentationType::const_iterator it = segmentation.begin(); it != segmentation.end(); ++it)
+              segment_ids.push_back( (*it).id() );
 
-            if (!writer){
+            if ( !detail::write_vtk_collection(filename, segment_ids.begin(), segment_ids.end()) )
+            {
               clear();
               throw cannot_open_file_exception("* ViennaGrid: vtk_writer::operator(): File " + filename + ": Cannot open file!");
             }
-
-            writer << "<?xml version=\"1.0\"?>" << std::endl;
-            writer << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\" compressor=\"vtkZLibDataCompressor\">" << std::endl;
-            writer << "<Collection>" << std::endl;
-
-            for (typename SegmentationType::const_iterator it = segmentation.begin(); it != segmentation.end(); ++it)
-            {
-              SegmentHandleType const & seg = *it;
-              writer << "    <DataSet part=\"" << seg.id() << "\" file=\"" << short_filename << "_" << seg.id() << ".vtu\" name=\"Segment_" << seg.id() << "\"/>" << std::endl;
-            }
-
-            writer << "  </Collection>" << std::endl;
-            writer << "</VTKFile>" << std::endl;
-            writer.close();
           }
 
           //
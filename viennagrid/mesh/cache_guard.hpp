@@ -0,0 +1,123 @@
+#ifndef VIENNAGRID_MESH_CACHE_GUARD_HPP
+#define VIENNAGRID_MESH_CACHE_GUARD_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#if defined(_MSC_VER) && !defined(__clang__)
+  #include <intrin.h>
+#endif
+
+#include "viennagrid/storage/mutex.hpp"
+
+/** @file viennagrid/mesh/cache_guard.hpp
+    @brief Synchronization of the lazily built caches (coboundary, neighbor, boundary and interface information) of meshes and segments
+
+    The caches are built on first use inside const query functions. Concurrent queries on a shared mesh are safe, no matter whether the threads are created by OpenMP, std::thread or POSIX threads:
+    An up-to-date cache is detected without locking, a stale cache is rebuilt by exactly one thread while holding a process-wide lock (see storage/mutex.hpp).
+    The lock-free detection requires atomic loads and stores, which are available for GCC (4.7 or higher), Clang and Visual C++, and for other compilers if VIENNAGRID_WITH_OPENMP is defined.
+    With other compilers, or if in doubt, call the prepare_* functions (e.g. prepare_coboundary()) before sharing a mesh between threads, afterwards all queries are read-only.
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+    /** @brief For internal use only. Reads a change counter of a cache, later reads of the cache cannot be reordered before this read. */
+    template<typename T>
+    T load_acquire(T const & value) { return __atomic_load_n(&value, __ATOMIC_ACQUIRE); }
+
+    /** @brief For internal use only. Writes a change counter of a cache after all writes to the cache are visible to other threads. */
+    template<typename T>
+    void store_release(T & value, T new_value) { __atomic_store_n(&value, new_value, __ATOMIC_RELEASE); }
+#elif defined(_MSC_VER)
+    // volatile accesses have acquire/release semantics with Visual C++ (/volatile:ms), the barrier prevents reordering by the compiler
+    template<typename T>
+    T load_acquire(T const & value)
+    {
+      T result = *static_cast<T const volatile *>(&value);
+      _ReadWriteBarrier();
+      return result;
+    }
+
+    template<typename T>
+    void store_release(T & value, T new_value)
+    {
+      _ReadWriteBarrier();
+      *static_cast<T volatile *>(&value) = new_value;
+    }
+#elif defined(VIENNAGRID_WITH_OPENMP)
+    template<typename T>
+    T load_acquire(T const & value)
+    {
+      T result = value;
+      #pragma omp flush
+      return result;
+    }
+
+    template<typename T>
+    void store_release(T & value, T new_value)
+    {
+      #pragma omp flush
+      value = new_value;
+    }
+#else
+    template<typename T>
+    T load_acquire(T const & value) { return value; }
+
+    template<typename T>
+    void store_release(T & value, T new_value) { value = new_value; }
+#endif
+
+
+    /** @brief For internal use only. Holds the process-wide lock for (re-)building caches during its lifetime.
+      *
+      * The lock is a recursive mutex, since building a cache might query other caches (e.g. the interface detection uses the boundary information).
+      * It is independent of OpenMP, hence also threads created by other means are serialized.
+      */
+    class cache_update_guard
+    {
+    public:
+      cache_update_guard() { mutex().lock(); }
+      ~cache_update_guard() { mutex().unlock(); }
+
+    private:
+      cache_update_guard(cache_update_guard const &);
+      cache_update_guard & operator=(cache_update_guard const &);
+
+      static recursive_mutex & mutex()
+      {
+        // the recursive mutex is created on first use while holding a statically initialized mutex, thus creation is safe without thread-safe initialization of local statics.
+        // Afterwards it is obtained from the published pointer without locking.
+        static recursive_mutex * published = NULL;
+        recursive_mutex * result = load_acquire(published);
+        if (!result)
+        {
+          static static_mutex creation_mutex = VIENNAGRID_STATIC_MUTEX_INITIALIZER;
+          scoped_lock<static_mutex> lock(creation_mutex);
+
+          result = published;
+          if (!result)
+          {
+            static recursive_mutex mutex_;
+            result = &mutex_;
+            store_release(published, result);
+          }
+        }
+        return *result;
+      }
+    };
+  }
+}
+
+#endif
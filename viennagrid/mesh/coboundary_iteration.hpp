@@ -17,6 +17,7 @@
 #include "viennagrid/storage/forwards.hpp"
 #include "viennagrid/mesh/mesh.hpp"
 #include "viennagrid/accessor.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 /** @file viennagrid/mesh/coboundary_iteration.hpp
     @brief Contains definition and implementation of coboundary iteration
@@ -175,6 +176,7 @@ namespace viennagrid
     template<typename element_type_or_tag, typename coboundary_type_or_tag, typename MeshT, typename coboundary_accessor_type>
     void create_coboundary_information(MeshT & mesh_obj, coboundary_accessor_type accessor)
     {
+      VIENNAGRID_INSTRUMENT_SCOPE("coboundary: create");
       typedef typename viennagrid::result_of::element_tag< element_type_or_tag >::type element_tag;
 
       typedef typename viennagrid::result_of::element< MeshT, coboundary_type_or_tag >::type coboundary_type;
@@ -210,6 +212,7 @@ namespace viennagrid
     template<typename element_type_or_tag, typename coboundary_type_or_tag, typename WrappedConfigT, typename ElementTypelistT, typename ContainerConfigT, typename coboundary_accessor_type>
     void create_coboundary_information(viennagrid::mesh< viennagrid::detail::decorated_mesh_view_config<WrappedConfigT, ElementTypelistT, ContainerConfigT> > & mesh_obj, coboundary_accessor_type accessor)
     {
+      VIENNAGRID_INSTRUMENT_SCOPE("coboundary: create on view");
       typedef viennagrid::mesh< viennagrid::detail::decorated_mesh_view_config<WrappedConfigT, ElementTypelistT, ContainerConfigT> > ViewType;
       typedef typename viennagrid::result_of::element_tag< element_type_or_tag >::type element_tag;
 
@@ -251,6 +254,38 @@ namespace viennagrid
 
 
 
+    /** @brief For internal use only. Counts the elements with an ID not smaller than id_bound. */
+    template<typename ElementTypeOrTagT, typename MeshT>
+    std::size_t count_elements_from_id(MeshT & mesh_obj, long id_bound)
+    {
+      typedef typename viennagrid::result_of::element_range< MeshT, ElementTypeOrTagT >::type element_range_type;
+      typedef typename viennagrid::result_of::iterator< element_range_type >::type element_range_iterator;
+
+      std::size_t count = 0;
+      element_range_type elements(mesh_obj);
+      for ( element_range_iterator it = elements.begin(); it != elements.end(); ++it )
+        if ( static_cast<long>((*it).id().get()) >= id_bound )
+          ++count;
+      return count;
+    }
+
+    /** @brief For internal use only. Records the element counts and ID bounds of a mesh, which are needed to extend the coboundary information after insertions. */
+    template<typename ElementTagT, typename CoboundaryTagT, typename WrappedConfigT, typename CoboundaryContainerWrapperT>
+    void store_coboundary_state(viennagrid::mesh<WrappedConfigT> const & mesh_obj, CoboundaryContainerWrapperT & coboundary_container_wrapper)
+    {
+      coboundary_container_wrapper.structure_change_counter = mesh_obj.change_counters().structure();
+      coboundary_container_wrapper.element_count            = viennagrid::elements<ElementTagT>(mesh_obj).size();
+      coboundary_container_wrapper.coboundary_element_count = viennagrid::elements<CoboundaryTagT>(mesh_obj).size();
+      coboundary_container_wrapper.element_id_bound            = static_cast<long>( viennagrid::id_upper_bound<ElementTagT>(mesh_obj).get() );
+      coboundary_container_wrapper.coboundary_element_id_bound = static_cast<long>( viennagrid::id_upper_bound<CoboundaryTagT>(mesh_obj).get() );
+    }
+
+    /** @brief For internal use only. Mesh views do not have ID generators, their coboundary information is always re-created. */
+    template<typename ElementTagT, typename CoboundaryTagT, typename WrappedConfigT, typename ElementTypelistT, typename ContainerConfigT, typename CoboundaryContainerWrapperT>
+    void store_coboundary_state(viennagrid::mesh< viennagrid::detail::decorated_mesh_view_config<WrappedConfigT, ElementTypelistT, ContainerConfigT> > const &, CoboundaryContainerWrapperT &)
+    {}
+
+
     /** @brief For internal use only */
     template<typename element_type_or_tag, typename coboundary_type_or_tag, typename mesh_type>
     void create_coboundary_information(mesh_type & mesh_obj)
@@ -270,16 +305,141 @@ namespace viennagrid
         coboundary_container_wrapper_type & coboundary_container_wrapper = detail::coboundary_collection<element_tag, coboundary_tag>(mesh_obj);//viennagrid::storage::detail::get< viennagrid::static_pair<element_tag, coboundary_tag> > ( mesh_obj.coboundary_collection() );
 
         create_coboundary_information<element_type_or_tag, coboundary_type_or_tag>( mesh_obj, viennagrid::make_accessor<element_type>(coboundary_container_wrapper.container) );
-        detail::update_change_counter( mesh_obj, coboundary_container_wrapper.change_counter );
+        store_coboundary_state<element_tag, coboundary_tag>( mesh_obj, coboundary_container_wrapper );
+        detail::update_dependency_change_counter< typename viennagrid::make_typelist<element_tag, coboundary_tag>::type >( mesh_obj, coboundary_container_wrapper.change_counter );
     }
 
 
 
+    /** @brief For internal use only. Extends the coboundary information by the elements inserted since it was created.
+      *
+      * All elements which were present when the coboundary information was created have an ID smaller than the recorded ID bound.
+      * If no element was deleted since then and all new elements have IDs not smaller than this bound, only the new elements have to be processed.
+      *
+      * @return false if the coboundary information cannot be extended and has to be re-created
+      */
+    template<typename ElementTypeOrTagT, typename CoboundaryTypeOrTagT, typename WrappedConfigT>
+    bool extend_coboundary_information(viennagrid::mesh<WrappedConfigT> & mesh_obj)
+    {
+      VIENNAGRID_INSTRUMENT_SCOPE("coboundary: extend");
+      typedef viennagrid::mesh<WrappedConfigT> mesh_type;
+      typedef typename viennagrid::result_of::element_tag< ElementTypeOrTagT >::type element_tag;
+      typedef typename viennagrid::result_of::element_tag< CoboundaryTypeOrTagT >::type coboundary_tag;
+      typedef typename viennagrid::result_of::element< mesh_type, element_tag >::type element_type;
+      typedef typename viennagrid::result_of::element< mesh_type, coboundary_tag >::type coboundary_type;
 
+      typedef typename viennagrid::detail::result_of::lookup<
+              typename viennagrid::detail::result_of::lookup<
+                  typename mesh_type::appendix_type,
+                  coboundary_collection_tag
+              >::type,
+              viennagrid::static_pair<element_tag, coboundary_tag>
+              >::type coboundary_container_wrapper_type;
+      coboundary_container_wrapper_type & coboundary_container_wrapper = detail::coboundary_collection<element_tag, coboundary_tag>(mesh_obj);
+
+      if ( coboundary_container_wrapper.structure_change_counter != mesh_obj.change_counters().structure() )
+        return false;
+
+      std::size_t element_count            = viennagrid::elements<element_tag>(mesh_obj).size();
+      std::size_t coboundary_element_count = viennagrid::elements<coboundary_tag>(mesh_obj).size();
+      if ( element_count < coboundary_container_wrapper.element_count ||
+           coboundary_element_count < coboundary_container_wrapper.coboundary_element_count )
+        return false;
+
+      long element_id_bound            = coboundary_container_wrapper.element_id_bound;
+      long coboundary_element_id_bound = coboundary_container_wrapper.coboundary_element_id_bound;
+
+      // new elements with an ID below the bound (explicitly set IDs) cannot be told apart from old ones
+      if ( count_elements_from_id<element_tag>(mesh_obj, element_id_bound) != element_count - coboundary_container_wrapper.element_count ||
+           count_elements_from_id<coboundary_tag>(mesh_obj, coboundary_element_id_bound) != coboundary_element_count - coboundary_container_wrapper.coboundary_element_count )
+        return false;
+
+      typename viennagrid::result_of::accessor<typename coboundary_container_wrapper_type::container_type, element_type>::type accessor =
+          viennagrid::make_accessor<element_type>(coboundary_container_wrapper.container);
+
+      typedef typename viennagrid::result_of::element_range< mesh_type, element_tag >::type element_range_type;
+      typedef typename viennagrid::result_of::iterator< element_range_type >::type element_range_iterator;
 
+      element_range_type elements(mesh_obj);
+      for ( element_range_iterator it = elements.begin(); it != elements.end(); ++it )
+      {
+        if ( static_cast<long>((*it).id().get()) < element_id_bound )
+          continue;
 
+        accessor( *it ).clear();
+        accessor( *it ).set_base_container( viennagrid::get< coboundary_type >( element_collection(mesh_obj) ) );
+      }
+
+      typedef typename viennagrid::result_of::element_range< mesh_type, coboundary_tag >::type coboundary_element_range_type;
+      typedef typename viennagrid::result_of::iterator< coboundary_element_range_type >::type coboundary_element_range_iterator;
+
+      coboundary_element_range_type coboundary_elements(mesh_obj);
+      for (coboundary_element_range_iterator it = coboundary_elements.begin(); it != coboundary_elements.end(); ++it)
+      {
+        if ( static_cast<long>((*it).id().get()) < coboundary_element_id_bound )
+          continue;
+
+        typedef typename viennagrid::result_of::element_range< coboundary_type, element_tag >::type element_on_coboundary_element_range_type;
+        typedef typename viennagrid::result_of::iterator< element_on_coboundary_element_range_type >::type element_on_coboundary_element_range_iterator;
 
+        element_on_coboundary_element_range_type elements_on_coboundary_element( *it );
+        for (element_on_coboundary_element_range_iterator jt = elements_on_coboundary_element.begin(); jt != elements_on_coboundary_element.end(); ++jt)
+          accessor.at( *jt ).insert_handle( it.handle() );
+      }
 
+      store_coboundary_state<element_tag, coboundary_tag>( mesh_obj, coboundary_container_wrapper );
+      detail::update_dependency_change_counter< typename viennagrid::make_typelist<element_tag, coboundary_tag>::type >( mesh_obj, coboundary_container_wrapper.change_counter );
+      return true;
+    }
+
+    /** @brief For internal use only. Mesh views are not extended, see store_coboundary_state() */
+    template<typename ElementTypeOrTagT, typename CoboundaryTypeOrTagT, typename WrappedConfigT, typename ElementTypelistT, typename ContainerConfigT>
+    bool extend_coboundary_information(viennagrid::mesh< viennagrid::detail::decorated_mesh_view_config<WrappedConfigT, ElementTypelistT, ContainerConfigT> > &)
+    {
+      return false;
+    }
+
+
+
+
+
+
+
+
+
+
+
+    /** @brief For internal use only. Updates the coboundary information if elements of the element type or the coboundary type changed.
+      *
+      * After insertions the coboundary information of a mesh is extended by the new elements, otherwise it is re-created.
+      * Thread-safe, see viennagrid/mesh/cache_guard.hpp
+      */
+    template<typename ElementTypeOrTagT, typename CoboundaryTypeOrTagT, typename WrappedConfigT>
+    void prepare_coboundary_information(viennagrid::mesh<WrappedConfigT> const & mesh_obj)
+    {
+      typedef viennagrid::mesh<WrappedConfigT> mesh_type;
+      typedef typename viennagrid::result_of::element_tag< ElementTypeOrTagT >::type element_tag;
+      typedef typename viennagrid::result_of::element_tag< CoboundaryTypeOrTagT >::type coboundary_tag;
+
+      typedef typename viennagrid::detail::result_of::lookup<
+              typename viennagrid::detail::result_of::lookup<
+                  typename mesh_type::appendix_type,
+                  coboundary_collection_tag
+              >::type,
+              viennagrid::static_pair<element_tag, coboundary_tag>
+              >::type coboundary_container_wrapper_type;
+      coboundary_container_wrapper_type const & coboundary_container_wrapper = detail::coboundary_collection<element_tag, coboundary_tag>(mesh_obj);
+
+      typedef typename viennagrid::make_typelist<element_tag, coboundary_tag>::type dependency_taglist;
+
+      if ( detail::is_dependency_obsolete<dependency_taglist>(mesh_obj, coboundary_container_wrapper.change_counter) )
+      {
+        detail::cache_update_guard guard;
+        if ( detail::is_dependency_obsolete<dependency_taglist>(mesh_obj, coboundary_container_wrapper.change_counter) &&
+             !detail::extend_coboundary_information<element_tag, coboundary_tag>( const_cast<mesh_type&>(mesh_obj) ) )
+          detail::create_coboundary_information<ElementTypeOrTagT, CoboundaryTypeOrTagT>( const_cast<mesh_type&>(mesh_obj) );
+      }
+    }
 
 
 
@@ -350,8 +510,7 @@ namespace viennagrid
             >::type coboundary_container_wrapper_type;
     coboundary_container_wrapper_type & coboundary_container_wrapper = detail::coboundary_collection<element_tag, coboundary_tag>(mesh_obj);
 
-    if ( detail::is_obsolete(mesh_obj, coboundary_container_wrapper.change_counter) )
-      detail::create_coboundary_information<ElementTypeOrTagT, CoboundaryTypeOrTagT>(mesh_obj);
+    detail::prepare_coboundary_information<ElementTypeOrTagT, CoboundaryTypeOrTagT>(mesh_obj);
 
     return detail::coboundary_elements<ElementTypeOrTagT, CoboundaryTypeOrTagT>( viennagrid::make_accessor<element_type>(coboundary_container_wrapper.container), viennagrid::dereference_handle(mesh_obj, element_or_handle) );
   }
@@ -384,8 +543,7 @@ namespace viennagrid
             >::type coboundary_container_wrapper_type;
     coboundary_container_wrapper_type const & coboundary_container_wrapper = detail::coboundary_collection<element_tag, coboundary_tag>(mesh_obj);
 
-    if ( detail::is_obsolete(mesh_obj, coboundary_container_wrapper.change_counter) )
-      detail::create_coboundary_information<ElementTypeOrTagT, CoboundaryTypeOrTagT>( const_cast<mesh_type&>(mesh_obj) );
+    detail::prepare_coboundary_information<ElementTypeOrTagT, CoboundaryTypeOrTagT>(mesh_obj);
 
     return detail::coboundary_elements<ElementTypeOrTagT, CoboundaryTypeOrTagT>( viennagrid::make_accessor<element_type>(coboundary_container_wrapper.container), viennagrid::dereference_handle(mesh_obj, element_or_handle) );
   }
@@ -426,6 +584,34 @@ namespace viennagrid
     return coboundary_elements<ElementTypeOrTagT, CoboundaryTypeOrTagT>( segment.view(), element_or_handle );
   }
 
+
+
+  /** @brief Creates the coboundary information of a mesh if it is out of date. Call this function before querying coboundary ranges of a shared mesh from multiple threads, afterwards the queries do not modify the mesh.
+    *
+    * @tparam ElementTypeOrTagT       The base element type/tag of the coboundary ranges
+    * @tparam CoboundaryTypeOrTagT    The coboundary element type/tag
+    * @tparam WrappedConfigT          The wrapped config of the mesh
+    * @param  mesh_obj                The mesh object
+    */
+  template<typename ElementTypeOrTagT, typename CoboundaryTypeOrTagT, typename WrappedConfigT>
+  void prepare_coboundary(viennagrid::mesh<WrappedConfigT> const & mesh_obj)
+  {
+    detail::prepare_coboundary_information<ElementTypeOrTagT, CoboundaryTypeOrTagT>(mesh_obj);
+  }
+
+  /** @brief Creates the coboundary information of a segment if it is out of date. Call this function before querying coboundary ranges of a shared segment from multiple threads, afterwards the queries do not modify the segment.
+    *
+    * @tparam ElementTypeOrTagT       The base element type/tag of the coboundary ranges
+    * @tparam CoboundaryTypeOrTagT    The coboundary element type/tag
+    * @tparam SegmentationT           The segmentation type of the segment type
+    * @param  segment                 The segment object
+    */
+  template<typename ElementTypeOrTagT, typename CoboundaryTypeOrTagT, typename SegmentationT>
+  void prepare_coboundary(segment_handle<SegmentationT> const & segment)
+  {
+    detail::prepare_coboundary_information<ElementTypeOrTagT, CoboundaryTypeOrTagT>( segment.view() );
+  }
+
 }
 
 #endif
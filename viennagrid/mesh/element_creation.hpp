@@ -17,6 +17,7 @@
 #include "viennagrid/mesh/segmentation.hpp"
 #include "viennagrid/topology/plc.hpp"
 #include "viennagrid/algorithm/norm.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 /** @file viennagrid/mesh/element_creation.hpp
     @brief Contains functions for creating elements within a mesh or segment
@@ -202,6 +203,7 @@ namespace viennagrid
         typename result_of::point<MeshOrSegmentHandleTypeT>::type const & point,
         typename result_of::coord<MeshOrSegmentHandleTypeT>::type tolerance)
   {
+    VIENNAGRID_INSTRUMENT_SCOPE("make_unique_vertex: search");
     typedef typename result_of::element_range<MeshOrSegmentHandleTypeT, vertex_tag>::type vertex_range_type;
     typedef typename result_of::iterator<vertex_range_type>::type vertex_range_iterator;
 
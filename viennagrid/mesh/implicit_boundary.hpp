@@ -0,0 +1,376 @@
+#ifndef VIENNAGRID_MESH_IMPLICIT_BOUNDARY_HPP
+#define VIENNAGRID_MESH_IMPLICIT_BOUNDARY_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/mesh/mesh.hpp"
+#include "viennagrid/mesh/segmentation.hpp"
+#include "viennagrid/topology/simplex.hpp"
+#include "viennagrid/topology/quadrilateral.hpp"
+#include "viennagrid/topology/hexahedron.hpp"
+
+/** @file viennagrid/mesh/implicit_boundary.hpp
+    @brief Provides boundary elements (e.g. facets and edges) identified on demand from the vertices of the cells, mainly for thin meshes storing vertices and cells only
+
+    A boundary element is identified by a cell and its local index within the cell, using the same local numbering as the boundary elements of a full mesh.
+    The class implicit_boundary_elements assigns compact IDs to the distinct boundary elements and provides boundary and interface detection on top of them.
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+    /** @brief For internal use only. Local vertex indices of the boundary elements of a cell, following the reference orientation of the boundary element generators. */
+    template <typename CellTagT, typename BoundaryTagT>
+    struct implicit_boundary_layout;
+
+    /** @brief Boundary k-simplices of an n-simplex: all increasing (k+1)-tuples of local vertex indices in lexicographical order */
+    template <int n, int k>
+    struct implicit_boundary_layout< simplex_tag<n>, simplex_tag<k> >
+    {
+      static const int num = boundary_elements< simplex_tag<n>, simplex_tag<k> >::num;
+      static const int num_vertices = k+1;
+
+      static void fill(int * table)
+      {
+        int tuple[k+1];
+        for (int i = 0; i <= k; ++i)
+          tuple[i] = i;
+
+        for (int index = 0; index < num; ++index)
+        {
+          for (int i = 0; i <= k; ++i)
+            table[index * num_vertices + i] = tuple[i];
+
+          // next tuple
+          int pos = k;
+          while (pos >= 0 && tuple[pos] == n - k + pos)
+            --pos;
+          if (pos < 0)
+            break;
+          ++tuple[pos];
+          for (int i = pos+1; i <= k; ++i)
+            tuple[i] = tuple[i-1] + 1;
+        }
+      }
+    };
+
+    template <>
+    struct implicit_boundary_layout< quadrilateral_tag, line_tag >
+    {
+      static const int num = 4;
+      static const int num_vertices = 2;
+
+      static void fill(int * table)
+      {
+        static const int layout[] = { 0,1,  0,2,  1,3,  2,3 };
+        std::copy(layout, layout + num * num_vertices, table);
+      }
+    };
+
+    template <>
+    struct implicit_boundary_layout< hexahedron_tag, line_tag >
+    {
+      static const int num = 12;
+      static const int num_vertices = 2;
+
+      static void fill(int * table)
+      {
+        static const int layout[] = { 0,1,  0,2,  0,4,  1,3,  1,5,  2,3,  2,6,  3,7,  4,5,  4,6,  5,7,  6,7 };
+        std::copy(layout, layout + num * num_vertices, table);
+      }
+    };
+
+    template <>
+    struct implicit_boundary_layout< hexahedron_tag, quadrilateral_tag >
+    {
+      static const int num = 6;
+      static const int num_vertices = 4;
+
+      static void fill(int * table)
+      {
+        static const int layout[] = { 0,1,2,3,  0,1,4,5,  0,2,4,6,  1,3,5,7,  2,3,6,7,  4,5,6,7 };
+        std::copy(layout, layout + num * num_vertices, table);
+      }
+    };
+
+
+    /** @brief For internal use only. The sorted vertex IDs of a boundary element together with its cell-local position, used for identifying equal boundary elements by sorting. */
+    template <int num_vertices>
+    struct implicit_boundary_key
+    {
+      int vertex_ids[num_vertices];
+      std::size_t local_index;
+
+      bool operator<(implicit_boundary_key const & other) const
+      {
+        for (int i = 0; i < num_vertices; ++i)
+          if (vertex_ids[i] != other.vertex_ids[i])
+            return vertex_ids[i] < other.vertex_ids[i];
+        return local_index < other.local_index;
+      }
+
+      bool same_element(implicit_boundary_key const & other) const
+      {
+        return std::equal(vertex_ids, vertex_ids + num_vertices, other.vertex_ids);
+      }
+    };
+
+
+    template <bool is_facet>
+    struct implicit_boundary_detection;
+  }
+
+
+  /** @brief Boundary elements of the cells of a mesh or segment, which are not stored in the mesh but identified from the vertices of the cells.
+    *
+    * All distinct boundary elements are numbered consecutively from 0 to size()-1 (compact IDs) by sorting the vertex tuples of all cell-local boundary elements.
+    * Memory consumption is one compact ID per cell-local boundary element plus the vertices, the number of adjacent cells and up to two adjacent cells per boundary element.
+    * The object reflects the mesh at the time of construction, it has to be rebuilt after the mesh has been modified.
+    *
+    * @tparam MeshOrSegmentT    The mesh or segment type, usually a thin mesh
+    * @tparam BoundaryTagT      The tag of the boundary elements, e.g. triangle_tag for the facets of a tetrahedral mesh
+    */
+  template <typename MeshOrSegmentT, typename BoundaryTagT>
+  class implicit_boundary_elements
+  {
+    template <bool is_facet> friend struct detail::implicit_boundary_detection;
+
+  public:
+    typedef typename viennagrid::result_of::cell_tag<MeshOrSegmentT>::type        cell_tag;
+    typedef BoundaryTagT                                                          element_tag;
+    typedef typename viennagrid::result_of::cell<MeshOrSegmentT>::type            cell_type;
+    typedef typename viennagrid::result_of::vertex<MeshOrSegmentT>::type          vertex_type;
+    typedef std::size_t                                                           id_type;
+    typedef std::size_t                                                           size_type;
+
+    typedef detail::implicit_boundary_layout<cell_tag, element_tag>               layout_type;
+
+    /** @brief The number of boundary elements of each cell */
+    static const int num_per_cell = layout_type::num;
+    /** @brief The number of vertices of each boundary element */
+    static const int num_vertices = layout_type::num_vertices;
+
+    /** @brief Value returned by id() for cells not present in the mesh or segment */
+    static id_type invalid_id() { return std::numeric_limits<id_type>::max(); }
+
+    implicit_boundary_elements(MeshOrSegmentT const & mesh_or_segment)
+    {
+      layout_type::fill(layout_);
+      build(mesh_or_segment);
+    }
+
+    /** @brief Returns the number of distinct boundary elements */
+    size_type size() const { return cell_counts_.size(); }
+
+    /** @brief Returns the local vertex index within the cell of vertex 'vertex_index' of the cell-local boundary element 'local_index' */
+    int local_vertex(int local_index, int vertex_index) const { return layout_[local_index * num_vertices + vertex_index]; }
+
+    /** @brief Returns the compact ID of the boundary element with local index 'local_index' of a cell */
+    id_type id(cell_type const & cell, int local_index) const
+    {
+      std::size_t cell_index = static_cast<std::size_t>(cell.id().get());
+      if (cell_index >= cell_ids_end_)
+        return invalid_id();
+      return local_to_id_[cell_index * static_cast<std::size_t>(num_per_cell) + static_cast<std::size_t>(local_index)];
+    }
+
+    /** @brief Returns vertex 'vertex_index' of a boundary element, the vertices are in the local order of the first cell containing the boundary element */
+    vertex_type const & vertex(id_type id, int vertex_index) const
+    {
+      return *vertices_[id * static_cast<std::size_t>(num_vertices) + static_cast<std::size_t>(vertex_index)];
+    }
+
+    /** @brief Returns the number of cells sharing a boundary element */
+    size_type cell_count(id_type id) const { return cell_counts_[id]; }
+
+    /** @brief Returns one of the first two cells sharing a boundary element, 'index' must be smaller than min(2, cell_count(id)) */
+    cell_type const & cell(id_type id, size_type index) const { return *cells_[2*id + index]; }
+
+    /** @brief Returns true if the boundary element is on the boundary of the mesh or segment */
+    bool is_boundary(id_type id) const { return boundary_flags_[id]; }
+
+  private:
+    void build(MeshOrSegmentT const & mesh_or_segment)
+    {
+      typedef typename viennagrid::result_of::const_cell_range<MeshOrSegmentT>::type    CellRange;
+      typedef typename viennagrid::result_of::iterator<CellRange>::type                 CellIterator;
+      typedef detail::implicit_boundary_key<num_vertices>                               KeyType;
+
+      std::size_t const per_cell = static_cast<std::size_t>(num_per_cell);
+
+      cell_ids_end_ = static_cast<std::size_t>( viennagrid::id_upper_bound<cell_tag>(mesh_or_segment).get() );
+      local_to_id_.assign(cell_ids_end_ * per_cell, invalid_id());
+
+      CellRange cells(mesh_or_segment);
+
+      std::vector<cell_type const *> cell_pointers(cell_ids_end_, static_cast<cell_type const *>(NULL));
+      std::vector<KeyType> keys;
+      keys.reserve(cells.size() * per_cell);
+
+      for (CellIterator cit = cells.begin(); cit != cells.end(); ++cit)
+      {
+        std::size_t cell_index = static_cast<std::size_t>( (*cit).id().get() );
+        cell_pointers[cell_index] = &(*cit);
+
+        for (int i = 0; i < num_per_cell; ++i)
+        {
+          KeyType key;
+          for (int j = 0; j < num_vertices; ++j)
+            key.vertex_ids[j] = viennagrid::vertices(*cit)[ static_cast<std::size_t>(local_vertex(i, j)) ].id().get();
+          std::sort(key.vertex_ids, key.vertex_ids + num_vertices);
+          key.local_index = cell_index * per_cell + static_cast<std::size_t>(i);
+          keys.push_back(key);
+        }
+      }
+
+      std::sort(keys.begin(), keys.end());
+
+      cell_counts_.clear();
+      cells_.clear();
+      vertices_.clear();
+      for (std::size_t k = 0; k < keys.size(); ++k)
+      {
+        std::size_t cell_index = keys[k].local_index / per_cell;
+        cell_type const * cell = cell_pointers[cell_index];
+
+        if (k == 0 || !keys[k].same_element(keys[k-1]))
+        {
+          int local_index = static_cast<int>(keys[k].local_index % per_cell);
+          for (int j = 0; j < num_vertices; ++j)
+            vertices_.push_back( &viennagrid::vertices(*cell)[ static_cast<std::size_t>(local_vertex(local_index, j)) ] );
+
+          cell_counts_.push_back(0);
+          cells_.push_back(cell);
+          cells_.push_back(static_cast<cell_type const *>(NULL));
+        }
+
+        id_type id = cell_counts_.size() - 1;
+        if (cell_counts_[id] == 1)
+          cells_[2*id+1] = cell;
+        ++cell_counts_[id];
+        local_to_id_[ keys[k].local_index ] = id;
+      }
+
+      detail::implicit_boundary_detection<element_tag::dim + 1 == cell_tag::dim>::apply(mesh_or_segment, *this);
+    }
+
+    int layout_[num_per_cell * num_vertices];
+    std::size_t cell_ids_end_;
+    std::vector<id_type> local_to_id_;
+    std::vector<vertex_type const *> vertices_;
+    std::vector<unsigned int> cell_counts_;
+    std::vector<cell_type const *> cells_;
+    std::vector<bool> boundary_flags_;
+  };
+
+
+  namespace detail
+  {
+    /** @brief For internal use only. Facets are on the boundary if they belong to a single cell */
+    template <>
+    struct implicit_boundary_detection<true>
+    {
+      template <typename MeshOrSegmentT, typename BoundaryTagT>
+      static void apply(MeshOrSegmentT const &, implicit_boundary_elements<MeshOrSegmentT, BoundaryTagT> & elements)
+      {
+        elements.boundary_flags_.resize(elements.size());
+        for (std::size_t id = 0; id < elements.size(); ++id)
+          elements.boundary_flags_[id] = (elements.cell_counts_[id] == 1);
+      }
+    };
+
+    /** @brief For internal use only. Lower-dimensional boundary elements are on the boundary if all their vertices are vertices of a boundary facet of the same cell */
+    template <>
+    struct implicit_boundary_detection<false>
+    {
+      template <typename MeshOrSegmentT, typename BoundaryTagT>
+      static void apply(MeshOrSegmentT const & mesh_or_segment, implicit_boundary_elements<MeshOrSegmentT, BoundaryTagT> & elements)
+      {
+        typedef implicit_boundary_elements<MeshOrSegmentT, BoundaryTagT>                                      ElementsType;
+        typedef typename ElementsType::cell_tag                                                               CellTag;
+        typedef implicit_boundary_elements<MeshOrSegmentT, typename CellTag::facet_tag>                       FacetsType;
+        typedef typename viennagrid::result_of::const_cell_range<MeshOrSegmentT>::type                        CellRange;
+        typedef typename viennagrid::result_of::iterator<CellRange>::type                                     CellIterator;
+
+        FacetsType facets(mesh_or_segment);
+
+        elements.boundary_flags_.assign(elements.size(), false);
+
+        CellRange cells(mesh_or_segment);
+        for (CellIterator cit = cells.begin(); cit != cells.end(); ++cit)
+        {
+          for (int f = 0; f < FacetsType::num_per_cell; ++f)
+          {
+            if ( !facets.is_boundary(facets.id(*cit, f)) )
+              continue;
+
+            for (int i = 0; i < ElementsType::num_per_cell; ++i)
+            {
+              bool on_facet = true;
+              for (int j = 0; j < ElementsType::num_vertices && on_facet; ++j)
+              {
+                on_facet = false;
+                for (int k = 0; k < FacetsType::num_vertices; ++k)
+                  if (facets.local_vertex(f, k) == elements.local_vertex(i, j))
+                    on_facet = true;
+              }
+
+              if (on_facet)
+                elements.boundary_flags_[ elements.id(*cit, i) ] = true;
+            }
+          }
+        }
+      }
+    };
+  }
+
+
+  /** @brief Returns true if an implicit facet is on the interface of two segments, i.e. it is on the boundary of both segments. The implicit facets have to be built for the whole mesh.
+    *
+    * @param  facets        The implicit facets of the mesh
+    * @param  seg0          The first segment
+    * @param  seg1          The second segment
+    * @param  id            The compact ID of the facet
+    */
+  template <typename MeshT, typename BoundaryTagT, typename SegmentationT>
+  bool is_interface(implicit_boundary_elements<MeshT, BoundaryTagT> const & facets,
+                    segment_handle<SegmentationT> const & seg0,
+                    segment_handle<SegmentationT> const & seg1,
+                    typename implicit_boundary_elements<MeshT, BoundaryTagT>::id_type id)
+  {
+    typedef typename implicit_boundary_elements<MeshT, BoundaryTagT>::cell_type    CellType;
+
+    if (facets.cell_count(id) == 1)
+    {
+      CellType const & cell = facets.cell(id, 0);
+      return viennagrid::is_in_segment(seg0, cell) && viennagrid::is_in_segment(seg1, cell);
+    }
+
+    if (facets.cell_count(id) != 2)
+      return false;
+
+    CellType const & cell0 = facets.cell(id, 0);
+    CellType const & cell1 = facets.cell(id, 1);
+    return viennagrid::is_in_segment(seg0, cell0) != viennagrid::is_in_segment(seg0, cell1) &&
+           viennagrid::is_in_segment(seg1, cell0) != viennagrid::is_in_segment(seg1, cell1);
+  }
+
+}
+
+#endif
@@ -0,0 +1,720 @@
+#ifndef VIENNAGRID_MESH_MEMORY_USAGE_HPP
+#define VIENNAGRID_MESH_MEMORY_USAGE_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <deque>
+#include <list>
+#include <set>
+#include <map>
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <climits>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/mesh/mesh.hpp"
+#include "viennagrid/mesh/segmentation.hpp"
+#include "viennagrid/storage/chunked_vector.hpp"
+#include "viennagrid/storage/hidden_key_map.hpp"
+#include "viennagrid/element/element_key.hpp"
+
+/** @file viennagrid/mesh/memory_usage.hpp
+    @brief Memory footprint reports of meshes and segmentations and dropping of the lazily built caches
+
+    The reported numbers are estimates: Heap blocks of the standard containers are computed from the memory layout of libstdc++ (e.g. 512 byte buffers of std::deque, tree nodes of std::map with four words of node header),
+    the bookkeeping overhead of the allocator itself is not included.
+*/
+
+namespace viennagrid
+{
+  /** @brief The subsystems a memory_usage_report is broken down into */
+  enum memory_usage_category
+  {
+    memory_elements,          ///< The element objects including their vertex coordinates and IDs, without boundary handles and orientations
+    memory_boundary_handles,  ///< The handles of an element to its boundary elements
+    memory_orientations,      ///< The orientations of the boundary elements with respect to an element
+    memory_dedup_keys,        ///< The keys and tree nodes used for detecting duplicate elements (hidden_key_map)
+    memory_coboundary,        ///< The coboundary cache
+    memory_neighbor,          ///< The neighbor cache
+    memory_boundary_flags,    ///< The boundary information cache
+    memory_segment_views,     ///< The element views of segments and mesh views
+    memory_segment_mapping,   ///< The element-to-segment mapping of a segmentation
+    memory_interface_info,    ///< The interface information cache of a segmentation
+    memory_category_count
+  };
+
+
+  /** @brief A report of the memory used by a mesh or segmentation, broken down by subsystem and element type. Obtained by memory_usage(). */
+  class memory_usage_report
+  {
+  public:
+
+    /** @brief One line of the report: The memory used by one subsystem for one element type (or element type pair for coboundary and neighbor information) */
+    struct entry
+    {
+      memory_usage_category category;
+      std::string name;
+      std::size_t count;
+      std::size_t bytes;
+    };
+
+    typedef std::vector<entry> entry_container_type;
+
+
+    /** @brief Adds memory to the report. Memory added for the same category and name is accumulated in one entry. */
+    void add(memory_usage_category category, std::string const & name, std::size_t count, std::size_t bytes)
+    {
+      for (std::size_t i = 0; i < entries_.size(); ++i)
+      {
+        if (entries_[i].category == category && entries_[i].name == name)
+        {
+          entries_[i].count += count;
+          entries_[i].bytes += bytes;
+          return;
+        }
+      }
+
+      entry new_entry;
+      new_entry.category = category;
+      new_entry.name = name;
+      new_entry.count = count;
+      new_entry.bytes = bytes;
+      entries_.push_back(new_entry);
+    }
+
+    /** @brief Returns the total number of bytes of all entries */
+    std::size_t bytes() const
+    {
+      std::size_t result = 0;
+      for (std::size_t i = 0; i < entries_.size(); ++i)
+        result += entries_[i].bytes;
+      return result;
+    }
+
+    /** @brief Returns the number of bytes used by one subsystem */
+    std::size_t bytes(memory_usage_category category) const
+    {
+      std::size_t result = 0;
+      for (std::size_t i = 0; i < entries_.size(); ++i)
+        if (entries_[i].category == category)
+          result += entries_[i].bytes;
+      return result;
+    }
+
+    /** @brief Returns the number of bytes used by one subsystem for one element type, e.g. bytes(memory_elements, "triangle") */
+    std::size_t bytes(memory_usage_category category, std::string const & name) const
+    {
+      for (std::size_t i = 0; i < entries_.size(); ++i)
+        if (entries_[i].category == category && entries_[i].name == name)
+          return entries_[i].bytes;
+      return 0;
+    }
+
+    /** @brief Returns all entries of the report in the order they were added */
+    entry_container_type const & entries() const { return entries_; }
+
+    /** @brief Accumulates the entries of another report into this report */
+    memory_usage_report & operator+=(memory_usage_report const & other)
+    {
+      for (std::size_t i = 0; i < other.entries_.size(); ++i)
+        add(other.entries_[i].category, other.entries_[i].name, other.entries_[i].count, other.entries_[i].bytes);
+      return *this;
+    }
+
+    /** @brief Returns a printable name of a subsystem */
+    static std::string category_name(memory_usage_category category)
+    {
+      switch (category)
+      {
+        case memory_elements:         return "elements";
+        case memory_boundary_handles: return "boundary handles";
+        case memory_orientations:     return "orientations";
+        case memory_dedup_keys:       return "dedup keys";
+        case memory_coboundary:       return "coboundary";
+        case memory_neighbor:         return "neighbor";
+        case memory_boundary_flags:   return "boundary flags";
+        case memory_segment_views:    return "segment views";
+        case memory_segment_mapping:  return "segment mapping";
+        case memory_interface_info:   return "interface info";
+        default:                      return "unknown";
+      }
+    }
+
+  private:
+    entry_container_type entries_;
+  };
+
+  /** @brief Prints a memory_usage_report as a table, grouped by subsystem */
+  inline std::ostream & operator<<(std::ostream & os, memory_usage_report const & report)
+  {
+    typedef memory_usage_report::entry_container_type entry_container_type;
+    entry_container_type const & entries = report.entries();
+
+    os << std::left << std::setw(18) << "category" << std::setw(24) << "element"
+       << std::right << std::setw(12) << "count" << std::setw(14) << "bytes" << std::endl;
+
+    for (int category = 0; category < memory_category_count; ++category)
+      for (std::size_t i = 0; i < entries.size(); ++i)
+        if (entries[i].category == category)
+          os << std::left << std::setw(18) << memory_usage_report::category_name(entries[i].category) << std::setw(24) << entries[i].name
+             << std::right << std::setw(12) << entries[i].count << std::setw(14) << entries[i].bytes << std::endl;
+
+    os << std::left << std::setw(18) << "total" << std::setw(24) << ""
+       << std::right << std::setw(12) << "" << std::setw(14) << report.bytes() << std::endl;
+
+    return os;
+  }
+
+
+
+  namespace detail
+  {
+    /** @brief For internal use only. The size of the node header of the red-black tree of std::set and std::map (color, parent, left and right child) */
+    static const std::size_t tree_node_header_size = 4 * sizeof(void*);
+
+    /** @brief For internal use only. The size of the node header of std::list (previous and next node) */
+    static const std::size_t list_node_header_size = 2 * sizeof(void*);
+
+    // All overloads are declared first, since they call each other for nested containers
+
+    template<typename T>
+    std::size_t heap_memory(T const &);
+
+    template<typename T, typename AllocatorT>
+    std::size_t heap_memory(std::vector<T, AllocatorT> const & c);
+
+    template<typename AllocatorT>
+    std::size_t heap_memory(std::vector<bool, AllocatorT> const & c);
+
+    template<typename T, typename AllocatorT>
+    std::size_t heap_memory(std::deque<T, AllocatorT> const & c);
+
+    template<typename T, typename AllocatorT>
+    std::size_t heap_memory(std::list<T, AllocatorT> const & c);
+
+    template<typename KeyT, typename CompareT, typename AllocatorT>
+    std::size_t heap_memory(std::set<KeyT, CompareT, AllocatorT> const & c);
+
+    template<typename KeyT, typename ValueT, typename CompareT, typename AllocatorT>
+    std::size_t heap_memory(std::map<KeyT, ValueT, CompareT, AllocatorT> const & c);
+
+    template<typename T, int ChunkSizeV>
+    std::size_t heap_memory(viennagrid::chunked_vector<T, ChunkSizeV> const & c);
+
+    template<typename KeyT, typename ValueT, typename AllocatorT>
+    std::size_t heap_memory(viennagrid::hidden_key_map<KeyT, ValueT, AllocatorT> const & c);
+
+    template<typename BaseContainerT, typename HandleTagT>
+    std::size_t heap_memory(viennagrid::detail::container<BaseContainerT, HandleTagT> const & c);
+
+    template<typename BaseContainerT, typename ContainerTagT>
+    std::size_t heap_memory(viennagrid::view<BaseContainerT, ContainerTagT> const & v);
+
+    template<typename ElementTagT, typename WrappedConfigT>
+    std::size_t heap_memory(viennagrid::element<ElementTagT, WrappedConfigT> const & element);
+
+    template<typename ElementSegmentMappingT, typename ContainerTagT>
+    std::size_t heap_memory(segment_info_t<ElementSegmentMappingT, ContainerTagT> const & info);
+
+    template<typename ContainerT, typename ChangeCounterT>
+    std::size_t heap_memory(segment_interface_information_wrapper<ContainerT, ChangeCounterT> const & wrapper);
+
+
+    /** @brief For internal use only. Returns the heap memory used by std::deque for n elements of type T */
+    template<typename T>
+    std::size_t deque_memory(std::size_t n)
+    {
+      std::size_t const values_per_buffer = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+      std::size_t const buffer_count = n / values_per_buffer + 1;
+      std::size_t const map_size = std::max<std::size_t>(8, buffer_count + 2);
+      return buffer_count * values_per_buffer * sizeof(T) + map_size * sizeof(T*);
+    }
+
+    /** @brief For internal use only. Returns the heap memory of a range of objects, excluding the objects themselves */
+    template<typename IteratorT>
+    std::size_t heap_memory_of_range(IteratorT it, IteratorT const & it_end)
+    {
+      std::size_t result = 0;
+      for (; it != it_end; ++it)
+        result += heap_memory(*it);
+      return result;
+    }
+
+
+    /** @brief For internal use only. Returns the heap memory owned by an object, excluding sizeof(object). Objects not owning heap memory use this overload. */
+    template<typename T>
+    std::size_t heap_memory(T const &) { return 0; }
+
+    template<typename T, typename AllocatorT>
+    std::size_t heap_memory(std::vector<T, AllocatorT> const & c)
+    { return c.capacity() * sizeof(T) + heap_memory_of_range(c.begin(), c.end()); }
+
+    template<typename AllocatorT>
+    std::size_t heap_memory(std::vector<bool, AllocatorT> const & c)
+    { return (c.capacity() + CHAR_BIT - 1) / CHAR_BIT; }
+
+    template<typename T, typename AllocatorT>
+    std::size_t heap_memory(std::deque<T, AllocatorT> const & c)
+    { return deque_memory<T>(c.size()) + heap_memory_of_range(c.begin(), c.end()); }
+
+    template<typename T, typename AllocatorT>
+    std::size_t heap_memory(std::list<T, AllocatorT> const & c)
+    { return c.size() * (list_node_header_size + sizeof(T)) + heap_memory_of_range(c.begin(), c.end()); }
+
+    template<typename KeyT, typename CompareT, typename AllocatorT>
+    std::size_t heap_memory(std::set<KeyT, CompareT, AllocatorT> const & c)
+    { return c.size() * (tree_node_header_size + sizeof(KeyT)) + heap_memory_of_range(c.begin(), c.end()); }
+
+    template<typename KeyT, typename ValueT, typename CompareT, typename AllocatorT>
+    std::size_t heap_memory(std::map<KeyT, ValueT, CompareT, AllocatorT> const & c)
+    {
+      std::size_t result = c.size() * (tree_node_header_size + sizeof(std::pair<const KeyT, ValueT>));
+      for (typename std::map<KeyT, ValueT, CompareT, AllocatorT>::const_iterator it = c.begin(); it != c.end(); ++it)
+        result += heap_memory(it->first) + heap_memory(it->second);
+      return result;
+    }
+
+    template<typename T, int ChunkSizeV>
+    std::size_t heap_memory(viennagrid::chunked_vector<T, ChunkSizeV> const & c)
+    {
+      typedef viennagrid::chunked_vector<T, ChunkSizeV> container_type;
+      std::size_t const chunk_count = c.capacity() / container_type::chunk_size;
+      return c.capacity() * sizeof(T) + (chunk_count + 1) * sizeof(T*) + heap_memory_of_range(c.begin(), c.end());
+    }
+
+
+    /** @brief For internal use only. Returns the heap memory of the key a hidden_key_map derives from a value. Keys not owning heap memory use this overload. */
+    template<typename KeyT>
+    struct hidden_key_heap_memory
+    {
+      template<typename ValueT>
+      static std::size_t get(ValueT const &) { return 0; }
+    };
+
+    template<typename ElementT>
+    struct hidden_key_heap_memory< viennagrid::element_key<ElementT> >
+    {
+      typedef typename viennagrid::result_of::element<ElementT, vertex_tag>::type::id_type id_type;
+
+      // element_key holds the sorted vertex IDs of the element in a std::vector
+      template<typename ValueT>
+      static std::size_t get(ValueT const & element)
+      { return viennagrid::elements<vertex_tag>(element).size() * sizeof(id_type); }
+    };
+
+    /** @brief For internal use only. Returns the memory of a hidden_key_map used for the keys, i.e. for detecting duplicate elements */
+    template<typename T>
+    std::size_t dedup_key_memory(T const &) { return 0; }
+
+    template<typename KeyT, typename ValueT, typename AllocatorT>
+    std::size_t dedup_key_memory(viennagrid::hidden_key_map<KeyT, ValueT, AllocatorT> const & c)
+    {
+      std::size_t result = c.size() * (tree_node_header_size + sizeof(std::pair<const KeyT, ValueT>) - sizeof(ValueT));
+      for (typename viennagrid::hidden_key_map<KeyT, ValueT, AllocatorT>::const_iterator it = c.begin(); it != c.end(); ++it)
+        result += hidden_key_heap_memory<KeyT>::get(*it);
+      return result;
+    }
+
+    template<typename BaseContainerT, typename HandleTagT>
+    std::size_t dedup_key_memory(viennagrid::detail::container<BaseContainerT, HandleTagT> const & c)
+    { return dedup_key_memory( static_cast<BaseContainerT const &>(c) ); }
+
+    template<typename KeyT, typename ValueT, typename AllocatorT>
+    std::size_t heap_memory(viennagrid::hidden_key_map<KeyT, ValueT, AllocatorT> const & c)
+    { return c.size() * sizeof(ValueT) + dedup_key_memory(c) + heap_memory_of_range(c.begin(), c.end()); }
+
+    template<typename BaseContainerT, typename HandleTagT>
+    std::size_t heap_memory(viennagrid::detail::container<BaseContainerT, HandleTagT> const & c)
+    { return heap_memory( static_cast<BaseContainerT const &>(c) ); }
+
+    template<typename BaseContainerT, typename ContainerTagT>
+    std::size_t heap_memory(viennagrid::view<BaseContainerT, ContainerTagT> const & v)
+    { return heap_memory(v.handles()); }
+
+
+    /** @brief For internal use only. Returns the memory of the boundary handles and orientations of an element, based on the boundary container typelist of the element */
+    template<typename BoundaryContainerTypelistT>
+    struct element_boundary_memory;
+
+    template<>
+    struct element_boundary_memory<viennagrid::null_type>
+    {
+      static std::size_t handle_size() { return 0; }
+      static std::size_t orientation_size() { return 0; }
+
+      template<typename ElementT>
+      static std::size_t heap(ElementT const &) { return 0; }
+    };
+
+    template<typename BoundaryContainerT, typename OrientationContainerT, typename TailT>
+    struct element_boundary_memory< viennagrid::typelist< viennagrid::static_pair<BoundaryContainerT, OrientationContainerT>, TailT > >
+    {
+      typedef element_boundary_memory<TailT> tail_type;
+
+      static std::size_t handle_size() { return sizeof(BoundaryContainerT) + tail_type::handle_size(); }
+      static std::size_t orientation_size() { return sizeof(OrientationContainerT) + tail_type::orientation_size(); }
+
+      template<typename ElementT>
+      static std::size_t heap(ElementT const & element)
+      {
+        typedef typename BoundaryContainerT::value_type::tag boundary_tag;
+        return heap_memory( element.container(boundary_tag()) ) + tail_type::heap(element);
+      }
+    };
+
+    template<typename BoundaryContainerT, typename TailT>
+    struct element_boundary_memory< viennagrid::typelist< viennagrid::static_pair<BoundaryContainerT, viennagrid::null_type>, TailT > >
+    {
+      typedef element_boundary_memory<TailT> tail_type;
+
+      static std::size_t handle_size() { return sizeof(BoundaryContainerT) + tail_type::handle_size(); }
+      static std::size_t orientation_size() { return tail_type::orientation_size(); }
+
+      template<typename ElementT>
+      static std::size_t heap(ElementT const & element)
+      {
+        typedef typename BoundaryContainerT::value_type::tag boundary_tag;
+        return heap_memory( element.container(boundary_tag()) ) + tail_type::heap(element);
+      }
+    };
+
+    template<typename ElementTagT, typename WrappedConfigT>
+    std::size_t heap_memory(viennagrid::element<ElementTagT, WrappedConfigT> const & element)
+    {
+      typedef typename viennagrid::element<ElementTagT, WrappedConfigT>::bnd_cell_container_typelist boundary_container_typelist;
+      return element_boundary_memory<boundary_container_typelist>::heap(element);
+    }
+
+    template<typename ElementSegmentMappingT, typename ContainerTagT>
+    std::size_t heap_memory(segment_info_t<ElementSegmentMappingT, ContainerTagT> const & info)
+    { return heap_memory(info.element_segment_mapping_container); }
+
+    template<typename ContainerT, typename ChangeCounterT>
+    std::size_t heap_memory(segment_interface_information_wrapper<ContainerT, ChangeCounterT> const & wrapper)
+    { return heap_memory(wrapper.container); }
+
+
+
+    /** @brief For internal use only. Returns the name of a collection key used in a memory_usage_report */
+    template<typename KeyT>
+    struct memory_usage_name
+    {
+      static std::string get() { return KeyT::name(); }
+    };
+
+    template<typename ElementTagT, typename WrappedConfigT>
+    struct memory_usage_name< viennagrid::element<ElementTagT, WrappedConfigT> >
+    {
+      static std::string get() { return ElementTagT::name(); }
+    };
+
+    template<typename FirstT, typename SecondT>
+    struct memory_usage_name< viennagrid::static_pair<FirstT, SecondT> >
+    {
+      static std::string get() { return FirstT::name() + "/" + SecondT::name(); }
+    };
+
+
+    /** @brief For internal use only. Adds the memory of the element container of a mesh, split into elements, boundary handles, orientations and dedup keys */
+    template<typename BaseContainerT, typename HandleTagT>
+    void add_element_container_memory(memory_usage_report & report, std::string const & name,
+                                      viennagrid::detail::container<BaseContainerT, HandleTagT> const & c)
+    {
+      typedef typename viennagrid::detail::container<BaseContainerT, HandleTagT>::value_type element_type;
+      typedef element_boundary_memory<typename element_type::bnd_cell_container_typelist> boundary_memory_type;
+
+      std::size_t const count = c.size();
+      std::size_t const total = sizeof(c) + heap_memory(c);
+
+      std::size_t boundary_bytes = count * boundary_memory_type::handle_size();
+      for (typename viennagrid::detail::container<BaseContainerT, HandleTagT>::const_iterator it = c.begin(); it != c.end(); ++it)
+        boundary_bytes += heap_memory(*it);
+
+      std::size_t const orientation_bytes = count * boundary_memory_type::orientation_size();
+      std::size_t const dedup_bytes = dedup_key_memory(c);
+
+      report.add(memory_elements, name, count, total - boundary_bytes - orientation_bytes - dedup_bytes);
+      if (boundary_bytes > 0)
+        report.add(memory_boundary_handles, name, count, boundary_bytes);
+      if (orientation_bytes > 0)
+        report.add(memory_orientations, name, count, orientation_bytes);
+      if (dedup_bytes > 0)
+        report.add(memory_dedup_keys, name, count, dedup_bytes);
+    }
+
+    /** @brief For internal use only. Adds the memory of an element view of a mesh view or segment */
+    template<typename BaseContainerT, typename ContainerTagT>
+    void add_element_container_memory(memory_usage_report & report, std::string const & name,
+                                      viennagrid::view<BaseContainerT, ContainerTagT> const & v)
+    {
+      report.add(memory_segment_views, name, v.size(), sizeof(v) + heap_memory(v));
+    }
+
+
+    /** @brief For internal use only. Adds the memory of all element containers of a mesh or mesh view to a report */
+    template<typename MeshT>
+    class element_memory_usage_functor
+    {
+    public:
+      element_memory_usage_functor(MeshT const & mesh_obj, memory_usage_report & report) : mesh_obj_(mesh_obj), report_(report) {}
+
+      template<typename ElementT>
+      void operator()( viennagrid::detail::tag<ElementT> )
+      {
+        add_element_container_memory(report_, memory_usage_name<ElementT>::get(),
+                                     viennagrid::get<ElementT>(mesh_obj_.element_collection()));
+      }
+
+    private:
+      MeshT const & mesh_obj_;
+      memory_usage_report & report_;
+    };
+
+    /** @brief For internal use only. Adds the memory of all caches of one kind (e.g. all coboundary caches) to a report */
+    template<typename CollectionT>
+    class cache_memory_usage_functor
+    {
+    public:
+      cache_memory_usage_functor(CollectionT const & collection, memory_usage_category category, memory_usage_report & report) :
+          collection_(collection), category_(category), report_(report) {}
+
+      template<typename KeyT>
+      void operator()( viennagrid::detail::tag<KeyT> )
+      {
+        typedef typename viennagrid::detail::result_of::lookup<typename CollectionT::typemap, KeyT>::type wrapper_type;
+        wrapper_type const & wrapper = viennagrid::get<KeyT>(collection_);
+
+        report_.add(category_, memory_usage_name<KeyT>::get(), wrapper.container.size(), sizeof(wrapper) + heap_memory(wrapper.container));
+      }
+
+    private:
+      CollectionT const & collection_;
+      memory_usage_category category_;
+      memory_usage_report & report_;
+    };
+
+    template<typename CollectionT>
+    void add_cache_memory(memory_usage_report & report, CollectionT const & collection, memory_usage_category category)
+    {
+      cache_memory_usage_functor<CollectionT> functor(collection, category, report);
+      viennagrid::detail::for_each< typename viennagrid::detail::result_of::key_typelist<typename CollectionT::typemap>::type >(functor);
+    }
+
+
+    /** @brief For internal use only. Releases all caches of one kind (e.g. all coboundary caches) of a mesh or mesh view */
+    template<typename CollectionT>
+    class shrink_caches_functor
+    {
+    public:
+      shrink_caches_functor(CollectionT & collection, std::size_t & released) : collection_(collection), released_(released) {}
+
+      template<typename KeyT>
+      void operator()( viennagrid::detail::tag<KeyT> )
+      {
+        typedef typename viennagrid::detail::result_of::lookup<typename CollectionT::typemap, KeyT>::type wrapper_type;
+        wrapper_type & wrapper = viennagrid::get<KeyT>(collection_);
+
+        released_ += heap_memory(wrapper.container);
+
+        // a default constructed wrapper is outdated unless the element types it depends on are empty, see element_change_counters
+        wrapper = wrapper_type();
+      }
+
+    private:
+      CollectionT & collection_;
+      std::size_t & released_;
+    };
+
+    template<typename CollectionT>
+    void shrink_cache_collection(CollectionT & collection, std::size_t & released)
+    {
+      shrink_caches_functor<CollectionT> functor(collection, released);
+      viennagrid::detail::for_each< typename viennagrid::detail::result_of::key_typelist<typename CollectionT::typemap>::type >(functor);
+    }
+
+
+    /** @brief For internal use only. Adds the memory of the interface information of a segmentation to a report */
+    template<typename CollectionT>
+    class interface_memory_usage_functor
+    {
+    public:
+      interface_memory_usage_functor(CollectionT const & collection, memory_usage_report & report) : collection_(collection), report_(report) {}
+
+      template<typename KeyT>
+      void operator()( viennagrid::detail::tag<KeyT> )
+      {
+        typedef typename viennagrid::detail::result_of::lookup<typename CollectionT::typemap, KeyT>::type wrapper_type;
+        wrapper_type const & wrapper = viennagrid::get<KeyT>(collection_);
+
+        report_.add(memory_interface_info, memory_usage_name<KeyT>::get(), wrapper.interface_flags.size(), sizeof(wrapper) + heap_memory(wrapper.interface_flags));
+      }
+
+    private:
+      CollectionT const & collection_;
+      memory_usage_report & report_;
+    };
+
+    /** @brief For internal use only. Releases the interface information of a segmentation */
+    template<typename CollectionT>
+    class shrink_interface_functor
+    {
+    public:
+      shrink_interface_functor(CollectionT & collection, std::size_t & released) : collection_(collection), released_(released) {}
+
+      template<typename KeyT>
+      void operator()( viennagrid::detail::tag<KeyT> )
+      {
+        typedef typename viennagrid::detail::result_of::lookup<typename CollectionT::typemap, KeyT>::type wrapper_type;
+        wrapper_type & wrapper = viennagrid::get<KeyT>(collection_);
+
+        released_ += heap_memory(wrapper.interface_flags);
+        wrapper.clear();
+      }
+
+    private:
+      CollectionT & collection_;
+      std::size_t & released_;
+    };
+
+    /** @brief For internal use only. Adds the memory of the element-to-segment mapping of a segmentation to a report */
+    template<typename CollectionT>
+    class segment_mapping_memory_usage_functor
+    {
+    public:
+      segment_mapping_memory_usage_functor(CollectionT const & collection, memory_usage_report & report) : collection_(collection), report_(report) {}
+
+      template<typename KeyT>
+      void operator()( viennagrid::detail::tag<KeyT> )
+      {
+        typedef typename viennagrid::detail::result_of::lookup<typename CollectionT::typemap, KeyT>::type container_type;
+        container_type const & container = viennagrid::get<KeyT>(collection_);
+
+        report_.add(memory_segment_mapping, memory_usage_name<KeyT>::get(), container.size(), sizeof(container) + heap_memory(container));
+      }
+
+    private:
+      CollectionT const & collection_;
+      memory_usage_report & report_;
+    };
+  }
+
+
+
+  /** @brief Returns the memory used by a mesh or mesh view, broken down by element type and subsystem.
+    *
+    * For a mesh the elements, boundary handles, orientations and dedup keys are reported, for a mesh view the element views are reported as segment views.
+    * The coboundary, neighbor and boundary caches are reported for both. The caches must not be rebuilt concurrently (see cache_guard.hpp).
+    *
+    * @param  mesh_obj    The mesh or mesh view
+    * @return             The memory report
+    */
+  template<typename WrappedConfigT>
+  memory_usage_report memory_usage(viennagrid::mesh<WrappedConfigT> const & mesh_obj)
+  {
+    typedef viennagrid::mesh<WrappedConfigT> mesh_type;
+    typedef typename viennagrid::result_of::element_typelist<mesh_type>::type element_typelist;
+
+    memory_usage_report report;
+
+    detail::element_memory_usage_functor<mesh_type> functor(mesh_obj, report);
+    viennagrid::detail::for_each<element_typelist>(functor);
+
+    detail::add_cache_memory(report, viennagrid::get<coboundary_collection_tag>(mesh_obj.appendix()), memory_coboundary);
+    detail::add_cache_memory(report, viennagrid::get<neighbor_collection_tag>(mesh_obj.appendix()), memory_neighbor);
+    detail::add_cache_memory(report, viennagrid::get<boundary_information_collection_tag>(mesh_obj.appendix()), memory_boundary_flags);
+
+    return report;
+  }
+
+  /** @brief Returns the memory used by a segmentation: The views of all segments including their caches, the element-to-segment mapping and the interface information. The elements of the mesh are not included.
+    *
+    * @param  segmentation_obj    The segmentation
+    * @return                     The memory report
+    */
+  template<typename WrappedConfigT>
+  memory_usage_report memory_usage(viennagrid::segmentation<WrappedConfigT> const & segmentation_obj)
+  {
+    typedef viennagrid::segmentation<WrappedConfigT> segmentation_type;
+    typedef typename segmentation_type::appendix_type appendix_type;
+
+    memory_usage_report report;
+
+    for (typename segmentation_type::const_iterator sit = segmentation_obj.begin(); sit != segmentation_obj.end(); ++sit)
+      report += memory_usage( (*sit).view() );
+    report += memory_usage( segmentation_obj.all_elements() );
+
+    typedef typename viennagrid::detail::result_of::lookup<appendix_type, detail::element_segment_mapping_tag>::type segment_mapping_collection_type;
+    detail::segment_mapping_memory_usage_functor<segment_mapping_collection_type> segment_mapping_functor(
+        viennagrid::get<detail::element_segment_mapping_tag>(segmentation_obj.appendix()), report);
+    viennagrid::detail::for_each< typename viennagrid::detail::result_of::key_typelist<typename segment_mapping_collection_type::typemap>::type >(segment_mapping_functor);
+
+    typedef typename viennagrid::detail::result_of::lookup<appendix_type, interface_information_collection_tag>::type interface_collection_type;
+    detail::interface_memory_usage_functor<interface_collection_type> interface_functor(
+        viennagrid::get<interface_information_collection_tag>(segmentation_obj.appendix()), report);
+    viennagrid::detail::for_each< typename viennagrid::detail::result_of::key_typelist<typename interface_collection_type::typemap>::type >(interface_functor);
+
+    return report;
+  }
+
+
+  /** @brief Releases the coboundary, neighbor and boundary caches of a mesh or mesh view. The caches are rebuilt on the next query.
+    *
+    * Must not be called while other threads query the mesh.
+    *
+    * @param  mesh_obj    The mesh or mesh view
+    * @return             The number of heap bytes released (estimate, see memory_usage())
+    */
+  template<typename WrappedConfigT>
+  std::size_t shrink_caches(viennagrid::mesh<WrappedConfigT> & mesh_obj)
+  {
+    std::size_t released = 0;
+
+    detail::shrink_cache_collection(viennagrid::get<coboundary_collection_tag>(mesh_obj.appendix()), released);
+    detail::shrink_cache_collection(viennagrid::get<neighbor_collection_tag>(mesh_obj.appendix()), released);
+    detail::shrink_cache_collection(viennagrid::get<boundary_information_collection_tag>(mesh_obj.appendix()), released);
+
+    return released;
+  }
+
+  /** @brief Releases the caches of all segments and the interface information of a segmentation. The caches are rebuilt on the next query.
+    *
+    * Must not be called while other threads query the segmentation.
+    *
+    * @param  segmentation_obj    The segmentation
+    * @return                     The number of heap bytes released (estimate, see memory_usage())
+    */
+  template<typename WrappedConfigT>
+  std::size_t shrink_caches(viennagrid::segmentation<WrappedConfigT> & segmentation_obj)
+  {
+    typedef viennagrid::segmentation<WrappedConfigT> segmentation_type;
+    typedef typename segmentation_type::appendix_type appendix_type;
+
+    std::size_t released = 0;
+
+    for (typename segmentation_type::iterator sit = segmentation_obj.begin(); sit != segmentation_obj.end(); ++sit)
+      released += shrink_caches( (*sit).view() );
+    released += shrink_caches( segmentation_obj.all_elements() );
+
+    typedef typename viennagrid::detail::result_of::lookup<appendix_type, interface_information_collection_tag>::type interface_collection_type;
+    detail::shrink_interface_functor<interface_collection_type> functor(
+        viennagrid::get<interface_information_collection_tag>(segmentation_obj.appendix()), released);
+    viennagrid::detail::for_each< typename viennagrid::detail::result_of::key_typelist<typename interface_collection_type::typemap>::type >(functor);
+
+    return released;
+  }
+}
+
+#endif
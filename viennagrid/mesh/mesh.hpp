@@ -27,6 +27,9 @@
 
 #include "viennagrid/element/element_view.hpp"
 
+#include "viennagrid/mesh/cache_guard.hpp"
+#include "viennagrid/instrumentation.hpp"
+
 /** @file viennagrid/mesh/mesh.hpp
     @brief Contains definition and implementation of mesh and mesh views
 */
@@ -60,14 +63,107 @@ namespace viennagrid
     };
 
 
+    /** @brief For internal use only. The change counters of a mesh or mesh view.
+      *
+      * The total counter is incremented on every change. Each element type additionally has a generation counter, which is incremented when elements of this type are inserted.
+      * Changes which invalidate handles or IDs (deleting elements, copying a mesh) increment the structure counter and all generation counters.
+      * A cache depending on some element types stores the sum of their generation counters (see generation_sum()): Since all counters only increase, the sum changes if and only if elements of one of these types changed.
+      */
+    template<typename ElementTaglistT, typename CounterT>
+    class element_change_counters
+    {
+      static const int type_count = viennagrid::detail::result_of::size<ElementTaglistT>::value;
+
+      template<typename ElementTagT>
+      struct index
+      {
+        static const int value = viennagrid::detail::result_of::index_of<ElementTaglistT, ElementTagT>::value;
+        static const bool present = (value >= 0);
+        static const int position = present ? value : 0;
+      };
+
+      template<typename TaglistT, bool dummy = true>
+      struct sum_helper
+      {
+        typedef index<typename TaglistT::head> head_index;
+
+        static CounterT get(CounterT const * generations)
+        {
+          return (head_index::present ? generations[head_index::position] : CounterT(0)) + sum_helper<typename TaglistT::tail>::get(generations);
+        }
+      };
+
+      template<bool dummy>
+      struct sum_helper<viennagrid::null_type, dummy>
+      {
+        static CounterT get(CounterT const *) { return CounterT(0); }
+      };
+
+    public:
+      typedef CounterT counter_type;
+
+      element_change_counters() : total_(0), structure_(0)
+      {
+        for (int i = 0; i < type_count; ++i)
+          generations_[i] = 0;
+      }
+
+      /** @brief Returns the counter incremented on every change */
+      counter_type total() const { return total_; }
+
+      /** @brief Returns the counter incremented on changes which invalidate handles or IDs */
+      counter_type structure() const { return structure_; }
+
+      /** @brief Returns the sum of the generation counters of all element tags in TaglistT. Element tags not present in the mesh do not contribute. */
+      template<typename TaglistT>
+      counter_type generation_sum() const { return sum_helper<TaglistT>::get(generations_); }
+
+      /** @brief Records the insertion of an element, the generation of its type is only incremented if the element was not present before */
+      template<typename ElementTagT>
+      void increment(bool inserted)
+      {
+        ++total_;
+        if (inserted && index<ElementTagT>::present)
+          ++generations_[index<ElementTagT>::position];
+      }
+
+      /** @brief Records a change which invalidates handles or IDs */
+      void increment_all()
+      {
+        ++total_;
+        ++structure_;
+        for (int i = 0; i < type_count; ++i)
+          ++generations_[i];
+      }
+
+    private:
+      counter_type total_;
+      counter_type structure_;
+      counter_type generations_[type_count];
+    };
+
+    /** @brief For internal use only. Records the insertion of an element of type ValueT into a mesh or mesh view. */
+    template<typename ElementTaglistT, typename CounterT, typename ValueT>
+    void increment_change_counter(element_change_counters<ElementTaglistT, CounterT> & change_counters, viennagrid::detail::tag<ValueT>, bool inserted)
+    { change_counters.template increment<typename ValueT::tag>(inserted); }
+
+
     /** @brief For internal use only */
     template<typename container_type_, typename change_counter_type>
     struct coboundary_container_wrapper
     {
         typedef container_type_ container_type;
-        coboundary_container_wrapper() : change_counter(0) {}
+        coboundary_container_wrapper() : change_counter(0), structure_change_counter(0),
+                                         element_count(0), coboundary_element_count(0), element_id_bound(0), coboundary_element_id_bound(0) {}
 
         change_counter_type change_counter;
+        // state of the mesh when the container was built, used for extending the container after insertions
+        change_counter_type structure_change_counter;
+        std::size_t element_count;
+        std::size_t coboundary_element_count;
+        long element_id_bound;
+        long coboundary_element_id_bound;
+
         container_type container;
     };
 
@@ -190,13 +286,33 @@ namespace viennagrid
     };
 
 
+    /** @brief For internal use only */
+    template <typename WrappedConfigT>
+    struct mesh_change_counters_type
+    {
+      typedef typename config::result_of::element_collection<WrappedConfigT>::type                          element_collection_type;
+      typedef typename viennagrid::detail::result_of::key_typelist<typename element_collection_type::typemap>::type   element_typelist;
+      typedef typename viennagrid::detail::TRANSFORM<viennagrid::result_of::element_tag, element_typelist>::type      element_taglist;
+
+      typedef viennagrid::detail::element_change_counters<element_taglist, typename mesh_change_counter_type<WrappedConfigT>::type> type;
+    };
+
+    template <typename WrappedMeshConfigT, typename ElementTypeList, typename ContainerConfig>
+    struct mesh_change_counters_type< viennagrid::detail::decorated_mesh_view_config<WrappedMeshConfigT, ElementTypeList, ContainerConfig> >
+    {
+      typedef typename viennagrid::detail::TRANSFORM<viennagrid::result_of::element_tag, ElementTypeList>::type      element_taglist;
+
+      typedef viennagrid::detail::element_change_counters<element_taglist, typename mesh_change_counter_type<WrappedMeshConfigT>::type> type;
+    };
+
+
     /** @brief For internal use only */
     template <typename WrappedConfigType>
     struct mesh_inserter_type
     {
       typedef typename config::result_of::element_collection<WrappedConfigType>::type                                                       element_collection_type;
       typedef typename viennagrid::result_of::id_generator<WrappedConfigType>::type                                                 id_generator_type;
-      typedef typename mesh_change_counter_type<WrappedConfigType>::type change_counter_type;
+      typedef typename mesh_change_counters_type<WrappedConfigType>::type change_counter_type;
 
       typedef typename viennagrid::result_of::physical_inserter<element_collection_type, change_counter_type, id_generator_type>::type   type;
     };
@@ -209,7 +325,7 @@ namespace viennagrid
 
       typedef typename mesh_element_collection_type<argument_type>::type                             view_container_collection_type;
       typedef typename mesh_inserter_type<WrappedMeshConfigT>::type                             full_mesh_inserter_type;
-      typedef typename mesh_change_counter_type<WrappedMeshConfigT>::type change_counter_type;
+      typedef typename mesh_change_counters_type<argument_type>::type change_counter_type;
 
       typedef typename viennagrid::result_of::recursive_inserter<view_container_collection_type, change_counter_type, full_mesh_inserter_type>::type      type;
     };
@@ -233,11 +349,12 @@ namespace viennagrid
     typedef typename result_of::mesh_element_collection_type<WrappedConfigType>::type     element_collection_type;
     typedef typename result_of::mesh_appendix_type<WrappedConfigType>::type               appendix_type;
     typedef typename result_of::mesh_change_counter_type<WrappedConfigType>::type         change_counter_type;
+    typedef typename result_of::mesh_change_counters_type<WrappedConfigType>::type        change_counters_type;
     typedef typename result_of::mesh_inserter_type<WrappedConfigType>::type               inserter_type;
 
 
     /** @brief Default constructor */
-    mesh() : inserter( element_container_collection, change_counter_ ), change_counter_(0) {}
+    mesh() : inserter( element_container_collection, change_counter_ ) {}
 
     /** @brief Constructor for creating a view from another mesh/mesh view
       *
@@ -245,7 +362,7 @@ namespace viennagrid
       * @tparam proxy                   Proxy object wrapping the mesh object from which the view is created
       */
     template<typename OtherWrappedConfigT>
-    mesh( mesh_proxy<viennagrid::mesh<OtherWrappedConfigT> > proxy ) : change_counter_(0)
+    mesh( mesh_proxy<viennagrid::mesh<OtherWrappedConfigT> > proxy )
     {
         typedef typename viennagrid::mesh<OtherWrappedConfigT>::element_collection_type   other_element_collection_type;
 
@@ -316,9 +433,12 @@ namespace viennagrid
     inserter_type const & get_inserter() const { return inserter; }
 
     /** @brief For internal use only */
-    bool is_obsolete( change_counter_type change_counter_to_check ) const { return change_counter_to_check != change_counter_; }
-    void update_change_counter( change_counter_type & change_counter_to_update ) const { change_counter_to_update = change_counter_; }
-    void increment_change_counter() { ++change_counter_; }
+    bool is_obsolete( change_counter_type change_counter_to_check ) const { return change_counter_to_check != change_counter_.total(); }
+    void update_change_counter( change_counter_type & change_counter_to_update ) const { detail::store_release(change_counter_to_update, change_counter_.total()); }
+    void increment_change_counter() { change_counter_.increment_all(); }
+
+    /** @brief For internal use only */
+    change_counters_type const & change_counters() const { return change_counter_; }
 
   protected:
     element_collection_type element_container_collection;
@@ -326,7 +446,7 @@ namespace viennagrid
     appendix_type appendix_;
     inserter_type inserter;
 
-    change_counter_type change_counter_;
+    change_counters_type change_counter_;
   };
 
   /** @brief Completely clears a mesh.
@@ -358,8 +478,8 @@ namespace viennagrid
 
     /** @brief For internal use only */
     template<typename WrappedConfigType>
-    bool is_obsolete( viennagrid::mesh<WrappedConfigType> const & mesh_obj, typename viennagrid::mesh<WrappedConfigType>::change_counter_type change_counter_to_check )
-    { return mesh_obj.is_obsolete( change_counter_to_check ); }
+    bool is_obsolete( viennagrid::mesh<WrappedConfigType> const & mesh_obj, typename viennagrid::mesh<WrappedConfigType>::change_counter_type const & change_counter_to_check )
+    { return mesh_obj.is_obsolete( load_acquire(change_counter_to_check) ); }
 
     /** @brief For internal use only */
     template<typename WrappedConfigType>
@@ -371,6 +491,16 @@ namespace viennagrid
     void increment_change_counter( viennagrid::mesh<WrappedConfigType> & mesh_obj)
     { mesh_obj.increment_change_counter(); }
 
+    /** @brief For internal use only. Returns true if a cache depending on the element tags in ElementTaglistT is out of date, see element_change_counters */
+    template<typename ElementTaglistT, typename WrappedConfigType>
+    bool is_dependency_obsolete( viennagrid::mesh<WrappedConfigType> const & mesh_obj, typename viennagrid::mesh<WrappedConfigType>::change_counter_type const & change_counter_to_check )
+    { return load_acquire(change_counter_to_check) != mesh_obj.change_counters().template generation_sum<ElementTaglistT>(); }
+
+    /** @brief For internal use only. Marks a cache depending on the element tags in ElementTaglistT as up to date, see element_change_counters */
+    template<typename ElementTaglistT, typename WrappedConfigType>
+    void update_dependency_change_counter( viennagrid::mesh<WrappedConfigType> const & mesh_obj, typename viennagrid::mesh<WrappedConfigType>::change_counter_type & change_counter_to_update )
+    { store_release(change_counter_to_update, mesh_obj.change_counters().template generation_sum<ElementTaglistT>()); }
+
 
 
 
@@ -831,11 +961,26 @@ namespace viennagrid
   typename viennagrid::result_of::id< typename viennagrid::result_of::element<MeshOrSegmentHandleT, ElementTypeOrTag>::type >::type
   id_upper_bound( MeshOrSegmentHandleT const & mesh_or_segment )
   {
-    return detail::id_generator(mesh_or_segment).max_id( viennagrid::detail::tag<ElementTypeOrTag>() );
+    return detail::id_generator(mesh_or_segment).max_id( viennagrid::detail::tag< typename viennagrid::result_of::element<MeshOrSegmentHandleT, ElementTypeOrTag>::type >() );
   }
 
 
 
+  /** @brief Reserves memory for a given number of elements of a specific element type/tag in a mesh. Only has an effect if the element container supports it (std_vector_tag, chunked_vector_tag).
+    *
+    * @tparam ElementTypeOrTagT  The element type/tag for which memory is reserved
+    * @tparam WrappedConfigT     The wrapped config of the mesh type
+    * @param  mesh_obj           The mesh object
+    * @param  size               The number of elements for which memory is reserved
+    */
+  template<typename ElementTypeOrTagT, typename WrappedConfigT>
+  void reserve(mesh<WrappedConfigT> & mesh_obj, std::size_t size)
+  {
+    typedef typename viennagrid::result_of::element<mesh<WrappedConfigT>, ElementTypeOrTagT>::type ElementType;
+    viennagrid::detail::reserve( get<ElementType>(viennagrid::detail::element_collection(mesh_obj)), size );
+  }
+
+
   /** @brief Function for dereferencing a handle using a mesh/segment object
     *
     * @tparam WrappedConfigT     The wrapped config of the mesh/segment type
@@ -848,6 +993,7 @@ namespace viennagrid
   typename viennagrid::detail::result_of::value_type<HandleT>::type &
   dereference_handle(mesh<WrappedMeshConfigT> & mesh_obj, HandleT const & handle)
   {
+    VIENNAGRID_INSTRUMENT_COUNT("handle: dereference");
     typedef typename viennagrid::detail::result_of::value_type<HandleT>::type value_type;
     return get<value_type>(viennagrid::detail::element_collection(mesh_obj)).dereference_handle( handle );
   }
@@ -864,6 +1010,7 @@ namespace viennagrid
   typename viennagrid::detail::result_of::value_type<HandleT>::type const &
   dereference_handle(mesh<WrappedMeshConfigT> const & mesh_obj, HandleT const & handle)
   {
+    VIENNAGRID_INSTRUMENT_COUNT("handle: dereference");
     typedef typename viennagrid::detail::result_of::value_type<HandleT>::type value_type;
     return get<value_type>(viennagrid::detail::element_collection(mesh_obj)).dereference_handle( handle );
   }
@@ -958,7 +1105,7 @@ namespace viennagrid
       dereference_handle_comparator(ContainerT const & container_) : container(container_) {}
 
       template<typename HandleT>
-      bool operator() ( HandleT h1, HandleT h2 )
+      bool operator() ( HandleT h1, HandleT h2 ) const
       {
           return &viennagrid::dereference_handle( container, h1 ) < &viennagrid::dereference_handle( container, h2 );
       }
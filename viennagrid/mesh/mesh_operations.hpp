@@ -19,6 +19,7 @@
 #include "viennagrid/mesh/element_creation.hpp"
 #include "viennagrid/mesh/coboundary_iteration.hpp"
 #include "viennagrid/functors.hpp"
+#include "viennagrid/algorithm/detail/spatial_hash.hpp"
 
 /** @file viennagrid/mesh/mesh_operations.hpp
     @brief Helper routines for meshes
@@ -28,6 +29,11 @@ namespace viennagrid
 {
 
   /** @brief A helper class for element copy operation between two differen meshes.
+    *
+    * Source vertices are mapped to destination vertex handles using an array indexed by the source vertex ID, hence a lookup is O(1).
+    * If vertices are copied with a positive tolerance, nearby vertices in the destination mesh are found using a spatial hash instead of a linear search.
+    * Vertices added to the destination mesh by other means (e.g. by another vertex_copy_map) are added to the spatial hash on the next search.
+    * If vertices are erased from the destination mesh, the vertex_copy_map has to be recreated.
     *
     * @tparam SrcMeshT      The mesh type of the source mesh
     * @tparam DstMeshT      The mesh type of the destination mesh
@@ -40,9 +46,10 @@ namespace viennagrid
       *
       * @param  dst_mesh_                The destination mesh
       */
-    vertex_copy_map( DstMeshT & dst_mesh_ ) : dst_mesh(dst_mesh_) {}
+    vertex_copy_map( DstMeshT & dst_mesh_ ) : dst_mesh(dst_mesh_), hashed_vertex_count(0) {}
 
     typedef typename viennagrid::result_of::coord<DstMeshT>::type DstNumericType;
+    typedef typename viennagrid::result_of::point<DstMeshT>::type DstPointType;
 
     typedef typename viennagrid::result_of::vertex<SrcMeshT>::type SrcVertexType;
     typedef typename viennagrid::result_of::vertex_id<SrcMeshT>::type SrcVertexIDType;
@@ -50,6 +57,19 @@ namespace viennagrid
     typedef typename viennagrid::result_of::vertex<DstMeshT>::type DstVertexType;
     typedef typename viennagrid::result_of::vertex_handle<DstMeshT>::type DstVertexHandleType;
 
+    /** @brief Presizes the internal mapping for source vertex IDs smaller than 'src_vertex_id_upper_bound'
+      *
+      * @param  src_vertex_id_upper_bound  Upper bound for the IDs of the source vertices, e.g. obtained via viennagrid::id_upper_bound<vertex_tag>(src_mesh)
+      */
+    void reserve( std::size_t src_vertex_id_upper_bound )
+    {
+      if (src_vertex_id_upper_bound > vertex_map.size())
+      {
+        vertex_map.resize( src_vertex_id_upper_bound );
+        vertex_mapped.resize( src_vertex_id_upper_bound, false );
+      }
+    }
+
     /** @brief Copies one vertex to the destination mesh. If the vertex is already present in the destination mesh, the vertex handle of this vertex is return, otherwise a new vertex is created in the destination mesh.
       *
       * @param  src_vertex              The vertex to be copied
@@ -57,15 +77,27 @@ namespace viennagrid
       */
     DstVertexHandleType operator()( SrcVertexType const & src_vertex, DstNumericType tolerance = 0.0 )
     {
-      typename std::map<SrcVertexIDType, DstVertexHandleType>::iterator vit = vertex_map.find( src_vertex.id() );
-      if (vit != vertex_map.end())
-        return vit->second;
-      else
+      std::size_t index = static_cast<std::size_t>( src_vertex.id().get() );
+      if (index < vertex_mapped.size() && vertex_mapped[index])
+        return vertex_map[index];
+
+      reserve(index+1);
+
+      DstPointType point = viennagrid::point(src_vertex);
+      DstVertexHandleType vh;
+      if ( !(tolerance > 0) || !find_vertex(point, tolerance, vh) )
       {
-        DstVertexHandleType vh = viennagrid::make_unique_vertex( dst_mesh, viennagrid::point(src_vertex), tolerance );
-        vertex_map[src_vertex.id()] = vh;
-        return vh;
+        vh = viennagrid::make_vertex( dst_mesh, point );
+        if (vertex_hash.cell_size() > 0)
+        {
+          vertex_hash.insert( point, vh );
+          ++hashed_vertex_count;
+        }
       }
+
+      vertex_map[index] = vh;
+      vertex_mapped[index] = true;
+      return vh;
     }
 
     /** @brief Copies a whole element including its vertices to the destination mesh.
@@ -80,25 +112,94 @@ namespace viennagrid
       typedef typename viennagrid::result_of::const_vertex_range<ElementType>::type ConstVerticesOnElementRangeType;
       typedef typename viennagrid::result_of::iterator<ConstVerticesOnElementRangeType>::type ConstVerticesOnElementIteratorType;
 
-      std::vector<DstVertexHandleType> vertex_handles;
+      vertex_handle_buffer.clear();
 
       ConstVerticesOnElementRangeType vertices(el);
       for (ConstVerticesOnElementIteratorType vit = vertices.begin(); vit != vertices.end(); ++vit)
-        vertex_handles.push_back( (*this)(*vit, tolerance) );
+        vertex_handle_buffer.push_back( (*this)(*vit, tolerance) );
 
-      return viennagrid::make_element<ElementTagT>( dst_mesh, vertex_handles.begin(), vertex_handles.end() );
+      return viennagrid::make_element<ElementTagT>( dst_mesh, vertex_handle_buffer.begin(), vertex_handle_buffer.end() );
     }
 
   private:
 
+    /** @brief Searches the destination mesh for a vertex closer than 'tolerance' to 'point'. The spatial hash is (re)built from all destination vertices whenever the tolerance changes, vertices created in the destination mesh since the last search are added. */
+    bool find_vertex( DstPointType const & point, DstNumericType tolerance, DstVertexHandleType & result )
+    {
+      typedef typename viennagrid::result_of::element_range<DstMeshT, vertex_tag>::type DstVertexRangeType;
+      typedef typename viennagrid::result_of::iterator<DstVertexRangeType>::type DstVertexIteratorType;
+
+      DstVertexRangeType vertices(dst_mesh);
+      if (vertex_hash.cell_size() != tolerance || vertices.size() < hashed_vertex_count)
+      {
+        vertex_hash.init( tolerance, std::max<std::size_t>(vertices.size(), vertex_map.size()) );
+        hashed_vertex_count = 0;
+      }
+
+      if (vertices.size() > hashed_vertex_count)
+      {
+        // vertices are appended to the destination mesh, hence only the trailing ones are new
+        DstVertexIteratorType vit = vertices.begin();
+        for (std::size_t i = 0; i < hashed_vertex_count; ++i)
+          ++vit;
+
+        for (; vit != vertices.end(); ++vit)
+          vertex_hash.insert( viennagrid::point(dst_mesh, *vit), vit.handle() );
+        hashed_vertex_count = vertices.size();
+      }
+
+      return vertex_hash.find( point, tolerance, result );
+    }
+
     DstMeshT & dst_mesh;
-    std::map<SrcVertexIDType, DstVertexHandleType> vertex_map;
+
+    std::vector<DstVertexHandleType> vertex_map;
+    std::vector<bool> vertex_mapped;
+
+    viennagrid::detail::spatial_hash<DstPointType, DstVertexHandleType> vertex_hash;
+    std::size_t hashed_vertex_count;
+    std::vector<DstVertexHandleType> vertex_handle_buffer;
   };
 
 
+  namespace detail
+  {
+    /** @brief Evaluates a boolean functor on all cells of a mesh and stores pointers to the cells for which the functor returns true. If VIENNAGRID_WITH_OPENMP is defined, the functor is evaluated in parallel and therefore has to be thread-safe. The order of the cells is preserved. For internal use only. */
+    template<typename SrcMeshT, typename ToCopyFunctorT>
+    void cells_to_copy( SrcMeshT const & src_mesh, ToCopyFunctorT functor,
+                        std::vector<typename viennagrid::result_of::cell<SrcMeshT>::type const *> & selected_cells )
+    {
+      typedef typename viennagrid::result_of::cell<SrcMeshT>::type CellType;
+      typedef typename viennagrid::result_of::const_cell_range<SrcMeshT>::type ConstCellRangeType;
+      typedef typename viennagrid::result_of::iterator<ConstCellRangeType>::type ConstCellIteratorType;
+
+      ConstCellRangeType cells(src_mesh);
+
+      std::vector<CellType const *> all_cells;
+      all_cells.reserve( cells.size() );
+      for (ConstCellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+        all_cells.push_back( &*cit );
+
+      long cell_count = static_cast<long>(all_cells.size());
+      std::vector<char> selected( all_cells.size() );
+
+#ifdef VIENNAGRID_WITH_OPENMP
+      #pragma omp parallel for
+#endif
+      for (long i = 0; i < cell_count; ++i)
+        selected[static_cast<std::size_t>(i)] = functor( *all_cells[static_cast<std::size_t>(i)] ) ? 1 : 0;
+
+      selected_cells.clear();
+      for (std::size_t i = 0; i < all_cells.size(); ++i)
+        if (selected[i])
+          selected_cells.push_back( all_cells[i] );
+    }
+  }
 
 
   /** @brief Copies the cells of a mesh if a boolean functor is true.
+    *
+    * The cells are selected in a first pass (in parallel if VIENNAGRID_WITH_OPENMP is defined, the functor then has to be thread-safe) and copied in a second pass in their original order.
     *
     * @param  src_mesh                The source mesh
     * @param  dst_mesh                The destination mesh
@@ -110,24 +211,20 @@ namespace viennagrid
     dst_mesh.clear();
 
     viennagrid::vertex_copy_map<SrcMeshT, DstMeshT> vertex_map(dst_mesh);
+    vertex_map.reserve( static_cast<std::size_t>(viennagrid::id_upper_bound<vertex_tag>(src_mesh).get()) );
 
-    //typedef typename viennagrid::result_of::cell<SrcMeshT>::type CellType;
-    //typedef typename viennagrid::result_of::coord<SrcMeshT>::type NumericType;
-
-    typedef typename viennagrid::result_of::const_cell_range<SrcMeshT>::type ConstCellRangeType;
-    typedef typename viennagrid::result_of::iterator<ConstCellRangeType>::type ConstCellIteratorType;
+    typedef typename viennagrid::result_of::cell<SrcMeshT>::type CellType;
 
-    //typedef typename viennagrid::result_of::cell_handle<DstMeshT>::type CellHandleType;
+    std::vector<CellType const *> selected_cells;
+    detail::cells_to_copy( src_mesh, functor, selected_cells );
 
-    ConstCellRangeType cells(src_mesh);
-    for (ConstCellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
-    {
-      if ( functor(*cit) )
-        vertex_map.copy_element(*cit );
-    }
+    for (std::size_t i = 0; i < selected_cells.size(); ++i)
+      vertex_map.copy_element( *selected_cells[i] );
   }
 
   /** @brief Copies the cells of a mesh and a segmentation if a boolean functor is true.
+    *
+    * The cells are selected in a first pass (in parallel if VIENNAGRID_WITH_OPENMP is defined, the functor then has to be thread-safe) and copied in a second pass in their original order.
     *
     * @param  src_mesh                The source mesh
     * @param  src_segmentation        The source segmentation
@@ -144,23 +241,19 @@ namespace viennagrid
     dst_segmentation.clear();
 
     viennagrid::vertex_copy_map<SrcMeshT, DstMeshT> vertex_map(dst_mesh);
+    vertex_map.reserve( static_cast<std::size_t>(viennagrid::id_upper_bound<vertex_tag>(src_mesh).get()) );
 
-    //typedef typename viennagrid::result_of::cell<SrcMeshT>::type CellType;
-    //typedef typename viennagrid::result_of::coord<SrcMeshT>::type NumericType;
-
-    typedef typename viennagrid::result_of::const_cell_range<SrcMeshT>::type ConstCellRangeType;
-    typedef typename viennagrid::result_of::iterator<ConstCellRangeType>::type ConstCellIteratorType;
-
+    typedef typename viennagrid::result_of::cell<SrcMeshT>::type CellType;
     typedef typename viennagrid::result_of::cell_handle<DstMeshT>::type CellHandleType;
 
-    ConstCellRangeType cells(src_mesh);
-    for (ConstCellIteratorType cit = cells.begin(); cit != cells.end(); ++cit)
+    std::vector<CellType const *> selected_cells;
+    detail::cells_to_copy( src_mesh, functor, selected_cells );
+
+    for (std::size_t i = 0; i < selected_cells.size(); ++i)
     {
-      if ( functor(*cit) )
-      {
-        CellHandleType cell_handle = vertex_map.copy_element(*cit );
-        viennagrid::add( dst_segmentation, viennagrid::segment_ids( src_segmentation, *cit ).begin(), viennagrid::segment_ids( src_segmentation, *cit ).end(), cell_handle );
-      }
+      CellType const & cell = *selected_cells[i];
+      CellHandleType cell_handle = vertex_map.copy_element( cell );
+      viennagrid::add( dst_segmentation, viennagrid::segment_ids( src_segmentation, cell ).begin(), viennagrid::segment_ids( src_segmentation, cell ).end(), cell_handle );
     }
   }
 
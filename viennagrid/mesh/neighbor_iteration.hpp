@@ -13,8 +13,13 @@
    License:      MIT (X11), see file LICENSE in the base directory
 ======================================================================= */
 
+#include <vector>
+#include <utility>
+#include <algorithm>
+
 #include "viennagrid/mesh/segmentation.hpp"
 #include "viennagrid/mesh/coboundary_iteration.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 /** @file viennagrid/mesh/neighbor_iteration.hpp
     @brief Contains definition and implementation of neighbor iteration
@@ -171,26 +176,41 @@ namespace viennagrid
   namespace detail
   {
 
-    /** @brief For internal use only */
+    /** @brief For internal use only. Emits all pairs of elements sharing a connector element bucketed by element, sorts and removes duplicate pairs per element and fills each neighbor view with exactly the required size. */
     template<typename ElementTypeOrTagT, typename ConnectorElementTypeOrTagT, typename mesh_type, typename neigbour_accessor_type>
     void create_neighbor_information(mesh_type & mesh_obj, neigbour_accessor_type accessor)
     {
+      VIENNAGRID_INSTRUMENT_SCOPE("neighbor: create");
       typedef typename viennagrid::result_of::element_tag< ElementTypeOrTagT >::type          element_tag;
       typedef typename viennagrid::result_of::element_tag< ConnectorElementTypeOrTagT >::type connector_element_tag;
 
       typedef typename viennagrid::result_of::element< mesh_type, ElementTypeOrTagT >::type   element_type;
+      typedef typename viennagrid::result_of::neighbor_view<mesh_type, ElementTypeOrTagT, ConnectorElementTypeOrTagT>::type view_type;
 
       typedef typename viennagrid::result_of::element_range< mesh_type, ElementTypeOrTagT >::type element_range_type;
       typedef typename viennagrid::result_of::iterator< element_range_type >::type                element_range_iterator;
+      typedef typename viennagrid::result_of::handle< mesh_type, ElementTypeOrTagT >::type        element_handle_type;
 
       element_range_type elements(mesh_obj);
 
+      // number the elements in the order of the range, the IDs are not necessarily contiguous (e.g. within a segment)
+      std::vector<element_handle_type> handles;
+      std::size_t id_bound = 0;
       for ( element_range_iterator it = elements.begin(); it != elements.end(); ++it )
       {
         accessor( *it ).clear();
-        accessor( *it ).set_base_container( viennagrid::get< element_type >( element_collection(mesh_obj) ) );
+        handles.push_back( it.handle() );
+        id_bound = std::max<std::size_t>( id_bound, static_cast<std::size_t>(it->id().get()) + 1 );
       }
 
+      std::vector<std::size_t> index_of(id_bound);
+      for (std::size_t i = 0; i < handles.size(); ++i)
+        index_of[ static_cast<std::size_t>(viennagrid::dereference_handle(mesh_obj, handles[i]).id().get()) ] = i;
+
+      // the elements on each connector element, stored consecutively
+      std::vector<std::size_t> connector_offsets(1, 0);
+      std::vector<std::size_t> connector_members;
+
       typedef typename viennagrid::result_of::element_range< mesh_type, connector_element_tag >::type     connector_element_range_type;
       typedef typename viennagrid::result_of::iterator< connector_element_range_type >::type              connector_element_range_iterator;
 
@@ -201,29 +221,41 @@ namespace viennagrid
         typedef typename viennagrid::result_of::iterator< element_on_connector_element_range_type >::type                 element_on_connector_element_range_iterator;
 
         element_on_connector_element_range_type coboundary_range = viennagrid::coboundary_elements<connector_element_tag, element_tag>( mesh_obj, it.handle() );
-        if (coboundary_range.empty())
-            continue;
-
-        element_on_connector_element_range_iterator jt1 = coboundary_range.begin(); ++jt1;
-        for (; jt1 != coboundary_range.end(); ++jt1)
-        {
-          for (element_on_connector_element_range_iterator jt0 = coboundary_range.begin(); jt0 != jt1; ++jt0)
-          {
-            typedef typename viennagrid::result_of::neighbor_view<mesh_type, ElementTypeOrTagT, ConnectorElementTypeOrTagT>::type view_type;
-            view_type & view_obj = accessor( *jt0 );
-
-            typename view_type::iterator kt = view_obj.begin();
-            for (; kt != view_obj.end(); ++kt)
-              if ( kt->id() == jt1->id() )
-                break;
-
-            if (kt == view_obj.end())
-            {
-              accessor( *jt0 ).insert_handle( jt1.handle() );
-              accessor( *jt1 ).insert_handle( jt0.handle() );
-            }
-          }
-        }
+        for (element_on_connector_element_range_iterator jt = coboundary_range.begin(); jt != coboundary_range.end(); ++jt)
+          connector_members.push_back( index_of[ static_cast<std::size_t>(jt->id().get()) ] );
+        connector_offsets.push_back( connector_members.size() );
+      }
+
+      // emit the pairs (element, neighbor) bucketed by element, a pair appears once for each shared connector element
+      std::vector<std::size_t> pair_offsets( handles.size() + 1, 0 );
+      for (std::size_t c = 0; c+1 < connector_offsets.size(); ++c)
+        for (std::size_t k = connector_offsets[c]; k < connector_offsets[c+1]; ++k)
+          pair_offsets[ connector_members[k] + 1 ] += connector_offsets[c+1] - connector_offsets[c] - 1;
+      for (std::size_t i = 0; i < handles.size(); ++i)
+        pair_offsets[i+1] += pair_offsets[i];
+
+      std::vector<std::size_t> pair_neighbors( pair_offsets.back() );
+      std::vector<std::size_t> fill( pair_offsets.begin(), pair_offsets.end()-1 );
+      for (std::size_t c = 0; c+1 < connector_offsets.size(); ++c)
+        for (std::size_t k = connector_offsets[c]; k < connector_offsets[c+1]; ++k)
+          for (std::size_t l = connector_offsets[c]; l < connector_offsets[c+1]; ++l)
+            if (k != l)
+              pair_neighbors[ fill[connector_members[k]]++ ] = connector_members[l];
+
+      std::size_t i = 0;
+      for ( element_range_iterator it = elements.begin(); it != elements.end(); ++it, ++i )
+      {
+        // sort and remove duplicates, the neighbors of each element are stored in the order of the element range
+        std::vector<std::size_t>::iterator first = pair_neighbors.begin() + static_cast<std::ptrdiff_t>(pair_offsets[i]);
+        std::vector<std::size_t>::iterator last  = pair_neighbors.begin() + static_cast<std::ptrdiff_t>(pair_offsets[i+1]);
+        std::sort(first, last);
+        last = std::unique(first, last);
+
+        view_type & view_obj = accessor( *it );
+        view_obj.set_base_container( viennagrid::get< element_type >( element_collection(mesh_obj) ) );
+        view_obj.resize( static_cast<typename view_type::size_type>(last - first) );
+        for (std::size_t pos = 0; first != last; ++first, ++pos)
+          view_obj.set_handle( handles[*first], pos );
       }
     }
 
@@ -247,7 +279,36 @@ namespace viennagrid
 
       create_neighbor_information<ElementTypeOrTagT, ConnectorElementTypeOrTagT>( mesh_obj, viennagrid::make_accessor<element_type>(neighbor_container_wrapper.container) );
 
-      detail::update_change_counter( mesh_obj, neighbor_container_wrapper.change_counter );
+      detail::update_dependency_change_counter< typename viennagrid::make_typelist<element_tag, connector_element_tag>::type >( mesh_obj, neighbor_container_wrapper.change_counter );
+    }
+
+
+
+    /** @brief For internal use only. Re-creates the neighbor information if elements of the element type or the connector type changed. Thread-safe, see viennagrid/mesh/cache_guard.hpp */
+    template<typename ElementTypeOrTagT, typename ConnectorElementTypeOrTagT, typename WrappedConfigT>
+    void prepare_neighbor_information(viennagrid::mesh<WrappedConfigT> const & mesh_obj)
+    {
+      typedef viennagrid::mesh<WrappedConfigT> mesh_type;
+      typedef typename viennagrid::result_of::element_tag< ElementTypeOrTagT >::type element_tag;
+      typedef typename viennagrid::result_of::element_tag< ConnectorElementTypeOrTagT >::type connector_element_tag;
+
+      typedef typename viennagrid::detail::result_of::lookup<
+              typename viennagrid::detail::result_of::lookup<
+                  typename mesh_type::appendix_type,
+                  neighbor_collection_tag
+              >::type,
+              viennagrid::static_pair<element_tag, connector_element_tag>
+              >::type neighbor_container_wrapper_type;
+      neighbor_container_wrapper_type const & neighbor_container_wrapper = detail::neighbor_collection<element_tag, connector_element_tag>(mesh_obj);
+
+      typedef typename viennagrid::make_typelist<element_tag, connector_element_tag>::type dependency_taglist;
+
+      if ( detail::is_dependency_obsolete<dependency_taglist>( mesh_obj, neighbor_container_wrapper.change_counter ) )
+      {
+        detail::cache_update_guard guard;
+        if ( detail::is_dependency_obsolete<dependency_taglist>( mesh_obj, neighbor_container_wrapper.change_counter ) )
+          detail::create_neighbor_information<ElementTypeOrTagT, ConnectorElementTypeOrTagT>( const_cast<mesh_type&>(mesh_obj) );
+      }
     }
 
 
@@ -289,7 +350,7 @@ namespace viennagrid
 
   }
 
-  /** @brief Obtaines a neighbor range of an element within a mesh. This function caches the neighbor information and re-creates it if the cached information is out of date. The worst case runtime of a re-creation is linear in the number of elements of type ConnectorElementTypeOrTagT time the number of elements of type ElementTypeOrTagT within the mesh.
+  /** @brief Obtaines a neighbor range of an element within a mesh. This function caches the neighbor information and re-creates it if the cached information is out of date. The runtime of a re-creation is proportional to the number of pairs of elements of type ElementTypeOrTagT sharing an element of type ConnectorElementTypeOrTagT within the mesh, up to a logarithmic factor for sorting.
     *
     * @tparam ElementTypeOrTagT             The base element type/tag from which the neighbor range is obtained
     * @tparam ConnectorElementTypeOrTagT    The connector element type/tag
@@ -317,13 +378,12 @@ namespace viennagrid
             >::type neighbor_container_wrapper_type;
     neighbor_container_wrapper_type & neighbor_container_wrapper = detail::neighbor_collection<element_tag, connector_element_tag>(mesh_obj);
 
-    if ( detail::is_obsolete( mesh_obj, neighbor_container_wrapper.change_counter ) )
-      detail::create_neighbor_information<ElementTypeOrTagT, ConnectorElementTypeOrTagT>(mesh_obj);
+    detail::prepare_neighbor_information<ElementTypeOrTagT, ConnectorElementTypeOrTagT>(mesh_obj);
 
     return detail::neighbor_elements<ElementTypeOrTagT, ConnectorElementTypeOrTagT>( viennagrid::make_accessor<element_type>(neighbor_container_wrapper.container), viennagrid::dereference_handle(mesh_obj, element_or_handle) );
   }
 
-  /** @brief Obtaines a const neighbor range of an element within a mesh. This function caches the neighbor information and re-creates it if the cached information is out of date. The worst case runtime of a re-creation is linear in the number of elements of type ConnectorElementTypeOrTagT time the number of elements of type ElementTypeOrTagT within the mesh.
+  /** @brief Obtaines a const neighbor range of an element within a mesh. This function caches the neighbor information and re-creates it if the cached information is out of date. The runtime of a re-creation is proportional to the number of pairs of elements of type ElementTypeOrTagT sharing an element of type ConnectorElementTypeOrTagT within the mesh, up to a logarithmic factor for sorting.
     *
     * @tparam ElementTypeOrTagT             The base element type/tag from which the neighbor range is obtained
     * @tparam ConnectorElementTypeOrTagT    The connector element type/tag
@@ -351,15 +411,14 @@ namespace viennagrid
             >::type neighbor_container_wrapper_type;
     neighbor_container_wrapper_type const & neighbor_container_wrapper = detail::neighbor_collection<element_tag, connector_element_tag>(mesh_obj);
 
-    if ( detail::is_obsolete( mesh_obj, neighbor_container_wrapper.change_counter ) )
-      detail::create_neighbor_information<ElementTypeOrTagT, ConnectorElementTypeOrTagT>( const_cast<mesh_type&>(mesh_obj) );
+    detail::prepare_neighbor_information<ElementTypeOrTagT, ConnectorElementTypeOrTagT>(mesh_obj);
 
 
     return detail::neighbor_elements<ElementTypeOrTagT, ConnectorElementTypeOrTagT>( viennagrid::make_accessor<element_type>(neighbor_container_wrapper.container), viennagrid::dereference_handle(mesh_obj, element_or_handle) );
   }
 
 
-  /** @brief Obtaines a neighbor range of an element within a segment. This function caches the neighbor information and re-creates it if the cached information is out of date. The worst case runtime of a re-creation is linear in the number of elements of type ConnectorElementTypeOrTagT time the number of elements of type ElementTypeOrTagT within the segment.
+  /** @brief Obtaines a neighbor range of an element within a segment. This function caches the neighbor information and re-creates it if the cached information is out of date. The runtime of a re-creation is proportional to the number of pairs of elements of type ElementTypeOrTagT sharing an element of type ConnectorElementTypeOrTagT within the segment, up to a logarithmic factor for sorting.
     *
     * @tparam ElementTypeOrTagT             The base element type/tag from which the neighbor range is obtained
     * @tparam ConnectorElementTypeOrTagT    The connector element type/tag
@@ -376,7 +435,7 @@ namespace viennagrid
     return neighbor_elements<ElementTypeOrTagT, ConnectorElementTypeOrTagT>( segment.view(), element_or_handle );
   }
 
-  /** @brief Obtaines a const neighbor range of an element within a segment. This function caches the neighbor information and re-creates it if the cached information is out of date. The worst case runtime of a re-creation is linear in the number of elements of type ConnectorElementTypeOrTagT time the number of elements of type ElementTypeOrTagT within the segment.
+  /** @brief Obtaines a const neighbor range of an element within a segment. This function caches the neighbor information and re-creates it if the cached information is out of date. The runtime of a re-creation is proportional to the number of pairs of elements of type ElementTypeOrTagT sharing an element of type ConnectorElementTypeOrTagT within the segment, up to a logarithmic factor for sorting.
     *
     * @tparam ElementTypeOrTagT             The base element type/tag from which the neighbor range is obtained
     * @tparam ConnectorElementTypeOrTagT    The connector element type/tag
@@ -393,6 +452,34 @@ namespace viennagrid
     return neighbor_elements<ElementTypeOrTagT, ConnectorElementTypeOrTagT>( segment.view(), element_or_handle );
   }
 
+
+
+  /** @brief Creates the neighbor information of a mesh if it is out of date. Call this function before querying neighbor ranges of a shared mesh from multiple threads, afterwards the queries do not modify the mesh.
+    *
+    * @tparam ElementTypeOrTagT             The base element type/tag of the neighbor ranges
+    * @tparam ConnectorElementTypeOrTagT    The connector element type/tag
+    * @tparam WrappedConfigT                The wrapped config of the mesh
+    * @param  mesh_obj                      The mesh object
+    */
+  template<typename ElementTypeOrTagT, typename ConnectorElementTypeOrTagT, typename WrappedConfigT>
+  void prepare_neighbors(viennagrid::mesh<WrappedConfigT> const & mesh_obj)
+  {
+    detail::prepare_neighbor_information<ElementTypeOrTagT, ConnectorElementTypeOrTagT>(mesh_obj);
+  }
+
+  /** @brief Creates the neighbor information of a segment if it is out of date. Call this function before querying neighbor ranges of a shared segment from multiple threads, afterwards the queries do not modify the segment.
+    *
+    * @tparam ElementTypeOrTagT             The base element type/tag of the neighbor ranges
+    * @tparam ConnectorElementTypeOrTagT    The connector element type/tag
+    * @tparam SegmentationT                 The segmentation type of the segment type
+    * @param  segment                       The segment object
+    */
+  template<typename ElementTypeOrTagT, typename ConnectorElementTypeOrTagT, typename SegmentationT>
+  void prepare_neighbors(segment_handle<SegmentationT> const & segment)
+  {
+    detail::prepare_neighbor_information<ElementTypeOrTagT, ConnectorElementTypeOrTagT>( segment.view() );
+  }
+
 }
 
 
@@ -259,7 +259,7 @@ namespace viennagrid
 
     /** @brief For internal use only */
     template<typename SegmentationType>
-    bool is_obsolete( segment_handle<SegmentationType> const & segment, typename segment_handle<SegmentationType>::view_type::change_counter_type change_counter_to_check )
+    bool is_obsolete( segment_handle<SegmentationType> const & segment, typename segment_handle<SegmentationType>::view_type::change_counter_type const & change_counter_to_check )
     { return is_obsolete(segment.view(), change_counter_to_check); }
 
     /** @brief For internal use only */
@@ -272,6 +272,16 @@ namespace viennagrid
     void increment_change_counter( segment_handle<SegmentationType> & segment )
     { increment_change_counter(segment.view()); }
 
+    /** @brief For internal use only */
+    template<typename ElementTaglistT, typename SegmentationType>
+    bool is_dependency_obsolete( segment_handle<SegmentationType> const & segment, typename segment_handle<SegmentationType>::view_type::change_counter_type const & change_counter_to_check )
+    { return is_dependency_obsolete<ElementTaglistT>(segment.view(), change_counter_to_check); }
+
+    /** @brief For internal use only */
+    template<typename ElementTaglistT, typename SegmentationType>
+    void update_dependency_change_counter( segment_handle<SegmentationType> const & segment, typename segment_handle<SegmentationType>::view_type::change_counter_type & change_counter_to_update )
+    { update_dependency_change_counter<ElementTaglistT>(segment.view(), change_counter_to_update); }
+
 
 
     /** @brief For internal use only */
@@ -530,6 +540,8 @@ namespace viennagrid
     /** @brief For internal use only */
     typedef typename result_of::segmentation_segment_container_tag<WrappedConfigType>::type segment_container_tag;
 
+    /** @brief For internal use only */
+    typedef WrappedConfigType wrapped_config_type;
     /** @brief For internal use only */
     typedef viennagrid::segmentation<WrappedConfigType> self_type;
 
@@ -798,7 +810,7 @@ namespace viennagrid
       typename segment_name_map_type::const_iterator it = segment_name_map.find(segment_name);
       if( it == segment_name_map.end() )
         throw viennagrid::segment_name_not_found_exception(segment_name);
-      return it->second;
+      return *it->second;
     }
 
 
@@ -916,6 +928,7 @@ namespace viennagrid
     {
       highest_id = -1;
       segment_id_map.clear();
+      segment_name_map.clear();
       segments.clear();
       appendix_ = appendix_type();
     }
@@ -1234,7 +1247,11 @@ namespace viennagrid
     };
 
 
-    /** @brief For internal use only */
+    /** @brief For internal use only. Holds the interface information of all segment pairs for one element type.
+      *
+      * The information of a segment pair is created on first use. Entries are never removed while the segmentation is shared (only clear() removes them), hence each created entry is published in a small hash index of immutable nodes, which is searched without locking.
+      * Only the creation of an entry takes the cache update lock.
+      */
     template<typename segment_id_type, typename container_type_, typename ChangeCounterType>
     struct interface_information_wrapper
     {
@@ -1243,7 +1260,26 @@ namespace viennagrid
       typedef std::pair<segment_id_type, segment_id_type> key_type;
       typedef std::map< key_type, segment_interface_information_wrapper_type > map_type;
 
-      interface_information_wrapper() {}
+      interface_information_wrapper() { clear_index(); }
+
+      interface_information_wrapper(interface_information_wrapper const & other) : interface_flags(other.interface_flags)
+      {
+        clear_index();
+        build_index();
+      }
+
+      interface_information_wrapper & operator=(interface_information_wrapper const & other)
+      {
+        if (this != &other)
+        {
+          release_index();
+          interface_flags = other.interface_flags;
+          build_index();
+        }
+        return *this;
+      }
+
+      ~interface_information_wrapper() { release_index(); }
 
       template<typename segment_handle_type>
       segment_interface_information_wrapper_type & get_interface_wrapper_impl( segment_handle_type const & seg0, segment_handle_type const & seg1 ) const
@@ -1252,7 +1288,19 @@ namespace viennagrid
 
         key_type key( std::min(seg0.id(), seg1.id()), std::max(seg0.id(), seg1.id()) );
 
-        return interface_flags[ key ];
+        segment_interface_information_wrapper_type * wrapper = find(key);
+        if (wrapper)
+          return *wrapper;
+
+        // the entry of the segment pair does not exist yet, creation is serialized
+        cache_update_guard guard;
+        wrapper = find(key);
+        if (!wrapper)
+        {
+          wrapper = &interface_flags[key];
+          publish(key, wrapper);
+        }
+        return *wrapper;
       }
 
       template<typename segment_handle_type>
@@ -1263,7 +1311,77 @@ namespace viennagrid
       segment_interface_information_wrapper_type const & get_interface_wrapper( segment_handle_type const & seg0, segment_handle_type const & seg1 ) const
       { return get_interface_wrapper_impl(seg0, seg1); }
 
+      /** @brief Removes the interface information of all segment pairs, must not be called while other threads query the segmentation */
+      void clear()
+      {
+        release_index();
+        map_type().swap(interface_flags);
+      }
+
       mutable map_type interface_flags;
+
+    private:
+
+      struct index_node
+      {
+        key_type key;
+        segment_interface_information_wrapper_type * wrapper;
+        index_node * next;
+      };
+
+      static const std::size_t index_bucket_count = 64;
+
+      static std::size_t bucket(key_type const & key)
+      {
+        return (static_cast<std::size_t>(key.first) * 31u + static_cast<std::size_t>(key.second)) % index_bucket_count;
+      }
+
+      segment_interface_information_wrapper_type * find(key_type const & key) const
+      {
+        for (index_node * node = load_acquire(index[bucket(key)]); node; node = node->next)
+          if (node->key == key)
+            return node->wrapper;
+        return NULL;
+      }
+
+      /** @brief Adds an entry of interface_flags to the index, the caller has to hold the cache update lock */
+      void publish(key_type const & key, segment_interface_information_wrapper_type * wrapper) const
+      {
+        std::size_t b = bucket(key);
+
+        index_node * node = new index_node;
+        node->key = key;
+        node->wrapper = wrapper;
+        node->next = index[b];
+        store_release(index[b], node);
+      }
+
+      void clear_index()
+      {
+        for (std::size_t i = 0; i < index_bucket_count; ++i)
+          index[i] = NULL;
+      }
+
+      void build_index()
+      {
+        for (typename map_type::iterator it = interface_flags.begin(); it != interface_flags.end(); ++it)
+          publish(it->first, &it->second);
+      }
+
+      void release_index()
+      {
+        for (std::size_t i = 0; i < index_bucket_count; ++i)
+        {
+          while (index[i])
+          {
+            index_node * next = index[i]->next;
+            delete index[i];
+            index[i] = next;
+          }
+        }
+      }
+
+      mutable index_node * index[index_bucket_count];
     };
 
 
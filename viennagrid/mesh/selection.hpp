@@ -0,0 +1,404 @@
+#ifndef VIENNAGRID_MESH_SELECTION_HPP
+#define VIENNAGRID_MESH_SELECTION_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <climits>
+
+#include "viennagrid/forwards.hpp"
+#include "viennagrid/mesh/mesh.hpp"
+#include "viennagrid/mesh/cache_guard.hpp"
+
+/** @file viennagrid/mesh/selection.hpp
+    @brief Selections of elements of a mesh stored as bitset over the element IDs
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+    /** @brief The word type of the bitsets of selections */
+    typedef unsigned long selection_word_type;
+
+    /** @brief The number of bits in one word of a selection */
+    static const std::size_t selection_word_bits = sizeof(selection_word_type) * CHAR_BIT;
+
+    /** @brief Returns the number of set bits of a word */
+    inline std::size_t popcount(selection_word_type word)
+    {
+#if defined(__GNUC__)
+      return static_cast<std::size_t>( __builtin_popcountl(word) );
+#else
+      std::size_t count = 0;
+      for (; word; word &= word - 1)
+        ++count;
+      return count;
+#endif
+    }
+
+    /** @brief Returns the position of the lowest set bit of a non-zero word */
+    inline std::size_t lowest_bit(selection_word_type word)
+    {
+#if defined(__GNUC__)
+      return static_cast<std::size_t>( __builtin_ctzl(word) );
+#else
+      std::size_t pos = 0;
+      for (; !(word & 1); word >>= 1)
+        ++pos;
+      return pos;
+#endif
+    }
+  }
+
+
+  /** @brief A selection of elements of one type of a mesh, stored as one bit per element ID.
+    *
+    * In contrast to views obtained from viennagrid::element_view(), which store one handle per selected element, contains(), insert() and erase() take constant time,
+    * size() counts the set bits word by word, the set operations (&=, |=, -=) work on whole words and the iteration skips words without selected elements.
+    * The iteration visits the elements in the order of their IDs. An element is obtained from its ID in constant time as long as the ID equals the position of the element in the mesh,
+    * which is the case for cells unless elements were deleted. Otherwise the elements are looked up in a table, which is created on demand and re-created after the mesh has changed.
+    * Selected IDs of elements which were deleted from the mesh are skipped by the iteration, but still counted by size() and contains() until they are erased from the selection.
+    * Like the other caches of a mesh, the table is built under the cache update lock, hence a selection can be iterated by several threads concurrently.
+    *
+    * @tparam MeshT              The mesh type
+    * @tparam ElementTypeOrTagT  The element type/tag of the selected elements
+    */
+  template<typename MeshT, typename ElementTypeOrTagT>
+  class element_selection
+  {
+  public:
+    typedef MeshT                                                                           mesh_type;
+    typedef typename viennagrid::result_of::element_tag<ElementTypeOrTagT>::type            element_tag;
+    typedef typename viennagrid::result_of::element<MeshT, element_tag>::type               element_type;
+    typedef typename viennagrid::result_of::handle<MeshT, element_tag>::type                handle_type;
+    typedef typename viennagrid::result_of::element_range<MeshT, element_tag>::type         range_type;
+    typedef std::size_t                                                                     size_type;
+
+    /** @brief Iterator over the selected elements in the order of their IDs */
+    class iterator
+    {
+    public:
+      typedef std::forward_iterator_tag         iterator_category;
+      typedef element_type                      value_type;
+      typedef std::ptrdiff_t                    difference_type;
+      typedef element_type *                    pointer;
+      typedef element_type &                    reference;
+
+      iterator() : selection_(NULL), id_(0) {}
+      iterator(element_selection const * selection_obj, std::size_t id_obj) : selection_(selection_obj), id_(id_obj) {}
+
+      reference operator*() const { return *selection_->find_element(id_); }
+      pointer operator->() const { return selection_->find_element(id_); }
+
+      /** @brief Returns the ID of the current element */
+      std::size_t id() const { return id_; }
+      /** @brief Returns the handle of the current element */
+      handle_type handle() const { return viennagrid::handle( *selection_->mesh_, **this ); }
+
+      iterator & operator++() { id_ = selection_->next_element(id_ + 1); return *this; }
+      iterator operator++(int) { iterator tmp(*this); ++*this; return tmp; }
+
+      bool operator==(iterator const & other) const { return id_ == other.id_; }
+      bool operator!=(iterator const & other) const { return id_ != other.id_; }
+
+    private:
+      element_selection const * selection_;
+      std::size_t id_;
+    };
+
+    typedef iterator const_iterator;
+
+
+    /** @brief Creates an empty selection for the elements of a mesh */
+    explicit element_selection(mesh_type & mesh_obj) : mesh_(&mesh_obj), table_change_counter_(0), table_valid_(false)
+    {
+      words_.resize( word_count( static_cast<std::size_t>(viennagrid::id_upper_bound<element_type>(mesh_obj).get()) ) );
+    }
+
+    /** @brief Returns the mesh of the selection */
+    mesh_type & mesh() const { return *mesh_; }
+
+    /** @brief Returns true if the element with the given ID is selected */
+    bool contains(std::size_t id) const
+    {
+      std::size_t word = id / detail::selection_word_bits;
+      return word < words_.size() && (words_[word] & bit(id)) != 0;
+    }
+    /** @brief Returns true if the element is selected */
+    bool contains(element_type const & element) const { return contains( static_cast<std::size_t>(element.id().get()) ); }
+
+    /** @brief Selects the element with the given ID */
+    void insert(std::size_t id)
+    {
+      std::size_t word = id / detail::selection_word_bits;
+      if (word >= words_.size())
+        words_.resize(word + 1);
+      words_[word] |= bit(id);
+    }
+    /** @brief Selects an element */
+    void insert(element_type const & element) { insert( static_cast<std::size_t>(element.id().get()) ); }
+
+    /** @brief Deselects the element with the given ID */
+    void erase(std::size_t id)
+    {
+      std::size_t word = id / detail::selection_word_bits;
+      if (word < words_.size())
+        words_[word] &= ~bit(id);
+    }
+    /** @brief Deselects an element */
+    void erase(element_type const & element) { erase( static_cast<std::size_t>(element.id().get()) ); }
+
+    /** @brief Deselects all elements */
+    void clear() { std::fill(words_.begin(), words_.end(), detail::selection_word_type(0)); }
+
+    /** @brief Returns the number of selected elements */
+    size_type size() const
+    {
+      size_type count = 0;
+      for (std::size_t i = 0; i < words_.size(); ++i)
+        count += detail::popcount(words_[i]);
+      return count;
+    }
+
+    /** @brief Returns true if no element is selected */
+    bool empty() const
+    {
+      for (std::size_t i = 0; i < words_.size(); ++i)
+        if (words_[i])
+          return false;
+      return true;
+    }
+
+    iterator begin() const { return iterator(this, next_element(0)); }
+    iterator end() const { return iterator(this, end_id()); }
+
+    /** @brief Keeps only the elements which are also selected in 'other' */
+    element_selection & operator&=(element_selection const & other)
+    {
+      std::size_t common = std::min(words_.size(), other.words_.size());
+      for (std::size_t i = 0; i < common; ++i)
+        words_[i] &= other.words_[i];
+      std::fill(words_.begin() + static_cast<std::ptrdiff_t>(common), words_.end(), detail::selection_word_type(0));
+      return *this;
+    }
+
+    /** @brief Adds all elements selected in 'other' */
+    element_selection & operator|=(element_selection const & other)
+    {
+      if (other.words_.size() > words_.size())
+        words_.resize(other.words_.size());
+      for (std::size_t i = 0; i < other.words_.size(); ++i)
+        words_[i] |= other.words_[i];
+      return *this;
+    }
+
+    /** @brief Removes all elements selected in 'other' */
+    element_selection & operator-=(element_selection const & other)
+    {
+      std::size_t common = std::min(words_.size(), other.words_.size());
+      for (std::size_t i = 0; i < common; ++i)
+        words_[i] &= ~other.words_[i];
+      return *this;
+    }
+
+    /** @brief Returns true if both selections contain the same elements */
+    bool operator==(element_selection const & other) const
+    {
+      std::size_t common = std::min(words_.size(), other.words_.size());
+      for (std::size_t i = 0; i < common; ++i)
+        if (words_[i] != other.words_[i])
+          return false;
+      for (std::size_t i = common; i < words_.size(); ++i)
+        if (words_[i])
+          return false;
+      for (std::size_t i = common; i < other.words_.size(); ++i)
+        if (other.words_[i])
+          return false;
+      return true;
+    }
+    bool operator!=(element_selection const & other) const { return !(*this == other); }
+
+  private:
+    friend class iterator;
+
+    static std::size_t word_count(std::size_t id_count) { return (id_count + detail::selection_word_bits - 1) / detail::selection_word_bits; }
+    static detail::selection_word_type bit(std::size_t id) { return detail::selection_word_type(1) << (id % detail::selection_word_bits); }
+
+    std::size_t end_id() const { return words_.size() * detail::selection_word_bits; }
+
+    /** @brief Returns the smallest selected ID not smaller than 'id', or end_id() if there is none */
+    std::size_t next(std::size_t id) const
+    {
+      std::size_t word = id / detail::selection_word_bits;
+      if (word >= words_.size())
+        return end_id();
+
+      // mask out the bits below 'id' in the first word, then skip empty words
+      detail::selection_word_type bits = words_[word] & (~detail::selection_word_type(0) << (id % detail::selection_word_bits));
+      while (!bits)
+      {
+        if (++word == words_.size())
+          return end_id();
+        bits = words_[word];
+      }
+      return word * detail::selection_word_bits + detail::lowest_bit(bits);
+    }
+
+    /** @brief Returns the smallest selected ID not smaller than 'id' which refers to an element of the mesh, or end_id() if there is none */
+    std::size_t next_element(std::size_t id) const
+    {
+      for (id = next(id); id != end_id() && !find_element(id); id = next(id + 1)) {}
+      return id;
+    }
+
+    /** @brief Returns the element with the given ID, or NULL if the mesh contains no such element (e.g. because it was deleted) */
+    element_type * find_element(std::size_t id) const
+    {
+      typedef typename viennagrid::result_of::iterator<range_type>::type range_iterator;
+      typedef typename std::iterator_traits<range_iterator>::iterator_category iterator_category;
+
+      range_type range = viennagrid::elements<element_tag>(*mesh_);
+      if ( is_random_access(iterator_category()) && id < range.size() )
+      {
+        element_type & element = range[id];
+        if (static_cast<std::size_t>(element.id().get()) == id)
+          return &element;
+      }
+
+      // the elements are not stored by ID (e.g. in a std::map or after deletion of elements): use a table which is re-created if the mesh has changed
+      if ( !detail::load_acquire(table_valid_) || detail::is_obsolete(*mesh_, table_change_counter_) )
+      {
+        detail::cache_update_guard guard;
+        if ( !table_valid_ || detail::is_obsolete(*mesh_, table_change_counter_) )
+        {
+          elements_by_id_.assign( static_cast<std::size_t>(viennagrid::id_upper_bound<element_type>(*mesh_).get()), static_cast<element_type *>(NULL) );
+          for (range_iterator it = range.begin(); it != range.end(); ++it)
+            elements_by_id_[ static_cast<std::size_t>((*it).id().get()) ] = &*it;
+          detail::update_change_counter(*mesh_, table_change_counter_);
+          detail::store_release(table_valid_, true);
+        }
+      }
+      return id < elements_by_id_.size() ? elements_by_id_[id] : NULL;
+    }
+
+    static bool is_random_access(std::random_access_iterator_tag) { return true; }
+    static bool is_random_access(std::input_iterator_tag) { return false; }
+
+    mesh_type * mesh_;
+    std::vector<detail::selection_word_type> words_;
+
+    mutable std::vector<element_type *> elements_by_id_;
+    mutable typename mesh_type::change_counter_type table_change_counter_;
+    mutable bool table_valid_;
+  };
+
+
+  /** @brief Returns the elements selected in both selections */
+  template<typename MeshT, typename ElementTypeOrTagT>
+  element_selection<MeshT, ElementTypeOrTagT> operator&(element_selection<MeshT, ElementTypeOrTagT> lhs, element_selection<MeshT, ElementTypeOrTagT> const & rhs)
+  { return lhs &= rhs; }
+
+  /** @brief Returns the elements selected in at least one of the selections */
+  template<typename MeshT, typename ElementTypeOrTagT>
+  element_selection<MeshT, ElementTypeOrTagT> operator|(element_selection<MeshT, ElementTypeOrTagT> lhs, element_selection<MeshT, ElementTypeOrTagT> const & rhs)
+  { return lhs |= rhs; }
+
+  /** @brief Returns the elements selected in the first but not in the second selection */
+  template<typename MeshT, typename ElementTypeOrTagT>
+  element_selection<MeshT, ElementTypeOrTagT> operator-(element_selection<MeshT, ElementTypeOrTagT> lhs, element_selection<MeshT, ElementTypeOrTagT> const & rhs)
+  { return lhs -= rhs; }
+
+
+
+  namespace result_of
+  {
+    /** @brief Returns the selection type for the provided element type or tag of a mesh or segment */
+    template<typename MeshOrSegmentHandleT, typename ElementTypeOrTagT>
+    struct element_selection
+    {
+      typedef viennagrid::element_selection<MeshOrSegmentHandleT, ElementTypeOrTagT> type;
+    };
+
+    /** \cond */
+    template<typename SegmentationT, typename ElementTypeOrTagT>
+    struct element_selection<viennagrid::segment_handle<SegmentationT>, ElementTypeOrTagT>
+    {
+      typedef viennagrid::element_selection<typename viennagrid::segment_handle<SegmentationT>::mesh_type, ElementTypeOrTagT> type;
+    };
+    /** \endcond */
+  }
+
+
+  namespace detail
+  {
+    /** @brief For internal use only */
+    template<typename WrappedConfigT>
+    viennagrid::mesh<WrappedConfigT> & selection_mesh(viennagrid::mesh<WrappedConfigT> & mesh_obj) { return mesh_obj; }
+
+    /** @brief For internal use only */
+    template<typename SegmentationT>
+    typename segment_handle<SegmentationT>::mesh_type & selection_mesh(segment_handle<SegmentationT> & segment) { return segment.mesh(); }
+  }
+
+  /** @brief Returns a selection of all elements of a mesh or segment for which the provided filter functor evaluates to true. The selection refers to the mesh (of the segment).
+    *
+    * @tparam ElementTypeOrTagT       The element type/tag of the selected elements
+    * @param  mesh_or_segment         The mesh or segment
+    * @param  f                       The filter functor, called with an element
+    */
+  template<typename ElementTypeOrTagT, typename MeshOrSegmentHandleT, typename FunctorT>
+  typename result_of::element_selection<MeshOrSegmentHandleT, ElementTypeOrTagT>::type
+  make_selection(MeshOrSegmentHandleT & mesh_or_segment, FunctorT f)
+  {
+    typedef typename result_of::element_tag<ElementTypeOrTagT>::type             element_tag;
+    typedef typename result_of::element_range<MeshOrSegmentHandleT, element_tag>::type RangeType;
+    typedef typename result_of::iterator<RangeType>::type                           IteratorType;
+
+    typename result_of::element_selection<MeshOrSegmentHandleT, ElementTypeOrTagT>::type selection( detail::selection_mesh(mesh_or_segment) );
+
+    RangeType range(mesh_or_segment);
+    for (IteratorType it = range.begin(); it != range.end(); ++it)
+      if ( f(*it) )
+        selection.insert(*it);
+
+    return selection;
+  }
+
+  /** @brief Returns a selection of all elements of a mesh or segment. The selection refers to the mesh (of the segment).
+    *
+    * @tparam ElementTypeOrTagT       The element type/tag of the selected elements
+    * @param  mesh_or_segment         The mesh or segment
+    */
+  template<typename ElementTypeOrTagT, typename MeshOrSegmentHandleT>
+  typename result_of::element_selection<MeshOrSegmentHandleT, ElementTypeOrTagT>::type
+  make_selection(MeshOrSegmentHandleT & mesh_or_segment)
+  {
+    typedef typename result_of::element_tag<ElementTypeOrTagT>::type             element_tag;
+    typedef typename result_of::element_range<MeshOrSegmentHandleT, element_tag>::type RangeType;
+    typedef typename result_of::iterator<RangeType>::type                           IteratorType;
+
+    typename result_of::element_selection<MeshOrSegmentHandleT, ElementTypeOrTagT>::type selection( detail::selection_mesh(mesh_or_segment) );
+
+    RangeType range(mesh_or_segment);
+    for (IteratorType it = range.begin(); it != range.end(); ++it)
+      selection.insert(*it);
+
+    return selection;
+  }
+
+}
+
+#endif
@@ -0,0 +1,397 @@
+#ifndef VIENNAGRID_STORAGE_CHUNKED_VECTOR_HPP
+#define VIENNAGRID_STORAGE_CHUNKED_VECTOR_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+
+#include "viennagrid/storage/forwards.hpp"
+
+/** @file viennagrid/storage/chunked_vector.hpp
+    @brief A vector-like container storing its elements in fixed-size chunks, hence element addresses stay valid when the container grows
+*/
+
+namespace viennagrid
+{
+  /** @brief A tag indicating that chunked_vector is used as a container
+    *
+    * @tparam ChunkSizeV    The number of elements per chunk, rounded down to a power of two. 0 selects chunks of about 64 KB.
+    */
+  template<int ChunkSizeV>
+  struct chunked_vector_tag
+  {
+    static const int chunk_size = ChunkSizeV;
+  };
+
+
+  namespace detail
+  {
+    /** @brief Computes the largest power of two not greater than ValueV (at least 1) */
+    template<std::size_t ValueV, std::size_t PowerV = 1, bool DoneV = (PowerV*2 > ValueV)>
+    struct floor_power_of_two
+    {
+      static const std::size_t value = floor_power_of_two<ValueV, PowerV*2>::value;
+    };
+
+    /** \cond */
+    template<std::size_t ValueV, std::size_t PowerV>
+    struct floor_power_of_two<ValueV, PowerV, true>
+    {
+      static const std::size_t value = PowerV;
+    };
+    /** \endcond */
+
+    /** @brief Returns the number of elements per chunk of a chunked_vector for value type T, see chunked_vector_tag */
+    template<typename T, int ChunkSizeV>
+    struct chunked_vector_chunk_size
+    {
+      static const std::size_t value = floor_power_of_two<static_cast<std::size_t>(ChunkSizeV)>::value;
+    };
+
+    /** \cond */
+    template<typename T>
+    struct chunked_vector_chunk_size<T, 0>
+    {
+      static const std::size_t preferred = 65536 / sizeof(T);
+      static const std::size_t value = floor_power_of_two< (preferred < 16) ? 16 : preferred >::value;
+    };
+    /** \endcond */
+
+
+
+    /** @brief Random access iterator of chunked_vector. Besides the current element the iterator holds a pointer to the entry of the current chunk in the chunk table, hence increments only touch the chunk table at chunk boundaries.
+      *
+      * @tparam T         The value type of the chunked_vector
+      * @tparam ValueT    T for iterators, T const for const iterators
+      * @tparam ChunkSizeV  The number of elements per chunk
+      */
+    template<typename T, typename ValueT, std::size_t ChunkSizeV>
+    class chunked_vector_iterator
+    {
+      template<typename, typename, std::size_t> friend class chunked_vector_iterator;
+
+    public:
+      typedef std::random_access_iterator_tag   iterator_category;
+      typedef T                                 value_type;
+      typedef std::ptrdiff_t                    difference_type;
+      typedef ValueT *                          pointer;
+      typedef ValueT &                          reference;
+
+      chunked_vector_iterator() : cur_(NULL), node_(NULL) {}
+      chunked_vector_iterator(ValueT * cur, T * const * node) : cur_(cur), node_(node) {}
+
+      /** @brief Conversion from iterator to const iterator */
+      template<typename OtherValueT>
+      chunked_vector_iterator(chunked_vector_iterator<T, OtherValueT, ChunkSizeV> const & other) : cur_(other.cur_), node_(other.node_) {}
+
+      reference operator*() const { return *cur_; }
+      pointer operator->() const { return cur_; }
+      reference operator[](difference_type n) const { return *(*this + n); }
+
+      chunked_vector_iterator & operator++()
+      {
+        ++cur_;
+        if (cur_ == *node_ + ChunkSizeV)
+        {
+          ++node_;
+          cur_ = *node_;
+        }
+        return *this;
+      }
+      chunked_vector_iterator operator++(int) { chunked_vector_iterator tmp(*this); ++*this; return tmp; }
+
+      chunked_vector_iterator & operator--()
+      {
+        if (cur_ == *node_)
+        {
+          --node_;
+          cur_ = *node_ + ChunkSizeV;
+        }
+        --cur_;
+        return *this;
+      }
+      chunked_vector_iterator operator--(int) { chunked_vector_iterator tmp(*this); --*this; return tmp; }
+
+      chunked_vector_iterator & operator+=(difference_type n)
+      {
+        difference_type chunk_size = static_cast<difference_type>(ChunkSizeV);
+        difference_type offset = (cur_ - *node_) + n;
+        if (offset >= 0 && offset < chunk_size)
+          cur_ += n;
+        else
+        {
+          difference_type node_offset = (offset >= 0) ? offset / chunk_size : -((chunk_size - 1 - offset) / chunk_size);
+          node_ += node_offset;
+          cur_ = *node_ + (offset - node_offset * chunk_size);
+        }
+        return *this;
+      }
+      chunked_vector_iterator & operator-=(difference_type n) { return *this += -n; }
+
+      chunked_vector_iterator operator+(difference_type n) const { chunked_vector_iterator tmp(*this); return tmp += n; }
+      chunked_vector_iterator operator-(difference_type n) const { chunked_vector_iterator tmp(*this); return tmp -= n; }
+
+      template<typename OtherValueT>
+      difference_type operator-(chunked_vector_iterator<T, OtherValueT, ChunkSizeV> const & other) const
+      {
+        return static_cast<difference_type>(ChunkSizeV) * (node_ - other.node_) + (cur_ - *node_) - (other.cur_ - *other.node_);
+      }
+
+      template<typename OtherValueT>
+      bool operator==(chunked_vector_iterator<T, OtherValueT, ChunkSizeV> const & other) const { return cur_ == other.cur_; }
+      template<typename OtherValueT>
+      bool operator!=(chunked_vector_iterator<T, OtherValueT, ChunkSizeV> const & other) const { return cur_ != other.cur_; }
+      template<typename OtherValueT>
+      bool operator<(chunked_vector_iterator<T, OtherValueT, ChunkSizeV> const & other) const
+      { return (node_ == other.node_) ? (cur_ < other.cur_) : (node_ < other.node_); }
+      template<typename OtherValueT>
+      bool operator>(chunked_vector_iterator<T, OtherValueT, ChunkSizeV> const & other) const { return other < *this; }
+      template<typename OtherValueT>
+      bool operator<=(chunked_vector_iterator<T, OtherValueT, ChunkSizeV> const & other) const { return !(other < *this); }
+      template<typename OtherValueT>
+      bool operator>=(chunked_vector_iterator<T, OtherValueT, ChunkSizeV> const & other) const { return !(*this < other); }
+
+    private:
+      ValueT * cur_;
+      T * const * node_;
+    };
+
+    template<typename T, typename ValueT, std::size_t ChunkSizeV>
+    chunked_vector_iterator<T, ValueT, ChunkSizeV> operator+(std::ptrdiff_t n, chunked_vector_iterator<T, ValueT, ChunkSizeV> const & it)
+    { return it + n; }
+  }
+
+
+
+  /** @brief A sequence container with the interface of std::vector which stores its elements in chunks of a fixed number of elements.
+    *
+    * Chunks are never moved or freed while the container grows, hence pointers to elements (and therefore pointer handles) stay valid on push_back, in contrast to std::vector.
+    * Iterators point into the table of chunks, which is reallocated when the container grows, hence iterators are invalidated by push_back and reserve (like std::deque).
+    * In contrast to std::deque the chunks hold many elements even for large element types, which keeps elements densely packed for sweeps over the whole container.
+    * Erasing an element moves all subsequent elements (like std::vector), erasing the last element does not affect any other element.
+    *
+    * @tparam T             The value type
+    * @tparam ChunkSizeV    The number of elements per chunk, see chunked_vector_tag
+    */
+  template<typename T, int ChunkSizeV = 0>
+  class chunked_vector
+  {
+  public:
+    /** @brief The number of elements per chunk */
+    static const std::size_t chunk_size = detail::chunked_vector_chunk_size<T, ChunkSizeV>::value;
+
+    typedef T                 value_type;
+    typedef T *               pointer;
+    typedef T const *         const_pointer;
+    typedef T &               reference;
+    typedef T const &         const_reference;
+    typedef std::size_t       size_type;
+    typedef std::ptrdiff_t    difference_type;
+
+    typedef detail::chunked_vector_iterator<T, T, chunk_size>         iterator;
+    typedef detail::chunked_vector_iterator<T, T const, chunk_size>   const_iterator;
+    typedef std::reverse_iterator<iterator>                           reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>                     const_reverse_iterator;
+
+    chunked_vector() : chunks_(1, static_cast<T*>(NULL)), size_(0) {}
+
+    chunked_vector(chunked_vector const & other) : chunks_(1, static_cast<T*>(NULL)), size_(0)
+    {
+      reserve(other.size());
+      for (const_iterator it = other.begin(); it != other.end(); ++it)
+        push_back(*it);
+    }
+
+    ~chunked_vector()
+    {
+      clear();
+      release_chunks(0);
+    }
+
+    chunked_vector & operator=(chunked_vector const & other)
+    {
+      if (this != &other)
+      {
+        chunked_vector tmp(other);
+        swap(tmp);
+      }
+      return *this;
+    }
+
+    void swap(chunked_vector & other)
+    {
+      chunks_.swap(other.chunks_);
+      std::swap(size_, other.size_);
+    }
+
+
+    iterator begin() { return iterator(chunks_[0], &chunks_[0]); }
+    iterator end() { return make_iterator(size_); }
+    const_iterator begin() const { return const_iterator(chunks_[0], &chunks_[0]); }
+    const_iterator end() const { return make_iterator(size_); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_type max_size() const { return static_cast<size_type>(-1) / sizeof(T); }
+
+    /** @brief Returns the number of elements which can be stored without allocating a new chunk */
+    size_type capacity() const { return (chunks_.size() - 1) * chunk_size; }
+
+    /** @brief Allocates chunks for at least 'new_capacity' elements. References and pointers to elements stay valid, iterators are invalidated since the chunk table may be reallocated. */
+    void reserve(size_type new_capacity)
+    {
+      if (new_capacity > capacity())
+      {
+        chunks_.reserve( (new_capacity + chunk_size - 1) / chunk_size + 1 );
+        while (capacity() < new_capacity)
+          allocate_chunk();
+      }
+    }
+
+    /** @brief Releases all chunks which hold no elements */
+    void shrink_to_fit()
+    {
+      release_chunks( (size_ + chunk_size - 1) / chunk_size );
+      std::vector<T*>(chunks_).swap(chunks_);
+    }
+
+
+    reference operator[](size_type pos) { return chunks_[pos / chunk_size][pos % chunk_size]; }
+    const_reference operator[](size_type pos) const { return chunks_[pos / chunk_size][pos % chunk_size]; }
+
+    reference at(size_type pos)
+    {
+      if (pos >= size_)
+        throw std::out_of_range("chunked_vector::at");
+      return (*this)[pos];
+    }
+    const_reference at(size_type pos) const
+    {
+      if (pos >= size_)
+        throw std::out_of_range("chunked_vector::at");
+      return (*this)[pos];
+    }
+
+    reference front() { return *chunks_[0]; }
+    const_reference front() const { return *chunks_[0]; }
+    reference back() { return (*this)[size_-1]; }
+    const_reference back() const { return (*this)[size_-1]; }
+
+
+    void push_back(const_reference value)
+    {
+      if (size_ == capacity())
+        allocate_chunk();
+
+      new (static_cast<void*>(chunks_[size_ / chunk_size] + size_ % chunk_size)) T(value);
+      ++size_;
+    }
+
+    void pop_back()
+    {
+      --size_;
+      (chunks_[size_ / chunk_size] + size_ % chunk_size)->~T();
+    }
+
+    void resize(size_type new_size, value_type value = value_type())
+    {
+      while (size_ > new_size)
+        pop_back();
+      reserve(new_size);
+      while (size_ < new_size)
+        push_back(value);
+    }
+
+    /** @brief Destroys all elements, the chunks are kept for reuse */
+    void clear()
+    {
+      while (size_ > 0)
+        pop_back();
+    }
+
+    /** @brief Erases the element at 'pos' by moving all subsequent elements one position to the front */
+    iterator erase(iterator pos)
+    {
+      iterator next = pos;
+      ++next;
+      return erase(pos, next);
+    }
+
+    /** @brief Erases the elements in [first, last) by moving all subsequent elements to the front */
+    iterator erase(iterator first, iterator last)
+    {
+      difference_type index = first - begin();
+      difference_type count = last - first;
+      if (count > 0)
+      {
+        std::copy(last, end(), first);
+        for (difference_type i = 0; i < count; ++i)
+          pop_back();
+      }
+      return begin() + index;
+    }
+
+  private:
+
+    iterator make_iterator(size_type pos)
+    {
+      T * const * node = &chunks_[pos / chunk_size];
+      return iterator( *node ? *node + pos % chunk_size : NULL, node );
+    }
+
+    const_iterator make_iterator(size_type pos) const
+    {
+      T * const * node = &chunks_[pos / chunk_size];
+      return const_iterator( *node ? *node + pos % chunk_size : NULL, node );
+    }
+
+    // the chunk table always ends with a NULL entry, which is the node of end() if all chunks are full
+    void allocate_chunk()
+    {
+      T * chunk = static_cast<T*>( ::operator new(chunk_size * sizeof(T)) );
+      chunks_.back() = chunk;
+      chunks_.push_back(NULL);
+    }
+
+    void release_chunks(size_type chunks_to_keep)
+    {
+      while (chunks_.size() - 1 > chunks_to_keep)
+      {
+        chunks_.pop_back();
+        ::operator delete(chunks_.back());
+        chunks_.back() = NULL;
+      }
+    }
+
+    std::vector<T*> chunks_;
+    size_type size_;
+  };
+
+  template<typename T, int ChunkSizeV>
+  const std::size_t chunked_vector<T, ChunkSizeV>::chunk_size;
+
+
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include "viennagrid/storage/forwards.hpp"
 #include "viennagrid/storage/handle.hpp"
 #include "viennagrid/storage/static_array.hpp"
+#include "viennagrid/storage/chunked_vector.hpp"
 
 /** @file viennagrid/storage/container.hpp
     @brief Defines the basic building blocks of containers in ViennaGrid
@@ -507,6 +508,9 @@ namespace viennagrid
       const_iterator begin() const { return cbegin(); }
       const_iterator end() const { return cend(); }
 
+      iterator erase( iterator pos )
+      { return iterator( base_container::erase( static_cast<typename base_container::iterator const &>(pos) ) ); }
+
 
       handle_type handle_at(std::size_t pos)
       {
@@ -526,11 +530,42 @@ namespace viennagrid
 
 
 
+    template<typename ContainerT>
+    struct reserve_helper
+    {
+      template<typename HandledContainerT>
+      static void reserve(HandledContainerT &, std::size_t) {}
+    };
+
+    template<typename T, typename AllocatorT>
+    struct reserve_helper< std::vector<T, AllocatorT> >
+    {
+      template<typename HandledContainerT>
+      static void reserve(HandledContainerT & container, std::size_t size) { container.reserve(size); }
+    };
+
+    template<typename T, int ChunkSizeV>
+    struct reserve_helper< chunked_vector<T, ChunkSizeV> >
+    {
+      template<typename HandledContainerT>
+      static void reserve(HandledContainerT & container, std::size_t size) { container.reserve(size); }
+    };
+
+    /** @brief Reserves memory for 'size' elements if the container supports it (std::vector, chunked_vector), does nothing otherwise */
+    template<typename ContainerT>
+    void reserve(ContainerT &, std::size_t) {}
+
+    template<typename BaseContainerT, typename HandleTagT>
+    void reserve(container<BaseContainerT, HandleTagT> & container_obj, std::size_t size)
+    { reserve_helper<BaseContainerT>::reserve(container_obj, size); }
+
+
+
 
     template<typename ValueT>
     struct IDCompare
     {
-      bool operator() (ValueT const & lhs, ValueT const & rhs)
+      bool operator() (ValueT const & lhs, ValueT const & rhs) const
       {
         return lhs->id() < rhs->id();
       }
@@ -539,7 +574,7 @@ namespace viennagrid
     template<typename ValueT, typename BaseIDType>
     struct IDCompare< smart_id<ValueT, BaseIDType> >
     {
-      bool operator() ( smart_id<ValueT, BaseIDType> const & lhs, smart_id<ValueT, BaseIDType> const & rhs)
+      bool operator() ( smart_id<ValueT, BaseIDType> const & lhs, smart_id<ValueT, BaseIDType> const & rhs) const
       {
         return lhs->id() < rhs->id();
       }
@@ -576,6 +611,12 @@ namespace viennagrid
         typedef std::list<value_type> type;
     };
 
+    template<typename value_type, int chunk_size>
+    struct container<value_type, chunked_vector_tag<chunk_size> >
+    {
+        typedef chunked_vector<value_type, chunk_size> type;
+    };
+
 
 
     template<typename ValueT>
@@ -61,6 +61,12 @@ namespace viennagrid
   struct std_deque_tag;
   /** @brief A tag indicating that std::list is used as a container */
   struct std_list_tag;
+  /** @brief A tag indicating that chunked_vector is used as a container, see viennagrid/storage/chunked_vector.hpp
+    *
+    * @tparam ChunkSizeV  The number of elements per chunk, 0 selects chunks of about 64 KB
+  */
+  template<int ChunkSizeV = 0>
+  struct chunked_vector_tag;
 
   struct id_compare_tag;
 
@@ -72,6 +78,10 @@ namespace viennagrid
   /** @brief A tag indicating that std::map is used as a container */
   struct std_map_tag;
 
+  /** @brief A tag indicating that the container selected by ContainerTagT uses pool_allocator, see viennagrid/storage/pool_allocator.hpp */
+  template<typename ContainerTagT>
+  struct pool_allocated_tag;
+
   /** @brief A tag indicating that storage::static_array should be used
     *
     * @tparam SizeV       The static size of the array
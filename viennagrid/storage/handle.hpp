@@ -21,6 +21,7 @@
 #include "viennagrid/meta/typemap.hpp"
 #include "viennagrid/storage/id.hpp"
 #include "viennagrid/storage/forwards.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 /** @file viennagrid/storage/handle.hpp
     @brief Defines the generic layer for handles (generalized references) to elements
@@ -243,6 +244,7 @@ namespace viennagrid
       template<typename ContainerT, typename HandleT>
       static typename result_of::value_type<HandleT>::type & dereference_handle( ContainerT & container, HandleT handle )
       {
+        VIENNAGRID_INSTRUMENT_COUNT("handle: dereference by ID search");
         typedef typename result_of::value_type<HandleT>::type ElementType;
         typedef typename result_of::id<ElementType>::type IDType;
 
@@ -256,6 +258,7 @@ namespace viennagrid
       template<typename ContainerT, typename HandleT>
       static typename result_of::value_type<HandleT>::type const & dereference_handle( ContainerT const & container, HandleT handle )
       {
+        VIENNAGRID_INSTRUMENT_COUNT("handle: dereference by ID search");
         typedef typename result_of::value_type<HandleT>::type ElementType;
         typedef typename result_of::id<ElementType>::type IDType;
 
@@ -14,7 +14,10 @@
 ======================================================================= */
 
 #include <map>
+#include <memory>
+#include <functional>
 #include "viennagrid/storage/container.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 /** @file viennagrid/storage/hidden_key_map.hpp
     @brief Provides the implementation of the hidden key map and its surrounding functionality
@@ -99,11 +102,12 @@ namespace viennagrid
     *
     * @tparam  KeyT    The key functor type which extracts the key from the value object
     * @tparam  ValueT  The value type, i.e. the element stored inside the map.
+    * @tparam  AllocatorT  The allocator of the underlying std::map
     */
-  template<typename KeyT, typename ValueT>
+  template<typename KeyT, typename ValueT, typename AllocatorT = std::allocator< std::pair<const KeyT, ValueT> > >
   class hidden_key_map
   {
-    typedef hidden_key_map<KeyT, ValueT> SelfType;
+    typedef hidden_key_map<KeyT, ValueT, AllocatorT> SelfType;
 
     friend class hidden_key_map_iterator<SelfType>;
     friend class hidden_key_map_const_iterator<SelfType>;
@@ -112,7 +116,7 @@ namespace viennagrid
 
   public:
 
-    typedef std::map< KeyT, ValueT >           container_type;
+    typedef std::map< KeyT, ValueT, std::less<KeyT>, AllocatorT >  container_type;
     typedef KeyT                               key_type;
     typedef ValueT                             value_type;
     typedef typename container_type::size_type size_type;
@@ -136,16 +140,19 @@ namespace viennagrid
 
     iterator find( const value_type & element)
     {
+      VIENNAGRID_INSTRUMENT_COUNT("hidden_key_map: find");
       return iterator(container.find( key_type(element) ));
     }
 
     const_iterator find( const value_type & element) const
     {
+      VIENNAGRID_INSTRUMENT_COUNT("hidden_key_map: find");
       return const_iterator(container.find( key_type(element) ));
     }
 
     std::pair<iterator, bool> insert( const value_type & element )
     {
+      VIENNAGRID_INSTRUMENT_COUNT("hidden_key_map: insert");
       std::pair<typename container_type::iterator, bool> ret = container.insert( std::make_pair( key_type(element), element ) );
       return std::make_pair( iterator(ret.first), ret.second );
     }
@@ -173,12 +180,12 @@ namespace viennagrid
 
   namespace detail
   {
-    template<typename KeyT, typename ElementT, typename handle_tag>
-    class container_base<hidden_key_map<KeyT, ElementT>, handle_tag> : public handled_container<hidden_key_map<KeyT, ElementT>, handle_tag>
+    template<typename KeyT, typename ElementT, typename AllocatorT, typename handle_tag>
+    class container_base<hidden_key_map<KeyT, ElementT, AllocatorT>, handle_tag> : public handled_container<hidden_key_map<KeyT, ElementT, AllocatorT>, handle_tag>
     {
     public:
 
-      typedef handled_container<hidden_key_map<KeyT, ElementT>, handle_tag> handled_container_type;
+      typedef handled_container<hidden_key_map<KeyT, ElementT, AllocatorT>, handle_tag> handled_container_type;
       typedef typename handled_container_type::container_type container_type;
 
       typedef typename handled_container_type::value_type value_type;
@@ -239,9 +246,9 @@ namespace viennagrid
 
   namespace detail
   {
-    template<typename KeyT, typename ValueT>
-    std::pair<typename hidden_key_map<KeyT, ValueT>::iterator, bool>
-        insert( hidden_key_map<KeyT, ValueT> & container, const ValueT & element )
+    template<typename KeyT, typename ValueT, typename AllocatorT>
+    std::pair<typename hidden_key_map<KeyT, ValueT, AllocatorT>::iterator, bool>
+        insert( hidden_key_map<KeyT, ValueT, AllocatorT> & container, const ValueT & element )
     {
       return container.insert( element );
     }
@@ -266,7 +273,7 @@ namespace viennagrid
             viennagrid::hidden_key_map_iterator<HiddenKeyMapT>,
             viennagrid::hidden_key_map_const_iterator<HiddenKeyMapT>,
             HandleTagT
-          > const & rhs )
+          > const & rhs ) const
       {
         return lhs->second.id() < rhs->second.id();
       }
@@ -48,6 +48,13 @@ namespace viennagrid
       }
     };
 
+    /** @brief Records the insertion of an element of type ValueT in a plain change counter. Change counters tracking element types provide an overload. */
+    template <typename ChangeCounterT, typename ValueT>
+    void increment_change_counter(ChangeCounterT & change_counter, viennagrid::detail::tag<ValueT>, bool)
+    {
+      ++change_counter;
+    }
+
     /** \endcond */
   }
 
@@ -121,7 +128,7 @@ namespace viennagrid
       //  id_generator.set_max_id( element.id() );
 
       std::pair<handle_type, bool> ret = container.insert( element );
-      if (change_counter) ++(*change_counter);
+      if (change_counter) increment_change_counter( *change_counter, viennagrid::detail::tag<value_type>(), ret.second );
 
       if (call_callback)
           viennagrid::detail::insert_callback(
@@ -188,7 +195,7 @@ namespace viennagrid
       viennagrid::detail::handle_or_ignore( *view_collection, ref, viennagrid::detail::tag<value_type>() );
 
       dependent_inserter->handle_insert( ref, viennagrid::detail::tag<value_type>() );
-      if (change_counter) ++(*change_counter);
+      if (change_counter) increment_change_counter( *change_counter, viennagrid::detail::tag<value_type>(), true );
     }
 
 
@@ -0,0 +1,116 @@
+#ifndef VIENNAGRID_STORAGE_MUTEX_HPP
+#define VIENNAGRID_STORAGE_MUTEX_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#ifdef _WIN32
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <pthread.h>
+#endif
+
+/** @file viennagrid/storage/mutex.hpp
+    @brief Portable mutexes (POSIX threads or Windows) for the process-wide state of ViennaGrid, independent of OpenMP
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+    /** @brief For internal use only. A non-recursive mutex for objects with static storage duration.
+      *
+      * static_mutex is a POD which has to be initialized with VIENNAGRID_STATIC_MUTEX_INITIALIZER, hence it is initialized before any dynamic initialization takes place and can be locked at any time, even during the destruction of static objects.
+      */
+    struct static_mutex
+    {
+#ifdef _WIN32
+      void lock() { AcquireSRWLockExclusive(&native); }
+      void unlock() { ReleaseSRWLockExclusive(&native); }
+
+      SRWLOCK native;
+#else
+      void lock() { pthread_mutex_lock(&native); }
+      void unlock() { pthread_mutex_unlock(&native); }
+
+      pthread_mutex_t native;
+#endif
+    };
+
+#ifdef _WIN32
+  #define VIENNAGRID_STATIC_MUTEX_INITIALIZER { SRWLOCK_INIT }
+#else
+  #define VIENNAGRID_STATIC_MUTEX_INITIALIZER { PTHREAD_MUTEX_INITIALIZER }
+#endif
+
+
+    /** @brief For internal use only. A recursive mutex, i.e. the thread holding the lock may lock it again. */
+    class recursive_mutex
+    {
+    public:
+#ifdef _WIN32
+      recursive_mutex() { InitializeCriticalSection(&native); }
+      ~recursive_mutex() { DeleteCriticalSection(&native); }
+
+      void lock() { EnterCriticalSection(&native); }
+      void unlock() { LeaveCriticalSection(&native); }
+#else
+      recursive_mutex()
+      {
+        pthread_mutexattr_t attributes;
+        pthread_mutexattr_init(&attributes);
+        pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+        pthread_mutex_init(&native, &attributes);
+        pthread_mutexattr_destroy(&attributes);
+      }
+      ~recursive_mutex() { pthread_mutex_destroy(&native); }
+
+      void lock() { pthread_mutex_lock(&native); }
+      void unlock() { pthread_mutex_unlock(&native); }
+#endif
+
+    private:
+      recursive_mutex(recursive_mutex const &);
+      recursive_mutex & operator=(recursive_mutex const &);
+
+#ifdef _WIN32
+      CRITICAL_SECTION native;
+#else
+      pthread_mutex_t native;
+#endif
+    };
+
+
+    /** @brief For internal use only. Holds the lock of a mutex during its lifetime. */
+    template<typename MutexT>
+    class scoped_lock
+    {
+    public:
+      explicit scoped_lock(MutexT & mutex_) : mutex(mutex_) { mutex.lock(); }
+      ~scoped_lock() { mutex.unlock(); }
+
+    private:
+      scoped_lock(scoped_lock const &);
+      scoped_lock & operator=(scoped_lock const &);
+
+      MutexT & mutex;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,353 @@
+#ifndef VIENNAGRID_STORAGE_POOL_ALLOCATOR_HPP
+#define VIENNAGRID_STORAGE_POOL_ALLOCATOR_HPP
+
+/* =======================================================================
+   Copyright (c) 2011-2014, Institute for Microelectronics,
+                            Institute for Analysis and Scientific Computing,
+                            TU Wien.
+
+                            -----------------
+                     ViennaGrid - The Vienna Grid Library
+                            -----------------
+
+   License:      MIT (X11), see file LICENSE in the base directory
+======================================================================= */
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <deque>
+#include <list>
+#include <set>
+#include <map>
+#include <functional>
+
+#include "viennagrid/storage/forwards.hpp"
+#include "viennagrid/storage/container.hpp"
+#include "viennagrid/storage/hidden_key_map.hpp"
+#include "viennagrid/storage/mutex.hpp"
+
+/** @file viennagrid/storage/pool_allocator.hpp
+    @brief A pool allocator serving small objects from large memory blocks, and the container tag pool_allocated_tag selecting it
+*/
+
+namespace viennagrid
+{
+  namespace detail
+  {
+    /** @brief A memory pool handing out chunks of a fixed size. Chunks are carved from large blocks and recycled through an intrusive free list. The pool is not thread-safe.
+      *
+      * The blocks are returned to the system when the pool is destroyed, unless chunks are still in use.
+      */
+    class memory_pool
+    {
+    public:
+      memory_pool() : chunk_size_(0), free_list_(NULL), next_block_chunks_(64), reserved_bytes_(0), chunks_in_use_(0) {}
+
+      ~memory_pool()
+      {
+        // chunks still in use (e.g. by containers with static storage duration) keep their blocks, which are reclaimed by the operating system
+        if (chunks_in_use_ > 0)
+          return;
+
+        for (std::size_t i = 0; i < blocks_.size(); ++i)
+          ::operator delete(blocks_[i]);
+      }
+
+      /** @brief Sets the chunk size, has to be called before the first allocation */
+      void init(std::size_t chunk_size) { chunk_size_ = chunk_size < sizeof(void*) ? sizeof(void*) : chunk_size; }
+
+      /** @brief Returns a chunk of memory */
+      void * allocate()
+      {
+        if (!free_list_)
+          grow();
+
+        void * chunk = free_list_;
+        free_list_ = *static_cast<void**>(chunk);
+        ++chunks_in_use_;
+        return chunk;
+      }
+
+      /** @brief Returns a chunk of memory to the pool */
+      void deallocate(void * chunk)
+      {
+        *static_cast<void**>(chunk) = free_list_;
+        free_list_ = chunk;
+        --chunks_in_use_;
+      }
+
+      /** @brief Returns the number of bytes obtained from the system */
+      std::size_t reserved_bytes() const { return reserved_bytes_; }
+
+    private:
+
+      memory_pool(memory_pool const &);
+      memory_pool & operator=(memory_pool const &);
+
+      void grow()
+      {
+        std::size_t chunks = next_block_chunks_;
+        char * block = static_cast<char*>( ::operator new(chunks * chunk_size_) );
+        blocks_.push_back(block);
+        reserved_bytes_ += chunks * chunk_size_;
+
+        // chain the chunks of the new block in address order
+        for (std::size_t i = 0; i+1 < chunks; ++i)
+          *reinterpret_cast<void**>(block + i*chunk_size_) = block + (i+1)*chunk_size_;
+        *reinterpret_cast<void**>(block + (chunks-1)*chunk_size_) = free_list_;
+        free_list_ = block;
+
+        if (next_block_chunks_ * chunk_size_ < 1024*1024)
+          next_block_chunks_ *= 2;
+      }
+
+      std::size_t chunk_size_;
+      void * free_list_;
+      std::size_t next_block_chunks_;
+      std::size_t reserved_bytes_;
+      std::size_t chunks_in_use_;
+      std::vector<char*> blocks_;
+    };
+
+
+    /** @brief Requests up to this size are served by the pools, larger requests are passed to operator new */
+    static const std::size_t pool_max_chunk_size = 1024;
+    /** @brief The size classes of the pools are multiples of this granularity */
+    static const std::size_t pool_granularity = 8;
+
+    /** @brief For internal use only. Returns the mutex serializing all accesses to the pools. */
+    inline static_mutex & pool_mutex()
+    {
+      static static_mutex mutex_ = VIENNAGRID_STATIC_MUTEX_INITIALIZER;
+      return mutex_;
+    }
+
+    /** @brief For internal use only. Returns true after the pools were destroyed at program exit. */
+    inline bool & pools_destroyed()
+    {
+      static bool destroyed = false;
+      return destroyed;
+    }
+
+    /** @brief For internal use only. The pools of all size classes. */
+    class memory_pool_set
+    {
+    public:
+      memory_pool_set()
+      {
+        for (std::size_t i = 0; i < pool_max_chunk_size / pool_granularity; ++i)
+          pools[i].init( (i+1) * pool_granularity );
+      }
+
+      ~memory_pool_set() { pools_destroyed() = true; }
+
+      memory_pool & operator()(std::size_t bytes) { return pools[ (bytes-1) / pool_granularity ]; }
+
+    private:
+      memory_pool pools[pool_max_chunk_size / pool_granularity];
+    };
+
+    /** @brief Returns the pool responsible for requests of 'bytes' bytes. The caller has to hold the lock of pool_mutex().
+      *
+      * The pools are created on first use (under the lock, hence also safe for compilers without thread-safe initialization of local statics) and destroyed at program exit.
+      */
+    inline memory_pool & pool_for_size(std::size_t bytes)
+    {
+      static memory_pool_set pools;
+      return pools(bytes);
+    }
+
+    /** @brief Allocates 'bytes' bytes from the pools */
+    inline void * pool_allocate(std::size_t bytes)
+    {
+      if (bytes == 0)
+        bytes = 1;
+      if (bytes > pool_max_chunk_size)
+        return ::operator new(bytes);
+
+      scoped_lock<static_mutex> lock( pool_mutex() );
+      if (pools_destroyed())
+        return ::operator new(bytes);   // during the destruction of static objects, freed again by the operating system
+      return pool_for_size(bytes).allocate();
+    }
+
+    /** @brief Returns memory previously obtained by pool_allocate() with the same size */
+    inline void pool_deallocate(void * chunk, std::size_t bytes)
+    {
+      if (!chunk)
+        return;
+      if (bytes == 0)
+        bytes = 1;
+      if (bytes > pool_max_chunk_size)
+      {
+        ::operator delete(chunk);
+        return;
+      }
+
+      scoped_lock<static_mutex> lock( pool_mutex() );
+      if (!pools_destroyed())
+        pool_for_size(bytes).deallocate(chunk);
+    }
+
+    /** @brief Returns the total number of bytes the pools obtained from the system */
+    inline std::size_t pool_reserved_bytes()
+    {
+      std::size_t result = 0;
+
+      scoped_lock<static_mutex> lock( pool_mutex() );
+      if (!pools_destroyed())
+      {
+        for (std::size_t bytes = pool_granularity; bytes <= pool_max_chunk_size; bytes += pool_granularity)
+          result += pool_for_size(bytes).reserved_bytes();
+      }
+      return result;
+    }
+  }
+
+
+  /** @brief A standard conforming allocator which serves small objects (up to 1 KB) from size-segregated memory pools.
+    *
+    * Allocation and deallocation are O(1) free list operations and memory is taken from the system in large blocks, which avoids heap fragmentation for the many small nodes and arrays of a mesh.
+    * The allocator is stateless, i.e. all instances share the same process-wide pools. Accesses to the pools are serialized by a mutex (POSIX threads or Windows, independent of OpenMP), hence meshes using the allocator can be built concurrently by different threads.
+    *
+    * @tparam T     The type of the objects to allocate
+    */
+  template<typename T>
+  class pool_allocator
+  {
+  public:
+    typedef T                 value_type;
+    typedef T *               pointer;
+    typedef T const *         const_pointer;
+    typedef T &               reference;
+    typedef T const &         const_reference;
+    typedef std::size_t       size_type;
+    typedef std::ptrdiff_t    difference_type;
+
+    template<typename U>
+    struct rebind
+    {
+      typedef pool_allocator<U> other;
+    };
+
+    pool_allocator() {}
+    pool_allocator(pool_allocator const &) {}
+    template<typename U>
+    pool_allocator(pool_allocator<U> const &) {}
+
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+
+    pointer allocate(size_type n, void const * = 0)
+    {
+      if (n > max_size())
+        throw std::bad_alloc();
+      return static_cast<pointer>( detail::pool_allocate(n * sizeof(T)) );
+    }
+
+    void deallocate(pointer p, size_type n) { detail::pool_deallocate(p, n * sizeof(T)); }
+
+    size_type max_size() const { return static_cast<size_type>(-1) / sizeof(T); }
+
+    void construct(pointer p, const_reference value) { new (static_cast<void*>(p)) T(value); }
+    void destroy(pointer p) { p->~T(); }
+  };
+
+  template<typename T, typename U>
+  bool operator==(pool_allocator<T> const &, pool_allocator<U> const &) { return true; }
+
+  template<typename T, typename U>
+  bool operator!=(pool_allocator<T> const &, pool_allocator<U> const &) { return false; }
+
+
+
+  /** @brief A tag indicating that the container selected by ContainerTagT allocates its memory using pool_allocator.
+    *
+    * Supported are std_vector_tag, std_deque_tag, std_list_tag, std_set_tag and hidden_key_map_tag.
+    * The tag can be used everywhere a container tag is expected, e.g. for the vertex and cell containers in config::result_of::full_mesh_config, as view container tag of segmentations or within a handled_container_tag.
+    *
+    * @tparam ContainerTagT   The tag of the underlying container, e.g. std_deque_tag
+    */
+  template<typename ContainerTagT>
+  struct pool_allocated_tag
+  {
+    typedef ContainerTagT container_tag;
+  };
+
+
+  /** @brief A typemap defining a view container configuration (e.g. for segments and mesh views) with pool allocated std::set */
+  typedef viennagrid::make_typemap<
+      default_tag,
+      pool_allocated_tag< std_set_tag<id_compare_tag> >
+  >::type pool_allocated_view_container_config;
+
+
+  namespace result_of
+  {
+    /** @brief Returns pool_allocated_tag<ContainerTagT> if ReferenceTagT is a pool_allocated_tag, ContainerTagT otherwise. Used for deriving container tags of internal containers from user-provided tags.
+      *
+      * @tparam ReferenceTagT   The container tag provided by the user
+      * @tparam ContainerTagT   The container tag to be adapted
+      */
+    template<typename ReferenceTagT, typename ContainerTagT>
+    struct allocation_alike
+    {
+      typedef ContainerTagT type;
+    };
+
+    /** \cond */
+    template<typename ReferenceContainerTagT, typename ContainerTagT>
+    struct allocation_alike< pool_allocated_tag<ReferenceContainerTagT>, ContainerTagT >
+    {
+      typedef pool_allocated_tag<ContainerTagT> type;
+    };
+
+    template<typename ReferenceContainerTagT, typename ContainerTagT>
+    struct allocation_alike< pool_allocated_tag<ReferenceContainerTagT>, pool_allocated_tag<ContainerTagT> >
+    {
+      typedef pool_allocated_tag<ContainerTagT> type;
+    };
+
+
+    template<typename ValueT>
+    struct container<ValueT, pool_allocated_tag<std_vector_tag> >
+    {
+      typedef std::vector<ValueT, pool_allocator<ValueT> > type;
+    };
+
+    template<typename ValueT>
+    struct container<ValueT, pool_allocated_tag<std_deque_tag> >
+    {
+      typedef std::deque<ValueT, pool_allocator<ValueT> > type;
+    };
+
+    template<typename ValueT>
+    struct container<ValueT, pool_allocated_tag<std_list_tag> >
+    {
+      typedef std::list<ValueT, pool_allocator<ValueT> > type;
+    };
+
+    template<typename ValueT>
+    struct container<ValueT, pool_allocated_tag< std_set_tag<default_tag> > >
+    {
+      typedef std::set<ValueT, std::less<ValueT>, pool_allocator<ValueT> > type;
+    };
+
+    template<typename ValueT>
+    struct container<ValueT, pool_allocated_tag< std_set_tag<id_compare_tag> > >
+    {
+      typedef std::set<ValueT, viennagrid::detail::IDCompare<ValueT>, pool_allocator<ValueT> > type;
+    };
+
+    template<typename ElementT, typename KeyTypeTagT>
+    struct container<ElementT, pool_allocated_tag< hidden_key_map_tag<KeyTypeTagT> > >
+    {
+      typedef typename hidden_key_map_key_type_from_tag<ElementT, KeyTypeTagT>::type KeyType;
+      typedef hidden_key_map< KeyType, ElementT, pool_allocator< std::pair<const KeyType, ElementT> > > type;
+    };
+    /** \endcond */
+  }
+}
+
+#endif
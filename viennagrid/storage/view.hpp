@@ -15,6 +15,7 @@
 
 #include <iterator>
 #include <algorithm>
+#include <set>
 
 #include "viennagrid/forwards.hpp"
 #include "viennagrid/meta/typemap.hpp"
@@ -23,6 +24,7 @@
 #include "viennagrid/storage/container_collection.hpp"
 #include "viennagrid/storage/handle.hpp"
 #include "viennagrid/storage/id.hpp"
+#include "viennagrid/instrumentation.hpp"
 
 
 /** @file viennagrid/storage/view.hpp
@@ -31,6 +33,43 @@
 
 namespace viennagrid
 {
+  namespace detail
+  {
+    /** @brief Returns an iterator to 'handle' within the handle container of a view. Linear search for sequence containers. */
+    template<typename HandleContainerT, typename HandleT>
+    typename HandleContainerT::iterator find_handle(HandleContainerT & container, HandleT const & handle)
+    { return std::find(container.begin(), container.end(), handle); }
+
+    template<typename HandleContainerT, typename HandleT>
+    typename HandleContainerT::const_iterator find_handle(HandleContainerT const & container, HandleT const & handle)
+    { return std::find(container.begin(), container.end(), handle); }
+
+    /** @brief Returns an iterator to 'handle' within the handle container of a view. Logarithmic search for std::set. */
+    template<typename KeyT, typename CompareT, typename AllocatorT, typename HandleT>
+    typename std::set<KeyT, CompareT, AllocatorT>::iterator find_handle(std::set<KeyT, CompareT, AllocatorT> & container, HandleT const & handle)
+    { return container.find(handle); }
+
+    template<typename KeyT, typename CompareT, typename AllocatorT, typename HandleT>
+    typename std::set<KeyT, CompareT, AllocatorT>::const_iterator find_handle(std::set<KeyT, CompareT, AllocatorT> const & container, HandleT const & handle)
+    { return container.find(handle); }
+
+    /** @brief Inserts 'handle' into the handle container of a view if it is not already present. */
+    template<typename HandleContainerT, typename HandleT>
+    void insert_unique_handle(HandleContainerT & container, HandleT const & handle)
+    {
+      VIENNAGRID_INSTRUMENT_COUNT("view: unique insert by linear search");
+      if (std::find(container.begin(), container.end(), handle) == container.end())
+        viennagrid::detail::insert(container, handle);
+    }
+
+    template<typename KeyT, typename CompareT, typename AllocatorT, typename HandleT>
+    void insert_unique_handle(std::set<KeyT, CompareT, AllocatorT> & container, HandleT const & handle)
+    {
+      VIENNAGRID_INSTRUMENT_COUNT("view: unique insert into set");
+      container.insert(handle);
+    }
+  }
+
   /** @brief A view holds references to a subset of elements in another elements, but represents itself to the outside as another container.
     *
     * @tparam base_container_type_    The container type on which the view acts
@@ -79,7 +118,7 @@ namespace viennagrid
       typedef typename view::pointer                               pointer;
       typedef typename std::iterator_traits<base>::iterator_category iterator_category;
 
-      handle_type &     handle()       { return base::operator*(); }
+      typename std::iterator_traits<base>::reference handle() { return base::operator*(); }
       const_handle_type handle() const { return base::operator*(); }
 
       reference       operator* ()       { return view_->dereference_handle( handle() ); }
@@ -146,7 +185,7 @@ namespace viennagrid
       typedef typename view::pointer pointer;
       typedef typename std::iterator_traits<base>::iterator_category iterator_category;
 
-      handle_type & handle() { return base::operator*(); }
+      typename std::iterator_traits<base>::reference handle() { return base::operator*(); }
       const_handle_type handle() const { return base::operator*(); }
 
       reference operator* () { return view_->dereference_handle( handle() ); }
@@ -230,9 +269,9 @@ namespace viennagrid
     const_handle_type handle( const_reference element ) const { return &element; }
 
     iterator find( const_reference element )
-    { return std::find( begin(), end(), handle(element)); }
+    { return iterator(*this, viennagrid::detail::find_handle(handle_container, const_cast<handle_type>(handle(element)))); }
     const_iterator find( const_reference element ) const
-    { return std::find( begin(), end(), handle(element)); }
+    { return const_iterator(*this, viennagrid::detail::find_handle(handle_container, const_cast<handle_type>(handle(element)))); }
 
 
     reference front() { return dereference_handle(handle_container.front()); }
@@ -247,6 +286,9 @@ namespace viennagrid
 
     size_type size() const { return handle_container.size(); }
     void resize(size_type size_) { handle_container.resize(size_); }
+
+    /** @brief For internal use only, returns the container of the element handles */
+    handle_container_type const & handles() const { return handle_container; }
     void increment_size() { resize( size()+1 ); }
 
     bool empty() const { return handle_container.empty(); }
@@ -255,10 +297,7 @@ namespace viennagrid
 
     void insert_unique_handle(handle_type handle)
     {
-      for (iterator it = begin(); it != end(); ++it)
-        if (handle == it.handle()) return;
-
-      insert_handle(handle);
+      viennagrid::detail::insert_unique_handle(handle_container, handle);
     }
 
     void insert_handle(handle_type handle) { viennagrid::detail::insert(handle_container, handle); }
@@ -296,256 +335,6 @@ namespace viennagrid
 
 
 
-  // specialization for std::set
-  /** \cond */
-  template<typename base_container_type_, typename CompareTagT>
-  class view<base_container_type_, std_set_tag<CompareTagT> >
-  {
-  public:
-
-    template<typename A, typename B>
-    friend class view;
-
-    typedef base_container_type_ base_container_type;
-
-    typedef std_set_tag<CompareTagT> container_tag;
-
-    typedef typename base_container_type::handle_tag handle_tag;
-    typedef typename detail::result_of::handle_type<base_container_type, handle_tag>::type handle_type;
-    typedef typename detail::result_of::const_handle_type<base_container_type, handle_tag>::type const_handle_type;
-
-
-  private:
-    typedef typename viennagrid::result_of::container<handle_type, container_tag>::type handle_container_type;
-
-
-  public:
-    typedef typename handle_container_type::size_type size_type;
-    typedef typename base_container_type::value_type value_type;
-    typedef value_type & reference;
-    typedef const value_type & const_reference;
-    typedef value_type * pointer;
-    typedef const value_type * const_pointer;
-
-
-
-    class iterator : public handle_container_type::iterator
-    {
-      typedef typename handle_container_type::iterator base;
-    public:
-      iterator(view & view_obj, const base & foo) : base(foo), view_(&view_obj) {}
-      iterator(const iterator & it) : base(it), view_(it.view_) {}
-
-      typedef typename std::iterator_traits<base>::difference_type   difference_type;
-      typedef typename view::value_type                            value_type;
-      typedef typename view::reference                             reference;
-      typedef typename view::const_reference                       const_reference;
-      typedef typename view::pointer                               pointer;
-      typedef typename std::iterator_traits<base>::iterator_category iterator_category;
-
-      handle_type       handle()       { return base::operator*(); }
-      const_handle_type handle() const { return base::operator*(); }
-
-      reference       operator* ()       { return view_->dereference_handle( handle() ); }
-      const_reference operator* () const { return view_->dereference_handle( handle() ); }
-
-      pointer operator->()       { return &(operator* ()); }
-      pointer operator->() const { return &(operator* ()); }
-
-      iterator & operator++() { base::operator++(); return *this; }
-      iterator operator++(int) { base::operator++(int()); return *this; }
-
-      iterator & operator--() { base::operator--(); return *this; }
-      iterator operator--(int) { base::operator--(int()); return *this; }
-
-    private:
-      view * view_;
-    };
-
-
-    class const_iterator : public handle_container_type::const_iterator
-    {
-      typedef typename handle_container_type::const_iterator base;
-    public:
-      const_iterator(view const & view_obj, const base & foo) : base(foo), view_(&view_obj) {}
-      const_iterator(const const_iterator & it) : base(it), view_(it.view_) {}
-      const_iterator(const iterator & it) : base(it), view_(it.view_) {}
-
-      typedef typename std::iterator_traits<base>::difference_type difference_type;
-      typedef typename view::value_type value_type;
-      typedef typename view::const_reference reference;
-      typedef typename view::const_reference const_reference;
-      typedef typename view::const_pointer pointer;
-      typedef typename std::iterator_traits<base>::iterator_category iterator_category;
-
-      const_handle_type handle() { return base::operator*(); }
-      const_handle_type handle() const { return base::operator*(); }
-
-      reference operator* () { return view_->dereference_handle( handle() ); }
-      const_reference operator* () const { return view_->dereference_handle( handle() ); }
-
-      pointer operator->() const { return &(operator* ()); }
-
-      const_iterator & operator++() { base::operator++(); return *this; }
-      const_iterator operator++(int) { base::operator++(int()); return *this; }
-
-      const_iterator & operator--() { base::operator--(); return *this; }
-      const_iterator operator--(int) { base::operator--(int()); return *this; }
-
-    private:
-      view const * view_;
-    };
-
-    class reverse_iterator : public handle_container_type::reverse_iterator
-    {
-      typedef typename handle_container_type::reverse_iterator base;
-    public:
-      reverse_iterator(view & view_obj, const base & foo) : base(foo), view_(&view_obj) {}
-      reverse_iterator(const reverse_iterator & it) : base(it), view_(it.view_) {}
-
-      typedef typename std::iterator_traits<base>::difference_type difference_type;
-      typedef typename view::value_type value_type;
-      typedef typename view::reference reference;
-      typedef typename view::const_reference const_reference;
-      typedef typename view::pointer pointer;
-      typedef typename std::iterator_traits<base>::iterator_category iterator_category;
-
-      handle_type & handle() { return base::operator*(); }
-      const_handle_type handle() const { return base::operator*(); }
-
-      reference operator* () { return view_->dereference_handle( handle() ); }
-      const_reference operator* () const { return view_->dereference_handle( handle() ); }
-
-      pointer operator->() { return &(operator* ()); }
-      pointer operator->() const { return &(operator* ()); }
-
-      reverse_iterator & operator++() { base::operator++(); return *this; }
-      reverse_iterator operator++(int) { base::operator++(int()); return *this; }
-
-      reverse_iterator & operator--() { base::operator--(); return *this; }
-      reverse_iterator operator--(int) { base::operator--(int()); return *this; }
-
-    private:
-      view * view_;
-    };
-
-
-    class const_reverse_iterator : public handle_container_type::const_reverse_iterator
-    {
-      typedef typename handle_container_type::const_reverse_iterator base;
-    public:
-      const_reverse_iterator(view const & view_obj, const base & foo) : base(foo), view_(&view_obj) {}
-      const_reverse_iterator(const const_reverse_iterator & it) : base(it), view_(it.view_) {}
-      const_reverse_iterator(const iterator & it) : base(it), view_(it.view) {}
-
-      typedef typename std::iterator_traits<base>::difference_type difference_type;
-      typedef typename view::value_type value_type;
-      typedef typename view::const_reference reference;
-      typedef typename view::const_reference const_reference;
-      typedef typename view::const_pointer pointer;
-      typedef typename std::iterator_traits<base>::iterator_category iterator_category;
-
-      const_handle_type handle() { return base::operator*(); }
-      const_handle_type handle() const { return base::operator*(); }
-
-      reference operator* () { return view_->dereference_handle( handle() ); }
-      const_reference operator* () const { return view_->dereference_handle( handle() ); }
-
-      pointer operator->() const { return &(operator* ()); }
-
-      const_reverse_iterator & operator++() { base::operator++(); return *this; }
-      const_reverse_iterator operator++(int) { base::operator++(int()); return *this; }
-
-      const_reverse_iterator & operator--() { base::operator--(); return *this; }
-      const_reverse_iterator operator--(int) { base::operator--(int()); return *this; }
-
-    private:
-      view const * view_;
-    };
-
-
-
-    view() {}
-
-    void set_base_container( base_container_type & base_container_ )
-    { base_container = &base_container_; }
-
-    template<typename other_container_tag>
-    void set_base_container( view<base_container_type, other_container_tag> & base_view )
-    { base_container = base_view.base_container; }
-
-    template<typename other_container_tag>
-    void set_base_container( view<base_container_type, other_container_tag> const & base_view )
-    { base_container = base_view.base_container; }
-
-
-    iterator begin() { return iterator(*this, handle_container.begin()); }
-    iterator end() { return iterator(*this, handle_container.end()); }
-
-    const_iterator cbegin() { return const_iterator(*this, handle_container.begin()); }
-    const_iterator cend() { return const_iterator(*this, handle_container.end()); }
-
-    const_iterator begin() const { return const_iterator(*this, handle_container.begin()); }
-    const_iterator end() const { return const_iterator(*this, handle_container.end()); }
-
-
-    reference dereference_handle( handle_type handle ) { return viennagrid::detail::dereference_handle( *base_container, handle ); }
-    const_reference dereference_handle( const_handle_type handle ) const { return viennagrid::detail::dereference_handle_const( *base_container, handle ); }
-
-    handle_type handle( reference element ) { return &element; }
-    const_handle_type handle( const_reference element ) const { return &element; }
-
-    iterator find( const_reference element )
-    { return iterator(*this, handle_container.find(const_cast<handle_type>(handle(element)))); }
-    const_iterator find( const_reference element ) const
-    { return const_iterator(*this, handle_container.find(const_cast<handle_type>(handle(element)))); }
-
-    reference front() { return dereference_handle(handle_container.front()); }
-    const_reference front() const { return dereference_handle(handle_container.front()); }
-
-    reference back() { return dereference_handle(handle_container.back()); }
-    const_reference back() const { return dereference_handle(handle_container.back()); }
-
-    reference operator[]( size_type index ) { iterator it = begin(); std::advance(it, static_cast<long>(index)); return *it; }
-    const_reference operator[]( size_type index ) const { const_iterator it = begin(); std::advance(it, static_cast<long>(index)); return *it; }
-
-
-    size_type size() const { return handle_container.size(); }
-    void resize(size_type size_) { handle_container.resize(size_); }
-    void increment_size() { resize( size()+1 ); }
-
-    bool empty() const { return handle_container.empty(); }
-    void clear() { handle_container.clear(); }
-
-
-    void insert_unique_handle(handle_type handle)
-    {
-      insert_handle(handle);
-    }
-
-    void insert_handle(handle_type handle)
-    {
-      viennagrid::detail::insert(handle_container, handle);
-    }
-    void set_handle( handle_type element, size_type pos ); // not supported
-    void erase_handle(handle_type handle)
-    {
-      for (iterator it = begin(); it != end(); ++it)
-        if (it.handle() == handle)
-        {
-          handle_container.erase( it );
-          return;
-        }
-    }
-
-    handle_type handle_at(std::size_t pos) { return viennagrid::advance(begin(), pos).handle(); }
-    const_handle_type handle_at(std::size_t pos) const { return viennagrid::advance(begin(), pos).handle(); }
-
-  private:
-    handle_container_type handle_container;
-    base_container_type * base_container;
-  };
-  /** \endcond */
 
 
 
@@ -721,6 +510,18 @@ namespace viennagrid
 //           );
     }
 
+    template<typename BaseContainerT>
+    typename view< BaseContainerT, pool_allocated_tag< std_set_tag<id_compare_tag> > >::iterator find(view< BaseContainerT, pool_allocated_tag< std_set_tag<id_compare_tag> > > & container, typename view< BaseContainerT, pool_allocated_tag< std_set_tag<id_compare_tag> > >::value_type const & element)
+    {
+      return container.find(element);
+    }
+
+    template<typename BaseContainerT>
+    typename view< BaseContainerT, pool_allocated_tag< std_set_tag<id_compare_tag> > >::const_iterator find(view< BaseContainerT, pool_allocated_tag< std_set_tag<id_compare_tag> > > const & container, typename view< BaseContainerT, pool_allocated_tag< std_set_tag<id_compare_tag> > >::value_type const & element)
+    {
+      return container.find(element);
+    }
+
 
 
 